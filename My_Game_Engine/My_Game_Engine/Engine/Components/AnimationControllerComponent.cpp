@@ -1,13 +1,31 @@
 #include "AnimationControllerComponent.h"
 #include "Core/Object.h"
+#include "Components/RigidbodyComponent.h"
 #include "Resource/Model.h"
 #include "GameEngine.h"
 #include "DX_Graphics/ResourceUtils.h"
 
+static_assert(sizeof(BoneMatrixData) == sizeof(XMFLOAT4X4), "Pose cache palettes are copied as raw matrices");
+
+namespace
+{
+    // Shared by every controller; updated from job workers.
+    struct
+    {
+        std::atomic<UINT> controllers = 0;
+        std::atomic<UINT> evaluatedControllers = 0;
+        std::atomic<UINT> frozenControllers = 0;
+        std::atomic<UINT> unchangedControllers = 0;
+        std::atomic<UINT> evaluatedBones = 0;
+        std::atomic<UINT> savedBones = 0;
+    } sLODStats;
+}
+
 AnimationControllerComponent::AnimationControllerComponent()
-    : SynchronizedComponent()
+    : Component()
 {
     mLayers.resize(1);
+    XMStoreFloat4x4(&mRootMotionSpace, XMMatrixIdentity());
 }
 
 rapidjson::Value AnimationControllerComponent::ToJSON(rapidjson::Document::AllocatorType& alloc) const
@@ -17,10 +35,10 @@ rapidjson::Value AnimationControllerComponent::ToJSON(rapidjson::Document::Alloc
     v.AddMember("type", "AnimationControllerComponent", alloc);
     v.AddMember("IsPaused", mIsPaused, alloc);
 
-    std::string skelGUID = mModelSkeleton ? mModelSkeleton->GetGUID() : "";
+    std::string skelGUID = mModelSkeleton ? mModelSkeleton->GetGUID().ToString() : "";
     v.AddMember("SkeletonGUID", rapidjson::Value(skelGUID.c_str(), alloc), alloc);
 
-    std::string avatarGUID = mModelAvatar ? mModelAvatar->GetGUID() : "";
+    std::string avatarGUID = mModelAvatar ? mModelAvatar->GetGUID().ToString() : "";
     v.AddMember("ModelAvatarGUID", rapidjson::Value(avatarGUID.c_str(), alloc), alloc);
 
     rapidjson::Value layerArray(rapidjson::kArrayType);
@@ -30,6 +48,32 @@ rapidjson::Value AnimationControllerComponent::ToJSON(rapidjson::Document::Alloc
     }
     v.AddMember("Layers", layerArray, alloc);
 
+    rapidjson::Value lod(rapidjson::kObjectType);
+    lod.AddMember("Enabled", mLODSettings.enabled, alloc);
+    rapidjson::Value distances(rapidjson::kArrayType);
+    for (float d : mLODSettings.distances) distances.PushBack(d, alloc);
+    lod.AddMember("Distances", distances, alloc);
+    rapidjson::Value intervals(rapidjson::kArrayType);
+    for (UINT n : mLODSettings.updateIntervals) intervals.PushBack(n, alloc);
+    lod.AddMember("UpdateIntervals", intervals, alloc);
+    lod.AddMember("LeafSkipLOD", mLODSettings.leafSkipLOD, alloc);
+    lod.AddMember("LeafDepth", mLODSettings.leafDepth, alloc);
+    lod.AddMember("MinScreenSize", mLODSettings.minScreenSize, alloc);
+    lod.AddMember("CullFreezeFrames", mLODSettings.cullFreezeFrames, alloc);
+    lod.AddMember("BoundsRadius", mLODSettings.boundsRadius, alloc);
+    v.AddMember("LOD", lod, alloc);
+
+    rapidjson::Value rootMotion(rapidjson::kObjectType);
+    rootMotion.AddMember("Enabled", mRootMotionSettings.enabled, alloc);
+    rootMotion.AddMember("LockX", mRootMotionSettings.lockX, alloc);
+    rootMotion.AddMember("LockY", mRootMotionSettings.lockY, alloc);
+    rootMotion.AddMember("LockZ", mRootMotionSettings.lockZ, alloc);
+    rootMotion.AddMember("LockYaw", mRootMotionSettings.lockYaw, alloc);
+    v.AddMember("RootMotion", rootMotion, alloc);
+
+    v.AddMember("PoseSharing", mPoseSharing, alloc);
+    v.AddMember("PoseSharingTimeStep", mPoseSharingTimeStep, alloc);
+
     return v;
 }
 
@@ -42,7 +86,7 @@ void AnimationControllerComponent::FromJSON(const rapidjson::Value& val)
     std::string skelGUID = val.HasMember("SkeletonGUID") ? val["SkeletonGUID"].GetString() : "";
     std::string skelPath = val.HasMember("SkeletonPath") ? val["SkeletonPath"].GetString() : "";
 
-    if (auto skel = resSystem->GetOrLoad<Skeleton>(skelGUID, skelPath))
+    if (auto skel = resSystem->GetOrLoad<Skeleton>(Guid::FromString(skelGUID), skelPath))
     {
         SetSkeleton(skel);
     }
@@ -55,7 +99,7 @@ void AnimationControllerComponent::FromJSON(const rapidjson::Value& val)
     std::string avatarGUID = val.HasMember("ModelAvatarGUID") ? val["ModelAvatarGUID"].GetString() : "";
     std::string avatarPath = val.HasMember("ModelAvatarPath") ? val["ModelAvatarPath"].GetString() : "";
 
-    if (auto avatar = resSystem->GetOrLoad<Model_Avatar>(avatarGUID, avatarPath))
+    if (auto avatar = resSystem->GetOrLoad<Model_Avatar>(Guid::FromString(avatarGUID), avatarPath))
     {
         SetModelAvatar(avatar);
     }
@@ -79,6 +123,47 @@ void AnimationControllerComponent::FromJSON(const rapidjson::Value& val)
             }
         }
     }
+
+    if (val.HasMember("LOD") && val["LOD"].IsObject())
+    {
+        const rapidjson::Value& lod = val["LOD"];
+        AnimationLODSettings settings;
+
+        if (lod.HasMember("Enabled")) settings.enabled = lod["Enabled"].GetBool();
+        if (lod.HasMember("Distances") && lod["Distances"].IsArray())
+        {
+            const auto& arr = lod["Distances"].GetArray();
+            for (UINT i = 0; i < arr.Size() && i < AnimationLODSettings::LevelCount - 1; ++i)
+                settings.distances[i] = arr[i].GetFloat();
+        }
+        if (lod.HasMember("UpdateIntervals") && lod["UpdateIntervals"].IsArray())
+        {
+            const auto& arr = lod["UpdateIntervals"].GetArray();
+            for (UINT i = 0; i < arr.Size() && i < AnimationLODSettings::LevelCount; ++i)
+                settings.updateIntervals[i] = arr[i].GetUint();
+        }
+        if (lod.HasMember("LeafSkipLOD")) settings.leafSkipLOD = lod["LeafSkipLOD"].GetInt();
+        if (lod.HasMember("LeafDepth")) settings.leafDepth = lod["LeafDepth"].GetUint();
+        if (lod.HasMember("MinScreenSize")) settings.minScreenSize = lod["MinScreenSize"].GetFloat();
+        if (lod.HasMember("CullFreezeFrames")) settings.cullFreezeFrames = lod["CullFreezeFrames"].GetUint();
+        if (lod.HasMember("BoundsRadius")) settings.boundsRadius = lod["BoundsRadius"].GetFloat();
+
+        SetLODSettings(settings);
+    }
+
+    if (val.HasMember("RootMotion") && val["RootMotion"].IsObject())
+    {
+        const rapidjson::Value& rm = val["RootMotion"];
+        if (rm.HasMember("Enabled")) mRootMotionSettings.enabled = rm["Enabled"].GetBool();
+        if (rm.HasMember("LockX")) mRootMotionSettings.lockX = rm["LockX"].GetBool();
+        if (rm.HasMember("LockY")) mRootMotionSettings.lockY = rm["LockY"].GetBool();
+        if (rm.HasMember("LockZ")) mRootMotionSettings.lockZ = rm["LockZ"].GetBool();
+        if (rm.HasMember("LockYaw")) mRootMotionSettings.lockYaw = rm["LockYaw"].GetBool();
+    }
+
+    bool sharing = val.HasMember("PoseSharing") ? val["PoseSharing"].GetBool() : false;
+    float timeStep = val.HasMember("PoseSharingTimeStep") ? val["PoseSharingTimeStep"].GetFloat() : 0.0f;
+    SetPoseSharing(sharing, timeStep);
 }
 
 void AnimationControllerComponent::WakeUp()
@@ -98,6 +183,9 @@ void AnimationControllerComponent::CreateBoneMatrixBuffer()
 
     mCpuBoneMatrices.resize(boneCount);
 
+    // Without a renderer (tools and benchmarks) the palette is only evaluated on the CPU.
+    if (!GameEngine::Get().GetRenderer()) return;
+
     RendererContext rc = GameEngine::Get().Get_UploadContext();
     DescriptorManager* heap = rc.resourceHeap;
 
@@ -129,8 +217,6 @@ void AnimationControllerComponent::CreateBoneMatrixBuffer()
 
 void AnimationControllerComponent::SetSkeleton(std::shared_ptr<Skeleton> skeleton)
 {
-    std::lock_guard<std::mutex> lock(componentMutex);
-
     if (mModelSkeleton == skeleton) return;
 
     if (mBoneMatrixBuffer)
@@ -164,15 +250,18 @@ void AnimationControllerComponent::SetSkeleton(std::shared_ptr<Skeleton> skeleto
 
 void AnimationControllerComponent::SetModelAvatar(std::shared_ptr<Model_Avatar> model_avatar)
 {
-    std::lock_guard<std::mutex> lock(componentMutex);
-
     mModelAvatar = model_avatar;
     UpdateBoneMappingCache();
 }
 
 bool AnimationControllerComponent::IsReady() const
 {
-    return mModelSkeleton != nullptr && mModelAvatar != nullptr && mBoneMatrixSRVSlot != UINT_MAX;
+    return CanEvaluate() && mBoneMatrixSRVSlot != UINT_MAX;
+}
+
+bool AnimationControllerComponent::CanEvaluate() const
+{
+    return mModelSkeleton != nullptr && mModelAvatar != nullptr && !mCpuBoneMatrices.empty();
 }
 
 void AnimationControllerComponent::UpdateBoneMappingCache()
@@ -182,23 +271,23 @@ void AnimationControllerComponent::UpdateBoneMappingCache()
     size_t boneCount = mModelSkeleton->GetBoneCount();
     const auto& bones = mModelSkeleton->GetBones();
 
-    mCachedBoneToKey.clear();
-    mCachedBoneToKey.resize(boneCount);
+    auto& bindings = AnimationBindingCache::Get();
+    bindings.PurgeExpired();
+    mAvatarBinding = bindings.GetAvatarBinding(mModelSkeleton, mModelAvatar);
+    if (!mAvatarBinding) return;
+    const std::vector<std::string>& boneKeys = mAvatarBinding->boneKeys;
 
     mControllerBoneCache.clear();
     mControllerBoneCache.resize(boneCount);
 
     for (size_t i = 0; i < boneCount; ++i)
     {
-        std::string boneName = mModelSkeleton->GetBoneName((int)i);
-        mCachedBoneToKey[i] = mModelAvatar->GetMappedKeyByBoneName(boneName);
-
         ControllerBoneCache& cache = mControllerBoneCache[i];
         const BoneInfo& boneInfo = bones[i];
 
 
-        cache.hasMapping = !mCachedBoneToKey[i].empty();
-        cache.isRootMotion = (boneInfo.parentIndex == -1) || (mCachedBoneToKey[i] == "Hips");
+        cache.hasMapping = !boneKeys[i].empty();
+        cache.isRootMotion = (boneInfo.parentIndex == -1) || (boneKeys[i] == "Hips");
 
         cache.bindScale = boneInfo.bindScale;
         cache.bindRotation = boneInfo.bindRotation;
@@ -210,7 +299,7 @@ void AnimationControllerComponent::UpdateBoneMappingCache()
             int curr = boneInfo.parentIndex;
             while (curr >= 0)
             {
-                if (!mCachedBoneToKey[curr].empty())
+                if (!boneKeys[curr].empty())
                 {
                     logicalParent = curr;
                     break;
@@ -223,16 +312,69 @@ void AnimationControllerComponent::UpdateBoneMappingCache()
             logicalParent = boneInfo.parentIndex;
         }
         cache.logicalParentIdx = logicalParent;
-        cache.globalTransform = XMMatrixIdentity();
     }
 
-    for (auto& layer : mLayers)
+    mBindPose.Resize(boneCount);
+    mTranslationMask.assign(mBindPose.GetPaddedCount(), 0.0f);
+    for (size_t i = 0; i < boneCount; ++i)
+    {
+        const ControllerBoneCache& cache = mControllerBoneCache[i];
+        mBindPose.SetBone(i, XMLoadFloat3(&cache.bindScale), XMLoadFloat4(&cache.bindRotation), XMLoadFloat3(&cache.bindTranslation));
+
+        // Only root motion bones take animated translation; the rest keep their bind offsets.
+        if (cache.isRootMotion) mTranslationMask[i] = 1.0f;
+    }
+
+    // Parents before children so model space is a single forward pass.
+    mEvalOrder.clear();
+    mEvalOrder.reserve(boneCount);
+    std::vector<std::vector<int>> children(boneCount);
+    for (size_t i = 0; i < boneCount; ++i)
     {
-        auto mask = layer.GetMask();
-        if (mask) mask->ExpandHierarchy(mModelSkeleton.get(), mCachedBoneToKey);
+        int parent = mControllerBoneCache[i].logicalParentIdx;
+        if (parent >= 0 && parent < (int)boneCount)
+            children[parent].push_back((int)i);
+        else
+            mEvalOrder.push_back((int)i);
+    }
+    for (size_t head = 0; head < mEvalOrder.size(); ++head)
+    {
+        for (int child : children[mEvalOrder[head]])
+            mEvalOrder.push_back(child);
+    }
+
+    // Root motion curves live in the Hips bone's parent space; walk the same logical parents the palette uses.
+    XMMATRIX rootSpace = XMMatrixIdentity();
+    auto hips = std::find(boneKeys.begin(), boneKeys.end(), "Hips");
+    if (hips != boneKeys.end())
+    {
+        for (int p = mControllerBoneCache[hips - boneKeys.begin()].logicalParentIdx; p >= 0; p = mControllerBoneCache[p].logicalParentIdx)
+        {
+            const ControllerBoneCache& parent = mControllerBoneCache[p];
+            XMMATRIX local = XMMatrixScalingFromVector(XMLoadFloat3(&parent.bindScale)) *
+                XMMatrixRotationQuaternion(XMLoadFloat4(&parent.bindRotation)) *
+                XMMatrixTranslationFromVector(XMLoadFloat3(&parent.bindTranslation));
+            rootSpace = rootSpace * local;
+        }
+    }
+    XMStoreFloat4x4(&mRootMotionSpace, rootSpace);
+
+    mHasEvaluated = false;
+    mPoseDirty = true;
+
+    mBoneHeights.assign(boneCount, 0);
+    for (auto it = mEvalOrder.rbegin(); it != mEvalOrder.rend(); ++it)
+    {
+        int parent = mControllerBoneCache[*it].logicalParentIdx;
+        if (parent >= 0)
+            mBoneHeights[parent] = std::max(mBoneHeights[parent], mBoneHeights[*it] + 1);
+    }
+    RebuildLeafMask();
 
-        layer.UpdateMaskCache(boneCount, mCachedBoneToKey);
-        layer.UpdateTrackCache(boneCount, mCachedBoneToKey);
+    for (auto& layer : mLayers)
+    {
+        layer.UpdateMaskCache(mModelSkeleton, mModelAvatar);
+        layer.UpdateTrackCache(mModelSkeleton, mModelAvatar);
     }
 }
 
@@ -240,6 +382,7 @@ void AnimationControllerComponent::SetLayerCount(int count)
 {
     if (count < 1) count = 1;
     mLayers.resize(count);
+    mPoseDirty = true;
 }
 
 void AnimationControllerComponent::SetLayerWeight(int layerIndex, float weight)
@@ -266,12 +409,7 @@ void AnimationControllerComponent::SetLayerMask(int layerIndex, std::shared_ptr<
         mLayers[layerIndex].SetMask(mask);
 
         if (mModelSkeleton)
-        {
-            if (mask)
-                mask->ExpandHierarchy(mModelSkeleton.get(), mCachedBoneToKey);
-
-            mLayers[layerIndex].UpdateMaskCache(mModelSkeleton->GetBoneCount(), mCachedBoneToKey);
-        }
+            mLayers[layerIndex].UpdateMaskCache(mModelSkeleton, mModelAvatar);
     }
 }
 
@@ -284,6 +422,26 @@ std::shared_ptr<AvatarMask> AnimationControllerComponent::GetLayerMask(int layer
     return nullptr;
 }
 
+void AnimationControllerComponent::SetLayerBlendMode(int layerIndex, LayerBlendMode mode)
+{
+    if (layerIndex >= 0 && layerIndex < mLayers.size())
+    {
+        mLayers[layerIndex].SetBlendMode(mode);
+
+        if (mModelSkeleton)
+            mLayers[layerIndex].UpdateTrackCache(mModelSkeleton, mModelAvatar);
+    }
+}
+
+LayerBlendMode AnimationControllerComponent::GetLayerBlendMode(int layerIndex) const
+{
+    if (layerIndex >= 0 && layerIndex < mLayers.size())
+    {
+        return mLayers[layerIndex].GetBlendMode();
+    }
+    return LayerBlendMode::Override;
+}
+
 void AnimationControllerComponent::SetPlaybackMode(PlaybackMode mode, int layerIndex)
 {
     if (layerIndex >= 0 && layerIndex < mLayers.size())
@@ -320,7 +478,7 @@ float AnimationControllerComponent::GetSpeed(int layerIndex) const
 
 void AnimationControllerComponent::Play(int layerIndex, std::shared_ptr<AnimationClip> clip, float blendTime, PlaybackMode mode, float speed)
 {
-    if (!IsReady()) return;
+    if (!CanEvaluate()) return;
 
     if (layerIndex < 0) return;
 
@@ -330,7 +488,7 @@ void AnimationControllerComponent::Play(int layerIndex, std::shared_ptr<Animatio
     mLayers[layerIndex].Play(clip, blendTime, mode, speed);
 
     if (mModelSkeleton)
-        mLayers[layerIndex].UpdateTrackCache(mModelSkeleton->GetBoneCount(), mCachedBoneToKey);
+        mLayers[layerIndex].UpdateTrackCache(mModelSkeleton, mModelAvatar);
 }
 
 bool AnimationControllerComponent::IsLayerTransitioning(int layerIndex) const
@@ -376,11 +534,181 @@ float AnimationControllerComponent::GetLayerDuration(int layerIndex) const
     return 0.0f;
 }
 
-void AnimationControllerComponent::Update(float deltaTime)
+bool AnimationControllerComponent::UpdateLOD(const AnimationLODView* view)
+{
+    auto transform = mTransform.lock();
+    if (!mLODSettings.enabled || !view || !view->frustum || !transform)
+    {
+        mCurrentLOD = 0;
+        mLODFrozen = false;
+        return true;
+    }
+
+    const XMFLOAT4X4& world = transform->GetWorldMatrix();
+    XMFLOAT3 center = { world._41, world._42, world._43 };
+
+    if (view->frustum->Intersects(BoundingSphere(center, mLODSettings.boundsRadius)))
+        mLastVisibleFrame = view->frameIndex;
+
+    float dist = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&center), XMLoadFloat3(&view->cameraPosition))));
+
+    int lod = 0;
+    while (lod < AnimationLODSettings::LevelCount - 1 && dist > mLODSettings.distances[lod])
+        ++lod;
+
+    float screenSize = mLODSettings.boundsRadius * view->projScale / std::max(dist, 1e-3f);
+    if (screenSize < mLODSettings.minScreenSize)
+        lod = AnimationLODSettings::LevelCount - 1;
+
+    mCurrentLOD = lod;
+
+    // Characters that have been off-screen for a while keep their last pose; time still accumulates.
+    mLODFrozen = mHasEvaluated && (view->frameIndex - mLastVisibleFrame > mLODSettings.cullFreezeFrames);
+    if (mLODFrozen) return false;
+
+    ++mFramesSinceEval;
+    if (mHasEvaluated && mFramesSinceEval < std::max(1u, mLODSettings.updateIntervals[lod]))
+        return false;
+
+    mFramesSinceEval = 0;
+    return true;
+}
+
+void AnimationControllerComponent::RebuildLeafMask()
+{
+    const size_t boneCount = mBoneHeights.size();
+    mLeafMask.assign(boneCount, 0);
+    mLeafCount = 0;
+
+    for (size_t i = 0; i < boneCount && i < mControllerBoneCache.size(); ++i)
+    {
+        if (mControllerBoneCache[i].isRootMotion) continue;
+        if (mBoneHeights[i] + 1 > mLODSettings.leafDepth) continue;
+
+        mLeafMask[i] = 1;
+        ++mLeafCount;
+    }
+}
+
+void AnimationControllerComponent::ApplyRootMotion(float deltaTime)
+{
+    XMFLOAT4 motion = mPendingRootMotion;
+    const bool hasMotion = mHasPendingRootMotion;
+    mPendingRootMotion = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+    mHasPendingRootMotion = false;
+
+    // Without root motion this frame the owner's velocity and position belong to physics and scripts.
+    if (!mRootMotionSettings.enabled || !hasMotion) return;
+
+    auto transform = mTransform.lock();
+    if (!transform) return;
+
+    // Root space -> model space -> the owner's parent space (its own rotation and scale).
+    const XMFLOAT3& scale = transform->GetScale();
+    const XMFLOAT4& rotation = transform->GetRotationQuaternion();
+    XMMATRIX toParent = XMLoadFloat4x4(&mRootMotionSpace) *
+        XMMatrixScaling(scale.x, scale.y, scale.z) * XMMatrixRotationQuaternion(XMLoadFloat4(&rotation));
+
+    XMFLOAT3 move;
+    XMStoreFloat3(&move, XMVector3TransformNormal(XMVectorSet(motion.x, motion.y, motion.z, 0.0f), toParent));
+    if (mRootMotionSettings.lockX) move.x = 0.0f;
+    if (mRootMotionSettings.lockY) move.y = 0.0f;
+    if (mRootMotionSettings.lockZ) move.z = 0.0f;
+
+    auto owner = GetOwner();
+    auto rigidbody = owner ? owner->GetComponent<RigidbodyComponent>() : nullptr;
+
+    if (rigidbody && !rigidbody->IsKinematic() && deltaTime > 0.0f)
+    {
+        // Locked axes keep whatever velocity physics gave them.
+        XMFLOAT3 velocity = rigidbody->GetVelocity();
+        if (!mRootMotionSettings.lockX) velocity.x = move.x / deltaTime;
+        if (!mRootMotionSettings.lockY) velocity.y = move.y / deltaTime;
+        if (!mRootMotionSettings.lockZ) velocity.z = move.z / deltaTime;
+        rigidbody->SetVelocity(velocity);
+    }
+    else if (move.x != 0.0f || move.y != 0.0f || move.z != 0.0f)
+    {
+        transform->AddPosition(move);
+    }
+
+    if (!mRootMotionSettings.lockYaw && motion.w != 0.0f)
+    {
+        XMFLOAT4 turn;
+        XMStoreFloat4(&turn, XMQuaternionRotationRollPitchYaw(0.0f, motion.w, 0.0f));
+        transform->AddRotate(turn);
+    }
+}
+
+void AnimationControllerComponent::SetLODSettings(const AnimationLODSettings& settings)
+{
+    mLODSettings = settings;
+    RebuildLeafMask();
+    mPoseDirty = true;
+}
+
+void AnimationControllerComponent::SetPoseSharing(bool enabled, float timeStep)
+{
+    mPoseSharing = enabled;
+    mPoseSharingTimeStep = std::max(0.0f, timeStep);
+    mPoseDirty = true;
+}
+
+bool AnimationControllerComponent::BuildPoseCacheKey(bool skipLeaves, AnimationPoseCache::Key& outKey) const
+{
+    // Crossfades and deep layer stacks are too individual to be worth sharing.
+    if (mLayers.size() > AnimationPoseCache::MaxLayers) return false;
+
+    outKey = AnimationPoseCache::Key();
+    outKey.skeleton = mModelSkeleton.get();
+    outKey.avatar = mModelAvatar.get();
+    outKey.leafDepth = skipLeaves ? mLODSettings.leafDepth + 1 : 0;
+    outKey.layerCount = static_cast<UINT>(mLayers.size());
+
+    for (size_t i = 0; i < mLayers.size(); ++i)
+    {
+        const AnimationLayer& layer = mLayers[i];
+        if (layer.IsTransitioning()) return false;
+
+        auto clip = layer.GetCurrentClip();
+        if (!clip || layer.GetWeight() <= 0.0f) continue;
+
+        AnimationPoseCache::LayerKey& lk = outKey.layers[i];
+        lk.clip = clip.get();
+        lk.mask = layer.GetMask().get();
+        lk.timeKey = AnimationPoseCache::MakeTimeKey(layer.GetCurrentTime(), mPoseSharingTimeStep);
+        lk.weight = layer.GetWeight();
+        lk.additive = (layer.GetBlendMode() == LayerBlendMode::Additive);
+    }
+    return true;
+}
+
+AnimationLODStats AnimationControllerComponent::GetLODStats()
 {
-    std::lock_guard<std::mutex> lock(componentMutex);
+    AnimationLODStats stats;
+    stats.controllers = sLODStats.controllers;
+    stats.evaluatedControllers = sLODStats.evaluatedControllers;
+    stats.frozenControllers = sLODStats.frozenControllers;
+    stats.unchangedControllers = sLODStats.unchangedControllers;
+    stats.evaluatedBones = sLODStats.evaluatedBones;
+    stats.savedBones = sLODStats.savedBones;
+    return stats;
+}
+
+void AnimationControllerComponent::ResetLODStats()
+{
+    sLODStats.controllers = 0;
+    sLODStats.evaluatedControllers = 0;
+    sLODStats.frozenControllers = 0;
+    sLODStats.unchangedControllers = 0;
+    sLODStats.evaluatedBones = 0;
+    sLODStats.savedBones = 0;
+}
 
-    if (!IsReady()) return;
+void AnimationControllerComponent::Update(float deltaTime, AnimationScratch& scratch, const AnimationLODView* lodView, AnimationPoseCache* poseCache)
+{
+    // No lock: controllers are updated in parallel and only touch their own state and palette.
+    if (!CanEvaluate()) return;
 
     std::shared_ptr<TransformComponent> transform = mTransform.lock();
     if (!transform)
@@ -392,16 +720,85 @@ void AnimationControllerComponent::Update(float deltaTime)
         }
     }
 
+    const UINT boneCount = static_cast<UINT>(mControllerBoneCache.size());
+
+    // Additive tracks rebuilt from the clip inspector replace the ones the layers cached.
+    for (auto& layer : mLayers)
+    {
+        if (layer.IsTrackCacheStale())
+            layer.UpdateTrackCache(mModelSkeleton, mModelAvatar);
+    }
+
+    // Time and root motion advance every frame; LOD only decides whether the pose is evaluated.
     if (!mIsPaused)
     {
+        XMVECTOR motion = XMVectorZero();
         for (auto& layer : mLayers)
         {
             layer.Update(deltaTime);
-            layer.GetRootMotionDelta(deltaTime);
+
+            XMFLOAT4 delta;
+            if (layer.ConsumeRootMotion(delta) && layer.GetBlendMode() == LayerBlendMode::Override)
+            {
+                motion = XMVectorLerp(motion, XMLoadFloat4(&delta), std::clamp(layer.GetWeight(), 0.0f, 1.0f));
+                mHasPendingRootMotion = true;
+            }
         }
+        XMStoreFloat4(&mPendingRootMotion, XMVectorAdd(XMLoadFloat4(&mPendingRootMotion), motion));
+    }
+
+    if (!UpdateLOD(lodView))
+    {
+        sLODStats.savedBones += boneCount;
+        if (mLODFrozen) ++sLODStats.frozenControllers;
+        ++sLODStats.controllers;
+        return;
+    }
+
+    const bool skipLeaves = mLODSettings.enabled && mCurrentLOD >= mLODSettings.leafSkipLOD && mLeafCount > 0;
+
+    // Paused, settled or single-frame poses: the GPU keeps the palette uploaded last time.
+    bool poseDirty = mPoseDirty || !mHasEvaluated || skipLeaves != mLastSkipLeaves;
+    for (const auto& layer : mLayers)
+        poseDirty = poseDirty || layer.IsPoseDirty();
+
+    if (!poseDirty)
+    {
+        sLODStats.savedBones += boneCount;
+        ++sLODStats.unchangedControllers;
+        ++sLODStats.controllers;
+        return;
+    }
+
+    AnimationPoseCache::Entry* cacheEntry = nullptr;
+    AnimationPoseCache::Lookup lookup = AnimationPoseCache::Lookup::Busy;
+    AnimationPoseCache::Key cacheKey;
+    if (mPoseSharing && poseCache && BuildPoseCacheKey(skipLeaves, cacheKey))
+        lookup = poseCache->Find(cacheKey, cacheEntry);
+
+    if (lookup == AnimationPoseCache::Lookup::Hit && cacheEntry->palette.size() == mCpuBoneMatrices.size())
+    {
+        memcpy(mCpuBoneMatrices.data(), cacheEntry->palette.data(), sizeof(BoneMatrixData) * mCpuBoneMatrices.size());
+    }
+    else
+    {
+        const float timeStep = mPoseSharing ? mPoseSharingTimeStep : 0.0f;
+        EvaluateLayers(scratch, skipLeaves ? mLeafMask.data() : nullptr, timeStep);
+
+        if (lookup == AnimationPoseCache::Lookup::Claimed)
+            poseCache->Publish(cacheEntry, &mCpuBoneMatrices.data()->transform, mCpuBoneMatrices.size());
     }
+    mHasEvaluated = true;
+    mPoseDirty = false;
+    mLastSkipLeaves = skipLeaves;
+    for (auto& layer : mLayers)
+        layer.ClearPoseDirty();
 
-    EvaluateLayers();
+    const UINT skipped = skipLeaves ? mLeafCount : 0;
+    sLODStats.evaluatedBones += boneCount - skipped;
+    sLODStats.savedBones += skipped;
+    ++sLODStats.evaluatedControllers;
+    ++sLODStats.controllers;
 
     if (mMappedBoneBuffer)
     {
@@ -409,92 +806,56 @@ void AnimationControllerComponent::Update(float deltaTime)
     }
 }
 
-void AnimationControllerComponent::EvaluateLayers()
+void AnimationControllerComponent::EvaluateLayers(AnimationScratch& scratch, const uint8_t* skipBones, float timeStep)
 {
     if (!mModelSkeleton || !mModelAvatar) return;
 
     const size_t boneCount = mControllerBoneCache.size();
+    if (mBindPose.GetBoneCount() != boneCount) return;
 
     if (mCpuBoneMatrices.size() != boneCount)
         mCpuBoneMatrices.resize(boneCount);
 
-    for (size_t i = 0; i < boneCount; ++i)
-    {
-        ControllerBoneCache& cache = mControllerBoneCache[i];
-
-        XMVECTOR S_bind = XMLoadFloat3(&cache.bindScale);
-        XMVECTOR R_bind = XMLoadFloat4(&cache.bindRotation);
-        XMVECTOR T_bind = XMLoadFloat3(&cache.bindTranslation);
-
-        XMVECTOR S_anim = S_bind;
-        XMVECTOR R_anim = R_bind;
-        XMVECTOR T_anim = T_bind;
-
-        bool isRootMotionBone = cache.isRootMotion;
-
-        for (auto& layer : mLayers)
-        {
-            if (isRootMotionBone)
-            {
-                layer.EvaluateAndBlend((int)i, S_anim, R_anim, T_anim);
-            }
-            else
-            {
-                XMVECTOR tempS = S_anim;
-                XMVECTOR tempR = R_anim;
-                XMVECTOR tempT = T_anim;
-
-                if (layer.EvaluateAndBlend((int)i, tempS, tempR, tempT))
-                {
-                    S_anim = tempS;
-                    R_anim = tempR;
-                    // T_anim = tempT;
-                }
-            }
-        }
-
-        R_anim = XMQuaternionNormalize(R_anim);
-
-        XMMATRIX finalGlobalTransform;
+    AnimationPose& pose = scratch.pose;
+    pose.CopyFrom(mBindPose);
 
-        if (cache.hasMapping)
-        {
-            XMMATRIX matAnimLocal = XMMatrixScalingFromVector(S_anim) * XMMatrixRotationQuaternion(R_anim) * XMMatrixTranslationFromVector(T_anim);
+    for (auto& layer : mLayers)
+    {
+        if (!layer.EvaluatePose(scratch.layerPose, scratch.crossFadePose, scratch.layerWeights, skipBones, timeStep)) continue;
 
-            XMMATRIX matLogicalParentGlobal = XMMatrixIdentity();
+        const size_t padded = scratch.layerWeights.size();
+        scratch.translationWeights.resize(padded);
+        for (size_t i = 0; i < padded; ++i)
+            scratch.translationWeights[i] = scratch.layerWeights[i] * mTranslationMask[i];
 
-            int logicalParentIdx = cache.logicalParentIdx;
-            if (logicalParentIdx >= 0)
-            {
-                matLogicalParentGlobal = mControllerBoneCache[logicalParentIdx].globalTransform;
-            }
-
-            finalGlobalTransform = matAnimLocal * matLogicalParentGlobal;
-        }
+        if (layer.GetBlendMode() == LayerBlendMode::Additive)
+            pose.ApplyAdditive(scratch.layerPose, scratch.layerWeights.data(), scratch.translationWeights.data());
         else
-        {
-            int parentIdx = cache.logicalParentIdx;
+            pose.Blend(scratch.layerPose, scratch.layerWeights.data(), scratch.translationWeights.data());
+    }
 
-            XMMATRIX matParentGlobal = XMMatrixIdentity();
-            if (parentIdx >= 0)
-            {
-                matParentGlobal = mControllerBoneCache[parentIdx].globalTransform;
-            }
+    if (scratch.localTransforms.size() < boneCount)
+    {
+        scratch.localTransforms.resize(boneCount);
+        scratch.modelTransforms.resize(boneCount);
+    }
 
-            XMMATRIX matLocal = XMMatrixScalingFromVector(S_bind) * XMMatrixRotationQuaternion(R_bind) * XMMatrixTranslationFromVector(T_bind);
+    XMMATRIX* local = scratch.localTransforms.data();
+    XMMATRIX* model = scratch.modelTransforms.data();
 
-            finalGlobalTransform = matLocal * matParentGlobal;
-        }
+    pose.ToLocalMatrices(local);
 
-        cache.globalTransform = finalGlobalTransform;
+    for (int i : mEvalOrder)
+    {
+        int parentIdx = mControllerBoneCache[i].logicalParentIdx;
+        model[i] = (parentIdx >= 0) ? XMMatrixMultiply(local[i], model[parentIdx]) : local[i];
     }
 
-
     const auto& bones = mModelSkeleton->GetBones(); 
     for (size_t i = 0; i < boneCount; ++i)
     {
         XMMATRIX invBind = XMLoadFloat4x4(&bones[i].inverseBind);
-        XMMATRIX finalMat = XMMatrixTranspose(invBind * mControllerBoneCache[i].globalTransform);
+        XMMATRIX finalMat = XMMatrixTranspose(invBind * model[i]);
 
         XMStoreFloat4x4(&mCpuBoneMatrices[i].transform, finalMat);
     }
@@ -3,6 +3,7 @@
 #include "Resource/Skeleton.h"
 #include "Resource/Model_Avatar.h"
 #include "Resource/AnimationLayer.h"
+#include "Resource/AnimationPoseCache.h"
 
 class TransformComponent;
 
@@ -15,15 +16,67 @@ struct ControllerBoneCache
     XMFLOAT3 bindScale;
     XMFLOAT4 bindRotation;
     XMFLOAT3 bindTranslation;
+};
+// Per-worker buffers for pose evaluation, reused by every controller that worker updates.
+struct AnimationScratch
+{
+    AnimationPose pose;
+    AnimationPose layerPose;
+    AnimationPose crossFadePose;
+    std::vector<float> layerWeights;
+    std::vector<float> translationWeights;
+    std::vector<XMMATRIX> localTransforms;
+    std::vector<XMMATRIX> modelTransforms;
+};
+
+struct AnimationLODSettings
+{
+    static constexpr int LevelCount = 4;
+
+    bool enabled = true;
+    float distances[LevelCount - 1] = { 15.0f, 40.0f, 100.0f }; // camera distance where LOD 1, 2 and 3 begin
+    UINT updateIntervals[LevelCount] = { 1, 2, 4, 8 };          // frames between evaluations per LOD
+    int leafSkipLOD = 2;          // from this LOD on, leaf bones stay at bind pose
+    UINT leafDepth = 2;           // bones this many links or fewer from a chain end count as leaves
+    float minScreenSize = 0.05f;  // projected radius / half screen height; smaller forces the last LOD
+    UINT cullFreezeFrames = 10;   // frames off-screen before the pose stops updating
+    float boundsRadius = 1.0f;
+};
+
+// Camera data shared by every controller in a frame.
+struct AnimationLODView
+{
+    XMFLOAT3 cameraPosition = { 0.0f, 0.0f, 0.0f };
+    float projScale = 1.0f; // 1 / tan(fovY / 2)
+    const BoundingFrustum* frustum = nullptr;
+    UINT64 frameIndex = 0;
+};
+
+struct AnimationLODStats
+{
+    UINT controllers = 0;
+    UINT evaluatedControllers = 0;
+    UINT frozenControllers = 0;
+    UINT unchangedControllers = 0; // skipped because no pose input changed
+    UINT evaluatedBones = 0;
+    UINT savedBones = 0;
+};
 
-    XMMATRIX globalTransform;
+struct RootMotionSettings
+{
+    bool enabled = true;
+    bool lockX = false;   // per-axis locks in the owner's parent space
+    bool lockY = true;    // vertical movement is left to physics and gravity by default
+    bool lockZ = false;
+    bool lockYaw = false;
 };
+
 struct BoneMatrixData
 {
     XMFLOAT4X4 transform;
 };
 
-class AnimationControllerComponent : public SynchronizedComponent
+class AnimationControllerComponent : public Component
 {
 public:
     virtual rapidjson::Value ToJSON(rapidjson::Document::AllocatorType& alloc) const;
@@ -42,6 +95,7 @@ public:
     void SetTransform(std::weak_ptr<TransformComponent> tf) { mTransform = tf; }
     std::shared_ptr<TransformComponent> GetTransform() { return mTransform.lock(); }
 
+    // Not locked: like every other setter, main thread only and never while the scene's animation jobs run.
     void SetSkeleton(std::shared_ptr<Skeleton> skeleton);
     void SetModelAvatar(std::shared_ptr<Model_Avatar> model_avatar);
 
@@ -59,6 +113,9 @@ public:
     void SetLayerMask(int layerIndex, std::shared_ptr<AvatarMask> mask);
     std::shared_ptr<AvatarMask> GetLayerMask(int layerIndex) const;
 
+    void SetLayerBlendMode(int layerIndex, LayerBlendMode mode);
+    LayerBlendMode GetLayerBlendMode(int layerIndex) const;
+
     void SetLayerNormalizedTime(int layerIndex, float ratio);
     float GetLayerNormalizedTime(int layerIndex) const;
     float GetLayerDuration(int layerIndex) const;
@@ -79,13 +136,43 @@ public:
 
     void Play(int layerIndex, std::shared_ptr<AnimationClip> clip, float blendTime = 0.2f, PlaybackMode mode = PlaybackMode::Loop, float speed = 1.0f);
 
+    // Ready to be drawn: the palette can be evaluated and has a GPU buffer for the skinning pass.
     bool IsReady() const;
-    void Update(float deltaTime);
+    // The skeleton, avatar and CPU palette are in place; enough for Update without a renderer.
+    bool CanEvaluate() const;
+    // Safe to call for different controllers from different threads; each call only writes its own palette.
+    // lodView may be null, which evaluates at full rate. poseCache is used only when pose sharing is enabled.
+    void Update(float deltaTime, AnimationScratch& scratch, const AnimationLODView* lodView = nullptr, AnimationPoseCache* poseCache = nullptr);
+
+    // Moves the owner by the root motion gathered in Update: through the Rigidbody's velocity when it has a
+    // dynamic one, otherwise through the Transform. Call on the main thread after the parallel update.
+    void ApplyRootMotion(float deltaTime);
+
+    void SetRootMotionSettings(const RootMotionSettings& settings) { mRootMotionSettings = settings; }
+    const RootMotionSettings& GetRootMotionSettings() const { return mRootMotionSettings; }
+
+    void SetLODSettings(const AnimationLODSettings& settings);
+    const AnimationLODSettings& GetLODSettings() const { return mLODSettings; }
+    int GetCurrentLOD() const { return mCurrentLOD; }
+    bool IsLODFrozen() const { return mLODFrozen; }
+
+    // Controllers with matching skeleton, avatar, clips, masks and (quantized) times share one evaluation.
+    // timeStep > 0 snaps sampling to multiples of it, trading accuracy for more shared poses.
+    void SetPoseSharing(bool enabled, float timeStep = 0.0f);
+    bool IsPoseSharingEnabled() const { return mPoseSharing; }
+    float GetPoseSharingTimeStep() const { return mPoseSharingTimeStep; }
+
+    // Totals over all controllers since the last ResetLODStats, which the scene calls every frame.
+    static AnimationLODStats GetLODStats();
+    static void ResetLODStats();
 
 private:
     void CreateBoneMatrixBuffer();
     void UpdateBoneMappingCache();
-    void EvaluateLayers();
+    bool UpdateLOD(const AnimationLODView* view);
+    void RebuildLeafMask();
+    void EvaluateLayers(AnimationScratch& scratch, const uint8_t* skipBones, float timeStep);
+    bool BuildPoseCacheKey(bool skipLeaves, AnimationPoseCache::Key& outKey) const;
 
 
 private:
@@ -96,9 +183,34 @@ private:
     std::vector<AnimationLayer> mLayers;
     bool mIsPaused = false;
 
-    std::vector<std::string> mCachedBoneToKey;
+    std::shared_ptr<const AvatarBinding> mAvatarBinding;
     std::vector<ControllerBoneCache> mControllerBoneCache;
 
+    // Pose pipeline: bind pose -> per-layer blend -> local matrices -> model space in mEvalOrder.
+    AnimationPose mBindPose;
+    std::vector<float> mTranslationMask;
+    std::vector<int> mEvalOrder;
+
+    AnimationLODSettings mLODSettings;
+    std::vector<UINT> mBoneHeights; // links to the deepest descendant, 0 for chain ends
+    std::vector<uint8_t> mLeafMask;
+    UINT mLeafCount = 0;
+    int mCurrentLOD = 0;
+    bool mLODFrozen = false;
+    bool mHasEvaluated = false;
+    bool mPoseDirty = true;
+    bool mLastSkipLeaves = false;
+    UINT mFramesSinceEval = 0;
+    UINT64 mLastVisibleFrame = 0;
+
+    RootMotionSettings mRootMotionSettings;
+    XMFLOAT4X4 mRootMotionSpace;  // model-space bind transform of the root motion bone's parent
+    XMFLOAT4 mPendingRootMotion = { 0.0f, 0.0f, 0.0f, 0.0f }; // xyz in root motion space, w = yaw
+    bool mHasPendingRootMotion = false; // an override layer produced root motion since the last ApplyRootMotion
+
+    bool mPoseSharing = false;
+    float mPoseSharingTimeStep = 0.0f;
+
 
     //-------------------------------------------------------
     std::vector<BoneMatrixData> mCpuBoneMatrices;
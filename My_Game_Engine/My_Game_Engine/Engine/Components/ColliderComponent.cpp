@@ -1,4 +1,6 @@
 #include "ColliderComponent.h"
+#include "GameEngine.h"
+#include "Physics/MeshBVH.h"
 
 ColliderComponent::ColliderComponent()
 {
@@ -8,15 +10,80 @@ rapidjson::Value ColliderComponent::ToJSON(rapidjson::Document::AllocatorType& a
 {
     Value v(kObjectType);
     v.AddMember("type", "ColliderComponent", alloc);
+    v.AddMember("ColliderType", static_cast<int>(mColliderType), alloc);
     v.AddMember("Radius", mRadius, alloc);
+    v.AddMember("Layer", mLayer, alloc);
+
+    if (mColliderType == Collider_Type::Mesh)
+    {
+        if (auto mesh = mMesh.lock())
+        {
+            std::string mesh_guid = mesh->GetGUID().ToString();
+            std::string mesh_path = mesh->GetPathCopy();
+            v.AddMember("mesh_guid", Value(mesh_guid.c_str(), alloc), alloc);
+            v.AddMember("mesh_path", Value(mesh_path.c_str(), alloc), alloc);
+        }
+    }
 
     return v;
 }
 void ColliderComponent::FromJSON(const rapidjson::Value& val)
 {
+	if (val.HasMember("ColliderType") && val["ColliderType"].IsInt())
+	{
+		mColliderType = static_cast<Collider_Type>(val["ColliderType"].GetInt());
+	}
+
 	if (val.HasMember("Radius"))
 	{
 		mRadius = val["Radius"].GetFloat();
 	}
 
-}
\ No newline at end of file
+	if (val.HasMember("Layer") && val["Layer"].IsUint())
+	{
+		SetLayer(val["Layer"].GetUint());
+	}
+
+	if (val.HasMember("mesh_guid") && val["mesh_guid"].IsString())
+	{
+		ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
+
+		std::string meshGuid = val["mesh_guid"].GetString();
+		Guid guid = Guid::FromString(meshGuid);
+		auto mesh = rs->GetByGUID<Mesh>(guid);
+
+		if (!mesh && val.HasMember("mesh_path") && val["mesh_path"].IsString())
+		{
+			std::string meshPath = val["mesh_path"].GetString();
+			LoadResult temp;
+			rs->Load(meshPath, "LoadedMesh", temp);
+			mesh = rs->GetByGUID<Mesh>(guid);
+			if (!mesh)
+				mesh = rs->GetByPath<Mesh>(meshPath); // scenes saved with ids of an older scheme
+		}
+
+		if (mesh)
+			SetMesh(mesh->GetId());
+		else
+			OutputDebugStringA(("[Collider] Missing mesh GUID: " + meshGuid + "\n").c_str());
+	}
+}
+
+void ColliderComponent::SetMesh(UINT id)
+{
+    auto rsm = GameEngine::Get().GetResourceSystem();
+
+    mMeshId = id;
+    mMesh.reset();
+    mMeshHandle = rsm->Acquire(id);
+    mMeshBVH.reset();
+
+    auto mesh = rsm->GetById<Mesh>(id);
+    if (!mesh)
+        return;
+
+    mMesh = mesh;
+    mMeshBVH = mesh->GetCollisionBVH();
+    if (!mMeshBVH)
+        OutputDebugStringA(("[Collider] Mesh has no collision BVH and will not collide: " + mesh->GetAlias() + "\n").c_str());
+}
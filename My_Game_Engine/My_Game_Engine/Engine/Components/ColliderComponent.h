@@ -1,5 +1,9 @@
 #pragma once
 #include "Core/Component.h"
+#include "Resource/ResourceHandle.h"
+
+class Mesh;
+class MeshBVH;
 
 enum class Collider_Type
 {
@@ -42,6 +46,17 @@ public:
     float GetHeight() const { return mHeight; }
     void SetHeight(float height) { mHeight = height; }
 
+    // Layer index 0..31. Scene queries filter with a bit mask of layers.
+    UINT GetLayer() const { return mLayer; }
+    void SetLayer(UINT layer) { mLayer = std::min(layer, 31u); }
+    UINT GetLayerMask() const { return 1u << mLayer; }
+
+    // Mesh colliders are static only; the BVH is shared with every collider using the same mesh.
+    void SetMesh(UINT id);
+    UINT GetMeshId() const { return mMeshId; }
+    std::shared_ptr<Mesh> GetMesh() const { return mMesh.lock(); }
+    std::shared_ptr<const MeshBVH> GetMeshBVH() const { return mMeshBVH; }
+
 private:
     Collider_Type mColliderType = Collider_Type::Sphere;
 
@@ -49,4 +64,10 @@ private:
     XMFLOAT3 mSize = { 1.0f, 1.0f, 1.0f };
     float mRadius = 0.5f;
     float mHeight = 1.0f;
+    UINT mLayer = 0;
+
+    UINT mMeshId = Engine::INVALID_ID;
+    std::weak_ptr<Mesh> mMesh;
+    ResourceHandle mMeshHandle;
+    std::shared_ptr<const MeshBVH> mMeshBVH;
 };
\ No newline at end of file
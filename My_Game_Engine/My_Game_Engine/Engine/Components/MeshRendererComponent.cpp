@@ -12,7 +12,7 @@ rapidjson::Value MeshRendererComponent::ToJSON(rapidjson::Document::AllocatorTyp
     if (!mesh)
         return v;
 
-    std::string mesh_guid = mesh->GetGUID();
+    std::string mesh_guid = mesh->GetGUID().ToString();
     std::string mesh_path = mesh->GetPathCopy();
     v.AddMember("mesh_guid", Value(mesh_guid.c_str(), alloc), alloc);
     v.AddMember("mesh_path", Value(mesh_path.c_str(), alloc), alloc);
@@ -28,7 +28,7 @@ rapidjson::Value MeshRendererComponent::ToJSON(rapidjson::Document::AllocatorTyp
 
         if (auto mat = rsm->GetById<Material>(matId))
         {
-            std::string mat_guid = mat->GetGUID();
+            std::string mat_guid = mat->GetGUID().ToString();
             std::string mat_path = mat->GetPathCopy();
             entry.AddMember("material_guid", Value(mat_guid.c_str(), alloc), alloc);
             entry.AddMember("material_path", Value(mat_path.c_str(), alloc), alloc);
@@ -54,14 +54,17 @@ void MeshRendererComponent::FromJSON(const rapidjson::Value& val)
     if (val.HasMember("mesh_guid") && val["mesh_guid"].IsString())
     {
         std::string meshGuid = val["mesh_guid"].GetString();
-        auto mesh = rs->GetByGUID<Mesh>(meshGuid);
+        Guid guid = Guid::FromString(meshGuid);
+        auto mesh = rs->GetByGUID<Mesh>(guid);
 
         if (!mesh && val.HasMember("mesh_path") && val["mesh_path"].IsString())
         {
             std::string meshPath = val["mesh_path"].GetString();
             LoadResult temp;
             rs->Load(meshPath, "LoadedMesh", temp);
-            mesh = rs->GetByGUID<Mesh>(meshGuid);
+            mesh = rs->GetByGUID<Mesh>(guid);
+            if (!mesh)
+                mesh = rs->GetByPath<Mesh>(meshPath); // scenes saved with ids of an older scheme
         }
 
         if (mesh)
@@ -91,22 +94,25 @@ void MeshRendererComponent::FromJSON(const rapidjson::Value& val)
                 continue;
 
             std::string matGuid = s["material_guid"].GetString();
-            auto mat = rs->GetByGUID<Material>(matGuid);
+            Guid guid = Guid::FromString(matGuid);
+            auto mat = rs->GetByGUID<Material>(guid);
 
             if (!mat && s.HasMember("material_path") && s["material_path"].IsString())
             {
                 std::string matPath = s["material_path"].GetString();
                 LoadResult temp;
                 rs->Load(matPath, "LoadedMat", temp);
-                mat = rs->GetByGUID<Material>(matGuid);
+                mat = rs->GetByGUID<Material>(guid);
+                if (!mat)
+                    mat = rs->GetByPath<Material>(matPath);
             }
 
             if (mat)
-                materialOverrides[idx] = mat->GetId();
+                SetMaterial(idx, mat->GetId());
             else
             {
                 OutputDebugStringA(("[MeshRenderer] Missing material GUID: " + matGuid + "\n").c_str());
-                materialOverrides[idx] = Engine::INVALID_ID;
+                SetMaterial(idx, Engine::INVALID_ID);
             }
         }
     }
@@ -119,6 +125,7 @@ void MeshRendererComponent::SetMesh(UINT id)
     meshId = id;
 
     mMesh = rsm->GetById<Mesh>(id);
+    mMeshHandle = rsm->Acquire(id);
 
     if (auto mesh = mMesh.lock())
     {
@@ -126,6 +133,7 @@ void MeshRendererComponent::SetMesh(UINT id)
     }
     else
         materialOverrides.clear();
+    mMaterialHandles.resize(materialOverrides.size());
 
 }
 
@@ -133,6 +141,7 @@ void MeshRendererComponent::SetMaterial(size_t submeshIndex, UINT matId)
 {
     if (submeshIndex >= materialOverrides.size()) return;
     materialOverrides[submeshIndex] = matId;
+    mMaterialHandles[submeshIndex] = GameEngine::Get().GetResourceSystem()->Acquire(matId);
 }
 
 UINT MeshRendererComponent::GetMaterial(size_t submeshIndex) const
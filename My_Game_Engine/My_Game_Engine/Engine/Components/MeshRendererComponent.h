@@ -1,5 +1,6 @@
 #pragma once
 #include "Core/Component.h"
+#include "Resource/ResourceHandle.h"
 
 class Mesh;
 
@@ -28,6 +29,8 @@ private:
     UINT meshId = Engine::INVALID_ID;
 
     std::weak_ptr<Mesh> mMesh;
+    ResourceHandle mMeshHandle;
 
     std::vector<UINT> materialOverrides;
+    std::vector<ResourceHandle> mMaterialHandles;
 };
\ No newline at end of file
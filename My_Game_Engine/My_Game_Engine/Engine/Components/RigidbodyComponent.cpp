@@ -10,6 +10,8 @@ rapidjson::Value RigidbodyComponent::ToJSON(rapidjson::Document::AllocatorType&
     v.AddMember("mass", mMass, alloc);
     v.AddMember("linearDamping", mLinearDamping, alloc);
     v.AddMember("angularDamping", mAngularDamping, alloc);
+    v.AddMember("useCCD", mUseCCD, alloc);
+    v.AddMember("ccdVelocityThreshold", mCCDVelocityThreshold, alloc);
 
     Value grav(kArrayType);
     grav.PushBack(mGravity.x, alloc).PushBack(mGravity.y, alloc).PushBack(mGravity.z, alloc);
@@ -25,6 +27,11 @@ void RigidbodyComponent::FromJSON(const rapidjson::Value& val)
     mLinearDamping = val["linearDamping"].GetFloat();
     mAngularDamping = val["angularDamping"].GetFloat();
 
+    if (val.HasMember("useCCD") && val["useCCD"].IsBool())
+        mUseCCD = val["useCCD"].GetBool();
+    if (val.HasMember("ccdVelocityThreshold") && val["ccdVelocityThreshold"].IsNumber())
+        mCCDVelocityThreshold = val["ccdVelocityThreshold"].GetFloat();
+
     const auto& g = val["gravity"].GetArray();
     mGravity = { (float)g[0].GetDouble(), (float)g[1].GetDouble(), (float)g[2].GetDouble() };
 }
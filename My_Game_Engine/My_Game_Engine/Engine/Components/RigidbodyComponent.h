@@ -48,6 +48,13 @@ public:
     float GetLinearDamping() const { return mLinearDamping; }
     float GetAngularDamping() const { return mAngularDamping; }
 
+    // Continuous collision: bodies faster than the threshold are swept instead of teleported each step.
+    void SetUseCCD(bool v) { mUseCCD = v; }
+    bool GetUseCCD() const { return mUseCCD; }
+
+    void SetCCDVelocityThreshold(float v) { mCCDVelocityThreshold = v; }
+    float GetCCDVelocityThreshold() const { return mCCDVelocityThreshold; }
+
 private:
     XMFLOAT3 mVelocity { 0,0,0 };
     XMFLOAT3 mAcceleration { 0,0,0 };
@@ -64,4 +71,7 @@ private:
 
     bool mIsKinematic = false;
     bool mUseGravity = true;
+
+    bool mUseCCD = false;
+    float mCCDVelocityThreshold = 10.0f;
 }; 
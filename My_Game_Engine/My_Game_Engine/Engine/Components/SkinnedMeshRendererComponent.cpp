@@ -17,7 +17,7 @@ rapidjson::Value SkinnedMeshRendererComponent::ToJSON(rapidjson::Document::Alloc
 
     auto mesh = GetMesh();
 
-    std::string meshGUID = mesh ? mesh->GetGUID() : "";
+    std::string meshGUID = mesh ? mesh->GetGUID().ToString() : "";
     std::string meshPath = mesh ? mesh->GetPathCopy() : "";
 
     v.AddMember("MeshGUID", rapidjson::Value(meshGUID.c_str(), alloc), alloc);
@@ -35,7 +35,7 @@ rapidjson::Value SkinnedMeshRendererComponent::ToJSON(rapidjson::Document::Alloc
             UINT matId = GetMaterial(i);
             auto mat = GameEngine::Get().GetResourceSystem()->GetById<Material>(matId);
 
-            std::string matGUID = mat ? mat->GetGUID() : "";
+            std::string matGUID = mat ? mat->GetGUID().ToString() : "";
             std::string matPath = mat ? mat->GetPathCopy() : "";
 
             entry.AddMember("MaterialGUID", rapidjson::Value(matGUID.c_str(), alloc), alloc);
@@ -57,7 +57,8 @@ void SkinnedMeshRendererComponent::FromJSON(const rapidjson::Value& val)
     if (val.HasMember("MeshGUID") && val["MeshGUID"].IsString())
     {
         std::string meshGuid = val["MeshGUID"].GetString();
-        auto mesh = resSystem->GetByGUID<SkinnedMesh>(meshGuid);
+        Guid guid = Guid::FromString(meshGuid);
+        auto mesh = resSystem->GetByGUID<SkinnedMesh>(guid);
 
         if (!mesh && val.HasMember("MeshPath") && val["MeshPath"].IsString())
         {
@@ -65,7 +66,9 @@ void SkinnedMeshRendererComponent::FromJSON(const rapidjson::Value& val)
             LoadResult temp;
             resSystem->Load(meshPath, "LoadedSkinnedMesh", temp);
 
-            mesh = resSystem->GetByGUID<SkinnedMesh>(meshGuid);
+            mesh = resSystem->GetByGUID<SkinnedMesh>(guid);
+            if (!mesh)
+                mesh = resSystem->GetByPath<SkinnedMesh>(meshPath); // scenes saved with ids of an older scheme
         }
 
         if (mesh)
@@ -92,14 +95,17 @@ void SkinnedMeshRendererComponent::FromJSON(const rapidjson::Value& val)
             if (matGuid.empty())
                 continue;
 
-            auto mat = resSystem->GetByGUID<Material>(matGuid);
+            Guid guid = Guid::FromString(matGuid);
+            auto mat = resSystem->GetByGUID<Material>(guid);
 
             if (!mat && s.HasMember("MaterialPath") && s["MaterialPath"].IsString())
             {
                 std::string matPath = s["MaterialPath"].GetString();
                 LoadResult temp;
                 resSystem->Load(matPath, "LoadedMat", temp);
-                mat = resSystem->GetByGUID<Material>(matGuid);
+                mat = resSystem->GetByGUID<Material>(guid);
+                if (!mat)
+                    mat = resSystem->GetByPath<Material>(matPath);
             }
 
             if (mat)
@@ -144,6 +150,7 @@ void SkinnedMeshRendererComponent::CacheAnimController()
 void SkinnedMeshRendererComponent::SetMesh(UINT id)
 {
     mDeferredMeshId = id;
+    mDeferredMeshHandle = GameEngine::Get().GetResourceSystem()->Acquire(id);
     mDeferredMeshUpdate = true;
 }
 
@@ -160,6 +167,7 @@ void SkinnedMeshRendererComponent::ApplyDeferredMeshChange()
     GameEngine::Get().GetRenderer()->FlushCommandQueue();
 
     MeshRendererComponent::SetMesh(mDeferredMeshId);
+    mDeferredMeshHandle.Reset();
 
     if (auto mesh = GetMesh())
     {
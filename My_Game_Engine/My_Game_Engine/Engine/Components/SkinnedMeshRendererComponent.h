@@ -54,4 +54,5 @@ private:
 
     bool mDeferredMeshUpdate = false;
     UINT mDeferredMeshId = Engine::INVALID_ID;
+    ResourceHandle mDeferredMeshHandle; // keeps the pending mesh loaded until it is applied
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Components/CameraComponent.h"
 #include "GameEngine.h"
 #include "Resource/ResourceSystem.h"
+#include "Physics/PhysicsUtils.h"
 
 TerrainComponent::TerrainComponent()
 {
@@ -39,6 +40,12 @@ void TerrainComponent::SetTerrain(UINT TerrainResourceID)
         mQuadTree->Initialize(mWidth, mDepth, mMaxHeight, mTreeDepth);
 }
 
+void TerrainComponent::SetMaterialID(UINT id)
+{
+    mMaterialID = id;
+    mMaterialHandle = GameEngine::Get().GetResourceSystem()->Acquire(id);
+}
+
 void TerrainComponent::SetTerrain_Width(float width)
 {
     mWidth = width;
@@ -112,16 +119,41 @@ const std::vector<TerrainInstanceData>& TerrainComponent::GetDrawList() const
     return empty;
 }
 
-float TerrainComponent::GetHeight(XMFLOAT3 worldPos)
+bool TerrainComponent::RefreshCollisionCache()
 {
-    if (!mTerrainRes || !mTerrainRes->GetHeightField()) return -FLT_MAX;
+    if (!mTerrainRes || !mTerrainRes->GetHeightField()) return false;
     std::shared_ptr<TransformComponent> tr = mTransform.lock();
-    if (!tr) return -FLT_MAX;
+    if (!tr) return false;
+
+    const XMFLOAT4X4& worldMat = tr->GetWorldMatrix();
+    CollisionCache& cache = mCollisionCache;
+
+    if (cache.valid &&
+        memcmp(&cache.world, &worldMat, sizeof(XMFLOAT4X4)) == 0 &&
+        cache.size.x == mWidth && cache.size.y == mMaxHeight && cache.size.z == mDepth)
+        return true;
+
+    XMMATRIX world = XMLoadFloat4x4(&worldMat);
+    XMMATRIX worldInv = XMMatrixInverse(nullptr, world);
+
+    cache.world = worldMat;
+    XMStoreFloat4x4(&cache.worldInv, worldInv);
+    XMStoreFloat4x4(&cache.normalMatrix, XMMatrixTranspose(worldInv));
+    cache.size = { mWidth, mMaxHeight, mDepth };
+
+    PhysicsUtils::AABB bounds = PhysicsUtils::TransformAABB({ { 0.0f, 0.0f, 0.0f }, cache.size }, worldMat);
+    cache.boundsMin = bounds.min;
+    cache.boundsMax = bounds.max;
+    cache.valid = true;
+
+    return true;
+}
 
-    const auto& worldMat = tr->GetWorldMatrix();
+float TerrainComponent::GetHeight(XMFLOAT3 worldPos)
+{
+    if (!RefreshCollisionCache()) return -FLT_MAX;
 
-    XMMATRIX worldInv = XMMatrixInverse(nullptr, XMLoadFloat4x4(&worldMat));
-    XMVECTOR localPosVec = XMVector3TransformCoord(XMLoadFloat3(&worldPos), worldInv);
+    XMVECTOR localPosVec = XMVector3TransformCoord(XMLoadFloat3(&worldPos), XMLoadFloat4x4(&mCollisionCache.worldInv));
     XMFLOAT3 localPos;
     XMStoreFloat3(&localPos, localPosVec);
 
@@ -134,7 +166,222 @@ float TerrainComponent::GetHeight(XMFLOAT3 worldPos)
     float localHeight = normalizedHeight * mMaxHeight;
 
     XMFLOAT3 surfaceLocal = { localPos.x, localHeight, localPos.z };
-    XMVECTOR surfaceWorldVec = XMVector3TransformCoord(XMLoadFloat3(&surfaceLocal), XMLoadFloat4x4(&worldMat));
+    XMVECTOR surfaceWorldVec = XMVector3TransformCoord(XMLoadFloat3(&surfaceLocal), XMLoadFloat4x4(&mCollisionCache.world));
 
     return XMVectorGetY(surfaceWorldVec);
-}
\ No newline at end of file
+}
+
+bool TerrainComponent::GetHeightAndNormal(const XMFLOAT3& worldPos, float& outHeight, XMFLOAT3& outNormal)
+{
+    if (!RefreshCollisionCache()) return false;
+
+    XMFLOAT3 localPos;
+    XMStoreFloat3(&localPos, XMVector3TransformCoord(XMLoadFloat3(&worldPos), XMLoadFloat4x4(&mCollisionCache.worldInv)));
+
+    float u = localPos.x / mWidth;
+    float v = localPos.z / mDepth;
+
+    if (u < 0.0f || u > 1.0f || v < 0.0f || v > 1.0f) return false;
+
+    const TerrainHeightField* field = mTerrainRes->GetHeightField();
+
+    XMFLOAT3 surfaceLocal = { localPos.x, field->GetHeight(u, v) * mMaxHeight, localPos.z };
+    XMFLOAT3 normalLocal = field->GetNormal(u, v, mWidth, mDepth, mMaxHeight);
+
+    outHeight = XMVectorGetY(XMVector3TransformCoord(XMLoadFloat3(&surfaceLocal), XMLoadFloat4x4(&mCollisionCache.world)));
+
+    XMVECTOR n = XMVector3TransformNormal(XMLoadFloat3(&normalLocal), XMLoadFloat4x4(&mCollisionCache.normalMatrix));
+    XMStoreFloat3(&outNormal, XMVector3Normalize(n));
+
+    return true;
+}
+
+void TerrainComponent::GetHeightsAndNormals(const std::vector<XMFLOAT3>& worldPositions, std::vector<HeightSample>& outSamples)
+{
+    const size_t count = worldPositions.size();
+    outSamples.assign(count, HeightSample{});
+
+    if (count == 0 || !RefreshCollisionCache()) return;
+
+    const TerrainHeightField* field = mTerrainRes->GetHeightField();
+    const auto& inv = mCollisionCache.worldInv.m;
+    const auto& w = mCollisionCache.world.m;
+    const auto& nm = mCollisionCache.normalMatrix.m;
+
+    const XMVECTOR zero = XMVectorZero();
+    const XMVECTOR one = XMVectorReplicate(1.0f);
+    const XMVECTOR invWidth = XMVectorReplicate(1.0f / mWidth);
+    const XMVECTOR invDepth = XMVectorReplicate(1.0f / mDepth);
+
+    for (size_t base = 0; base < count; base += 4)
+    {
+        const size_t lanes = std::min<size_t>(4, count - base);
+
+        XMFLOAT4 px = { 0, 0, 0, 0 }, py = { 0, 0, 0, 0 }, pz = { 0, 0, 0, 0 };
+        float* pxs = &px.x;
+        float* pys = &py.x;
+        float* pzs = &pz.x;
+        for (size_t i = 0; i < lanes; ++i)
+        {
+            pxs[i] = worldPositions[base + i].x;
+            pys[i] = worldPositions[base + i].y;
+            pzs[i] = worldPositions[base + i].z;
+        }
+
+        XMVECTOR x = XMLoadFloat4(&px);
+        XMVECTOR y = XMLoadFloat4(&py);
+        XMVECTOR z = XMLoadFloat4(&pz);
+
+        // Row-vector transform into terrain space, four points per lane group.
+        XMVECTOR lx = XMVectorMultiplyAdd(x, XMVectorReplicate(inv[0][0]),
+            XMVectorMultiplyAdd(y, XMVectorReplicate(inv[1][0]),
+                XMVectorMultiplyAdd(z, XMVectorReplicate(inv[2][0]), XMVectorReplicate(inv[3][0]))));
+        XMVECTOR lz = XMVectorMultiplyAdd(x, XMVectorReplicate(inv[0][2]),
+            XMVectorMultiplyAdd(y, XMVectorReplicate(inv[1][2]),
+                XMVectorMultiplyAdd(z, XMVectorReplicate(inv[2][2]), XMVectorReplicate(inv[3][2]))));
+
+        XMVECTOR u = XMVectorMultiply(lx, invWidth);
+        XMVECTOR v = XMVectorMultiply(lz, invDepth);
+
+        XMVECTOR inside = XMVectorAndInt(
+            XMVectorAndInt(XMVectorGreaterOrEqual(u, zero), XMVectorLessOrEqual(u, one)),
+            XMVectorAndInt(XMVectorGreaterOrEqual(v, zero), XMVectorLessOrEqual(v, one)));
+
+        u = XMVectorClamp(u, zero, one);
+        v = XMVectorClamp(v, zero, one);
+
+        XMVECTOR h = XMVectorScale(field->GetHeight4(u, v), mMaxHeight);
+
+        XMVECTOR wy = XMVectorMultiplyAdd(lx, XMVectorReplicate(w[0][1]),
+            XMVectorMultiplyAdd(h, XMVectorReplicate(w[1][1]),
+                XMVectorMultiplyAdd(lz, XMVectorReplicate(w[2][1]), XMVectorReplicate(w[3][1]))));
+
+        XMVECTOR nx, ny, nz;
+        field->GetNormal4(u, v, mWidth, mDepth, mMaxHeight, nx, ny, nz);
+
+        XMVECTOR wnx = XMVectorMultiplyAdd(nx, XMVectorReplicate(nm[0][0]), XMVectorMultiplyAdd(ny, XMVectorReplicate(nm[1][0]), XMVectorMultiply(nz, XMVectorReplicate(nm[2][0]))));
+        XMVECTOR wny = XMVectorMultiplyAdd(nx, XMVectorReplicate(nm[0][1]), XMVectorMultiplyAdd(ny, XMVectorReplicate(nm[1][1]), XMVectorMultiply(nz, XMVectorReplicate(nm[2][1]))));
+        XMVECTOR wnz = XMVectorMultiplyAdd(nx, XMVectorReplicate(nm[0][2]), XMVectorMultiplyAdd(ny, XMVectorReplicate(nm[1][2]), XMVectorMultiply(nz, XMVectorReplicate(nm[2][2]))));
+
+        XMVECTOR invLen = XMVectorReciprocalSqrt(XMVectorMultiplyAdd(wnx, wnx, XMVectorMultiplyAdd(wny, wny, XMVectorMultiply(wnz, wnz))));
+        wnx = XMVectorMultiply(wnx, invLen);
+        wny = XMVectorMultiply(wny, invLen);
+        wnz = XMVectorMultiply(wnz, invLen);
+
+        XMFLOAT4 hs, ns[3];
+        uint32_t valid[4];
+        XMStoreFloat4(&hs, wy);
+        XMStoreFloat4(&ns[0], wnx);
+        XMStoreFloat4(&ns[1], wny);
+        XMStoreFloat4(&ns[2], wnz);
+        XMStoreInt4(valid, inside);
+
+        for (size_t i = 0; i < lanes; ++i)
+        {
+            HeightSample& out = outSamples[base + i];
+            out.valid = valid[i] != 0;
+            if (!out.valid) continue;
+
+            out.height = (&hs.x)[i];
+            out.normal = { (&ns[0].x)[i], (&ns[1].x)[i], (&ns[2].x)[i] };
+        }
+    }
+}
+
+bool TerrainComponent::GetWorldBounds(XMFLOAT3& outMin, XMFLOAT3& outMax)
+{
+    if (!RefreshCollisionCache()) return false;
+
+    outMin = mCollisionCache.boundsMin;
+    outMax = mCollisionCache.boundsMax;
+    return true;
+}
+
+bool TerrainComponent::Raycast(const XMFLOAT3& origin, const XMFLOAT3& dir, float maxDist, float& outT, XMFLOAT3& outNormal)
+{
+    if (!RefreshCollisionCache()) return false;
+
+    const TerrainHeightField* field = mTerrainRes->GetHeightField();
+    if (field->GetWidthCount() < 2 || field->GetHeightCount() < 2) return false;
+
+    XMMATRIX worldInv = XMLoadFloat4x4(&mCollisionCache.worldInv);
+
+    // Local direction is not renormalized, so the ray parameter stays in world units.
+    XMFLOAT3 o, d;
+    XMStoreFloat3(&o, XMVector3TransformCoord(XMLoadFloat3(&origin), worldInv));
+    XMStoreFloat3(&d, XMVector3TransformNormal(XMLoadFloat3(&dir), worldInv));
+
+    const float boxMin[3] = { 0.0f, 0.0f, 0.0f };
+    const float boxMax[3] = { mWidth, mMaxHeight, mDepth };
+    const float ro[3] = { o.x, o.y, o.z };
+    const float rd[3] = { d.x, d.y, d.z };
+
+    float t0 = 0.0f;
+    float t1 = maxDist;
+    for (int a = 0; a < 3; ++a)
+    {
+        if (fabsf(rd[a]) < 1e-8f)
+        {
+            if (ro[a] < boxMin[a] || ro[a] > boxMax[a]) return false;
+            continue;
+        }
+
+        float lo = (boxMin[a] - ro[a]) / rd[a];
+        float hi = (boxMax[a] - ro[a]) / rd[a];
+        if (lo > hi) std::swap(lo, hi);
+        t0 = std::max(t0, lo);
+        t1 = std::min(t1, hi);
+        if (t0 > t1) return false;
+    }
+
+    auto aboveSurface = [&](float t)
+        {
+            float x = o.x + d.x * t;
+            float z = o.z + d.z * t;
+            float u = std::clamp(x / mWidth, 0.0f, 1.0f);
+            float v = std::clamp(z / mDepth, 0.0f, 1.0f);
+            return (o.y + d.y * t) - field->GetHeight(u, v) * mMaxHeight;
+        };
+
+    // March one texel at a time in XZ, then bisect the first sign change.
+    float cell = std::min(mWidth / (field->GetWidthCount() - 1), mDepth / (field->GetHeightCount() - 1));
+    float horiz = sqrtf(d.x * d.x + d.z * d.z);
+    float step = (horiz > 1e-6f) ? cell / horiz : (t1 - t0);
+    step = std::max(step, (t1 - t0) / 65536.0f);
+
+    if (aboveSurface(t0) <= 0.0f) return false;
+
+    float prevT = t0;
+    float hitT = -1.0f;
+
+    for (float t = t0 + step; prevT < t1; t += step)
+    {
+        t = std::min(t, t1);
+
+        if (aboveSurface(t) <= 0.0f)
+        {
+            float lo = prevT;
+            float hi = t;
+            for (int i = 0; i < 12; ++i)
+            {
+                float mid = (lo + hi) * 0.5f;
+                if (aboveSurface(mid) <= 0.0f) hi = mid;
+                else lo = mid;
+            }
+            hitT = hi;
+            break;
+        }
+        prevT = t;
+    }
+
+    if (hitT < 0.0f) return false;
+
+    float u = std::clamp((o.x + d.x * hitT) / mWidth, 0.0f, 1.0f);
+    float v = std::clamp((o.z + d.z * hitT) / mDepth, 0.0f, 1.0f);
+    XMFLOAT3 normalLocal = field->GetNormal(u, v, mWidth, mDepth, mMaxHeight);
+
+    XMVECTOR n = XMVector3TransformNormal(XMLoadFloat3(&normalLocal), XMLoadFloat4x4(&mCollisionCache.normalMatrix));
+    XMStoreFloat3(&outNormal, XMVector3Normalize(n));
+    outT = hitT;
+    return true;
+}
@@ -2,6 +2,7 @@
 #include "Core/Component.h"
 #include "Terrain/TerrainQuadTree.h"
 #include "Resource/TerrainResource.h"
+#include "Resource/ResourceHandle.h"
 
 
 class Mesh;
@@ -31,7 +32,7 @@ public:
 
 public:
     void SetTerrain(UINT TerrainResourceID);
-    void SetMaterialID(UINT id) { mMaterialID = id; }
+    void SetMaterialID(UINT id);
 
     void SetTerrain_Size(float width, float depth, float maxHeight);
     void SetTerrain_Width(float width);
@@ -53,17 +54,47 @@ public:
 public:
     void UpdateLOD(CameraComponent* camera);
     float GetHeight(XMFLOAT3 worldPos);
+    bool GetHeightAndNormal(const XMFLOAT3& worldPos, float& outHeight, XMFLOAT3& outNormal);
+    bool GetWorldBounds(XMFLOAT3& outMin, XMFLOAT3& outMax);
+    bool Raycast(const XMFLOAT3& origin, const XMFLOAT3& dir, float maxDist, float& outT, XMFLOAT3& outNormal);
+
+    struct HeightSample
+    {
+        float height = -FLT_MAX;
+        XMFLOAT3 normal = { 0.0f, 1.0f, 0.0f };
+        bool valid = false;
+    };
+
+    // World-space heights and normals for many points, four per SIMD pass. Points outside the terrain come back invalid.
+    void GetHeightsAndNormals(const std::vector<XMFLOAT3>& worldPositions, std::vector<HeightSample>& outSamples);
     const std::vector<TerrainInstanceData>& GetDrawList() const;
 
+private:
+    // Recomputes the inverse and normal matrices only when the world matrix or terrain size changed.
+    bool RefreshCollisionCache();
+
 private:
     std::weak_ptr<TransformComponent> mTransform;
 
+    struct CollisionCache
+    {
+        XMFLOAT4X4 world;
+        XMFLOAT4X4 worldInv;
+        XMFLOAT4X4 normalMatrix;
+        XMFLOAT3 boundsMin;
+        XMFLOAT3 boundsMax;
+        XMFLOAT3 size;
+        bool valid = false;
+    };
+    CollisionCache mCollisionCache;
+
     std::unique_ptr<TerrainQuadTree> mQuadTree;
     std::shared_ptr<TerrainResource> mTerrainRes;
     std::shared_ptr<Mesh> mPatchMesh;
 
     UINT mTerrainResID = Engine::INVALID_ID;
     UINT mMaterialID = Engine::INVALID_ID;
+    ResourceHandle mMaterialHandle;
 
     float mWidth = 1000.0f;
     float mDepth = 1000.0f;
@@ -8,6 +8,7 @@ Scene::Scene()
 { 
 	scene_id = Engine::INVALID_ID; 
 	m_pObjectManager = std::make_unique<ObjectManager>(this);
+	mAnimationPoseCache = std::make_unique<AnimationPoseCache>();
 }
 
 Scene::~Scene()
@@ -251,11 +252,40 @@ void Scene::Update_Scene(float dt)
 
 	m_pObjectManager->Update_Animate_All(dt);
 
-	for (auto animController : animation_controller_list)
+	// Controllers are independent, so the result does not depend on how they are split across workers.
+	JobSystem* jobs = GameEngine::Get().GetJobSystem();
+	const UINT workerCount = jobs ? jobs->GetWorkerCount() : 1;
+	if (mAnimationScratch.size() < workerCount)
+		mAnimationScratch.resize(workerCount);
+
+	AnimationLODView lodView;
+	lodView.frameIndex = ++mAnimationFrame;
+	if (auto cam = activeCamera.lock())
 	{
-		if (animController)
-			animController->Update(dt);
+		lodView.cameraPosition = cam->GetPosition();
+		lodView.projScale = 1.0f / tanf(cam->GetFovY() * 0.5f);
+		lodView.frustum = &cam->GetFrustumWS();
 	}
+	AnimationControllerComponent::ResetLODStats();
+	mAnimationPoseCache->BeginFrame();
+
+	auto updateRange = [&](size_t begin, size_t end, UINT worker)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				if (const auto& animController = animation_controller_list[i])
+					animController->Update(dt, mAnimationScratch[worker], &lodView, mAnimationPoseCache.get());
+			}
+		};
+
+	if (jobs)
+		jobs->ParallelFor(animation_controller_list.size(), AnimationUpdateGrain, updateRange);
+	else
+		updateRange(0, animation_controller_list.size(), 0);
+
+	// Root motion moves transforms and rigidbodies, so it is applied serially after the parallel update.
+	for (const auto& animController : animation_controller_list)
+		if (animController) animController->ApplyRootMotion(dt);
 
 	for (const auto& rd : renderData_list)
 	{
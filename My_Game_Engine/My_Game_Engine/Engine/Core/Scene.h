@@ -5,6 +5,8 @@
 class SceneManager;
 class Object;
 class TerrainComponent;
+struct AnimationScratch;
+class AnimationPoseCache;
 
 class Scene : public std::enable_shared_from_this<Scene>
 {
@@ -52,6 +54,8 @@ protected:
     void WakeUp();
 
 private:
+    static constexpr size_t AnimationUpdateGrain = 8;
+
     UINT scene_id;
     std::string alias;
     
@@ -61,6 +65,9 @@ private:
 
     std::vector<std::weak_ptr<LightComponent>> light_list;
 	std::vector<std::shared_ptr<AnimationControllerComponent>> animation_controller_list;
+	std::vector<AnimationScratch> mAnimationScratch; // one per job worker
+	std::unique_ptr<AnimationPoseCache> mAnimationPoseCache;
+	UINT64 mAnimationFrame = 0;
 
     std::vector<std::weak_ptr<CameraComponent>> camera_list;
     std::weak_ptr<CameraComponent> activeCamera;
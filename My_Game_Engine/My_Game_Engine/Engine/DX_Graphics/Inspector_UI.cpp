@@ -5,11 +5,28 @@
 #include "Components/ColliderComponent.h"
 #include "Components/TerrainComponent.h"
 #include "Resource/Mesh.h"
+#include "Physics/MeshBVH.h"
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
 static UINT g_SelectedResID = Engine::INVALID_ID;
 
+static std::string FormatBytes(UINT64 bytes)
+{
+    const char* units[] = { "B", "KB", "MB", "GB" };
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < IM_ARRAYSIZE(units) - 1)
+    {
+        value /= 1024.0;
+        ++unit;
+    }
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), unit == 0 ? "%.0f %s" : "%.2f %s", value, units[unit]);
+    return buffer;
+}
+
 void UIManager::Initialize(HWND hWnd, ID3D12Device* device, ID3D12CommandQueue* cmdQueue, DescriptorManager* heapManager, ResourceSystem* resSystem)
 {
     mHeapManager = heapManager;
@@ -115,6 +132,7 @@ void UIManager::Render(ID3D12GraphicsCommandList* cmdList, D3D12_GPU_DESCRIPTOR_
             ImGui::DockBuilderDockWindow("Game Viewport", dock_main_id);
             ImGui::DockBuilderDockWindow("Scene Hierarchy", dock_left_id);
             ImGui::DockBuilderDockWindow("Performance", dock_right_id);
+            ImGui::DockBuilderDockWindow("Resource Memory", dock_right_id);
             ImGui::DockBuilderDockWindow("Inspector", dock_right_id);
             ImGui::DockBuilderDockWindow("Resource Inspector", dock_down_id);
 
@@ -156,6 +174,7 @@ void UIManager::Render(ID3D12GraphicsCommandList* cmdList, D3D12_GPU_DESCRIPTOR_
     ImGui::PopStyleVar();
 
     DrawPerformanceWindow();
+    DrawMemoryWindow();
     DrawResourceWindow();
     DrawInspectorWindow();
     DrawHierarchyWindow();
@@ -201,6 +220,87 @@ void UIManager::DrawPerformanceWindow()
     ImGui::End();
 }
 
+void UIManager::DrawMemoryWindow()
+{
+    if (ImGui::Begin("Resource Memory"))
+    {
+        const ResourceSystem* rs = mResourceSystem;
+        const ImGuiTableFlags tableFlags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp;
+
+        if (ImGui::BeginTable("CategoryUsage", 5, tableFlags))
+        {
+            ImGui::TableSetupColumn("Category");
+            ImGui::TableSetupColumn("CPU");
+            ImGui::TableSetupColumn("GPU");
+            ImGui::TableSetupColumn("Staging");
+            ImGui::TableSetupColumn("Budget (CPU / GPU)");
+            ImGui::TableHeadersRow();
+
+            for (int i = 0; i <= static_cast<int>(ResourceType::etc); ++i)
+            {
+                ResourceType type = static_cast<ResourceType>(i);
+                const MemoryFootprint& usage = rs->GetCategoryUsage(type);
+                const ResourceBudget& budget = rs->GetBudget(type);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(GetResourceTypeString(type));
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(FormatBytes(usage.cpuBytes).c_str());
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(FormatBytes(usage.gpuBytes).c_str());
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(FormatBytes(usage.stagingBytes).c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%s / %s",
+                    budget.cpuBytes ? FormatBytes(budget.cpuBytes).c_str() : "-",
+                    budget.gpuBytes ? FormatBytes(budget.gpuBytes).c_str() : "-");
+            }
+
+            MemoryFootprint total = rs->GetTotalUsage();
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted("Total");
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(FormatBytes(total.cpuBytes).c_str());
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(FormatBytes(total.gpuBytes).c_str());
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(FormatBytes(total.stagingBytes).c_str());
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(FormatBytes(total.GetTotal()).c_str());
+
+            ImGui::EndTable();
+        }
+
+        ImGui::Separator();
+
+        static int topCount = 10;
+        ImGui::SliderInt("Top N", &topCount, 1, 50);
+
+        if (ImGui::BeginTable("TopConsumers", 4, tableFlags | ImGuiTableFlags_ScrollY))
+        {
+            ImGui::TableSetupColumn("Resource");
+            ImGui::TableSetupColumn("Type");
+            ImGui::TableSetupColumn("Total");
+            ImGui::TableSetupColumn("CPU / GPU / Staging");
+            ImGui::TableHeadersRow();
+
+            for (const ResourceEntry* entry : rs->GetTopMemoryConsumers(static_cast<size_t>(topCount)))
+            {
+                const MemoryFootprint& footprint = entry->footprint;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::PushID(static_cast<int>(entry->id));
+                if (ImGui::Selectable(entry->alias.c_str(), g_SelectedResID == entry->id, ImGuiSelectableFlags_SpanAllColumns))
+                    g_SelectedResID = entry->id;
+                ImGui::PopID();
+
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(GetResourceTypeString(entry->resource->Get_Type()));
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(FormatBytes(footprint.GetTotal()).c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%s / %s / %s", FormatBytes(footprint.cpuBytes).c_str(),
+                    FormatBytes(footprint.gpuBytes).c_str(), FormatBytes(footprint.stagingBytes).c_str());
+            }
+
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
+
 void UIManager::DrawResourceWindow()
 {
     if (ImGui::Begin("Resource Inspector"))
@@ -904,6 +1004,89 @@ void UIManager::DrawAnimationControllerInspector(Component* comp)
                 ImGui::TreePop();
             }
 
+            if (ImGui::TreeNodeEx("LOD"))
+            {
+                AnimationLODSettings lod = animCtrl->GetLODSettings();
+                bool changed = false;
+
+                changed |= ImGui::Checkbox("Enabled", &lod.enabled);
+                changed |= ImGui::DragFloat3("Distances", lod.distances, 0.5f, 0.0f, 1000.0f, "%.1f m");
+
+                int intervals[AnimationLODSettings::LevelCount];
+                for (int l = 0; l < AnimationLODSettings::LevelCount; ++l) intervals[l] = (int)lod.updateIntervals[l];
+                if (ImGui::DragInt4("Update Intervals", intervals, 0.1f, 1, 60))
+                {
+                    for (int l = 0; l < AnimationLODSettings::LevelCount; ++l) lod.updateIntervals[l] = (UINT)std::max(1, intervals[l]);
+                    changed = true;
+                }
+
+                changed |= ImGui::SliderInt("Leaf Skip LOD", &lod.leafSkipLOD, 0, AnimationLODSettings::LevelCount);
+
+                int leafDepth = (int)lod.leafDepth;
+                if (ImGui::SliderInt("Leaf Depth", &leafDepth, 0, 5))
+                {
+                    lod.leafDepth = (UINT)leafDepth;
+                    changed = true;
+                }
+
+                changed |= ImGui::DragFloat("Min Screen Size", &lod.minScreenSize, 0.001f, 0.0f, 1.0f, "%.3f");
+
+                int freezeFrames = (int)lod.cullFreezeFrames;
+                if (ImGui::DragInt("Cull Freeze Frames", &freezeFrames, 1.0f, 0, 600))
+                {
+                    lod.cullFreezeFrames = (UINT)std::max(0, freezeFrames);
+                    changed = true;
+                }
+
+                changed |= ImGui::DragFloat("Bounds Radius", &lod.boundsRadius, 0.05f, 0.01f, 50.0f);
+
+                if (changed)
+                    animCtrl->SetLODSettings(lod);
+
+                ImGui::Text("Current LOD: %d%s", animCtrl->GetCurrentLOD(), animCtrl->IsLODFrozen() ? " (Frozen)" : "");
+
+                AnimationLODStats stats = AnimationControllerComponent::GetLODStats();
+                ImGui::TextDisabled("Scene: %u / %u controllers evaluated, %u frozen, %u unchanged",
+                    stats.evaluatedControllers, stats.controllers, stats.frozenControllers, stats.unchangedControllers);
+                ImGui::TextDisabled("Bones: %u evaluated, %u saved", stats.evaluatedBones, stats.savedBones);
+
+                ImGui::TreePop();
+            }
+
+            if (ImGui::TreeNodeEx("Root Motion"))
+            {
+                RootMotionSettings rootMotion = animCtrl->GetRootMotionSettings();
+
+                bool changed = ImGui::Checkbox("Apply Root Motion", &rootMotion.enabled);
+                changed |= ImGui::Checkbox("Lock X", &rootMotion.lockX);
+                ImGui::SameLine();
+                changed |= ImGui::Checkbox("Lock Y", &rootMotion.lockY);
+                ImGui::SameLine();
+                changed |= ImGui::Checkbox("Lock Z", &rootMotion.lockZ);
+                changed |= ImGui::Checkbox("Lock Yaw", &rootMotion.lockYaw);
+                if (changed)
+                    animCtrl->SetRootMotionSettings(rootMotion);
+
+                ImGui::TreePop();
+            }
+
+            if (ImGui::TreeNodeEx("Pose Sharing"))
+            {
+                bool sharing = animCtrl->IsPoseSharingEnabled();
+                float timeStep = animCtrl->GetPoseSharingTimeStep();
+
+                bool changed = ImGui::Checkbox("Enabled", &sharing);
+                changed |= ImGui::DragFloat("Time Step", &timeStep, 0.001f, 0.0f, 0.5f, "%.3f s");
+                if (changed)
+                    animCtrl->SetPoseSharing(sharing, timeStep);
+
+                AnimationPoseCacheStats stats = AnimationPoseCache::GetStats();
+                ImGui::TextDisabled("Scene: %u / %u lookups hit (%.1f%%), %u poses published",
+                    stats.hits, stats.lookups, stats.GetHitRate() * 100.0f, stats.published);
+
+                ImGui::TreePop();
+            }
+
             ImGui::Separator();
             ImGui::Text("Global Timeline Control");
 
@@ -940,7 +1123,7 @@ void UIManager::DrawAnimationControllerInspector(Component* comp)
             {
                 ImGui::PushID(i);
 
-                float childHeight = 230.0f;
+                float childHeight = 255.0f;
                 if (ImGui::BeginChild("LayerFrame", ImVec2(0, childHeight), true, ImGuiWindowFlags_None))
                 {
                     std::string headerName = "Layer " + std::to_string(i);
@@ -958,6 +1141,13 @@ void UIManager::DrawAnimationControllerInspector(Component* comp)
                         animCtrl->SetLayerWeight(i, weight);
                     }
 
+                    const char* blendNames[] = { "Override", "Additive" };
+                    int blendIdx = (int)animCtrl->GetLayerBlendMode(i);
+                    if (ImGui::Combo("Blend Mode", &blendIdx, blendNames, IM_ARRAYSIZE(blendNames)))
+                    {
+                        animCtrl->SetLayerBlendMode(i, (LayerBlendMode)blendIdx);
+                    }
+
                     auto currentMask = animCtrl->GetLayerMask(i);
                     std::string maskName = currentMask ? currentMask->GetAlias() : "None (Full Body)";
 
@@ -1262,6 +1452,17 @@ void UIManager::DrawRigidbodyInspector(Component* comp)
         if (ImGui::Checkbox("Is Kinematic", &isKinematic))
             rb->SetKinematic(isKinematic);
 
+        bool useCCD = rb->GetUseCCD();
+        if (ImGui::Checkbox("Continuous Collision", &useCCD))
+            rb->SetUseCCD(useCCD);
+
+        if (useCCD)
+        {
+            float threshold = rb->GetCCDVelocityThreshold();
+            if (ImGui::DragFloat("CCD Velocity Threshold", &threshold, 0.1f, 0.0f, 10000.0f))
+                rb->SetCCDVelocityThreshold(threshold);
+        }
+
         ImGui::Separator();
         ImGui::Text("Runtime Debug Info");
 
@@ -1300,6 +1501,12 @@ void UIManager::DrawColliderInspector(Component* comp)
             col->SetColliderType(static_cast<Collider_Type>(currentTypeIdx));
         }
 
+        int layer = static_cast<int>(col->GetLayer());
+        if (ImGui::SliderInt("Layer", &layer, 0, 31))
+        {
+            col->SetLayer(static_cast<UINT>(layer));
+        }
+
         ImGui::Separator();
 
         XMFLOAT3 center = col->GetCenter();
@@ -1344,9 +1551,32 @@ void UIManager::DrawColliderInspector(Component* comp)
             break;
         }
         case Collider_Type::Mesh:
+        {
+            ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
+            Mesh* currentMesh = col->GetMesh().get();
+
+            DrawResourcePickUI<Mesh>(
+                "##ColliderMeshSelect",
+                currentMesh,
+                rs->GetMeshes(),
+                PAYLOAD_MESH,
+                [col](Mesh* newMesh) {
+                    if (newMesh) col->SetMesh(newMesh->GetId());
+                    else col->SetMesh(Engine::INVALID_ID);
+                }
+            );
+
+            if (auto bvh = col->GetMeshBVH())
+                ImGui::TextDisabled("Triangles: %u  Nodes: %u", bvh->GetTriangleCount(), bvh->GetNodeCount());
+            else if (currentMesh)
+                ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "No collision data (enable generate_collision in the model .meta)");
+
+            ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "[Static]");
+            break;
+        }
         case Collider_Type::Terrain:
         {
-            ImGui::TextDisabled("Auto-Calculated from Mesh/Terrain Data");
+            ImGui::TextDisabled("Auto-Calculated from Terrain Data");
             break;
         }
         default:
@@ -1519,6 +1749,7 @@ void UIManager::DrawResourceDetails()
     ImGui::TextColored(ImVec4(0.2f, 0.8f, 1.0f, 1.0f), "[ %s ]", res->GetAlias().c_str());
     ImGui::Text("ID: %d", res->GetId());
     ImGui::TextWrapped("Path: %s", res->GetPath().c_str());
+    DrawMemoryFootprint(res->GetMemoryFootprint());
     ImGui::Separator();
     ImGui::Spacing();
 
@@ -1575,10 +1806,18 @@ const char* UIManager::GetResourceTypeString(ResourceType type)
     case ResourceType::Skeleton: return "Skeleton";
     case ResourceType::AnimationClip: return "AnimationClip";
     case ResourceType::AvatarMask: return "AvatarMask";
+    case ResourceType::TerrainData: return "Terrain";
+    case ResourceType::etc: return "Etc";
     default: return "Unknown";
     }
 }
 
+void UIManager::DrawMemoryFootprint(const MemoryFootprint& footprint)
+{
+    ImGui::Text("Memory: %s (CPU %s, GPU %s, Staging %s)", FormatBytes(footprint.GetTotal()).c_str(),
+        FormatBytes(footprint.cpuBytes).c_str(), FormatBytes(footprint.gpuBytes).c_str(), FormatBytes(footprint.stagingBytes).c_str());
+}
+
 void UIManager::DrawSimpleTooltip(Game_Resource* res)
 {
     ImGui::Text("Name: %s", res->GetAlias().c_str());
@@ -1742,6 +1981,52 @@ void UIManager::DrawDetailInfo(AnimationClip* clip)
     ImGui::Text("Duration:  %.2f sec", clip->GetDuration());
     ImGui::Text("FrameRate: %.2f FPS", clip->GetTicksPerSecond());
     ImGui::Text("Total Keyframes: %d", clip->GetTotalKeyframes());
+
+    ImGui::Separator();
+
+    // Additive settings rebuild the clip's additive tracks and are saved with the clip.
+    bool settingsChanged = false;
+    bool additive = clip->HasAdditive();
+    if (ImGui::Checkbox("Additive", &additive))
+    {
+        clip->SetAdditive(additive);
+        settingsChanged = true;
+    }
+
+    if (additive)
+    {
+        ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
+        auto reference = rs->GetByGUID<AnimationClip>(clip->GetAdditiveReferenceClip());
+
+        ImGui::Text("Reference Clip (None = this clip)");
+        settingsChanged |= DrawResourcePickUI<AnimationClip>(
+            "##AdditiveReference",
+            reference.get(),
+            rs->GetAnimationClips(),
+            PAYLOAD_CLIP,
+            [clip](AnimationClip* newRef) {
+                Guid guid = (newRef && newRef != clip) ? newRef->GetGUID() : Guid{};
+                clip->SetAdditiveReference(guid, clip->GetAdditiveReferenceTime());
+            }
+        );
+
+        const AnimationClip* timeSource = reference ? reference.get() : clip;
+        float referenceTime = clip->GetAdditiveReferenceTime();
+        if (ImGui::SliderFloat("Reference Time", &referenceTime, 0.0f, timeSource->GetDuration(), "%.2f sec"))
+            clip->SetAdditiveReference(clip->GetAdditiveReferenceClip(), referenceTime);
+        if (ImGui::IsItemDeactivatedAfterEdit())
+            settingsChanged = true;
+    }
+
+    if (settingsChanged && !clip->GetPath().empty() && !clip->SaveToFile(clip->GetPath()))
+        OutputDebugStringA(("[UIManager] Failed to save clip: " + clip->GetPath() + "\n").c_str());
+
+    if (!clip->GetPath().empty() && ImGui::Button("Export JSON"))
+    {
+        std::string jsonPath = std::filesystem::path(clip->GetPath()).replace_extension(".json").string();
+        if (!clip->ExportToJson(jsonPath))
+            OutputDebugStringA(("[UIManager] Failed to export clip: " + jsonPath + "\n").c_str());
+    }
 }
 
 void UIManager::DrawDetailInfo(AvatarMask* mask)
@@ -12,6 +12,7 @@
 #define PAYLOAD_TERRAIN "PAYLOAD_TERRAIN"
 
 enum class ResourceType;
+struct MemoryFootprint;
 class ResourceSystem;
 class Scene;
 class Object;
@@ -66,6 +67,7 @@ private:
     // Main Window Drawers (Called in Render)
     // ------------------------------------------------------
     void DrawPerformanceWindow();
+    void DrawMemoryWindow();
     void DrawResourceWindow();
     void DrawInspectorWindow();
     void DrawHierarchyWindow();
@@ -100,6 +102,7 @@ private:
     void DrawResourceDetails();  // Right Panel
     void FilterResources();
     const char* GetResourceTypeString(ResourceType type);
+    void DrawMemoryFootprint(const MemoryFootprint& footprint);
     void DrawSimpleTooltip(Game_Resource* res);
     void OpenLoadResourceDialog();
 
@@ -192,6 +192,9 @@ public:
     // --- Getters ---
     UINT GetRenderWidth() const { return mRenderWidth; }
     UINT GetRenderHeight() const { return mRenderHeight; }
+    UINT64 GetSubmittedFenceValue() const { return mFenceValue; }
+    UINT64 GetCompletedFenceValue() const { return mFence->GetCompletedValue(); }
+    UINT64 GetUploadFenceValue() const { return mUploadFenceValue; }
 
     // --- Main Render Loop ---
     void Update_SceneCBV(SceneData& data);
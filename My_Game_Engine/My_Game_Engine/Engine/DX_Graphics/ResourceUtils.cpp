@@ -15,6 +15,35 @@ static void LogIfFailed(HRESULT hr, const char* msg)
     }
 }
 
+// Records the copy of decoded subresources into a texture created in COPY_DEST, through a new upload buffer.
+static ComPtr<ID3D12Resource> UploadTexture(const RendererContext& ctx, const ComPtr<ID3D12Resource>& texture,
+    const D3D12_SUBRESOURCE_DATA* subresources, UINT numSubresources, ComPtr<ID3D12Resource>& uploadBuffer)
+{
+    const UINT64 uploadBufferSize = GetRequiredIntermediateSize(texture.Get(), 0, numSubresources);
+
+    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
+    CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize);
+
+    HRESULT hr = ctx.device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(uploadBuffer.GetAddressOf()));
+
+    if (FAILED(hr))
+    {
+        LogIfFailed(hr, "UploadTexture: upload heap");
+        return nullptr;
+    }
+
+    UpdateSubresources(ctx.cmdList, texture.Get(), uploadBuffer.Get(), 0, 0, numSubresources, subresources);
+
+    auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(texture.Get(),
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    ctx.cmdList->ResourceBarrier(1, &barrier);
+
+    return texture;
+}
+
 // =====================================================
 // CreateDefaultBuffer
 // =====================================================
@@ -40,30 +69,23 @@ ComPtr<ID3D12Resource> ResourceUtils::LoadDDSTexture(const RendererContext& ctx,
         return nullptr;
     }
 
-    const UINT numSubresources = (UINT)subresources.size();
-    const UINT64 uploadBufferSize = GetRequiredIntermediateSize(texture.Get(), 0, numSubresources);
-    
-    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
-    CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize);
+    return UploadTexture(ctx, texture, subresources.data(), (UINT)subresources.size(), uploadBuffer);
+}
 
-    hr = ctx.device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc, 
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(uploadBuffer.GetAddressOf()));
+ComPtr<ID3D12Resource> ResourceUtils::LoadDDSTextureFromMemory(const RendererContext& ctx, const uint8_t* data, size_t size, ComPtr<ID3D12Resource>& uploadBuffer)
+{
+    ComPtr<ID3D12Resource> texture;
+    std::vector<D3D12_SUBRESOURCE_DATA> subresources;
 
-    if (FAILED(hr)) 
+    // The subresources point into data, which the caller keeps alive until the copy is recorded below.
+    HRESULT hr = DirectX::LoadDDSTextureFromMemory(ctx.device, data, size, texture.GetAddressOf(), subresources);
+    if (FAILED(hr))
     {
-        LogIfFailed(hr, "LoadDDSTexture: upload heap");
+        LogIfFailed(hr, "LoadDDSTextureFromMemory");
         return nullptr;
     }
 
-    UpdateSubresources(ctx.cmdList, texture.Get(), uploadBuffer.Get(), 0, 0, numSubresources, subresources.data());
-
-    auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(texture.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
-    ctx.cmdList->ResourceBarrier(1, &barrier);
-
-    return texture;
+    return UploadTexture(ctx, texture, subresources.data(), (UINT)subresources.size(), uploadBuffer);
 }
 
 // =====================================================
@@ -83,30 +105,23 @@ ComPtr<ID3D12Resource> ResourceUtils::LoadWICTexture(const RendererContext& ctx,
         return nullptr; 
     }
 
-    const UINT64 uploadBufferSize = GetRequiredIntermediateSize(texture.Get(), 0, 1);
-
-
-    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
-    CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize);
+    return UploadTexture(ctx, texture, &subresource, 1, uploadBuffer);
+}
 
-    hr = ctx.device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE,
-        &bufferDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(uploadBuffer.GetAddressOf()));
+ComPtr<ID3D12Resource> ResourceUtils::LoadWICTextureFromMemory(const RendererContext& ctx, const uint8_t* data, size_t size, ComPtr<ID3D12Resource>& uploadBuffer)
+{
+    ComPtr<ID3D12Resource> texture;
+    std::unique_ptr<uint8_t[]> decodedData;
+    D3D12_SUBRESOURCE_DATA subresource;
 
+    HRESULT hr = DirectX::LoadWICTextureFromMemory(ctx.device, data, size, texture.GetAddressOf(), decodedData, subresource);
     if (FAILED(hr))
     {
-        LogIfFailed(hr, "LoadWICTexture: upload heap");
+        LogIfFailed(hr, "LoadWICTextureFromMemory");
         return nullptr;
     }
 
-    UpdateSubresources(ctx.cmdList, texture.Get(), uploadBuffer.Get(), 0, 0, 1, &subresource);
-
-    auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(texture.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
-    ctx.cmdList->ResourceBarrier(1, &barrier);
-
-    return texture;
+    return UploadTexture(ctx, texture, &subresource, 1, uploadBuffer);
 }
 
 
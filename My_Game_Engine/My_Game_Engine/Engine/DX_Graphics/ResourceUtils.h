@@ -7,6 +7,8 @@ namespace ResourceUtils
     ComPtr<ID3D12Resource> CreateDefaultBuffer(const RendererContext& ctx, const void* initData, UINT64 byteSize, ComPtr<ID3D12Resource>& uploadBuffer);
     ComPtr<ID3D12Resource> LoadDDSTexture(const RendererContext& ctx, const std::wstring& filename, ComPtr<ID3D12Resource>& uploadBuffer);
     ComPtr<ID3D12Resource> LoadWICTexture(const RendererContext& ctx, const std::wstring& filename, ComPtr<ID3D12Resource>& uploadBuffer);
+    ComPtr<ID3D12Resource> LoadDDSTextureFromMemory(const RendererContext& ctx, const uint8_t* data, size_t size, ComPtr<ID3D12Resource>& uploadBuffer);
+    ComPtr<ID3D12Resource> LoadWICTextureFromMemory(const RendererContext& ctx, const uint8_t* data, size_t size, ComPtr<ID3D12Resource>& uploadBuffer);
 
 
     ComPtr<ID3D12Resource> CreateResource(const RendererContext& ctx, void* pData, UINT64 nBytes, D3D12_RESOURCE_DIMENSION dimension, UINT width, UINT height, UINT depthOrArraySize, UINT mipLevels, D3D12_RESOURCE_FLAGS flags, DXGI_FORMAT format, D3D12_HEAP_TYPE heapType, D3D12_RESOURCE_STATES finalState, ComPtr<ID3D12Resource>& uploadBuffer);
@@ -7,6 +7,7 @@ void GameEngine::OnCreate(HINSTANCE hInstance, HWND hMainWnd)
 	m_hWnd = hMainWnd;
 
 	mTimer = std::make_unique<GameTimer>();
+	m_JobSystem = std::make_unique<JobSystem>();
 	m_PhysicsSystem = std::make_unique<PhysicsSystem>();
 	m_ResourceSystem = std::make_unique<ResourceSystem>();
 	m_ResourceSystem->Initialize("Assets/");
@@ -77,6 +78,7 @@ void GameEngine::FrameAdvance()
 	mRenderer->Update_SceneCBV(scene_data);
 
 	mRenderer->Render(active_scene);
+	m_ResourceSystem->Update();
 
 
 	//if (minimap_Camera)
@@ -7,6 +7,7 @@
 #include "Scene_Manager.h"
 #include "Managers/ObjectManager.h"
 #include "PhysicsSystem.h"
+#include "JobSystem.h"
 
 class GameEngine
 {
@@ -46,6 +47,7 @@ public:
     DX12_Renderer* GetRenderer() const { return mRenderer.get(); }
     GameTimer* GetTimer() { return mTimer.get(); }
     PhysicsSystem* GetPhysicsSystem() { return m_PhysicsSystem.get(); }
+    JobSystem* GetJobSystem() { return m_JobSystem.get(); }
     ResourceSystem* GetResourceSystem() { return m_ResourceSystem.get(); }
 	AvatarDefinitionManager* GetAvatarSystem() { return m_AvatarSystem.get(); }
 
@@ -66,6 +68,7 @@ private:
     
 	std::unique_ptr<AvatarDefinitionManager> m_AvatarSystem;
     std::unique_ptr<PhysicsSystem> m_PhysicsSystem;
+    std::unique_ptr<JobSystem> m_JobSystem;
     std::unique_ptr<ResourceSystem> m_ResourceSystem;
     std::unique_ptr<GameTimer> mTimer;
     std::unique_ptr<DX12_Renderer>   mRenderer;
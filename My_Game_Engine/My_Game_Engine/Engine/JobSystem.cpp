@@ -0,0 +1,117 @@
+#include "JobSystem.h"
+
+namespace
+{
+    thread_local bool tInsideJob = false;
+}
+
+JobSystem::JobSystem(UINT threadCount)
+{
+    if (threadCount == 0)
+    {
+        UINT hw = std::thread::hardware_concurrency();
+        threadCount = (hw > 1) ? hw - 1 : 0;
+    }
+
+    mThreads.reserve(threadCount);
+    for (UINT i = 0; i < threadCount; ++i)
+        mThreads.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWakeCV.notify_all();
+
+    for (auto& t : mThreads)
+        if (t.joinable()) t.join();
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const RangeFn& fn)
+{
+    if (count == 0) return;
+    if (grainSize == 0) grainSize = 1;
+
+    if (mThreads.empty() || tInsideJob || count <= grainSize)
+    {
+        fn(0, count, 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> dispatch(mDispatchMutex);
+
+    {
+        // Late workers from the previous loop must be gone before the chunk counter is reset.
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDoneCV.wait(lock, [this] { return mActiveWorkers == 0; });
+
+        mFn = &fn;
+        mCount = count;
+        mGrain = grainSize;
+        mNextChunk = 0;
+        mPendingChunks = (count + grainSize - 1) / grainSize;
+        ++mGeneration;
+    }
+    mWakeCV.notify_all();
+
+    RunChunks(0, fn, count, grainSize);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCV.wait(lock, [this] { return mPendingChunks == 0; });
+}
+
+void JobSystem::WorkerLoop(UINT workerIndex)
+{
+    UINT64 seenGeneration = 0;
+
+    while (true)
+    {
+        const RangeFn* fn;
+        size_t count, grain;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWakeCV.wait(lock, [&] { return mStop || mGeneration != seenGeneration; });
+            if (mStop) return;
+
+            seenGeneration = mGeneration;
+            fn = mFn;
+            count = mCount;
+            grain = mGrain;
+            ++mActiveWorkers;
+        }
+
+        RunChunks(workerIndex, *fn, count, grain);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mActiveWorkers;
+        }
+        mDoneCV.notify_all();
+    }
+}
+
+void JobSystem::RunChunks(UINT workerIndex, const RangeFn& fn, size_t count, size_t grain)
+{
+    const size_t chunkCount = (count + grain - 1) / grain;
+
+    tInsideJob = true;
+    while (true)
+    {
+        size_t chunk = mNextChunk.fetch_add(1);
+        if (chunk >= chunkCount) break;
+
+        size_t begin = chunk * grain;
+        size_t end = std::min(begin + grain, count);
+        fn(begin, end, workerIndex);
+
+        if (mPendingChunks.fetch_sub(1) == 1)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDoneCV.notify_all();
+        }
+    }
+    tInsideJob = false;
+}
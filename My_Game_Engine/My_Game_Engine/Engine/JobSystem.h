@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+
+// Fixed pool of worker threads for data-parallel loops. The calling thread joins the work,
+// so worker index 0 is always the caller and GetWorkerCount() includes it.
+class JobSystem
+{
+public:
+    using RangeFn = std::function<void(size_t begin, size_t end, UINT workerIndex)>;
+
+public:
+    explicit JobSystem(UINT threadCount = 0); // 0 = hardware threads - 1
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    UINT GetWorkerCount() const { return static_cast<UINT>(mThreads.size()) + 1; }
+
+    // Splits [0, count) into grainSize chunks and blocks until all of them ran.
+    // Calls made from inside a job run inline on the calling worker.
+    void ParallelFor(size_t count, size_t grainSize, const RangeFn& fn);
+
+private:
+    void WorkerLoop(UINT workerIndex);
+    void RunChunks(UINT workerIndex, const RangeFn& fn, size_t count, size_t grain);
+
+private:
+    std::vector<std::thread> mThreads;
+
+    std::mutex mDispatchMutex;
+    std::mutex mMutex;
+    std::condition_variable mWakeCV;
+    std::condition_variable mDoneCV;
+
+    const RangeFn* mFn = nullptr;
+    size_t mCount = 0;
+    size_t mGrain = 1;
+    std::atomic<size_t> mNextChunk = 0;
+    std::atomic<size_t> mPendingChunks = 0;
+    UINT mActiveWorkers = 0;
+    UINT64 mGeneration = 0;
+    bool mStop = false;
+};
@@ -0,0 +1,122 @@
+#include "Broadphase.h"
+
+void Broadphase::Build(std::vector<Proxy>&& proxies)
+{
+    mNodes.clear();
+    mProxies = std::move(proxies);
+
+    if (mProxies.empty()) return;
+
+    mNodes.reserve(mProxies.size() / MaxLeafProxies * 2 + 1);
+    BuildRecursive(0, static_cast<UINT>(mProxies.size()));
+}
+
+UINT Broadphase::BuildRecursive(UINT begin, UINT end)
+{
+    XMVECTOR bMin = XMVectorReplicate(FLT_MAX);
+    XMVECTOR bMax = XMVectorReplicate(-FLT_MAX);
+    XMVECTOR cMin = XMVectorReplicate(FLT_MAX);
+    XMVECTOR cMax = XMVectorReplicate(-FLT_MAX);
+
+    for (UINT i = begin; i < end; ++i)
+    {
+        XMVECTOR mn = XMLoadFloat3(&mProxies[i].bounds.min);
+        XMVECTOR mx = XMLoadFloat3(&mProxies[i].bounds.max);
+        bMin = XMVectorMin(bMin, mn);
+        bMax = XMVectorMax(bMax, mx);
+
+        XMVECTOR c = XMVectorScale(XMVectorAdd(mn, mx), 0.5f);
+        cMin = XMVectorMin(cMin, c);
+        cMax = XMVectorMax(cMax, c);
+    }
+
+    const UINT nodeIndex = static_cast<UINT>(mNodes.size());
+    mNodes.emplace_back();
+    XMStoreFloat3(&mNodes[nodeIndex].min, bMin);
+    XMStoreFloat3(&mNodes[nodeIndex].max, bMax);
+
+    const UINT count = end - begin;
+    if (count <= MaxLeafProxies)
+    {
+        mNodes[nodeIndex].first = begin;
+        mNodes[nodeIndex].count = count;
+        return nodeIndex;
+    }
+
+    XMFLOAT3 spread;
+    XMStoreFloat3(&spread, XMVectorSubtract(cMax, cMin));
+
+    int axis = 0;
+    if (spread.y > spread.x) axis = 1;
+    if (spread.z > (axis == 0 ? spread.x : spread.y)) axis = 2;
+
+    const UINT mid = begin + count / 2;
+    std::nth_element(mProxies.begin() + begin, mProxies.begin() + mid, mProxies.begin() + end,
+        [axis](const Proxy& a, const Proxy& b)
+        {
+            const float* aMin = &a.bounds.min.x;
+            const float* aMax = &a.bounds.max.x;
+            const float* bMin = &b.bounds.min.x;
+            const float* bMax = &b.bounds.max.x;
+            return (aMin[axis] + aMax[axis]) < (bMin[axis] + bMax[axis]);
+        });
+
+    UINT left = BuildRecursive(begin, mid);
+    UINT right = BuildRecursive(mid, end);
+
+    mNodes[nodeIndex].left = left;
+    mNodes[nodeIndex].right = right;
+    return nodeIndex;
+}
+
+XMFLOAT3 Broadphase::SafeInverse(const XMFLOAT3& dir)
+{
+    auto inv = [](float d)
+        {
+            if (fabsf(d) < 1e-12f) d = (d < 0.0f) ? -1e-12f : 1e-12f;
+            return 1.0f / d;
+        };
+
+    return { inv(dir.x), inv(dir.y), inv(dir.z) };
+}
+
+bool Broadphase::SlabTest(const XMFLOAT3& origin, const XMFLOAT3& invDir, float maxT, const XMFLOAT3& bmin, const XMFLOAT3& bmax, float& tEnter)
+{
+    XMVECTOR o = XMLoadFloat3(&origin);
+    XMVECTOR inv = XMLoadFloat3(&invDir);
+
+    XMVECTOR t1 = XMVectorMultiply(XMVectorSubtract(XMLoadFloat3(&bmin), o), inv);
+    XMVECTOR t2 = XMVectorMultiply(XMVectorSubtract(XMLoadFloat3(&bmax), o), inv);
+
+    XMFLOAT3 tNear, tFar;
+    XMStoreFloat3(&tNear, XMVectorMin(t1, t2));
+    XMStoreFloat3(&tFar, XMVectorMax(t1, t2));
+
+    float t0 = std::max({ tNear.x, tNear.y, tNear.z, 0.0f });
+    float t1f = std::min({ tFar.x, tFar.y, tFar.z, maxT });
+
+    tEnter = t0;
+    return t0 <= t1f;
+}
+
+UINT Broadphase::SlabTest4(const RayPacket& packet, const XMFLOAT3& bmin, const XMFLOAT3& bmax)
+{
+    // One box against four rays: each lane is one ray, so the slab test runs once for the packet.
+    XMVECTOR tx1 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(bmin.x), packet.ox), packet.invDx);
+    XMVECTOR tx2 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(bmax.x), packet.ox), packet.invDx);
+    XMVECTOR ty1 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(bmin.y), packet.oy), packet.invDy);
+    XMVECTOR ty2 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(bmax.y), packet.oy), packet.invDy);
+    XMVECTOR tz1 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(bmin.z), packet.oz), packet.invDz);
+    XMVECTOR tz2 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(bmax.z), packet.oz), packet.invDz);
+
+    XMVECTOR tNear = XMVectorMax(XMVectorMax(XMVectorMin(tx1, tx2), XMVectorMin(ty1, ty2)), XMVectorMin(tz1, tz2));
+    XMVECTOR tFar = XMVectorMin(XMVectorMin(XMVectorMax(tx1, tx2), XMVectorMax(ty1, ty2)), XMVectorMax(tz1, tz2));
+
+    tNear = XMVectorMax(tNear, XMVectorZero());
+    tFar = XMVectorMin(tFar, packet.maxT);
+
+    uint32_t hit[4];
+    XMStoreInt4(hit, XMVectorLessOrEqual(tNear, tFar));
+
+    return (hit[0] ? 1u : 0u) | (hit[1] ? 2u : 0u) | (hit[2] ? 4u : 0u) | (hit[3] ? 8u : 0u);
+}
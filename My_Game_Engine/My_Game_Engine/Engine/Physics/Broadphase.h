@@ -0,0 +1,203 @@
+#pragma once
+#include "PhysicsUtils.h"
+
+// AABB tree over every collider in a physics world. Rebuilt from scratch each step; scene queries walk it.
+class Broadphase
+{
+public:
+    struct Proxy
+    {
+        PhysicsUtils::AABB bounds;
+        UINT layerMask = 0;
+        UINT entry = 0;
+        bool isStatic = false;
+    };
+
+    struct Node
+    {
+        XMFLOAT3 min;
+        XMFLOAT3 max;
+        UINT left = 0;
+        UINT right = 0;
+        UINT first = 0;
+        UINT count = 0;
+    };
+
+    // Four rays in SoA form for the batched query path.
+    struct RayPacket
+    {
+        XMVECTOR ox, oy, oz;
+        XMVECTOR invDx, invDy, invDz;
+        XMVECTOR maxT;
+        UINT activeMask = 0;
+    };
+
+    static constexpr UINT MaxLeafProxies = 4;
+    static constexpr int MaxStackDepth = 64;
+
+public:
+    void Build(std::vector<Proxy>&& proxies);
+    void Clear() { mNodes.clear(); mProxies.clear(); }
+
+    const std::vector<Proxy>& GetProxies() const { return mProxies; }
+    bool IsEmpty() const { return mProxies.empty(); }
+
+    // fn(const Proxy&) for every proxy overlapping the box and passing the layer mask.
+    template<typename Fn>
+    void QueryAABB(const PhysicsUtils::AABB& box, UINT layerMask, Fn&& fn) const;
+
+    // fn(const Proxy&, float maxT) returns the new maxT so nodes beyond the closest hit are skipped.
+    template<typename Fn>
+    void QueryRay(const XMFLOAT3& origin, const XMFLOAT3& dir, float maxT, UINT layerMask, Fn&& fn) const;
+
+    // fn(const Proxy&, UINT laneMask) receives the lanes whose slabs reached the proxy; lanes' maxT may be shortened through the packet.
+    template<typename Fn>
+    void QueryRayPacket(RayPacket& packet, UINT layerMask, Fn&& fn) const;
+
+    static UINT SlabTest4(const RayPacket& packet, const XMFLOAT3& bmin, const XMFLOAT3& bmax);
+    static bool SlabTest(const XMFLOAT3& origin, const XMFLOAT3& invDir, float maxT, const XMFLOAT3& bmin, const XMFLOAT3& bmax, float& tEnter);
+    static XMFLOAT3 SafeInverse(const XMFLOAT3& dir);
+
+private:
+    UINT BuildRecursive(UINT begin, UINT end);
+
+private:
+    std::vector<Node> mNodes;
+    std::vector<Proxy> mProxies;
+};
+
+template<typename Fn>
+void Broadphase::QueryAABB(const PhysicsUtils::AABB& box, UINT layerMask, Fn&& fn) const
+{
+    if (mNodes.empty()) return;
+
+    UINT stack[MaxStackDepth];
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0)
+    {
+        const Node& node = mNodes[stack[--sp]];
+        if (!PhysicsUtils::Overlaps(box, { node.min, node.max })) continue;
+
+        if (node.count > 0)
+        {
+            for (UINT i = node.first; i < node.first + node.count; ++i)
+            {
+                const Proxy& p = mProxies[i];
+                if ((p.layerMask & layerMask) && PhysicsUtils::Overlaps(box, p.bounds))
+                    fn(p);
+            }
+            continue;
+        }
+
+        if (sp + 2 <= MaxStackDepth)
+        {
+            stack[sp++] = node.left;
+            stack[sp++] = node.right;
+        }
+    }
+}
+
+template<typename Fn>
+void Broadphase::QueryRay(const XMFLOAT3& origin, const XMFLOAT3& dir, float maxT, UINT layerMask, Fn&& fn) const
+{
+    if (mNodes.empty()) return;
+
+    XMFLOAT3 invDir = SafeInverse(dir);
+
+    float tEnter;
+    if (!SlabTest(origin, invDir, maxT, mNodes[0].min, mNodes[0].max, tEnter)) return;
+
+    UINT stack[MaxStackDepth];
+    float stackT[MaxStackDepth];
+    int sp = 0;
+    stack[sp] = 0;
+    stackT[sp++] = tEnter;
+
+    while (sp > 0)
+    {
+        --sp;
+        if (stackT[sp] > maxT) continue;
+
+        const Node& node = mNodes[stack[sp]];
+
+        if (node.count > 0)
+        {
+            for (UINT i = node.first; i < node.first + node.count; ++i)
+            {
+                const Proxy& p = mProxies[i];
+                if (!(p.layerMask & layerMask)) continue;
+
+                float t;
+                if (SlabTest(origin, invDir, maxT, p.bounds.min, p.bounds.max, t))
+                    maxT = fn(p, maxT);
+            }
+            continue;
+        }
+
+        float tL, tR;
+        bool hitL = SlabTest(origin, invDir, maxT, mNodes[node.left].min, mNodes[node.left].max, tL);
+        bool hitR = SlabTest(origin, invDir, maxT, mNodes[node.right].min, mNodes[node.right].max, tR);
+
+        if (sp + 2 > MaxStackDepth) continue;
+
+        // Push the farther child first so the nearer one is popped next.
+        if (hitL && hitR)
+        {
+            bool leftFirst = tL <= tR;
+            stack[sp] = leftFirst ? node.right : node.left;
+            stackT[sp++] = leftFirst ? tR : tL;
+            stack[sp] = leftFirst ? node.left : node.right;
+            stackT[sp++] = leftFirst ? tL : tR;
+        }
+        else if (hitL)
+        {
+            stack[sp] = node.left;
+            stackT[sp++] = tL;
+        }
+        else if (hitR)
+        {
+            stack[sp] = node.right;
+            stackT[sp++] = tR;
+        }
+    }
+}
+
+template<typename Fn>
+void Broadphase::QueryRayPacket(RayPacket& packet, UINT layerMask, Fn&& fn) const
+{
+    if (mNodes.empty() || packet.activeMask == 0) return;
+
+    UINT stack[MaxStackDepth];
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0)
+    {
+        const Node& node = mNodes[stack[--sp]];
+
+        UINT lanes = SlabTest4(packet, node.min, node.max) & packet.activeMask;
+        if (lanes == 0) continue;
+
+        if (node.count > 0)
+        {
+            for (UINT i = node.first; i < node.first + node.count; ++i)
+            {
+                const Proxy& p = mProxies[i];
+                if (!(p.layerMask & layerMask)) continue;
+
+                UINT proxyLanes = SlabTest4(packet, p.bounds.min, p.bounds.max) & packet.activeMask;
+                if (proxyLanes)
+                    fn(p, proxyLanes);
+            }
+            continue;
+        }
+
+        if (sp + 2 <= MaxStackDepth)
+        {
+            stack[sp++] = node.right;
+            stack[sp++] = node.left;
+        }
+    }
+}
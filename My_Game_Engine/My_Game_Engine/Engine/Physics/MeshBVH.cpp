@@ -0,0 +1,156 @@
+#include "MeshBVH.h"
+
+void MeshBVH::Build(const std::vector<XMFLOAT3>& positions, const std::vector<UINT>& triangleIndices)
+{
+    mNodes.clear();
+    mVertices = positions;
+    mTriIndices.clear();
+    mRoot = 0;
+
+    const UINT triCount = static_cast<UINT>(triangleIndices.size() / 3);
+    if (triCount == 0 || positions.empty()) return;
+
+    std::vector<BuildTri> tris;
+    tris.reserve(triCount);
+
+    for (UINT t = 0; t < triCount; ++t)
+    {
+        UINT i0 = triangleIndices[t * 3 + 0];
+        UINT i1 = triangleIndices[t * 3 + 1];
+        UINT i2 = triangleIndices[t * 3 + 2];
+        if (i0 >= positions.size() || i1 >= positions.size() || i2 >= positions.size()) continue;
+
+        XMVECTOR a = XMLoadFloat3(&positions[i0]);
+        XMVECTOR b = XMLoadFloat3(&positions[i1]);
+        XMVECTOR c = XMLoadFloat3(&positions[i2]);
+
+        BuildTri bt;
+        XMStoreFloat3(&bt.min, XMVectorMin(a, XMVectorMin(b, c)));
+        XMStoreFloat3(&bt.max, XMVectorMax(a, XMVectorMax(b, c)));
+        XMStoreFloat3(&bt.centroid, XMVectorScale(XMVectorAdd(a, XMVectorAdd(b, c)), 1.0f / 3.0f));
+        bt.index = t;
+        tris.push_back(bt);
+    }
+
+    if (tris.empty()) return;
+
+    XMVECTOR bMin = XMVectorReplicate(FLT_MAX);
+    XMVECTOR bMax = XMVectorReplicate(-FLT_MAX);
+    for (const auto& bt : tris)
+    {
+        bMin = XMVectorMin(bMin, XMLoadFloat3(&bt.min));
+        bMax = XMVectorMax(bMax, XMLoadFloat3(&bt.max));
+    }
+    XMStoreFloat3(&mBoundsMin, bMin);
+    XMStoreFloat3(&mBoundsMax, bMax);
+
+    XMFLOAT3 extent;
+    XMStoreFloat3(&extent, XMVectorSubtract(bMax, bMin));
+    mQuantScale = {
+        65535.0f / std::max(extent.x, 1e-6f),
+        65535.0f / std::max(extent.y, 1e-6f),
+        65535.0f / std::max(extent.z, 1e-6f)
+    };
+    mDequantScale = { 1.0f / mQuantScale.x, 1.0f / mQuantScale.y, 1.0f / mQuantScale.z };
+
+    mNodes.reserve(tris.size() / MaxLeafTriangles * 2 + 1);
+
+    XMFLOAT3 rootMin, rootMax;
+    mRoot = BuildRecursive(tris, 0, static_cast<UINT>(tris.size()), rootMin, rootMax);
+
+    mTriIndices.resize(tris.size() * 3);
+    for (size_t i = 0; i < tris.size(); ++i)
+    {
+        UINT src = tris[i].index;
+        mTriIndices[i * 3 + 0] = triangleIndices[src * 3 + 0];
+        mTriIndices[i * 3 + 1] = triangleIndices[src * 3 + 1];
+        mTriIndices[i * 3 + 2] = triangleIndices[src * 3 + 2];
+    }
+
+    mNodes.shrink_to_fit();
+}
+
+uint32_t MeshBVH::BuildRecursive(std::vector<BuildTri>& tris, UINT begin, UINT end, XMFLOAT3& outMin, XMFLOAT3& outMax)
+{
+    XMVECTOR bMin = XMVectorReplicate(FLT_MAX);
+    XMVECTOR bMax = XMVectorReplicate(-FLT_MAX);
+    XMVECTOR cMin = XMVectorReplicate(FLT_MAX);
+    XMVECTOR cMax = XMVectorReplicate(-FLT_MAX);
+
+    for (UINT i = begin; i < end; ++i)
+    {
+        bMin = XMVectorMin(bMin, XMLoadFloat3(&tris[i].min));
+        bMax = XMVectorMax(bMax, XMLoadFloat3(&tris[i].max));
+
+        XMVECTOR centroid = XMLoadFloat3(&tris[i].centroid);
+        cMin = XMVectorMin(cMin, centroid);
+        cMax = XMVectorMax(cMax, centroid);
+    }
+    XMStoreFloat3(&outMin, bMin);
+    XMStoreFloat3(&outMax, bMax);
+
+    const UINT count = end - begin;
+    if (count <= MaxLeafTriangles)
+        return LeafFlag | (begin << 4) | (count - 1);
+
+    XMFLOAT3 spread;
+    XMStoreFloat3(&spread, XMVectorSubtract(cMax, cMin));
+
+    int axis = 0;
+    if (spread.y > spread.x) axis = 1;
+    if (spread.z > (axis == 0 ? spread.x : spread.y)) axis = 2;
+
+    const UINT mid = begin + count / 2;
+    std::nth_element(tris.begin() + begin, tris.begin() + mid, tris.begin() + end,
+        [axis](const BuildTri& a, const BuildTri& b)
+        {
+            const float* ca = &a.centroid.x;
+            const float* cb = &b.centroid.x;
+            return ca[axis] < cb[axis];
+        });
+
+    const UINT nodeIndex = static_cast<UINT>(mNodes.size());
+    mNodes.emplace_back();
+
+    XMFLOAT3 lMin, lMax, rMin, rMax;
+    uint32_t left = BuildRecursive(tris, begin, mid, lMin, lMax);
+    uint32_t right = BuildRecursive(tris, mid, end, rMin, rMax);
+
+    Node& node = mNodes[nodeIndex];
+    QuantizeMin(lMin, node.childMin[0]);
+    QuantizeMax(lMax, node.childMax[0]);
+    QuantizeMin(rMin, node.childMin[1]);
+    QuantizeMax(rMax, node.childMax[1]);
+    node.child[0] = left;
+    node.child[1] = right;
+
+    return nodeIndex;
+}
+
+void MeshBVH::QuantizeMin(const XMFLOAT3& p, uint16_t out[3]) const
+{
+    out[0] = static_cast<uint16_t>(std::clamp(floorf((p.x - mBoundsMin.x) * mQuantScale.x), 0.0f, 65535.0f));
+    out[1] = static_cast<uint16_t>(std::clamp(floorf((p.y - mBoundsMin.y) * mQuantScale.y), 0.0f, 65535.0f));
+    out[2] = static_cast<uint16_t>(std::clamp(floorf((p.z - mBoundsMin.z) * mQuantScale.z), 0.0f, 65535.0f));
+}
+
+void MeshBVH::QuantizeMax(const XMFLOAT3& p, uint16_t out[3]) const
+{
+    out[0] = static_cast<uint16_t>(std::clamp(ceilf((p.x - mBoundsMin.x) * mQuantScale.x), 0.0f, 65535.0f));
+    out[1] = static_cast<uint16_t>(std::clamp(ceilf((p.y - mBoundsMin.y) * mQuantScale.y), 0.0f, 65535.0f));
+    out[2] = static_cast<uint16_t>(std::clamp(ceilf((p.z - mBoundsMin.z) * mQuantScale.z), 0.0f, 65535.0f));
+}
+
+void MeshBVH::GetTriangle(UINT tri, XMFLOAT3& a, XMFLOAT3& b, XMFLOAT3& c) const
+{
+    a = mVertices[mTriIndices[tri * 3 + 0]];
+    b = mVertices[mTriIndices[tri * 3 + 1]];
+    c = mVertices[mTriIndices[tri * 3 + 2]];
+}
+
+size_t MeshBVH::GetMemorySize() const
+{
+    return mNodes.capacity() * sizeof(Node)
+        + mVertices.capacity() * sizeof(XMFLOAT3)
+        + mTriIndices.capacity() * sizeof(UINT);
+}
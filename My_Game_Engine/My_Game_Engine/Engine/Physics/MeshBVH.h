@@ -0,0 +1,216 @@
+#pragma once
+
+// Static triangle BVH used by mesh colliders. Built once per Mesh and shared by every collider that references it.
+class MeshBVH
+{
+public:
+    // Each node stores the quantized bounds of both children so one fetch decides the whole descent.
+    struct Node
+    {
+        uint16_t childMin[2][3];
+        uint16_t childMax[2][3];
+        uint32_t child[2];
+    };
+    static_assert(sizeof(Node) == 32, "MeshBVH::Node must stay 32 bytes");
+
+    static constexpr uint32_t LeafFlag = 0x80000000u;
+    static constexpr uint32_t MaxLeafTriangles = 4;
+    static constexpr int MaxStackDepth = 64;
+
+public:
+    MeshBVH() = default;
+    ~MeshBVH() = default;
+
+    void Build(const std::vector<XMFLOAT3>& positions, const std::vector<UINT>& triangleIndices);
+
+    template<typename Fn>
+    void ForEachTriangle(const XMFLOAT3& localMin, const XMFLOAT3& localMax, Fn&& fn) const;
+
+    // Local-space ray. fn(triIndex, maxT) returns the new maxT so farther nodes are culled.
+    template<typename Fn>
+    void ForEachTriangleOnRay(const XMFLOAT3& origin, const XMFLOAT3& dir, float maxT, Fn&& fn) const;
+
+    void GetTriangle(UINT tri, XMFLOAT3& a, XMFLOAT3& b, XMFLOAT3& c) const;
+
+    const XMFLOAT3& GetBoundsMin() const { return mBoundsMin; }
+    const XMFLOAT3& GetBoundsMax() const { return mBoundsMax; }
+
+    UINT GetTriangleCount() const { return static_cast<UINT>(mTriIndices.size() / 3); }
+    UINT GetNodeCount() const { return static_cast<UINT>(mNodes.size()); }
+    size_t GetMemorySize() const;
+
+    bool IsEmpty() const { return mTriIndices.empty(); }
+
+private:
+    struct BuildTri
+    {
+        XMFLOAT3 min;
+        XMFLOAT3 max;
+        XMFLOAT3 centroid;
+        UINT index;
+    };
+
+    uint32_t BuildRecursive(std::vector<BuildTri>& tris, UINT begin, UINT end, XMFLOAT3& outMin, XMFLOAT3& outMax);
+
+    void QuantizeMin(const XMFLOAT3& p, uint16_t out[3]) const;
+    void QuantizeMax(const XMFLOAT3& p, uint16_t out[3]) const;
+
+    static bool Overlaps(const uint16_t aMin[3], const uint16_t aMax[3], const uint16_t bMin[3], const uint16_t bMax[3])
+    {
+        return aMin[0] <= bMax[0] && aMax[0] >= bMin[0] &&
+               aMin[1] <= bMax[1] && aMax[1] >= bMin[1] &&
+               aMin[2] <= bMax[2] && aMax[2] >= bMin[2];
+    }
+
+    bool RaySlab(const float origin[3], const float invDir[3], float maxT, const uint16_t qMin[3], const uint16_t qMax[3], float& tEnter) const
+    {
+        float t0 = 0.0f;
+        float t1 = maxT;
+        const float* bMin = &mBoundsMin.x;
+        const float* dq = &mDequantScale.x;
+
+        for (int a = 0; a < 3; ++a)
+        {
+            float lo = (bMin[a] + qMin[a] * dq[a] - origin[a]) * invDir[a];
+            float hi = (bMin[a] + qMax[a] * dq[a] - origin[a]) * invDir[a];
+            if (lo > hi) std::swap(lo, hi);
+            t0 = std::max(t0, lo);
+            t1 = std::min(t1, hi);
+        }
+
+        tEnter = t0;
+        return t0 <= t1;
+    }
+
+    static bool IsLeaf(uint32_t ref) { return (ref & LeafFlag) != 0; }
+    static UINT LeafFirst(uint32_t ref) { return (ref & ~LeafFlag) >> 4; }
+    static UINT LeafCount(uint32_t ref) { return (ref & 0xFu) + 1; }
+
+private:
+    std::vector<Node> mNodes;
+    std::vector<XMFLOAT3> mVertices;
+    std::vector<UINT> mTriIndices;
+
+    uint32_t mRoot = 0;
+
+    XMFLOAT3 mBoundsMin = { 0.0f, 0.0f, 0.0f };
+    XMFLOAT3 mBoundsMax = { 0.0f, 0.0f, 0.0f };
+    XMFLOAT3 mQuantScale = { 0.0f, 0.0f, 0.0f };
+    XMFLOAT3 mDequantScale = { 0.0f, 0.0f, 0.0f };
+};
+
+template<typename Fn>
+void MeshBVH::ForEachTriangle(const XMFLOAT3& localMin, const XMFLOAT3& localMax, Fn&& fn) const
+{
+    if (IsEmpty()) return;
+
+    if (localMin.x > mBoundsMax.x || localMax.x < mBoundsMin.x ||
+        localMin.y > mBoundsMax.y || localMax.y < mBoundsMin.y ||
+        localMin.z > mBoundsMax.z || localMax.z < mBoundsMin.z)
+        return;
+
+    uint16_t qMin[3], qMax[3];
+    QuantizeMin(localMin, qMin);
+    QuantizeMax(localMax, qMax);
+
+    auto emitLeaf = [&](uint32_t ref)
+        {
+            UINT first = LeafFirst(ref);
+            UINT count = LeafCount(ref);
+            for (UINT t = first; t < first + count; ++t)
+                fn(t);
+        };
+
+    if (IsLeaf(mRoot))
+    {
+        emitLeaf(mRoot);
+        return;
+    }
+
+    uint32_t stack[MaxStackDepth];
+    int sp = 0;
+    stack[sp++] = mRoot;
+
+    while (sp > 0)
+    {
+        const Node& node = mNodes[stack[--sp]];
+
+        for (int c = 0; c < 2; ++c)
+        {
+            if (!Overlaps(node.childMin[c], node.childMax[c], qMin, qMax))
+                continue;
+
+            if (IsLeaf(node.child[c]))
+                emitLeaf(node.child[c]);
+            else if (sp < MaxStackDepth)
+                stack[sp++] = node.child[c];
+        }
+    }
+}
+
+template<typename Fn>
+void MeshBVH::ForEachTriangleOnRay(const XMFLOAT3& origin, const XMFLOAT3& dir, float maxT, Fn&& fn) const
+{
+    if (IsEmpty()) return;
+
+    const float o[3] = { origin.x, origin.y, origin.z };
+    float inv[3];
+    const float d[3] = { dir.x, dir.y, dir.z };
+    for (int a = 0; a < 3; ++a)
+        inv[a] = 1.0f / ((fabsf(d[a]) < 1e-12f) ? ((d[a] < 0.0f) ? -1e-12f : 1e-12f) : d[a]);
+
+    auto emitLeaf = [&](uint32_t ref)
+        {
+            UINT first = LeafFirst(ref);
+            UINT count = LeafCount(ref);
+            for (UINT t = first; t < first + count; ++t)
+                maxT = fn(t, maxT);
+        };
+
+    if (IsLeaf(mRoot))
+    {
+        emitLeaf(mRoot);
+        return;
+    }
+
+    uint32_t stack[MaxStackDepth];
+    float stackT[MaxStackDepth];
+    int sp = 0;
+    stack[sp] = mRoot;
+    stackT[sp++] = 0.0f;
+
+    while (sp > 0)
+    {
+        --sp;
+        if (stackT[sp] > maxT) continue;
+
+        const Node& node = mNodes[stack[sp]];
+
+        float tc[2];
+        bool hit[2];
+        for (int c = 0; c < 2; ++c)
+            hit[c] = RaySlab(o, inv, maxT, node.childMin[c], node.childMax[c], tc[c]);
+
+        // Visit the nearer child first; leaves are handled immediately, inner nodes go on the stack far-first.
+        int order[2] = { 0, 1 };
+        if (hit[0] && hit[1] && tc[1] < tc[0]) std::swap(order[0], order[1]);
+
+        for (int k = 1; k >= 0; --k)
+        {
+            int c = order[k];
+            if (!hit[c] || IsLeaf(node.child[c])) continue;
+            if (sp < MaxStackDepth)
+            {
+                stack[sp] = node.child[c];
+                stackT[sp++] = tc[c];
+            }
+        }
+
+        for (int k = 0; k < 2; ++k)
+        {
+            int c = order[k];
+            if (hit[c] && IsLeaf(node.child[c]) && tc[c] <= maxT)
+                emitLeaf(node.child[c]);
+        }
+    }
+}
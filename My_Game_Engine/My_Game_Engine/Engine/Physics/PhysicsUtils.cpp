@@ -0,0 +1,1214 @@
+#include "PhysicsUtils.h"
+#include "Components/TransformComponent.h"
+#include "Components/ColliderComponent.h"
+#include "Components/TerrainComponent.h"
+#include "MeshBVH.h"
+
+namespace PhysicsUtils
+{
+    static constexpr float kEpsilon = 1e-6f;
+
+    static bool ContactFromPoints(FXMVECTOR pointA, FXMVECTOR pointB, float radiusSum, Contact& out)
+    {
+        XMVECTOR d = XMVectorSubtract(pointA, pointB);
+        float distSq = XMVectorGetX(XMVector3LengthSq(d));
+
+        if (distSq >= radiusSum * radiusSum)
+            return false;
+
+        float dist = sqrtf(distSq);
+        if (dist > 0.0001f)
+        {
+            XMStoreFloat3(&out.normal, XMVectorScale(d, 1.0f / dist));
+        }
+        else
+        {
+            out.normal = { 0.0f, 1.0f, 0.0f };
+        }
+        out.penetration = radiusSum - dist;
+        return true;
+    }
+
+    AABB GetAABB(TransformComponent* tf, ColliderComponent* col)
+    {
+        XMFLOAT3 pos = tf->GetPosition();
+        XMFLOAT3 center = col->GetCenter();
+
+        XMFLOAT3 worldCenter = { pos.x + center.x, pos.y + center.y, pos.z + center.z };
+
+        switch (col->GetColliderType())
+        {
+        case Collider_Type::Sphere:
+        {
+            float r = col->GetRadius();
+            return {
+                { worldCenter.x - r, worldCenter.y - r, worldCenter.z - r },
+                { worldCenter.x + r, worldCenter.y + r, worldCenter.z + r }
+            };
+        }
+        case Collider_Type::Capsule:
+        {
+            Capsule cap = GetCapsule(tf, col);
+            XMVECTOR r = XMVectorReplicate(cap.radius);
+            XMVECTOR p0 = XMLoadFloat3(&cap.p0);
+            XMVECTOR p1 = XMLoadFloat3(&cap.p1);
+
+            AABB box;
+            XMStoreFloat3(&box.min, XMVectorSubtract(XMVectorMin(p0, p1), r));
+            XMStoreFloat3(&box.max, XMVectorAdd(XMVectorMax(p0, p1), r));
+            return box;
+        }
+        case Collider_Type::Mesh:
+        {
+            auto bvh = col->GetMeshBVH();
+            if (!bvh || bvh->IsEmpty()) break;
+            return TransformAABB({ bvh->GetBoundsMin(), bvh->GetBoundsMax() }, tf->GetWorldMatrix());
+        }
+        default:
+            break;
+        }
+
+        XMFLOAT3 size = col->GetSize();
+        XMFLOAT3 scale = tf->GetScale();
+
+        XMFLOAT3 extent = {
+            (size.x * scale.x) * 0.5f,
+            (size.y * scale.y) * 0.5f,
+            (size.z * scale.z) * 0.5f
+        };
+
+        return {
+            { worldCenter.x - extent.x, worldCenter.y - extent.y, worldCenter.z - extent.z },
+            { worldCenter.x + extent.x, worldCenter.y + extent.y, worldCenter.z + extent.z }
+        };
+    }
+
+    Capsule GetCapsule(TransformComponent* tf, ColliderComponent* col)
+    {
+        XMFLOAT3 pos = tf->GetPosition();
+        XMFLOAT3 center = col->GetCenter();
+
+        XMVECTOR c = XMVectorAdd(XMLoadFloat3(&pos), XMLoadFloat3(&center));
+        XMVECTOR axis = XMVector3Rotate(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), XMLoadFloat4(&tf->GetRotationQuaternion()));
+
+        float radius = col->GetRadius();
+        float halfSegment = std::max(0.0f, col->GetHeight() * 0.5f - radius);
+        XMVECTOR offset = XMVectorScale(axis, halfSegment);
+
+        Capsule cap;
+        XMStoreFloat3(&cap.p0, XMVectorSubtract(c, offset));
+        XMStoreFloat3(&cap.p1, XMVectorAdd(c, offset));
+        cap.radius = radius;
+        return cap;
+    }
+
+    bool Overlaps(const AABB& a, const AABB& b)
+    {
+        XMVECTOR minA = XMLoadFloat3(&a.min);
+        XMVECTOR maxA = XMLoadFloat3(&a.max);
+        XMVECTOR minB = XMLoadFloat3(&b.min);
+        XMVECTOR maxB = XMLoadFloat3(&b.max);
+
+        return XMVector3Greater(maxA, minB) && XMVector3Less(minA, maxB);
+    }
+
+    XMVECTOR ClosestPointOnSegment(FXMVECTOR p, FXMVECTOR a, FXMVECTOR b)
+    {
+        XMVECTOR ab = XMVectorSubtract(b, a);
+        float lenSq = XMVectorGetX(XMVector3LengthSq(ab));
+        if (lenSq <= kEpsilon)
+            return a;
+
+        float t = XMVectorGetX(XMVector3Dot(XMVectorSubtract(p, a), ab)) / lenSq;
+        t = std::clamp(t, 0.0f, 1.0f);
+        return XMVectorMultiplyAdd(ab, XMVectorReplicate(t), a);
+    }
+
+    void ClosestPointsSegmentSegment(FXMVECTOR p0, FXMVECTOR p1, FXMVECTOR q0, GXMVECTOR q1, XMVECTOR& outP, XMVECTOR& outQ)
+    {
+        XMVECTOR d1 = XMVectorSubtract(p1, p0);
+        XMVECTOR d2 = XMVectorSubtract(q1, q0);
+        XMVECTOR r = XMVectorSubtract(p0, q0);
+
+        float a = XMVectorGetX(XMVector3Dot(d1, d1));
+        float e = XMVectorGetX(XMVector3Dot(d2, d2));
+        float f = XMVectorGetX(XMVector3Dot(d2, r));
+
+        float s = 0.0f;
+        float t = 0.0f;
+
+        if (a <= kEpsilon && e <= kEpsilon)
+        {
+            outP = p0;
+            outQ = q0;
+            return;
+        }
+
+        if (a <= kEpsilon)
+        {
+            t = std::clamp(f / e, 0.0f, 1.0f);
+        }
+        else
+        {
+            float c = XMVectorGetX(XMVector3Dot(d1, r));
+            if (e <= kEpsilon)
+            {
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            }
+            else
+            {
+                float b = XMVectorGetX(XMVector3Dot(d1, d2));
+                float denom = a * e - b * b;
+
+                s = (denom > kEpsilon) ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+                t = (b * s + f) / e;
+
+                if (t < 0.0f)
+                {
+                    t = 0.0f;
+                    s = std::clamp(-c / a, 0.0f, 1.0f);
+                }
+                else if (t > 1.0f)
+                {
+                    t = 1.0f;
+                    s = std::clamp((b - c) / a, 0.0f, 1.0f);
+                }
+            }
+        }
+
+        outP = XMVectorMultiplyAdd(d1, XMVectorReplicate(s), p0);
+        outQ = XMVectorMultiplyAdd(d2, XMVectorReplicate(t), q0);
+    }
+
+    bool CapsuleCapsule(const Capsule& a, const Capsule& b, Contact& out)
+    {
+        XMVECTOR pA, pB;
+        ClosestPointsSegmentSegment(
+            XMLoadFloat3(&a.p0), XMLoadFloat3(&a.p1),
+            XMLoadFloat3(&b.p0), XMLoadFloat3(&b.p1),
+            pA, pB);
+
+        return ContactFromPoints(pA, pB, a.radius + b.radius, out);
+    }
+
+    bool CapsuleSphere(const Capsule& a, const XMFLOAT3& center, float radius, Contact& out)
+    {
+        XMVECTOR c = XMLoadFloat3(&center);
+        XMVECTOR pA = ClosestPointOnSegment(c, XMLoadFloat3(&a.p0), XMLoadFloat3(&a.p1));
+
+        return ContactFromPoints(pA, c, a.radius + radius, out);
+    }
+
+    bool CapsuleBox(const Capsule& a, const AABB& box, Contact& out)
+    {
+        XMVECTOR s0 = XMLoadFloat3(&a.p0);
+        XMVECTOR s1 = XMLoadFloat3(&a.p1);
+        XMVECTOR bMin = XMLoadFloat3(&box.min);
+        XMVECTOR bMax = XMLoadFloat3(&box.max);
+
+        // Alternating projection between the segment and the box converges to the closest pair.
+        XMVECTOR boxCenter = XMVectorScale(XMVectorAdd(bMin, bMax), 0.5f);
+        XMVECTOR p = ClosestPointOnSegment(boxCenter, s0, s1);
+        XMVECTOR q = XMVectorClamp(p, bMin, bMax);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            p = ClosestPointOnSegment(q, s0, s1);
+            XMVECTOR next = XMVectorClamp(p, bMin, bMax);
+
+            bool converged = XMVector3NearEqual(next, q, XMVectorReplicate(0.0001f));
+            q = next;
+            if (converged) break;
+        }
+
+        XMVECTOR d = XMVectorSubtract(p, q);
+        float distSq = XMVectorGetX(XMVector3LengthSq(d));
+
+        if (distSq >= a.radius * a.radius)
+            return false;
+
+        if (distSq > 0.0001f * 0.0001f)
+        {
+            float dist = sqrtf(distSq);
+            XMStoreFloat3(&out.normal, XMVectorScale(d, 1.0f / dist));
+            out.penetration = a.radius - dist;
+            return true;
+        }
+
+        // Segment passes through the box: push out through the nearest face.
+        XMFLOAT3 toMin, toMax;
+        XMStoreFloat3(&toMin, XMVectorSubtract(p, bMin));
+        XMStoreFloat3(&toMax, XMVectorSubtract(bMax, p));
+
+        const float faceDist[6] = { toMin.x, toMax.x, toMin.y, toMax.y, toMin.z, toMax.z };
+        const XMFLOAT3 faceNormal[6] = {
+            { -1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f },
+            { 0.0f, -1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+            { 0.0f, 0.0f, -1.0f }, { 0.0f, 0.0f, 1.0f },
+        };
+
+        int best = 0;
+        for (int i = 1; i < 6; ++i)
+        {
+            if (faceDist[i] < faceDist[best]) best = i;
+        }
+
+        out.normal = faceNormal[best];
+        out.penetration = faceDist[best] + a.radius;
+        return true;
+    }
+
+    bool CapsuleHeightField(const Capsule& a, TerrainComponent* terrain, Contact& out)
+    {
+        if (!terrain) return false;
+
+        bool hit = false;
+        const XMFLOAT3 caps[2] = { a.p0, a.p1 };
+
+        for (const XMFLOAT3& c : caps)
+        {
+            float h;
+            XMFLOAT3 n;
+            if (!terrain->GetHeightAndNormal(c, h, n)) continue;
+
+            // Distance from the cap center to the tangent plane at (c.x, h, c.z).
+            float dist = (c.y - h) * n.y;
+            float penetration = a.radius - dist;
+
+            if (penetration > 0.0f && (!hit || penetration > out.penetration))
+            {
+                out.normal = n;
+                out.penetration = penetration;
+                hit = true;
+            }
+        }
+
+        return hit;
+    }
+
+    XMVECTOR ClosestPointOnTriangle(FXMVECTOR p, FXMVECTOR a, FXMVECTOR b, GXMVECTOR c)
+    {
+        XMVECTOR ab = XMVectorSubtract(b, a);
+        XMVECTOR ac = XMVectorSubtract(c, a);
+        XMVECTOR ap = XMVectorSubtract(p, a);
+
+        float d1 = XMVectorGetX(XMVector3Dot(ab, ap));
+        float d2 = XMVectorGetX(XMVector3Dot(ac, ap));
+        if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+        XMVECTOR bp = XMVectorSubtract(p, b);
+        float d3 = XMVectorGetX(XMVector3Dot(ab, bp));
+        float d4 = XMVectorGetX(XMVector3Dot(ac, bp));
+        if (d3 >= 0.0f && d4 <= d3) return b;
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+            return XMVectorMultiplyAdd(ab, XMVectorReplicate(d1 / (d1 - d3)), a);
+
+        XMVECTOR cp = XMVectorSubtract(p, c);
+        float d5 = XMVectorGetX(XMVector3Dot(ab, cp));
+        float d6 = XMVectorGetX(XMVector3Dot(ac, cp));
+        if (d6 >= 0.0f && d5 <= d6) return c;
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+            return XMVectorMultiplyAdd(ac, XMVectorReplicate(d2 / (d2 - d6)), a);
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        {
+            float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            return XMVectorMultiplyAdd(XMVectorSubtract(c, b), XMVectorReplicate(w), b);
+        }
+
+        float denom = 1.0f / (va + vb + vc);
+        float v = vb * denom;
+        float w = vc * denom;
+        return XMVectorAdd(a, XMVectorAdd(XMVectorScale(ab, v), XMVectorScale(ac, w)));
+    }
+
+    static XMVECTOR TriangleNormal(FXMVECTOR a, FXMVECTOR b, FXMVECTOR c)
+    {
+        XMVECTOR n = XMVector3Cross(XMVectorSubtract(b, a), XMVectorSubtract(c, a));
+        if (XMVectorGetX(XMVector3LengthSq(n)) <= kEpsilon * kEpsilon)
+            return XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+        return XMVector3Normalize(n);
+    }
+
+    bool SphereTriangle(const XMFLOAT3& center, float radius, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, Contact& out)
+    {
+        XMVECTOR p = XMLoadFloat3(&center);
+        XMVECTOR q = ClosestPointOnTriangle(p, a, b, c);
+
+        if (!ContactFromPoints(p, q, radius, out))
+            return false;
+
+        // Center lies on the triangle: no separating direction, use the face normal.
+        if (out.penetration >= radius - 0.0001f)
+            XMStoreFloat3(&out.normal, TriangleNormal(a, b, c));
+
+        return true;
+    }
+
+    bool CapsuleTriangle(const Capsule& cap, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, Contact& out)
+    {
+        XMVECTOR s0 = XMLoadFloat3(&cap.p0);
+        XMVECTOR s1 = XMLoadFloat3(&cap.p1);
+        XMVECTOR n = TriangleNormal(a, b, c);
+
+        float d0 = XMVectorGetX(XMVector3Dot(XMVectorSubtract(s0, a), n));
+        float d1 = XMVectorGetX(XMVector3Dot(XMVectorSubtract(s1, a), n));
+
+        // Segment pierces the plane inside the triangle: leave through whichever side is shallower.
+        if (d0 * d1 < 0.0f)
+        {
+            float t = d0 / (d0 - d1);
+            XMVECTOR hit = XMVectorLerp(s0, s1, t);
+            XMVECTOR onTri = ClosestPointOnTriangle(hit, a, b, c);
+
+            if (XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(hit, onTri))) <= kEpsilon)
+            {
+                float up = cap.radius - std::min(d0, d1);
+                float down = cap.radius + std::max(d0, d1);
+
+                if (up <= down)
+                {
+                    XMStoreFloat3(&out.normal, n);
+                    out.penetration = up;
+                }
+                else
+                {
+                    XMStoreFloat3(&out.normal, XMVectorNegate(n));
+                    out.penetration = down;
+                }
+                return true;
+            }
+        }
+
+        // Otherwise the closest pair is an endpoint against the face or the segment against an edge.
+        XMVECTOR bestP = s0;
+        XMVECTOR bestQ = ClosestPointOnTriangle(s0, a, b, c);
+        float bestDistSq = XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(bestP, bestQ)));
+
+        auto consider = [&](FXMVECTOR p, FXMVECTOR q)
+            {
+                float distSq = XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(p, q)));
+                if (distSq < bestDistSq)
+                {
+                    bestDistSq = distSq;
+                    bestP = p;
+                    bestQ = q;
+                }
+            };
+
+        consider(s1, ClosestPointOnTriangle(s1, a, b, c));
+
+        const XMVECTOR edges[3][2] = { { a, b }, { b, c }, { c, a } };
+        for (const auto& e : edges)
+        {
+            XMVECTOR p, q;
+            ClosestPointsSegmentSegment(s0, s1, e[0], e[1], p, q);
+            consider(p, q);
+        }
+
+        if (!ContactFromPoints(bestP, bestQ, cap.radius, out))
+            return false;
+
+        if (out.penetration >= cap.radius - 0.0001f)
+            XMStoreFloat3(&out.normal, (d0 + d1 >= 0.0f) ? n : XMVectorNegate(n));
+
+        return true;
+    }
+
+    bool BoxTriangle(const AABB& box, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, Contact& out)
+    {
+        XMVECTOR bMin = XMLoadFloat3(&box.min);
+        XMVECTOR bMax = XMLoadFloat3(&box.max);
+        XMVECTOR center = XMVectorScale(XMVectorAdd(bMin, bMax), 0.5f);
+
+        XMFLOAT3 e;
+        XMStoreFloat3(&e, XMVectorScale(XMVectorSubtract(bMax, bMin), 0.5f));
+
+        // Work relative to the box center so the box interval on any axis is [-r, r].
+        XMVECTOR v[3] = { XMVectorSubtract(a, center), XMVectorSubtract(b, center), XMVectorSubtract(c, center) };
+        XMVECTOR f[3] = { XMVectorSubtract(v[1], v[0]), XMVectorSubtract(v[2], v[1]), XMVectorSubtract(v[0], v[2]) };
+
+        XMVECTOR axes[13];
+        int axisCount = 0;
+
+        axes[axisCount++] = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+        axes[axisCount++] = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+        axes[axisCount++] = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+        axes[axisCount++] = XMVector3Cross(f[0], f[1]);
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+                axes[axisCount++] = XMVector3Cross(axes[i], f[j]);
+        }
+
+        float bestDepth = FLT_MAX;
+        XMVECTOR bestAxis = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+
+        for (int i = 0; i < axisCount; ++i)
+        {
+            float lenSq = XMVectorGetX(XMVector3LengthSq(axes[i]));
+            if (lenSq <= kEpsilon) continue;
+
+            XMVECTOR L = XMVectorScale(axes[i], 1.0f / sqrtf(lenSq));
+            XMFLOAT3 l;
+            XMStoreFloat3(&l, L);
+
+            float p0 = XMVectorGetX(XMVector3Dot(v[0], L));
+            float p1 = XMVectorGetX(XMVector3Dot(v[1], L));
+            float p2 = XMVectorGetX(XMVector3Dot(v[2], L));
+
+            float triMin = std::min({ p0, p1, p2 });
+            float triMax = std::max({ p0, p1, p2 });
+            float r = e.x * fabsf(l.x) + e.y * fabsf(l.y) + e.z * fabsf(l.z);
+
+            if (triMin > r || triMax < -r)
+                return false;
+
+            // Moving the box along +L clears triMax, along -L clears triMin.
+            float pushPos = triMax + r;
+            float pushNeg = r - triMin;
+
+            if (pushPos < bestDepth)
+            {
+                bestDepth = pushPos;
+                bestAxis = L;
+            }
+            if (pushNeg < bestDepth)
+            {
+                bestDepth = pushNeg;
+                bestAxis = XMVectorNegate(L);
+            }
+        }
+
+        XMStoreFloat3(&out.normal, bestAxis);
+        out.penetration = bestDepth;
+        return true;
+    }
+
+    AABB TransformAABB(const AABB& local, const XMFLOAT4X4& world)
+    {
+        XMVECTOR mn = XMLoadFloat3(&local.min);
+        XMVECTOR mx = XMLoadFloat3(&local.max);
+        XMVECTOR center = XMVector3TransformCoord(XMVectorScale(XMVectorAdd(mn, mx), 0.5f), XMLoadFloat4x4(&world));
+
+        XMFLOAT3 e;
+        XMStoreFloat3(&e, XMVectorScale(XMVectorSubtract(mx, mn), 0.5f));
+
+        const auto& m = world.m;
+        XMVECTOR extent = XMVectorSet(
+            fabsf(m[0][0]) * e.x + fabsf(m[1][0]) * e.y + fabsf(m[2][0]) * e.z,
+            fabsf(m[0][1]) * e.x + fabsf(m[1][1]) * e.y + fabsf(m[2][1]) * e.z,
+            fabsf(m[0][2]) * e.x + fabsf(m[1][2]) * e.y + fabsf(m[2][2]) * e.z,
+            0.0f);
+
+        AABB box;
+        XMStoreFloat3(&box.min, XMVectorSubtract(center, extent));
+        XMStoreFloat3(&box.max, XMVectorAdd(center, extent));
+        return box;
+    }
+
+    template<typename TriTest>
+    static bool QueryMesh(const AABB& worldQuery, const MeshBVH& bvh, const XMFLOAT4X4& world, Contact& out, TriTest&& test)
+    {
+        XMMATRIX W = XMLoadFloat4x4(&world);
+        XMVECTOR det;
+        XMMATRIX invW = XMMatrixInverse(&det, W);
+        if (fabsf(XMVectorGetX(det)) <= kEpsilon)
+            return false;
+
+        XMFLOAT4X4 inv;
+        XMStoreFloat4x4(&inv, invW);
+        AABB localQuery = TransformAABB(worldQuery, inv);
+
+        bool hit = false;
+        bvh.ForEachTriangle(localQuery.min, localQuery.max, [&](UINT tri)
+            {
+                XMFLOAT3 la, lb, lc;
+                bvh.GetTriangle(tri, la, lb, lc);
+
+                XMVECTOR a = XMVector3TransformCoord(XMLoadFloat3(&la), W);
+                XMVECTOR b = XMVector3TransformCoord(XMLoadFloat3(&lb), W);
+                XMVECTOR c = XMVector3TransformCoord(XMLoadFloat3(&lc), W);
+
+                Contact contact;
+                if (test(a, b, c, contact) && (!hit || contact.penetration > out.penetration))
+                {
+                    out = contact;
+                    hit = true;
+                }
+            });
+
+        return hit;
+    }
+
+    bool SphereMesh(const XMFLOAT3& center, float radius, const MeshBVH& bvh, const XMFLOAT4X4& world, Contact& out)
+    {
+        AABB query = {
+            { center.x - radius, center.y - radius, center.z - radius },
+            { center.x + radius, center.y + radius, center.z + radius }
+        };
+
+        return QueryMesh(query, bvh, world, out, [&](FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, Contact& contact)
+            {
+                return SphereTriangle(center, radius, a, b, c, contact);
+            });
+    }
+
+    bool CapsuleMesh(const Capsule& cap, const MeshBVH& bvh, const XMFLOAT4X4& world, Contact& out)
+    {
+        XMVECTOR r = XMVectorReplicate(cap.radius);
+        XMVECTOR p0 = XMLoadFloat3(&cap.p0);
+        XMVECTOR p1 = XMLoadFloat3(&cap.p1);
+
+        AABB query;
+        XMStoreFloat3(&query.min, XMVectorSubtract(XMVectorMin(p0, p1), r));
+        XMStoreFloat3(&query.max, XMVectorAdd(XMVectorMax(p0, p1), r));
+
+        return QueryMesh(query, bvh, world, out, [&](FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, Contact& contact)
+            {
+                return CapsuleTriangle(cap, a, b, c, contact);
+            });
+    }
+
+    bool BoxMesh(const AABB& box, const MeshBVH& bvh, const XMFLOAT4X4& world, Contact& out)
+    {
+        return QueryMesh(box, bvh, world, out, [&](FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, Contact& contact)
+            {
+                return BoxTriangle(box, a, b, c, contact);
+            });
+    }
+
+    static XMFLOAT3 GetSphereCenter(TransformComponent* tf, ColliderComponent* col)
+    {
+        XMFLOAT3 pos = tf->GetPosition();
+        XMFLOAT3 center = col->GetCenter();
+        return { pos.x + center.x, pos.y + center.y, pos.z + center.z };
+    }
+
+    bool RaySphere(const XMFLOAT3& origin, const XMFLOAT3& dir, const XMFLOAT3& center, float radius, float maxT, RayHit& out)
+    {
+        XMVECTOR o = XMLoadFloat3(&origin);
+        XMVECTOR d = XMLoadFloat3(&dir);
+        XMVECTOR m = XMVectorSubtract(o, XMLoadFloat3(&center));
+
+        float a = XMVectorGetX(XMVector3Dot(d, d));
+        float b = XMVectorGetX(XMVector3Dot(m, d));
+        float c = XMVectorGetX(XMVector3Dot(m, m)) - radius * radius;
+
+        if (c <= 0.0f || a <= kEpsilon) return false;
+        if (b > 0.0f) return false;
+
+        float disc = b * b - a * c;
+        if (disc < 0.0f) return false;
+
+        float t = (-b - sqrtf(disc)) / a;
+        if (t < 0.0f || t > maxT) return false;
+
+        XMVECTOR p = XMVectorMultiplyAdd(d, XMVectorReplicate(t), o);
+        XMStoreFloat3(&out.normal, XMVector3Normalize(XMVectorSubtract(p, XMLoadFloat3(&center))));
+        out.t = t;
+        return true;
+    }
+
+    bool RayAABB(const XMFLOAT3& origin, const XMFLOAT3& dir, const AABB& box, float maxT, RayHit& out)
+    {
+        const float o[3] = { origin.x, origin.y, origin.z };
+        const float d[3] = { dir.x, dir.y, dir.z };
+        const float mn[3] = { box.min.x, box.min.y, box.min.z };
+        const float mx[3] = { box.max.x, box.max.y, box.max.z };
+
+        float tEnter = -FLT_MAX;
+        float tExit = FLT_MAX;
+        int enterAxis = -1;
+        float enterSign = 0.0f;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            if (fabsf(d[i]) < kEpsilon)
+            {
+                if (o[i] < mn[i] || o[i] > mx[i]) return false;
+                continue;
+            }
+
+            float inv = 1.0f / d[i];
+            float t0 = (mn[i] - o[i]) * inv;
+            float t1 = (mx[i] - o[i]) * inv;
+            float sign = -1.0f;
+            if (t0 > t1)
+            {
+                std::swap(t0, t1);
+                sign = 1.0f;
+            }
+
+            if (t0 > tEnter)
+            {
+                tEnter = t0;
+                enterAxis = i;
+                enterSign = sign;
+            }
+            tExit = std::min(tExit, t1);
+
+            if (tEnter > tExit) return false;
+        }
+
+        if (enterAxis < 0 || tEnter < 0.0f || tEnter > maxT) return false;
+
+        XMFLOAT3 n = { 0.0f, 0.0f, 0.0f };
+        (&n.x)[enterAxis] = enterSign;
+        out.normal = n;
+        out.t = tEnter;
+        return true;
+    }
+
+    bool RayCapsule(const XMFLOAT3& origin, const XMFLOAT3& dir, const Capsule& cap, float maxT, RayHit& out)
+    {
+        XMVECTOR o = XMLoadFloat3(&origin);
+        XMVECTOR d = XMLoadFloat3(&dir);
+        XMVECTOR p0 = XMLoadFloat3(&cap.p0);
+        XMVECTOR p1 = XMLoadFloat3(&cap.p1);
+
+        XMVECTOR axis = XMVectorSubtract(p1, p0);
+        float axisLen = XMVectorGetX(XMVector3Length(axis));
+
+        // Starting inside the capsule is not a hit.
+        XMVECTOR closest = ClosestPointOnSegment(o, p0, p1);
+        if (XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(o, closest))) <= cap.radius * cap.radius)
+            return false;
+
+        bool hit = false;
+        RayHit best;
+        best.t = maxT;
+
+        if (axisLen > kEpsilon)
+        {
+            XMVECTOR n = XMVectorScale(axis, 1.0f / axisLen);
+            XMVECTOR ao = XMVectorSubtract(o, p0);
+
+            XMVECTOR dPerp = XMVectorSubtract(d, XMVectorScale(n, XMVectorGetX(XMVector3Dot(d, n))));
+            XMVECTOR oPerp = XMVectorSubtract(ao, XMVectorScale(n, XMVectorGetX(XMVector3Dot(ao, n))));
+
+            float a = XMVectorGetX(XMVector3Dot(dPerp, dPerp));
+            float b = XMVectorGetX(XMVector3Dot(oPerp, dPerp));
+            float c = XMVectorGetX(XMVector3Dot(oPerp, oPerp)) - cap.radius * cap.radius;
+
+            float disc = b * b - a * c;
+            if (a > kEpsilon && disc >= 0.0f)
+            {
+                float t = (-b - sqrtf(disc)) / a;
+                if (t >= 0.0f && t <= best.t)
+                {
+                    float s = XMVectorGetX(XMVector3Dot(XMVectorMultiplyAdd(d, XMVectorReplicate(t), ao), n));
+                    if (s >= 0.0f && s <= axisLen)
+                    {
+                        XMVECTOR radial = XMVectorMultiplyAdd(dPerp, XMVectorReplicate(t), oPerp);
+                        XMStoreFloat3(&best.normal, XMVector3Normalize(radial));
+                        best.t = t;
+                        hit = true;
+                    }
+                }
+            }
+        }
+
+        RayHit capHit;
+        if (RaySphere(origin, dir, cap.p0, cap.radius, best.t, capHit)) { best = capHit; hit = true; }
+        if (RaySphere(origin, dir, cap.p1, cap.radius, best.t, capHit)) { best = capHit; hit = true; }
+
+        if (hit) out = best;
+        return hit;
+    }
+
+    bool RayTriangle(const XMFLOAT3& origin, const XMFLOAT3& dir, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, float maxT, RayHit& out)
+    {
+        XMVECTOR o = XMLoadFloat3(&origin);
+        XMVECTOR d = XMLoadFloat3(&dir);
+
+        XMVECTOR e1 = XMVectorSubtract(b, a);
+        XMVECTOR e2 = XMVectorSubtract(c, a);
+        XMVECTOR p = XMVector3Cross(d, e2);
+
+        float det = XMVectorGetX(XMVector3Dot(e1, p));
+        if (fabsf(det) < 1e-12f) return false;
+
+        float invDet = 1.0f / det;
+        XMVECTOR s = XMVectorSubtract(o, a);
+
+        float u = XMVectorGetX(XMVector3Dot(s, p)) * invDet;
+        if (u < 0.0f || u > 1.0f) return false;
+
+        XMVECTOR q = XMVector3Cross(s, e1);
+        float v = XMVectorGetX(XMVector3Dot(d, q)) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return false;
+
+        float t = XMVectorGetX(XMVector3Dot(e2, q)) * invDet;
+        if (t < 0.0f || t > maxT) return false;
+
+        XMVECTOR n = TriangleNormal(a, b, c);
+        if (XMVectorGetX(XMVector3Dot(n, d)) > 0.0f) n = XMVectorNegate(n);
+
+        XMStoreFloat3(&out.normal, n);
+        out.t = t;
+        return true;
+    }
+
+    bool RayMesh(const XMFLOAT3& origin, const XMFLOAT3& dir, const MeshBVH& bvh, const XMFLOAT4X4& world, float maxT, RayHit& out)
+    {
+        XMMATRIX W = XMLoadFloat4x4(&world);
+        XMVECTOR det;
+        XMMATRIX invW = XMMatrixInverse(&det, W);
+        if (fabsf(XMVectorGetX(det)) <= kEpsilon)
+            return false;
+
+        // The direction is transformed without renormalizing so t stays in world units.
+        XMFLOAT3 localOrigin, localDir;
+        XMStoreFloat3(&localOrigin, XMVector3TransformCoord(XMLoadFloat3(&origin), invW));
+        XMStoreFloat3(&localDir, XMVector3TransformNormal(XMLoadFloat3(&dir), invW));
+
+        bool hit = false;
+        UINT bestTri = 0;
+        float bestT = maxT;
+
+        bvh.ForEachTriangleOnRay(localOrigin, localDir, maxT, [&](UINT tri, float curMaxT)
+            {
+                XMFLOAT3 a, b, c;
+                bvh.GetTriangle(tri, a, b, c);
+
+                RayHit h;
+                if (RayTriangle(localOrigin, localDir, XMLoadFloat3(&a), XMLoadFloat3(&b), XMLoadFloat3(&c), curMaxT, h))
+                {
+                    hit = true;
+                    bestTri = tri;
+                    bestT = h.t;
+                    return h.t;
+                }
+                return curMaxT;
+            });
+
+        if (!hit) return false;
+
+        XMFLOAT3 a, b, c;
+        bvh.GetTriangle(bestTri, a, b, c);
+
+        XMVECTOR n = TriangleNormal(
+            XMVector3TransformCoord(XMLoadFloat3(&a), W),
+            XMVector3TransformCoord(XMLoadFloat3(&b), W),
+            XMVector3TransformCoord(XMLoadFloat3(&c), W));
+        if (XMVectorGetX(XMVector3Dot(n, XMLoadFloat3(&dir))) > 0.0f) n = XMVectorNegate(n);
+
+        XMStoreFloat3(&out.normal, n);
+        out.t = bestT;
+        return true;
+    }
+
+    bool RayCollider(TransformComponent* tf, ColliderComponent* col, const XMFLOAT3& origin, const XMFLOAT3& dir, float maxT, RayHit& out)
+    {
+        switch (col->GetColliderType())
+        {
+        case Collider_Type::Sphere:
+            return RaySphere(origin, dir, GetSphereCenter(tf, col), col->GetRadius(), maxT, out);
+
+        case Collider_Type::Box:
+            return RayAABB(origin, dir, GetAABB(tf, col), maxT, out);
+
+        case Collider_Type::Capsule:
+            return RayCapsule(origin, dir, GetCapsule(tf, col), maxT, out);
+
+        case Collider_Type::Mesh:
+        {
+            auto bvh = col->GetMeshBVH();
+            return bvh && RayMesh(origin, dir, *bvh, tf->GetWorldMatrix(), maxT, out);
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool SphereCastAABB(const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, const AABB& box, float maxT, RayHit& out)
+    {
+        XMVECTOR o = XMLoadFloat3(&origin);
+        XMVECTOR bMin = XMLoadFloat3(&box.min);
+        XMVECTOR bMax = XMLoadFloat3(&box.max);
+
+        XMVECTOR onBox = XMVectorClamp(o, bMin, bMax);
+        if (XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(o, onBox))) <= radius * radius)
+            return false;
+
+        // Face region of the rounded box: hit the box grown by the radius.
+        AABB grown;
+        XMStoreFloat3(&grown.min, XMVectorSubtract(bMin, XMVectorReplicate(radius)));
+        XMStoreFloat3(&grown.max, XMVectorAdd(bMax, XMVectorReplicate(radius)));
+
+        RayHit faceHit;
+        if (!RayAABB(origin, dir, grown, maxT, faceHit))
+        {
+            XMVECTOR inGrown = XMVectorClamp(o, XMLoadFloat3(&grown.min), XMLoadFloat3(&grown.max));
+            if (!XMVector3Equal(inGrown, o))
+                return false;
+        }
+        else
+        {
+            XMFLOAT3 p;
+            XMStoreFloat3(&p, XMVectorMultiplyAdd(XMLoadFloat3(&dir), XMVectorReplicate(faceHit.t), o));
+
+            int outside = 0;
+            if (p.x < box.min.x || p.x > box.max.x) ++outside;
+            if (p.y < box.min.y || p.y > box.max.y) ++outside;
+            if (p.z < box.min.z || p.z > box.max.z) ++outside;
+
+            if (outside <= 1)
+            {
+                out = faceHit;
+                return true;
+            }
+        }
+
+        // Edge or corner region: the rounded box there is the union of edge capsules.
+        const XMFLOAT3& mn = box.min;
+        const XMFLOAT3& mx = box.max;
+        const XMFLOAT3 corners[8] = {
+            { mn.x, mn.y, mn.z }, { mx.x, mn.y, mn.z }, { mn.x, mx.y, mn.z }, { mx.x, mx.y, mn.z },
+            { mn.x, mn.y, mx.z }, { mx.x, mn.y, mx.z }, { mn.x, mx.y, mx.z }, { mx.x, mx.y, mx.z },
+        };
+        const int edges[12][2] = {
+            { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+            { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+            { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },
+        };
+
+        bool hit = false;
+        RayHit best;
+        best.t = maxT;
+
+        for (const auto& e : edges)
+        {
+            Capsule edge = { corners[e[0]], corners[e[1]], radius };
+            RayHit h;
+            if (RayCapsule(origin, dir, edge, best.t, h))
+            {
+                best = h;
+                hit = true;
+            }
+        }
+
+        if (hit) out = best;
+        return hit;
+    }
+
+    bool SphereCastTriangle(const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, float maxT, RayHit& out)
+    {
+        XMVECTOR o = XMLoadFloat3(&origin);
+        XMVECTOR d = XMLoadFloat3(&dir);
+        XMVECTOR n = TriangleNormal(a, b, c);
+
+        float dist0 = XMVectorGetX(XMVector3Dot(XMVectorSubtract(o, a), n));
+        if (dist0 < 0.0f)
+        {
+            n = XMVectorNegate(n);
+            dist0 = -dist0;
+        }
+
+        // Face: the sphere touches the plane where the contact point falls inside the triangle.
+        float approach = -XMVectorGetX(XMVector3Dot(d, n));
+        if (dist0 >= radius && approach > kEpsilon)
+        {
+            float t = (dist0 - radius) / approach;
+            if (t > maxT) return false;
+
+            XMVECTOR contact = XMVectorSubtract(XMVectorMultiplyAdd(d, XMVectorReplicate(t), o), XMVectorScale(n, radius));
+            XMVECTOR onTri = ClosestPointOnTriangle(contact, a, b, c);
+
+            if (XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(contact, onTri))) <= 1e-8f)
+            {
+                XMStoreFloat3(&out.normal, n);
+                out.t = t;
+                return true;
+            }
+        }
+
+        // Otherwise the first contact is on an edge or a vertex, both covered by the edge capsules.
+        XMFLOAT3 v[3];
+        XMStoreFloat3(&v[0], a);
+        XMStoreFloat3(&v[1], b);
+        XMStoreFloat3(&v[2], c);
+
+        bool hit = false;
+        RayHit best;
+        best.t = maxT;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            Capsule edge = { v[i], v[(i + 1) % 3], radius };
+            RayHit h;
+            if (RayCapsule(origin, dir, edge, best.t, h))
+            {
+                best = h;
+                hit = true;
+            }
+        }
+
+        if (hit) out = best;
+        return hit;
+    }
+
+    bool SphereCastMesh(const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, const MeshBVH& bvh, const XMFLOAT4X4& world, float maxT, RayHit& out)
+    {
+        XMMATRIX W = XMLoadFloat4x4(&world);
+        XMVECTOR det;
+        XMMATRIX invW = XMMatrixInverse(&det, W);
+        if (fabsf(XMVectorGetX(det)) <= kEpsilon)
+            return false;
+
+        XMVECTOR o = XMLoadFloat3(&origin);
+        XMVECTOR end = XMVectorMultiplyAdd(XMLoadFloat3(&dir), XMVectorReplicate(std::min(maxT, 1e6f)), o);
+        XMVECTOR r = XMVectorReplicate(radius);
+
+        AABB swept;
+        XMStoreFloat3(&swept.min, XMVectorSubtract(XMVectorMin(o, end), r));
+        XMStoreFloat3(&swept.max, XMVectorAdd(XMVectorMax(o, end), r));
+
+        XMFLOAT4X4 inv;
+        XMStoreFloat4x4(&inv, invW);
+        AABB localSwept = TransformAABB(swept, inv);
+
+        bool hit = false;
+        RayHit best;
+        best.t = maxT;
+
+        bvh.ForEachTriangle(localSwept.min, localSwept.max, [&](UINT tri)
+            {
+                XMFLOAT3 la, lb, lc;
+                bvh.GetTriangle(tri, la, lb, lc);
+
+                RayHit h;
+                if (SphereCastTriangle(origin, radius, dir,
+                    XMVector3TransformCoord(XMLoadFloat3(&la), W),
+                    XMVector3TransformCoord(XMLoadFloat3(&lb), W),
+                    XMVector3TransformCoord(XMLoadFloat3(&lc), W), best.t, h))
+                {
+                    best = h;
+                    hit = true;
+                }
+            });
+
+        if (hit) out = best;
+        return hit;
+    }
+
+    bool SphereCastHeightField(const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, TerrainComponent* terrain, float maxT, RayHit& out)
+    {
+        if (!terrain) return false;
+
+        AABB bounds;
+        if (!terrain->GetWorldBounds(bounds.min, bounds.max)) return false;
+
+        bounds.min.x -= radius; bounds.min.y -= radius; bounds.min.z -= radius;
+        bounds.max.x += radius; bounds.max.y += radius; bounds.max.z += radius;
+
+        // Clip the sweep to the terrain volume before marching.
+        float tStart = 0.0f;
+        float tEnd = maxT;
+        {
+            XMVECTOR o = XMLoadFloat3(&origin);
+            XMVECTOR inBounds = XMVectorClamp(o, XMLoadFloat3(&bounds.min), XMLoadFloat3(&bounds.max));
+            if (!XMVector3Equal(inBounds, o))
+            {
+                RayHit enter;
+                if (!RayAABB(origin, dir, bounds, maxT, enter)) return false;
+                tStart = enter.t;
+            }
+
+            const float diag = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&bounds.max), XMLoadFloat3(&bounds.min))));
+            tEnd = std::min(maxT, tStart + diag);
+        }
+
+        auto penetration = [&](float t, XMFLOAT3& n)
+            {
+                XMFLOAT3 c = { origin.x + dir.x * t, origin.y + dir.y * t, origin.z + dir.z * t };
+                float h;
+                if (!terrain->GetHeightAndNormal(c, h, n)) return -FLT_MAX;
+                return radius - (c.y - h) * n.y;
+            };
+
+        XMFLOAT3 n;
+        if (penetration(tStart, n) > 0.0f)
+        {
+            if (tStart <= 0.0f) return false;
+            out.t = tStart;
+            out.normal = n;
+            return true;
+        }
+
+        const float step = std::max(radius * 0.5f, 0.05f);
+        float prevT = tStart;
+
+        for (float t = tStart + step; prevT < tEnd; t += step)
+        {
+            t = std::min(t, tEnd);
+
+            if (penetration(t, n) > 0.0f)
+            {
+                float lo = prevT;
+                float hi = t;
+                for (int i = 0; i < 10; ++i)
+                {
+                    float mid = (lo + hi) * 0.5f;
+                    if (penetration(mid, n) > 0.0f) hi = mid;
+                    else lo = mid;
+                }
+
+                penetration(hi, n);
+                out.t = lo;
+                out.normal = n;
+                return true;
+            }
+            prevT = t;
+        }
+
+        return false;
+    }
+
+    bool SphereCastCollider(TransformComponent* tf, ColliderComponent* col, const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, float maxT, RayHit& out)
+    {
+        switch (col->GetColliderType())
+        {
+        case Collider_Type::Sphere:
+            return RaySphere(origin, dir, GetSphereCenter(tf, col), col->GetRadius() + radius, maxT, out);
+
+        case Collider_Type::Box:
+            return SphereCastAABB(origin, radius, dir, GetAABB(tf, col), maxT, out);
+
+        case Collider_Type::Capsule:
+        {
+            Capsule cap = GetCapsule(tf, col);
+            cap.radius += radius;
+            return RayCapsule(origin, dir, cap, maxT, out);
+        }
+        case Collider_Type::Mesh:
+        {
+            auto bvh = col->GetMeshBVH();
+            return bvh && SphereCastMesh(origin, radius, dir, *bvh, tf->GetWorldMatrix(), maxT, out);
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool OverlapSphereCollider(TransformComponent* tf, ColliderComponent* col, const XMFLOAT3& center, float radius)
+    {
+        Contact contact;
+
+        switch (col->GetColliderType())
+        {
+        case Collider_Type::Sphere:
+        {
+            XMFLOAT3 c = GetSphereCenter(tf, col);
+            float r = col->GetRadius() + radius;
+            return XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(XMLoadFloat3(&c), XMLoadFloat3(&center)))) < r * r;
+        }
+        case Collider_Type::Box:
+        {
+            AABB box = GetAABB(tf, col);
+            XMVECTOR p = XMLoadFloat3(&center);
+            XMVECTOR q = XMVectorClamp(p, XMLoadFloat3(&box.min), XMLoadFloat3(&box.max));
+            return XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(p, q))) < radius * radius;
+        }
+        case Collider_Type::Capsule:
+            return CapsuleSphere(GetCapsule(tf, col), center, radius, contact);
+
+        case Collider_Type::Mesh:
+        {
+            auto bvh = col->GetMeshBVH();
+            return bvh && SphereMesh(center, radius, *bvh, tf->GetWorldMatrix(), contact);
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool OverlapBoxCollider(TransformComponent* tf, ColliderComponent* col, const AABB& box)
+    {
+        Contact contact;
+
+        switch (col->GetColliderType())
+        {
+        case Collider_Type::Sphere:
+        {
+            XMFLOAT3 c = GetSphereCenter(tf, col);
+            float r = col->GetRadius();
+            XMVECTOR p = XMLoadFloat3(&c);
+            XMVECTOR q = XMVectorClamp(p, XMLoadFloat3(&box.min), XMLoadFloat3(&box.max));
+            return XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(p, q))) < r * r;
+        }
+
+        case Collider_Type::Box:
+            return Overlaps(box, GetAABB(tf, col));
+
+        case Collider_Type::Capsule:
+            return CapsuleBox(GetCapsule(tf, col), box, contact);
+
+        case Collider_Type::Mesh:
+        {
+            auto bvh = col->GetMeshBVH();
+            return bvh && BoxMesh(box, *bvh, tf->GetWorldMatrix(), contact);
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool OverlapCapsuleCollider(TransformComponent* tf, ColliderComponent* col, const Capsule& cap)
+    {
+        Contact contact;
+
+        switch (col->GetColliderType())
+        {
+        case Collider_Type::Sphere:
+            return CapsuleSphere(cap, GetSphereCenter(tf, col), col->GetRadius(), contact);
+
+        case Collider_Type::Box:
+            return CapsuleBox(cap, GetAABB(tf, col), contact);
+
+        case Collider_Type::Capsule:
+            return CapsuleCapsule(cap, GetCapsule(tf, col), contact);
+
+        case Collider_Type::Mesh:
+        {
+            auto bvh = col->GetMeshBVH();
+            return bvh && CapsuleMesh(cap, *bvh, tf->GetWorldMatrix(), contact);
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool OverlapSphereHeightField(TerrainComponent* terrain, const XMFLOAT3& center, float radius)
+    {
+        float h;
+        XMFLOAT3 n;
+        if (!terrain || !terrain->GetHeightAndNormal(center, h, n)) return false;
+
+        return (center.y - h) * n.y < radius;
+    }
+
+    bool OverlapBoxHeightField(TerrainComponent* terrain, const AABB& box)
+    {
+        if (!terrain) return false;
+
+        const XMFLOAT3 samples[5] = {
+            { (box.min.x + box.max.x) * 0.5f, box.min.y, (box.min.z + box.max.z) * 0.5f },
+            { box.min.x, box.min.y, box.min.z }, { box.max.x, box.min.y, box.min.z },
+            { box.min.x, box.min.y, box.max.z }, { box.max.x, box.min.y, box.max.z },
+        };
+
+        for (const XMFLOAT3& p : samples)
+        {
+            float h = terrain->GetHeight(p);
+            if (h > -FLT_MAX && box.min.y < h) return true;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+class TransformComponent;
+class ColliderComponent;
+class TerrainComponent;
+class MeshBVH;
+
+namespace PhysicsUtils
+{
+    struct AABB { XMFLOAT3 min; XMFLOAT3 max; };
+
+    // Capsule axis follows the transform's local Y. p0/p1 are the cap sphere centers.
+    struct Capsule
+    {
+        XMFLOAT3 p0;
+        XMFLOAT3 p1;
+        float radius;
+    };
+
+    // normal points from B to A, penetration is the distance A must move along it.
+    struct Contact
+    {
+        XMFLOAT3 normal = { 0.0f, 1.0f, 0.0f };
+        float penetration = 0.0f;
+    };
+
+    AABB GetAABB(TransformComponent* tf, ColliderComponent* col);
+    Capsule GetCapsule(TransformComponent* tf, ColliderComponent* col);
+
+    bool Overlaps(const AABB& a, const AABB& b);
+
+    XMVECTOR ClosestPointOnSegment(FXMVECTOR p, FXMVECTOR a, FXMVECTOR b);
+    void ClosestPointsSegmentSegment(FXMVECTOR p0, FXMVECTOR p1, FXMVECTOR q0, GXMVECTOR q1, XMVECTOR& outP, XMVECTOR& outQ);
+
+    bool CapsuleCapsule(const Capsule& a, const Capsule& b, Contact& out);
+    bool CapsuleSphere(const Capsule& a, const XMFLOAT3& center, float radius, Contact& out);
+    bool CapsuleBox(const Capsule& a, const AABB& box, Contact& out);
+    bool CapsuleHeightField(const Capsule& a, TerrainComponent* terrain, Contact& out);
+
+    XMVECTOR ClosestPointOnTriangle(FXMVECTOR p, FXMVECTOR a, FXMVECTOR b, GXMVECTOR c);
+
+    // Triangle is B: the contact normal points away from the triangle towards the query shape.
+    bool SphereTriangle(const XMFLOAT3& center, float radius, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, Contact& out);
+    bool CapsuleTriangle(const Capsule& cap, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, Contact& out);
+    bool BoxTriangle(const AABB& box, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, Contact& out);
+
+    // Mesh queries keep the deepest triangle contact. world is the mesh collider's world matrix.
+    bool SphereMesh(const XMFLOAT3& center, float radius, const MeshBVH& bvh, const XMFLOAT4X4& world, Contact& out);
+    bool CapsuleMesh(const Capsule& cap, const MeshBVH& bvh, const XMFLOAT4X4& world, Contact& out);
+    bool BoxMesh(const AABB& box, const MeshBVH& bvh, const XMFLOAT4X4& world, Contact& out);
+
+    AABB TransformAABB(const AABB& local, const XMFLOAT4X4& world);
+
+    struct RayHit
+    {
+        float t = FLT_MAX;
+        XMFLOAT3 normal = { 0.0f, 1.0f, 0.0f };
+    };
+
+    // Rays that start inside a shape report no hit against it. t is in units of dir's length.
+    bool RaySphere(const XMFLOAT3& origin, const XMFLOAT3& dir, const XMFLOAT3& center, float radius, float maxT, RayHit& out);
+    bool RayAABB(const XMFLOAT3& origin, const XMFLOAT3& dir, const AABB& box, float maxT, RayHit& out);
+    bool RayCapsule(const XMFLOAT3& origin, const XMFLOAT3& dir, const Capsule& cap, float maxT, RayHit& out);
+    bool RayTriangle(const XMFLOAT3& origin, const XMFLOAT3& dir, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, float maxT, RayHit& out);
+    bool RayMesh(const XMFLOAT3& origin, const XMFLOAT3& dir, const MeshBVH& bvh, const XMFLOAT4X4& world, float maxT, RayHit& out);
+    bool RayCollider(TransformComponent* tf, ColliderComponent* col, const XMFLOAT3& origin, const XMFLOAT3& dir, float maxT, RayHit& out);
+
+    // Sphere of the given radius swept from origin along dir. normal is the surface normal at the first contact.
+    bool SphereCastAABB(const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, const AABB& box, float maxT, RayHit& out);
+    bool SphereCastTriangle(const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, FXMVECTOR a, FXMVECTOR b, FXMVECTOR c, float maxT, RayHit& out);
+    bool SphereCastMesh(const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, const MeshBVH& bvh, const XMFLOAT4X4& world, float maxT, RayHit& out);
+    bool SphereCastHeightField(const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, TerrainComponent* terrain, float maxT, RayHit& out);
+    bool SphereCastCollider(TransformComponent* tf, ColliderComponent* col, const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, float maxT, RayHit& out);
+
+    bool OverlapSphereCollider(TransformComponent* tf, ColliderComponent* col, const XMFLOAT3& center, float radius);
+    bool OverlapBoxCollider(TransformComponent* tf, ColliderComponent* col, const AABB& box);
+    bool OverlapCapsuleCollider(TransformComponent* tf, ColliderComponent* col, const Capsule& cap);
+
+    bool OverlapSphereHeightField(TerrainComponent* terrain, const XMFLOAT3& center, float radius);
+    bool OverlapBoxHeightField(TerrainComponent* terrain, const AABB& box);
+}
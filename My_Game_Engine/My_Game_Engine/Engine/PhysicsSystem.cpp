@@ -4,32 +4,8 @@
 #include "Components/RigidbodyComponent.h"
 #include "Components/ColliderComponent.h"
 #include "Components/TerrainComponent.h"
-
-namespace PhysicsUtils
-{
-    struct AABB { XMFLOAT3 min; XMFLOAT3 max; };
-
-    AABB GetAABB(TransformComponent* tf, ColliderComponent* col)
-    {
-        XMFLOAT3 pos = tf->GetPosition();
-        XMFLOAT3 center = col->GetCenter();
-        XMFLOAT3 size = col->GetSize();
-        XMFLOAT3 scale = tf->GetScale();
-
-        XMFLOAT3 worldCenter = { pos.x + center.x, pos.y + center.y, pos.z + center.z };
-
-        XMFLOAT3 extent = {
-            (size.x * scale.x) * 0.5f,
-            (size.y * scale.y) * 0.5f,
-            (size.z * scale.z) * 0.5f
-        };
-
-        return {
-            { worldCenter.x - extent.x, worldCenter.y - extent.y, worldCenter.z - extent.z },
-            { worldCenter.x + extent.x, worldCenter.y + extent.y, worldCenter.z + extent.z }
-        };
-    }
-}
+#include "Physics/PhysicsUtils.h"
+#include "Physics/MeshBVH.h"
 
 void PhysicsSystem::Register(SceneID id, Object* obj)
 {
@@ -44,6 +20,7 @@ void PhysicsSystem::Register(SceneID id, Object* obj)
         e.col = col; 
         e.tf = tf;
         worlds[id].dynamics.push_back(e);
+        worlds[id].broadphaseDirty = true;
     }
     else if (col) 
     {
@@ -51,6 +28,7 @@ void PhysicsSystem::Register(SceneID id, Object* obj)
         e.col = col;
         e.tf = tf;
         worlds[id].statics.push_back(e);
+        worlds[id].broadphaseDirty = true;
     }
 }
 
@@ -60,6 +38,7 @@ void PhysicsSystem::Unregister(SceneID id, Object* obj)
     auto col = obj->GetComponent<ColliderComponent>();
 
     auto& world = worlds[id];
+    world.broadphaseDirty = true;
 
     if (rb) {
         world.dynamics.erase(
@@ -104,13 +83,20 @@ void PhysicsSystem::Update(SceneID id, float dt)
 {
     Update_Integration(id, dt);
     Update_Object_Terrain_Interact(id, dt);
+    Update_Object_Mesh_Interact(id, dt);
     Update_Object_Object_Interact(id, dt);
+
+    RebuildBroadphase(worlds[id]);
 }
 
 void PhysicsSystem::Update_Integration(SceneID id, float dt)
 {
     auto& world = worlds[id];
 
+    // CCD sweeps need the tree; it is otherwise rebuilt at the end of the step.
+    if (world.broadphaseDirty)
+        RebuildBroadphase(world);
+
     for (auto& entry : world.dynamics)
     {
         auto tf = entry.tf.lock();
@@ -123,6 +109,16 @@ void PhysicsSystem::Update_Integration(SceneID id, float dt)
         XMFLOAT3 currentPos = tf->GetPosition();
         XMFLOAT3 velocity = rb->GetVelocity();
 
+        if (rb->GetUseCCD())
+        {
+            float speed = XMVectorGetX(XMVector3Length(XMLoadFloat3(&velocity)));
+            if (speed > 0.0f && speed >= rb->GetCCDVelocityThreshold())
+            {
+                Integrate_CCD(world, tf.get(), rb.get(), entry.col.lock().get(), dt);
+                continue;
+            }
+        }
+
         currentPos.x += velocity.x * dt;
         currentPos.y += velocity.y * dt;
         currentPos.z += velocity.z * dt;
@@ -131,6 +127,114 @@ void PhysicsSystem::Update_Integration(SceneID id, float dt)
     }
 }
 
+// Sphere centers approximating the collider for sweeps. Boxes use their inscribed sphere so they never stop short of a wall.
+static UINT GetSweepSpheres(TransformComponent* tf, ColliderComponent* col, XMFLOAT3* outCenters, UINT maxCount, float& outRadius)
+{
+    constexpr float MinSweepRadius = 0.01f;
+
+    if (!col)
+    {
+        outCenters[0] = tf->GetPosition();
+        outRadius = MinSweepRadius;
+        return 1;
+    }
+
+    switch (col->GetColliderType())
+    {
+    case Collider_Type::Sphere:
+    {
+        XMFLOAT3 pos = tf->GetPosition();
+        XMFLOAT3 offset = col->GetCenter();
+        outCenters[0] = { pos.x + offset.x, pos.y + offset.y, pos.z + offset.z };
+        outRadius = std::max(col->GetRadius(), MinSweepRadius);
+        return 1;
+    }
+    case Collider_Type::Capsule:
+    {
+        PhysicsUtils::Capsule cap = PhysicsUtils::GetCapsule(tf, col);
+        outRadius = std::max(cap.radius, MinSweepRadius);
+
+        XMVECTOR p0 = XMLoadFloat3(&cap.p0);
+        XMVECTOR p1 = XMLoadFloat3(&cap.p1);
+        float length = XMVectorGetX(XMVector3Length(XMVectorSubtract(p1, p0)));
+
+        UINT count = std::min(maxCount, static_cast<UINT>(ceilf(length / outRadius)) + 1);
+        if (count < 2)
+        {
+            XMStoreFloat3(&outCenters[0], XMVectorLerp(p0, p1, 0.5f));
+            return 1;
+        }
+
+        for (UINT i = 0; i < count; ++i)
+            XMStoreFloat3(&outCenters[i], XMVectorLerp(p0, p1, static_cast<float>(i) / (count - 1)));
+        return count;
+    }
+    default:
+    {
+        PhysicsUtils::AABB box = PhysicsUtils::GetAABB(tf, col);
+        outCenters[0] = { (box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f };
+        outRadius = std::max(0.5f * std::min({ box.max.x - box.min.x, box.max.y - box.min.y, box.max.z - box.min.z }), MinSweepRadius);
+        return 1;
+    }
+    }
+}
+
+void PhysicsSystem::Integrate_CCD(World& world, TransformComponent* tf, RigidbodyComponent* rb, ColliderComponent* col, float dt)
+{
+    constexpr UINT MaxSweepSpheres = 8;
+
+    XMFLOAT3 currentPos = tf->GetPosition();
+    XMFLOAT3 velocity = rb->GetVelocity();
+    float remaining = dt;
+
+    // Advance to the first time of impact, slide off the surface, and spend the rest of the step from there.
+    for (int step = 0; step < MaxCCDSubsteps && remaining > 0.0f; ++step)
+    {
+        XMVECTOR vel = XMLoadFloat3(&velocity);
+        float speed = XMVectorGetX(XMVector3Length(vel));
+        if (speed <= 1e-6f) break;
+
+        float travel = speed * remaining;
+        XMFLOAT3 dir;
+        XMStoreFloat3(&dir, XMVectorScale(vel, 1.0f / speed));
+
+        XMFLOAT3 centers[MaxSweepSpheres];
+        float radius = 0.0f;
+        UINT count = GetSweepSpheres(tf, col, centers, MaxSweepSpheres, radius);
+
+        RaycastHit hit;
+        bool blocked = false;
+        float closest = travel;
+
+        for (UINT i = 0; i < count; ++i)
+        {
+            RaycastHit h;
+            if (SweepSphere(world, centers[i], radius, dir, closest, AllLayers, col, h))
+            {
+                hit = h;
+                closest = h.distance;
+                blocked = true;
+            }
+        }
+
+        float advance = blocked ? std::max(0.0f, hit.distance - CCDContactSkin) : travel;
+
+        XMStoreFloat3(&currentPos, XMVectorMultiplyAdd(XMLoadFloat3(&dir), XMVectorReplicate(advance), XMLoadFloat3(&currentPos)));
+        tf->SetPosition(currentPos);
+
+        if (!blocked) break;
+
+        remaining -= advance / speed;
+
+        XMVECTOR n = XMLoadFloat3(&hit.normal);
+        float intoSurface = XMVectorGetX(XMVector3Dot(vel, n));
+        if (intoSurface < 0.0f)
+            XMStoreFloat3(&velocity, XMVectorSubtract(vel, XMVectorScale(n, intoSurface)));
+    }
+
+    rb->SetVelocity(velocity);
+}
+
 void PhysicsSystem::Update_Object_Terrain_Interact(SceneID id, float dt)
 {
     auto& world = worlds[id];
@@ -138,6 +242,24 @@ void PhysicsSystem::Update_Object_Terrain_Interact(SceneID id, float dt)
 
     if (terrains.empty()) return;
 
+    // Every body is reduced to a few sphere centers sharing one radius, so all shapes go through the same batched sampling.
+    struct TerrainBody
+    {
+        std::shared_ptr<TransformComponent> tf;
+        std::shared_ptr<RigidbodyComponent> rb;
+        PhysicsUtils::AABB bounds;
+        UINT firstPoint = 0;
+        UINT pointCount = 0;
+        float radius = 0.0f;
+        PhysicsUtils::Contact contact;
+        bool touching = false;
+    };
+
+    std::vector<TerrainBody> bodies;
+    std::vector<XMFLOAT3> points;
+    bodies.reserve(world.dynamics.size());
+    points.reserve(world.dynamics.size() * 2);
+
     for (auto& entry : world.dynamics)
     {
         auto tf = entry.tf.lock();
@@ -146,76 +268,232 @@ void PhysicsSystem::Update_Object_Terrain_Interact(SceneID id, float dt)
 
         if (!tf || !rb) continue;
 
-        XMFLOAT3 currentPos = tf->GetPosition();
-        XMFLOAT3 velocity = rb->GetVelocity();
+        TerrainBody body;
+        body.tf = tf;
+        body.rb = rb;
+        body.firstPoint = static_cast<UINT>(points.size());
 
-        float distToBottom = 0.0f;
-        XMFLOAT3 centerOffset = { 0.f, 0.f, 0.f };
-
-        if (col)
+        if (!col)
         {
-            centerOffset = col->GetCenter();
+            XMFLOAT3 pos = tf->GetPosition();
+            body.bounds = { pos, pos };
+            points.push_back(pos);
+        }
+        else
+        {
+            body.bounds = PhysicsUtils::GetAABB(tf.get(), col.get());
 
             switch (col->GetColliderType())
             {
             case Collider_Type::Sphere:
-                distToBottom = col->GetRadius();
-                break;
-
-            case Collider_Type::Box:
-                distToBottom = col->GetSize().y * 0.5f;
+            {
+                const auto& b = body.bounds;
+                points.push_back({ (b.min.x + b.max.x) * 0.5f, (b.min.y + b.max.y) * 0.5f, (b.min.z + b.max.z) * 0.5f });
+                body.radius = col->GetRadius();
                 break;
-
+            }
             case Collider_Type::Capsule:
-                distToBottom = col->GetHeight() * 0.5f;
+            {
+                PhysicsUtils::Capsule cap = PhysicsUtils::GetCapsule(tf.get(), col.get());
+                points.push_back(cap.p0);
+                points.push_back(cap.p1);
+                body.radius = cap.radius;
                 break;
-
-            case Collider_Type::Mesh:
-            case Collider_Type::Terrain:
+            }
             default:
-                //  
-                distToBottom = 0.0f;
+            {
+                // Boxes (and anything else bounded by an AABB) touch the ground with their bottom face.
+                const auto& b = body.bounds;
+                points.push_back({ (b.min.x + b.max.x) * 0.5f, b.min.y, (b.min.z + b.max.z) * 0.5f });
+                points.push_back({ b.min.x, b.min.y, b.min.z });
+                points.push_back({ b.max.x, b.min.y, b.min.z });
+                points.push_back({ b.min.x, b.min.y, b.max.z });
+                points.push_back({ b.max.x, b.min.y, b.max.z });
                 break;
             }
+            }
         }
 
-        XMFLOAT3 checkPos = currentPos;
-        checkPos.x += centerOffset.x;
-        checkPos.z += centerOffset.z;
+        body.pointCount = static_cast<UINT>(points.size()) - body.firstPoint;
+        bodies.push_back(std::move(body));
+    }
+
+    if (bodies.empty()) return;
 
+    std::vector<XMFLOAT3> queryPoints;
+    std::vector<UINT> queryOwner;
+    std::vector<TerrainComponent::HeightSample> samples;
 
-        float objectBottomY = (currentPos.y + centerOffset.y) - distToBottom;
+    for (auto* terrain : terrains)
+    {
+        XMFLOAT3 tMin, tMax;
+        if (!terrain->GetWorldBounds(tMin, tMax)) continue;
 
-        float maxTerrainHeight = -FLT_MAX;
-        bool isOverTerrain = false;
+        queryPoints.clear();
+        queryOwner.clear();
 
-        for (auto* terrain : terrains)
+        for (UINT b = 0; b < bodies.size(); ++b)
         {
-            float h = terrain->GetHeight(checkPos);
+            const auto& bounds = bodies[b].bounds;
+            if (bounds.max.x < tMin.x || bounds.min.x > tMax.x ||
+                bounds.max.z < tMin.z || bounds.min.z > tMax.z ||
+                bounds.min.y > tMax.y)
+                continue;
 
-            if (h > -FLT_MAX && h > maxTerrainHeight)
+            for (UINT p = 0; p < bodies[b].pointCount; ++p)
             {
-                maxTerrainHeight = h;
-                isOverTerrain = true;
+                queryPoints.push_back(points[bodies[b].firstPoint + p]);
+                queryOwner.push_back(b);
             }
         }
 
-        if (isOverTerrain)
+        if (queryPoints.empty()) continue;
+
+        terrain->GetHeightsAndNormals(queryPoints, samples);
+
+        for (size_t k = 0; k < samples.size(); ++k)
         {
-            if (objectBottomY < maxTerrainHeight)
+            const auto& sample = samples[k];
+            if (!sample.valid) continue;
+
+            TerrainBody& body = bodies[queryOwner[k]];
+
+            // Signed distance from the sample to the tangent plane at (p.x, h, p.z).
+            float dist = (queryPoints[k].y - sample.height) * sample.normal.y;
+            float penetration = body.radius - dist;
+
+            if (penetration > 0.0f && (!body.touching || penetration > body.contact.penetration))
             {
-                float correctedY = (maxTerrainHeight + distToBottom) - centerOffset.y;
+                body.contact.normal = sample.normal;
+                body.contact.penetration = penetration;
+                body.touching = true;
+            }
+        }
+    }
 
-                currentPos.y = correctedY;
-                tf->SetPosition(currentPos);
+    for (auto& body : bodies)
+    {
+        if (!body.touching) continue;
 
-                if (velocity.y < 0.0f)
-                {
-                    velocity.y = 0.0f;
-                    rb->SetVelocity(velocity);
-                }
+        XMFLOAT3 currentPos = body.tf->GetPosition();
+        XMFLOAT3 velocity = body.rb->GetVelocity();
+
+        XMVECTOR n = XMLoadFloat3(&body.contact.normal);
+        XMVECTOR pos = XMVectorMultiplyAdd(n, XMVectorReplicate(body.contact.penetration), XMLoadFloat3(&currentPos));
+        XMStoreFloat3(&currentPos, pos);
+        body.tf->SetPosition(currentPos);
+
+        // Only the velocity into the surface is removed, so bodies keep sliding along slopes.
+        XMVECTOR vel = XMLoadFloat3(&velocity);
+        float intoSurface = XMVectorGetX(XMVector3Dot(vel, n));
+        if (intoSurface < 0.0f)
+        {
+            XMStoreFloat3(&velocity, XMVectorSubtract(vel, XMVectorScale(n, intoSurface)));
+            body.rb->SetVelocity(velocity);
+        }
+    }
+}
+
+void PhysicsSystem::Update_Object_Mesh_Interact(SceneID id, float dt)
+{
+    auto& world = worlds[id];
+
+    struct StaticMesh
+    {
+        std::shared_ptr<const MeshBVH> bvh;
+        XMFLOAT4X4 world;
+        PhysicsUtils::AABB bounds;
+    };
+
+    std::vector<StaticMesh> meshes;
+    for (auto& entry : world.statics)
+    {
+        auto tf = entry.tf.lock();
+        auto col = entry.col.lock();
+
+        if (!tf || !col || col->GetColliderType() != Collider_Type::Mesh) continue;
+
+        auto bvh = col->GetMeshBVH();
+        if (!bvh || bvh->IsEmpty()) continue;
+
+        StaticMesh sm;
+        sm.bvh = bvh;
+        sm.world = tf->GetWorldMatrix();
+        sm.bounds = PhysicsUtils::TransformAABB({ bvh->GetBoundsMin(), bvh->GetBoundsMax() }, sm.world);
+        meshes.push_back(std::move(sm));
+    }
+
+    if (meshes.empty()) return;
+
+    for (auto& entry : world.dynamics)
+    {
+        auto tf = entry.tf.lock();
+        auto rb = entry.rb.lock();
+        auto col = entry.col.lock();
+
+        if (!tf || !rb || !col) continue;
+
+        Collider_Type type = col->GetColliderType();
+        if (type != Collider_Type::Sphere && type != Collider_Type::Box && type != Collider_Type::Capsule) continue;
+
+        PhysicsUtils::AABB aabb = PhysicsUtils::GetAABB(tf.get(), col.get());
+
+        PhysicsUtils::Contact deepest;
+        bool touching = false;
+
+        for (const auto& sm : meshes)
+        {
+            if (!PhysicsUtils::Overlaps(aabb, sm.bounds)) continue;
+
+            PhysicsUtils::Contact contact;
+            bool hit = false;
+
+            switch (type)
+            {
+            case Collider_Type::Sphere:
+            {
+                XMFLOAT3 pos = tf->GetPosition();
+                XMFLOAT3 offset = col->GetCenter();
+                XMFLOAT3 center = { pos.x + offset.x, pos.y + offset.y, pos.z + offset.z };
+                hit = PhysicsUtils::SphereMesh(center, col->GetRadius(), *sm.bvh, sm.world, contact);
+                break;
+            }
+            case Collider_Type::Capsule:
+                hit = PhysicsUtils::CapsuleMesh(PhysicsUtils::GetCapsule(tf.get(), col.get()), *sm.bvh, sm.world, contact);
+                break;
+
+            case Collider_Type::Box:
+                hit = PhysicsUtils::BoxMesh(aabb, *sm.bvh, sm.world, contact);
+                break;
+
+            default:
+                break;
+            }
+
+            if (hit && (!touching || contact.penetration > deepest.penetration))
+            {
+                deepest = contact;
+                touching = true;
             }
         }
+
+        if (!touching) continue;
+
+        XMFLOAT3 currentPos = tf->GetPosition();
+        XMFLOAT3 velocity = rb->GetVelocity();
+
+        XMVECTOR n = XMLoadFloat3(&deepest.normal);
+        XMVECTOR pos = XMVectorMultiplyAdd(n, XMVectorReplicate(deepest.penetration), XMLoadFloat3(&currentPos));
+        XMStoreFloat3(&currentPos, pos);
+        tf->SetPosition(currentPos);
+
+        XMVECTOR vel = XMLoadFloat3(&velocity);
+        float intoSurface = XMVectorGetX(XMVector3Dot(vel, n));
+        if (intoSurface < 0.0f)
+        {
+            XMStoreFloat3(&velocity, XMVectorSubtract(vel, XMVectorScale(n, intoSurface)));
+            rb->SetVelocity(velocity);
+        }
     }
 }
 
@@ -257,6 +535,11 @@ void PhysicsSystem::Update_Object_Object_Interact(SceneID id, float dt)
             XMFLOAT3 centerA = { posA.x + offsetA.x, posA.y + offsetA.y, posA.z + offsetA.z };
             XMFLOAT3 centerB = { posB.x + offsetB.x, posB.y + offsetB.y, posB.z + offsetB.z };
 
+            auto aabbA = PhysicsUtils::GetAABB(tfA.get(), colA.get());
+            auto aabbB = PhysicsUtils::GetAABB(tfB.get(), colB.get());
+
+            if (!PhysicsUtils::Overlaps(aabbA, aabbB)) continue;
+
             if (typeA == Collider_Type::Sphere && typeB == Collider_Type::Sphere)
             {
                 float rA = colA->GetRadius(); 
@@ -286,9 +569,6 @@ void PhysicsSystem::Update_Object_Object_Interact(SceneID id, float dt)
             }
             else if (typeA == Collider_Type::Box && typeB == Collider_Type::Box)
             {
-                auto aabbA = PhysicsUtils::GetAABB(tfA.get(), colA.get());
-                auto aabbB = PhysicsUtils::GetAABB(tfB.get(), colB.get());
-
                 if (aabbA.max.x > aabbB.min.x && aabbA.min.x < aabbB.max.x &&
                     aabbA.max.y > aabbB.min.y && aabbA.min.y < aabbB.max.y &&
                     aabbA.max.z > aabbB.min.z && aabbA.min.z < aabbB.max.z)
@@ -319,13 +599,11 @@ void PhysicsSystem::Update_Object_Object_Interact(SceneID id, float dt)
                 bool aIsSphere = (typeA == Collider_Type::Sphere);
 
                 auto* sphereCol = aIsSphere ? colA.get() : colB.get();
-                auto* boxCol = aIsSphere ? colB.get() : colA.get();
-                auto* boxTf = aIsSphere ? tfB.get() : tfA.get();
 
                 XMFLOAT3 sphereCenter = aIsSphere ? centerA : centerB;
                 float radius = sphereCol->GetRadius();
 
-                auto aabb = PhysicsUtils::GetAABB(boxTf, boxCol);
+                const auto& aabb = aIsSphere ? aabbB : aabbA;
 
                 float closestX = std::max(aabb.min.x, std::min(sphereCenter.x, aabb.max.x));
                 float closestY = std::max(aabb.min.y, std::min(sphereCenter.y, aabb.max.y));
@@ -356,6 +634,44 @@ void PhysicsSystem::Update_Object_Object_Interact(SceneID id, float dt)
                     }
                 }
             }
+            else if (typeA == Collider_Type::Capsule || typeB == Collider_Type::Capsule)
+            {
+                bool aIsCapsule = (typeA == Collider_Type::Capsule);
+
+                auto* capTf = aIsCapsule ? tfA.get() : tfB.get();
+                auto* capCol = aIsCapsule ? colA.get() : colB.get();
+                Collider_Type otherType = aIsCapsule ? typeB : typeA;
+
+                PhysicsUtils::Capsule capsule = PhysicsUtils::GetCapsule(capTf, capCol);
+                PhysicsUtils::Contact contact;
+
+                switch (otherType)
+                {
+                case Collider_Type::Capsule:
+                    isColliding = PhysicsUtils::CapsuleCapsule(capsule, PhysicsUtils::GetCapsule(tfB.get(), colB.get()), contact);
+                    break;
+
+                case Collider_Type::Sphere:
+                    isColliding = PhysicsUtils::CapsuleSphere(capsule,
+                        aIsCapsule ? centerB : centerA,
+                        aIsCapsule ? colB->GetRadius() : colA->GetRadius(), contact);
+                    break;
+
+                case Collider_Type::Box:
+                    isColliding = PhysicsUtils::CapsuleBox(capsule, aIsCapsule ? aabbB : aabbA, contact);
+                    break;
+
+                default:
+                    break;
+                }
+
+                if (isColliding)
+                {
+                    float sign = aIsCapsule ? 1.0f : -1.0f;
+                    normal = { contact.normal.x * sign, contact.normal.y * sign, contact.normal.z * sign };
+                    penetration = contact.penetration;
+                }
+            }
 
             if (isColliding)
             {
@@ -386,4 +702,409 @@ void PhysicsSystem::Update_Object_Object_Interact(SceneID id, float dt)
 void PhysicsSystem::Clear(SceneID id) 
 {
     worlds.erase(id);
-}
\ No newline at end of file
+}
+
+void PhysicsSystem::RebuildBroadphase(World& world)
+{
+    std::vector<Broadphase::Proxy> proxies;
+    proxies.reserve(world.dynamics.size() + world.statics.size());
+
+    auto gather = [&](const std::vector<Entry>& entries, bool isStatic)
+        {
+            for (UINT i = 0; i < entries.size(); ++i)
+            {
+                auto tf = entries[i].tf.lock();
+                auto col = entries[i].col.lock();
+                if (!tf || !col) continue;
+
+                Broadphase::Proxy p;
+                p.bounds = PhysicsUtils::GetAABB(tf.get(), col.get());
+                p.layerMask = col->GetLayerMask();
+                p.entry = i;
+                p.isStatic = isStatic;
+                proxies.push_back(p);
+            }
+        };
+
+    gather(world.dynamics, false);
+    gather(world.statics, true);
+
+    world.broadphase.Build(std::move(proxies));
+    world.broadphaseDirty = false;
+}
+
+PhysicsSystem::World* PhysicsSystem::GetQueryWorld(SceneID id)
+{
+    auto it = worlds.find(id);
+    if (it == worlds.end()) return nullptr;
+
+    if (it->second.broadphaseDirty)
+        RebuildBroadphase(it->second);
+
+    return &it->second;
+}
+
+bool PhysicsSystem::ResolveProxy(World& world, const Broadphase::Proxy& proxy, std::shared_ptr<TransformComponent>& outTf, std::shared_ptr<ColliderComponent>& outCol) const
+{
+    const auto& entries = proxy.isStatic ? world.statics : world.dynamics;
+    if (proxy.entry >= entries.size()) return false;
+
+    outTf = entries[proxy.entry].tf.lock();
+    outCol = entries[proxy.entry].col.lock();
+    return outTf && outCol;
+}
+
+static bool NormalizeDirection(const XMFLOAT3& direction, XMFLOAT3& outDir)
+{
+    XMVECTOR d = XMLoadFloat3(&direction);
+    if (XMVectorGetX(XMVector3LengthSq(d)) <= 1e-12f) return false;
+
+    XMStoreFloat3(&outDir, XMVector3Normalize(d));
+    return true;
+}
+
+static PhysicsSystem::RaycastHit MakeHit(const XMFLOAT3& origin, const XMFLOAT3& dir, const PhysicsUtils::RayHit& h)
+{
+    PhysicsSystem::RaycastHit hit;
+    hit.point = { origin.x + dir.x * h.t, origin.y + dir.y * h.t, origin.z + dir.z * h.t };
+    hit.normal = h.normal;
+    hit.distance = h.t;
+    return hit;
+}
+
+bool PhysicsSystem::Raycast(SceneID id, const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, RaycastHit& outHit, UINT layerMask)
+{
+    World* world = GetQueryWorld(id);
+    XMFLOAT3 dir;
+    if (!world || !NormalizeDirection(direction, dir)) return false;
+
+    bool found = false;
+    float closest = maxDistance;
+
+    world->broadphase.QueryRay(origin, dir, maxDistance, layerMask, [&](const Broadphase::Proxy& proxy, float maxT)
+        {
+            std::shared_ptr<TransformComponent> tf;
+            std::shared_ptr<ColliderComponent> col;
+            if (!ResolveProxy(*world, proxy, tf, col)) return maxT;
+
+            PhysicsUtils::RayHit h;
+            if (!PhysicsUtils::RayCollider(tf.get(), col.get(), origin, dir, maxT, h)) return maxT;
+
+            outHit = MakeHit(origin, dir, h);
+            outHit.object = col->GetOwner();
+            outHit.collider = col.get();
+            outHit.terrain = nullptr;
+            closest = h.t;
+            found = true;
+            return h.t;
+        });
+
+    if (layerMask & TerrainLayerMask)
+    {
+        for (auto* terrain : world->terrains)
+        {
+            PhysicsUtils::RayHit h;
+            if (!terrain->Raycast(origin, dir, closest, h.t, h.normal)) continue;
+
+            outHit = MakeHit(origin, dir, h);
+            outHit.object = terrain->GetOwner();
+            outHit.collider = nullptr;
+            outHit.terrain = terrain;
+            closest = h.t;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+UINT PhysicsSystem::RaycastAll(SceneID id, const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, std::vector<RaycastHit>& outHits, UINT layerMask)
+{
+    outHits.clear();
+
+    World* world = GetQueryWorld(id);
+    XMFLOAT3 dir;
+    if (!world || !NormalizeDirection(direction, dir)) return 0;
+
+    world->broadphase.QueryRay(origin, dir, maxDistance, layerMask, [&](const Broadphase::Proxy& proxy, float maxT)
+        {
+            std::shared_ptr<TransformComponent> tf;
+            std::shared_ptr<ColliderComponent> col;
+            if (!ResolveProxy(*world, proxy, tf, col)) return maxT;
+
+            PhysicsUtils::RayHit h;
+            if (PhysicsUtils::RayCollider(tf.get(), col.get(), origin, dir, maxT, h))
+            {
+                RaycastHit hit = MakeHit(origin, dir, h);
+                hit.object = col->GetOwner();
+                hit.collider = col.get();
+                outHits.push_back(hit);
+            }
+            return maxT;
+        });
+
+    if (layerMask & TerrainLayerMask)
+    {
+        for (auto* terrain : world->terrains)
+        {
+            PhysicsUtils::RayHit h;
+            if (!terrain->Raycast(origin, dir, maxDistance, h.t, h.normal)) continue;
+
+            RaycastHit hit = MakeHit(origin, dir, h);
+            hit.object = terrain->GetOwner();
+            hit.terrain = terrain;
+            outHits.push_back(hit);
+        }
+    }
+
+    std::sort(outHits.begin(), outHits.end(), [](const RaycastHit& a, const RaycastHit& b) { return a.distance < b.distance; });
+    return static_cast<UINT>(outHits.size());
+}
+
+bool PhysicsSystem::SphereCast(SceneID id, const XMFLOAT3& origin, float radius, const XMFLOAT3& direction, float maxDistance, RaycastHit& outHit, UINT layerMask)
+{
+    World* world = GetQueryWorld(id);
+    XMFLOAT3 dir;
+    if (!world || !NormalizeDirection(direction, dir)) return false;
+
+    return SweepSphere(*world, origin, radius, dir, maxDistance, layerMask, nullptr, outHit);
+}
+
+bool PhysicsSystem::SweepSphere(World& world, const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, float maxDistance, UINT layerMask, const ColliderComponent* ignore, RaycastHit& outHit)
+{
+    bool found = false;
+    float closest = maxDistance;
+
+    // Walk the tree with the swept sphere's bounding box; sweeps are short enough that ray ordering buys little.
+    XMVECTOR o = XMLoadFloat3(&origin);
+    XMVECTOR end = XMVectorMultiplyAdd(XMLoadFloat3(&dir), XMVectorReplicate(std::min(maxDistance, 1e6f)), o);
+    XMVECTOR r = XMVectorReplicate(radius);
+
+    PhysicsUtils::AABB swept;
+    XMStoreFloat3(&swept.min, XMVectorSubtract(XMVectorMin(o, end), r));
+    XMStoreFloat3(&swept.max, XMVectorAdd(XMVectorMax(o, end), r));
+
+    world.broadphase.QueryAABB(swept, layerMask, [&](const Broadphase::Proxy& proxy)
+        {
+            std::shared_ptr<TransformComponent> tf;
+            std::shared_ptr<ColliderComponent> col;
+            if (!ResolveProxy(world, proxy, tf, col) || col.get() == ignore) return;
+
+            PhysicsUtils::RayHit h;
+            if (!PhysicsUtils::SphereCastCollider(tf.get(), col.get(), origin, radius, dir, closest, h)) return;
+
+            outHit = MakeHit(origin, dir, h);
+            outHit.point = { outHit.point.x - h.normal.x * radius, outHit.point.y - h.normal.y * radius, outHit.point.z - h.normal.z * radius };
+            outHit.object = col->GetOwner();
+            outHit.collider = col.get();
+            outHit.terrain = nullptr;
+            closest = h.t;
+            found = true;
+        });
+
+    if (layerMask & TerrainLayerMask)
+    {
+        for (auto* terrain : world.terrains)
+        {
+            PhysicsUtils::RayHit h;
+            if (!PhysicsUtils::SphereCastHeightField(origin, radius, dir, terrain, closest, h)) continue;
+
+            outHit = MakeHit(origin, dir, h);
+            outHit.point = { outHit.point.x - h.normal.x * radius, outHit.point.y - h.normal.y * radius, outHit.point.z - h.normal.z * radius };
+            outHit.object = terrain->GetOwner();
+            outHit.collider = nullptr;
+            outHit.terrain = terrain;
+            closest = h.t;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+UINT PhysicsSystem::OverlapSphere(SceneID id, const XMFLOAT3& center, float radius, std::vector<Object*>& outObjects, UINT layerMask)
+{
+    outObjects.clear();
+
+    World* world = GetQueryWorld(id);
+    if (!world) return 0;
+
+    PhysicsUtils::AABB box = {
+        { center.x - radius, center.y - radius, center.z - radius },
+        { center.x + radius, center.y + radius, center.z + radius }
+    };
+
+    world->broadphase.QueryAABB(box, layerMask, [&](const Broadphase::Proxy& proxy)
+        {
+            std::shared_ptr<TransformComponent> tf;
+            std::shared_ptr<ColliderComponent> col;
+            if (ResolveProxy(*world, proxy, tf, col) && PhysicsUtils::OverlapSphereCollider(tf.get(), col.get(), center, radius))
+                outObjects.push_back(col->GetOwner());
+        });
+
+    if (layerMask & TerrainLayerMask)
+    {
+        for (auto* terrain : world->terrains)
+        {
+            if (PhysicsUtils::OverlapSphereHeightField(terrain, center, radius))
+                outObjects.push_back(terrain->GetOwner());
+        }
+    }
+
+    return static_cast<UINT>(outObjects.size());
+}
+
+UINT PhysicsSystem::OverlapBox(SceneID id, const XMFLOAT3& center, const XMFLOAT3& halfExtents, std::vector<Object*>& outObjects, UINT layerMask)
+{
+    outObjects.clear();
+
+    World* world = GetQueryWorld(id);
+    if (!world) return 0;
+
+    PhysicsUtils::AABB box = {
+        { center.x - halfExtents.x, center.y - halfExtents.y, center.z - halfExtents.z },
+        { center.x + halfExtents.x, center.y + halfExtents.y, center.z + halfExtents.z }
+    };
+
+    world->broadphase.QueryAABB(box, layerMask, [&](const Broadphase::Proxy& proxy)
+        {
+            std::shared_ptr<TransformComponent> tf;
+            std::shared_ptr<ColliderComponent> col;
+            if (ResolveProxy(*world, proxy, tf, col) && PhysicsUtils::OverlapBoxCollider(tf.get(), col.get(), box))
+                outObjects.push_back(col->GetOwner());
+        });
+
+    if (layerMask & TerrainLayerMask)
+    {
+        for (auto* terrain : world->terrains)
+        {
+            if (PhysicsUtils::OverlapBoxHeightField(terrain, box))
+                outObjects.push_back(terrain->GetOwner());
+        }
+    }
+
+    return static_cast<UINT>(outObjects.size());
+}
+
+UINT PhysicsSystem::OverlapCapsule(SceneID id, const XMFLOAT3& p0, const XMFLOAT3& p1, float radius, std::vector<Object*>& outObjects, UINT layerMask)
+{
+    outObjects.clear();
+
+    World* world = GetQueryWorld(id);
+    if (!world) return 0;
+
+    PhysicsUtils::Capsule cap = { p0, p1, radius };
+
+    PhysicsUtils::AABB box = {
+        { std::min(p0.x, p1.x) - radius, std::min(p0.y, p1.y) - radius, std::min(p0.z, p1.z) - radius },
+        { std::max(p0.x, p1.x) + radius, std::max(p0.y, p1.y) + radius, std::max(p0.z, p1.z) + radius }
+    };
+
+    world->broadphase.QueryAABB(box, layerMask, [&](const Broadphase::Proxy& proxy)
+        {
+            std::shared_ptr<TransformComponent> tf;
+            std::shared_ptr<ColliderComponent> col;
+            if (ResolveProxy(*world, proxy, tf, col) && PhysicsUtils::OverlapCapsuleCollider(tf.get(), col.get(), cap))
+                outObjects.push_back(col->GetOwner());
+        });
+
+    if (layerMask & TerrainLayerMask)
+    {
+        for (auto* terrain : world->terrains)
+        {
+            PhysicsUtils::Contact contact;
+            if (PhysicsUtils::CapsuleHeightField(cap, terrain, contact))
+                outObjects.push_back(terrain->GetOwner());
+        }
+    }
+
+    return static_cast<UINT>(outObjects.size());
+}
+
+void PhysicsSystem::RaycastBatch(SceneID id, const std::vector<Ray>& rays, std::vector<RaycastHit>& outHits, UINT layerMask)
+{
+    outHits.assign(rays.size(), RaycastHit{});
+
+    World* world = GetQueryWorld(id);
+    if (!world) return;
+
+    const size_t count = rays.size();
+
+    for (size_t base = 0; base < count; base += 4)
+    {
+        XMFLOAT3 origin[4] = {};
+        XMFLOAT3 dir[4] = {};
+        XMFLOAT3 inv[4] = {};
+        float maxT[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        Broadphase::RayPacket packet;
+        packet.activeMask = 0;
+
+        for (UINT lane = 0; lane < 4 && base + lane < count; ++lane)
+        {
+            const Ray& ray = rays[base + lane];
+            if (!NormalizeDirection(ray.direction, dir[lane])) continue;
+
+            origin[lane] = ray.origin;
+            inv[lane] = Broadphase::SafeInverse(dir[lane]);
+            maxT[lane] = ray.maxDistance;
+            packet.activeMask |= 1u << lane;
+        }
+
+        if (packet.activeMask == 0) continue;
+
+        packet.ox = XMVectorSet(origin[0].x, origin[1].x, origin[2].x, origin[3].x);
+        packet.oy = XMVectorSet(origin[0].y, origin[1].y, origin[2].y, origin[3].y);
+        packet.oz = XMVectorSet(origin[0].z, origin[1].z, origin[2].z, origin[3].z);
+        packet.invDx = XMVectorSet(inv[0].x, inv[1].x, inv[2].x, inv[3].x);
+        packet.invDy = XMVectorSet(inv[0].y, inv[1].y, inv[2].y, inv[3].y);
+        packet.invDz = XMVectorSet(inv[0].z, inv[1].z, inv[2].z, inv[3].z);
+        packet.maxT = XMVectorSet(maxT[0], maxT[1], maxT[2], maxT[3]);
+
+        world->broadphase.QueryRayPacket(packet, layerMask, [&](const Broadphase::Proxy& proxy, UINT lanes)
+            {
+                std::shared_ptr<TransformComponent> tf;
+                std::shared_ptr<ColliderComponent> col;
+                if (!ResolveProxy(*world, proxy, tf, col)) return;
+
+                bool shortened = false;
+                for (UINT lane = 0; lane < 4; ++lane)
+                {
+                    if (!(lanes & (1u << lane))) continue;
+
+                    PhysicsUtils::RayHit h;
+                    if (!PhysicsUtils::RayCollider(tf.get(), col.get(), origin[lane], dir[lane], maxT[lane], h)) continue;
+
+                    RaycastHit& hit = outHits[base + lane];
+                    hit = MakeHit(origin[lane], dir[lane], h);
+                    hit.object = col->GetOwner();
+                    hit.collider = col.get();
+                    maxT[lane] = h.t;
+                    shortened = true;
+                }
+
+                if (shortened)
+                    packet.maxT = XMVectorSet(maxT[0], maxT[1], maxT[2], maxT[3]);
+            });
+
+        if (!(layerMask & TerrainLayerMask)) continue;
+
+        for (UINT lane = 0; lane < 4; ++lane)
+        {
+            if (!(packet.activeMask & (1u << lane))) continue;
+
+            for (auto* terrain : world->terrains)
+            {
+                PhysicsUtils::RayHit h;
+                if (!terrain->Raycast(origin[lane], dir[lane], maxT[lane], h.t, h.normal)) continue;
+
+                RaycastHit& hit = outHits[base + lane];
+                hit = MakeHit(origin[lane], dir[lane], h);
+                hit.object = terrain->GetOwner();
+                hit.collider = nullptr;
+                hit.terrain = terrain;
+                maxT[lane] = h.t;
+            }
+        }
+    }
+}
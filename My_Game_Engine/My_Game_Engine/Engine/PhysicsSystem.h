@@ -1,4 +1,5 @@
 #pragma once
+#include "Physics/Broadphase.h"
 
 class Component;
 class TransformComponent;
@@ -14,6 +15,26 @@ using SceneID = UINT;
 class PhysicsSystem 
 {
 public:
+    static constexpr UINT AllLayers = 0xFFFFFFFFu;
+    static constexpr UINT TerrainLayerMask = 1u << 0; // terrains have no collider and answer queries on layer 0
+
+    struct RaycastHit
+    {
+        Object* object = nullptr;
+        ColliderComponent* collider = nullptr; // null for terrain hits
+        TerrainComponent* terrain = nullptr;
+        XMFLOAT3 point = { 0.0f, 0.0f, 0.0f };
+        XMFLOAT3 normal = { 0.0f, 1.0f, 0.0f };
+        float distance = FLT_MAX;
+    };
+
+    struct Ray
+    {
+        XMFLOAT3 origin = { 0.0f, 0.0f, 0.0f };
+        XMFLOAT3 direction = { 0.0f, 0.0f, 1.0f };
+        float maxDistance = FLT_MAX;
+    };
+
     struct Entry 
     {
         std::weak_ptr<TransformComponent> tf;
@@ -27,11 +48,15 @@ public:
         std::vector<Entry> statics; // Transform + Collider
 
         std::vector<TerrainComponent*> terrains;
+
+        Broadphase broadphase;
+        bool broadphaseDirty = true;
     };
 
     void Update(SceneID id, float dt);
     void Update_Integration(SceneID id, float dt); 
     void Update_Object_Terrain_Interact(SceneID id, float dt);
+    void Update_Object_Mesh_Interact(SceneID id, float dt);
     void Update_Object_Object_Interact(SceneID id, float dt);
 
     void Register(SceneID id, Object* obj);
@@ -42,6 +67,29 @@ public:
 
     void Clear(SceneID id);
 
+public:
+    bool Raycast(SceneID id, const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, RaycastHit& outHit, UINT layerMask = AllLayers);
+    UINT RaycastAll(SceneID id, const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, std::vector<RaycastHit>& outHits, UINT layerMask = AllLayers);
+    bool SphereCast(SceneID id, const XMFLOAT3& origin, float radius, const XMFLOAT3& direction, float maxDistance, RaycastHit& outHit, UINT layerMask = AllLayers);
+
+    UINT OverlapSphere(SceneID id, const XMFLOAT3& center, float radius, std::vector<Object*>& outObjects, UINT layerMask = AllLayers);
+    UINT OverlapBox(SceneID id, const XMFLOAT3& center, const XMFLOAT3& halfExtents, std::vector<Object*>& outObjects, UINT layerMask = AllLayers);
+    UINT OverlapCapsule(SceneID id, const XMFLOAT3& p0, const XMFLOAT3& p1, float radius, std::vector<Object*>& outObjects, UINT layerMask = AllLayers);
+
+    // Closest hit per ray, four rays per broadphase walk. Misses keep distance == FLT_MAX.
+    void RaycastBatch(SceneID id, const std::vector<Ray>& rays, std::vector<RaycastHit>& outHits, UINT layerMask = AllLayers);
+
+private:
+    static constexpr int MaxCCDSubsteps = 4;
+    static constexpr float CCDContactSkin = 0.005f;
+
+    void Integrate_CCD(World& world, TransformComponent* tf, RigidbodyComponent* rb, ColliderComponent* col, float dt);
+    bool SweepSphere(World& world, const XMFLOAT3& origin, float radius, const XMFLOAT3& dir, float maxDistance, UINT layerMask, const ColliderComponent* ignore, RaycastHit& outHit);
+
+    void RebuildBroadphase(World& world);
+    World* GetQueryWorld(SceneID id);
+    bool ResolveProxy(World& world, const Broadphase::Proxy& proxy, std::shared_ptr<TransformComponent>& outTf, std::shared_ptr<ColliderComponent>& outCol) const;
+
 private:
     std::unordered_map<SceneID, World> worlds;
 };
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "AnimationBinding.h"
+#include "AnimationClip.h"
+#include "AvatarMask.h"
+
+size_t AnimationBindingCache::KeyHash::operator()(const Key& key) const
+{
+    size_t h = std::hash<const void*>()(key.source);
+    h ^= std::hash<const void*>()(key.skeleton) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h ^= std::hash<const void*>()(key.avatar) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h ^= std::hash<UINT>()(key.avatarRevision) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h ^= std::hash<UINT>()(key.sourceRevision) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+AnimationBindingCache& AnimationBindingCache::Get()
+{
+    static AnimationBindingCache instance;
+    return instance;
+}
+
+std::shared_ptr<const AvatarBinding> AnimationBindingCache::GetAvatarBinding(const std::shared_ptr<Skeleton>& skeleton,
+    const std::shared_ptr<Model_Avatar>& avatar)
+{
+    if (!skeleton || !avatar) return nullptr;
+
+    Key key{ nullptr, skeleton.get(), avatar.get(), avatar->GetMappingRevision(), 0 };
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mAvatarBindings.find(key);
+        if (it != mAvatarBindings.end() && it->second.IsAlive(false))
+            return it->second.binding;
+    }
+
+    auto binding = std::make_shared<AvatarBinding>();
+    const UINT boneCount = skeleton->GetBoneCount();
+    binding->boneKeys.resize(boneCount);
+    for (UINT i = 0; i < boneCount; ++i)
+        binding->boneKeys[i] = avatar->GetMappedKeyByBoneName(skeleton->GetBoneName((int)i));
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mAvatarBindings[key] = { {}, skeleton, avatar, binding };
+    return binding;
+}
+
+std::shared_ptr<const ClipBinding> AnimationBindingCache::GetClipBinding(const std::shared_ptr<AnimationClip>& clip,
+    const std::shared_ptr<Skeleton>& skeleton, const std::shared_ptr<Model_Avatar>& avatar)
+{
+    if (!clip || !skeleton || !avatar) return nullptr;
+
+    Key key{ clip.get(), skeleton.get(), avatar.get(), avatar->GetMappingRevision(), 0 };
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mClipBindings.find(key);
+        if (it != mClipBindings.end() && it->second.IsAlive(true))
+            return it->second.binding;
+    }
+
+    auto avatarBinding = GetAvatarBinding(skeleton, avatar);
+    if (!avatarBinding) return nullptr;
+
+    auto binding = std::make_shared<ClipBinding>();
+    const size_t boneCount = avatarBinding->boneKeys.size();
+    binding->boneToTrack.assign(boneCount, InvalidTrackIndex);
+    for (size_t i = 0; i < boneCount; ++i)
+    {
+        const std::string& boneKey = avatarBinding->boneKeys[i];
+        if (!boneKey.empty())
+            binding->boneToTrack[i] = clip->FindTrackIndex(boneKey);
+    }
+    binding->rootTrack = clip->FindTrackIndex("Hips");
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mClipBindings[key] = { clip, skeleton, avatar, binding };
+    return binding;
+}
+
+std::shared_ptr<const MaskBinding> AnimationBindingCache::GetMaskBinding(const std::shared_ptr<AvatarMask>& mask,
+    const std::shared_ptr<Skeleton>& skeleton, const std::shared_ptr<Model_Avatar>& avatar)
+{
+    if (!mask || !skeleton || !avatar) return nullptr;
+
+    Key key{ mask.get(), skeleton.get(), avatar.get(), avatar->GetMappingRevision(), mask->GetRevision() };
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mMaskBindings.find(key);
+        if (it != mMaskBindings.end() && it->second.IsAlive(true))
+            return it->second.binding;
+    }
+
+    auto avatarBinding = GetAvatarBinding(skeleton, avatar);
+    if (!avatarBinding) return nullptr;
+
+    auto binding = std::make_shared<MaskBinding>();
+    mask->Compile(*skeleton, avatarBinding->boneKeys, binding->weights);
+
+    // Padding bits past the last bone are set so a trailing masked-out block is skipped as a whole.
+    const size_t boneCount = binding->weights.size();
+    binding->zeroBits.assign((boneCount + 63) / 64, 0);
+    for (size_t i = 0; i < binding->zeroBits.size() * 64; ++i)
+    {
+        if (i >= boneCount || binding->weights[i] <= 0.0f)
+            binding->zeroBits[i >> 6] |= (uint64_t(1) << (i & 63));
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mMaskBindings[key] = { mask, skeleton, avatar, binding };
+    return binding;
+}
+
+void AnimationBindingCache::PurgeExpired()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    // Entries built against an older avatar mapping can never be hit again either.
+    auto stale = [](const Key& key, const auto& entry, bool hasSource)
+        {
+            if (!entry.IsAlive(hasSource)) return true;
+            auto avatar = entry.avatar.lock();
+            return !avatar || avatar->GetMappingRevision() != key.avatarRevision;
+        };
+
+    std::erase_if(mAvatarBindings, [&](const auto& pair) { return stale(pair.first, pair.second, false); });
+    std::erase_if(mClipBindings, [&](const auto& pair) { return stale(pair.first, pair.second, true); });
+    std::erase_if(mMaskBindings, [&](const auto& pair)
+        {
+            if (stale(pair.first, pair.second, true)) return true;
+            auto mask = std::static_pointer_cast<AvatarMask>(pair.second.source.lock());
+            return !mask || mask->GetRevision() != pair.first.sourceRevision;
+        });
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+class AnimationClip;
+class AvatarMask;
+class Skeleton;
+class Model_Avatar;
+
+constexpr uint16_t InvalidTrackIndex = 0xFFFF;
+
+// Abstract avatar key of every skeleton bone, empty for unmapped bones.
+struct AvatarBinding
+{
+    std::vector<std::string> boneKeys;
+};
+
+// Track index of every skeleton bone in a clip, InvalidTrackIndex where the clip has no track.
+// Indices are valid for both the clip's regular and additive track arrays.
+struct ClipBinding
+{
+    std::vector<uint16_t> boneToTrack;
+    uint16_t rootTrack = InvalidTrackIndex;
+};
+
+// An avatar mask compiled against a skeleton: one weight per bone, plus a bit per bone whose weight is zero
+// so layers can step over whole masked-out blocks.
+struct MaskBinding
+{
+    std::vector<float> weights;
+    std::vector<uint64_t> zeroBits;
+
+    bool IsZero(size_t bone) const { return (zeroBits[bone >> 6] >> (bone & 63)) & 1; }
+    uint64_t GetZeroWord(size_t word) const { return zeroBits[word]; }
+};
+
+// Bindings resolved by name once per (skeleton, avatar), (clip, skeleton, avatar) and (mask, skeleton, avatar),
+// then shared by every controller using the same resources. Entries whose resources were released are rebuilt.
+class AnimationBindingCache
+{
+public:
+    static AnimationBindingCache& Get();
+
+    std::shared_ptr<const AvatarBinding> GetAvatarBinding(const std::shared_ptr<Skeleton>& skeleton,
+        const std::shared_ptr<Model_Avatar>& avatar);
+
+    std::shared_ptr<const ClipBinding> GetClipBinding(const std::shared_ptr<AnimationClip>& clip,
+        const std::shared_ptr<Skeleton>& skeleton, const std::shared_ptr<Model_Avatar>& avatar);
+
+    std::shared_ptr<const MaskBinding> GetMaskBinding(const std::shared_ptr<AvatarMask>& mask,
+        const std::shared_ptr<Skeleton>& skeleton, const std::shared_ptr<Model_Avatar>& avatar);
+
+    // Drops entries whose source, skeleton or avatar no longer exists or has changed since.
+    void PurgeExpired();
+
+private:
+    struct Key
+    {
+        const void* source = nullptr; // clip or mask, null for avatar bindings
+        const void* skeleton = nullptr;
+        const void* avatar = nullptr;
+        UINT avatarRevision = 0;
+        UINT sourceRevision = 0;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    template<typename T>
+    struct Entry
+    {
+        std::weak_ptr<void> source;
+        std::weak_ptr<Skeleton> skeleton;
+        std::weak_ptr<Model_Avatar> avatar;
+        std::shared_ptr<const T> binding;
+
+        bool IsAlive(bool hasSource) const { return (!hasSource || !source.expired()) && !skeleton.expired() && !avatar.expired(); }
+    };
+
+private:
+    std::mutex mMutex;
+    std::unordered_map<Key, Entry<AvatarBinding>, KeyHash> mAvatarBindings;
+    std::unordered_map<Key, Entry<ClipBinding>, KeyHash> mClipBindings;
+    std::unordered_map<Key, Entry<MaskBinding>, KeyHash> mMaskBindings;
+};
@@ -1,77 +1,355 @@
 #include "AnimationClip.h"
 #include "DXMathUtils.h"
+#include "BinaryIO.h"
+#include "GameEngine.h"
 
 
 namespace
 {
-    struct KeyTimeCompare {
-        bool operator()(const auto& key, float time) const { return key.time < time; }
-        bool operator()(float time, const auto& key) const { return time < key.time; }
+    constexpr uint32_t ClipMagic = 0x4D494E41; // "ANIM"
+    constexpr uint32_t ClipVersion = 2; // 2: additive reference clip
+    constexpr size_t KeyDataAlignment = 16;
+
+    enum ClipFlags : uint32_t
+    {
+        ClipFlag_RootMotionBaked = 1 << 0,
+        ClipFlag_Additive = 1 << 1,
+    };
+
+    struct ChannelHeader
+    {
+        uint32_t count = 0;
+        float invStep = 0.0f;
     };
 
     template<typename T>
-    void WriteKeyVector(rapidjson::Value& obj, const char* name, const std::vector<TKey<T>>& vec, rapidjson::Document::AllocatorType& alloc);
+    ChannelHeader MakeChannelHeader(const KeyChannel<T>& channel)
+    {
+        return { static_cast<uint32_t>(channel.size()), channel.invStep };
+    }
+
+    template<typename T>
+    void WriteChannelData(std::ostream& os, const KeyChannel<T>& channel)
+    {
+        BinaryIO::WritePadding(os, KeyDataAlignment);
+        BinaryIO::WriteArray(os, channel.times.data(), channel.times.size());
+        BinaryIO::WritePadding(os, KeyDataAlignment);
+        BinaryIO::WriteArray(os, channel.values.data(), channel.values.size());
+    }
+
+    template<typename T>
+    bool ReadChannelData(BinaryReader& reader, const ChannelHeader& header, KeyChannel<T>& channel)
+    {
+        if (!reader.Align(KeyDataAlignment) || !reader.ReadArray(channel.times, header.count)) return false;
+        if (!reader.Align(KeyDataAlignment) || !reader.ReadArray(channel.values, header.count)) return false;
+        channel.invStep = header.invStep;
+        return true;
+    }
+
+    // Name table, then every channel's header, then the key arrays, each aligned for direct use.
+    void WriteTrackSet(std::ostream& os, const std::vector<std::pair<std::string, AnimationTrack>>& tracks)
+    {
+        BinaryIO::Write(os, static_cast<uint32_t>(tracks.size()));
+        for (const auto& [name, track] : tracks)
+            BinaryIO::WriteString(os, name);
+
+        for (const auto& [name, track] : tracks)
+        {
+            BinaryIO::Write(os, MakeChannelHeader(track.PositionKeys));
+            BinaryIO::Write(os, MakeChannelHeader(track.RotationKeys));
+            BinaryIO::Write(os, MakeChannelHeader(track.ScaleKeys));
+        }
+
+        for (const auto& [name, track] : tracks)
+        {
+            WriteChannelData(os, track.PositionKeys);
+            WriteChannelData(os, track.RotationKeys);
+            WriteChannelData(os, track.ScaleKeys);
+        }
+    }
+
+    bool ReadTrackSet(BinaryReader& reader, std::vector<std::pair<std::string, AnimationTrack>>& tracks)
+    {
+        // Each track needs at least its name length and three channel headers.
+        uint32_t count = 0;
+        if (!reader.Read(count) || !reader.CanRead(count, sizeof(uint32_t) + 3 * sizeof(ChannelHeader))) return false;
+
+        tracks.clear();
+        tracks.resize(count);
+        for (auto& [name, track] : tracks)
+        {
+            if (!reader.ReadString(name)) return false;
+        }
+
+        std::vector<ChannelHeader> headers;
+        if (!reader.ReadArray(headers, size_t(count) * 3)) return false;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            AnimationTrack& track = tracks[i].second;
+            bool ok = ReadChannelData(reader, headers[i * 3 + 0], track.PositionKeys) &&
+                ReadChannelData(reader, headers[i * 3 + 1], track.RotationKeys) &&
+                ReadChannelData(reader, headers[i * 3 + 2], track.ScaleKeys);
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    template<typename T>
+    void WriteKeyVector(rapidjson::Value& obj, const char* name, const KeyChannel<T>& vec, rapidjson::Document::AllocatorType& alloc);
 
     template<>
-    void WriteKeyVector<XMFLOAT3>(rapidjson::Value& obj, const char* name, const std::vector<VectorKey>& vec, rapidjson::Document::AllocatorType& alloc)
+    void WriteKeyVector<XMFLOAT3>(rapidjson::Value& obj, const char* name, const KeyChannel<XMFLOAT3>& vec, rapidjson::Document::AllocatorType& alloc)
     {
         rapidjson::Value keys(rapidjson::kArrayType);
-        for (const auto& k : vec)
+        for (size_t i = 0; i < vec.size(); ++i)
         {
-            keys.PushBack(k.time, alloc);
-            keys.PushBack(k.value.x, alloc);
-            keys.PushBack(k.value.y, alloc);
-            keys.PushBack(k.value.z, alloc);
+            keys.PushBack(vec.times[i], alloc);
+            keys.PushBack(vec.values[i].x, alloc);
+            keys.PushBack(vec.values[i].y, alloc);
+            keys.PushBack(vec.values[i].z, alloc);
         }
         obj.AddMember(rapidjson::Value(name, alloc), keys, alloc);
     }
 
     template<>
-    void WriteKeyVector<XMFLOAT4>(rapidjson::Value& obj, const char* name, const std::vector<QuatKey>& vec, rapidjson::Document::AllocatorType& alloc)
+    void WriteKeyVector<XMFLOAT4>(rapidjson::Value& obj, const char* name, const KeyChannel<XMFLOAT4>& vec, rapidjson::Document::AllocatorType& alloc)
     {
         rapidjson::Value keys(rapidjson::kArrayType);
-        for (const auto& k : vec)
+        for (size_t i = 0; i < vec.size(); ++i)
         {
-            keys.PushBack(k.time, alloc);
-            keys.PushBack(k.value.x, alloc);
-            keys.PushBack(k.value.y, alloc);
-            keys.PushBack(k.value.z, alloc);
-            keys.PushBack(k.value.w, alloc);
+            keys.PushBack(vec.times[i], alloc);
+            keys.PushBack(vec.values[i].x, alloc);
+            keys.PushBack(vec.values[i].y, alloc);
+            keys.PushBack(vec.values[i].z, alloc);
+            keys.PushBack(vec.values[i].w, alloc);
         }
         obj.AddMember(rapidjson::Value(name, alloc), keys, alloc);
     }
 
     template<typename T>
-    void ReadKeyVector(const rapidjson::Value& obj, const char* name, std::vector<TKey<T>>& vec);
+    void ReadKeyVector(const rapidjson::Value& obj, const char* name, KeyChannel<T>& vec);
 
     template<>
-    void ReadKeyVector<XMFLOAT3>(const rapidjson::Value& obj, const char* name, std::vector<VectorKey>& vec)
+    void ReadKeyVector<XMFLOAT3>(const rapidjson::Value& obj, const char* name, KeyChannel<XMFLOAT3>& vec)
     {
         if (obj.HasMember(name) && obj[name].IsArray())
         {
             const auto& arr = obj[name].GetArray();
-            for (size_t i = 0; i < arr.Size(); i += 4)
+            vec.reserve(arr.Size() / 4);
+            for (size_t i = 0; i + 3 < arr.Size(); i += 4)
             {
-                vec.push_back({ arr[i].GetFloat(), { arr[i + 1].GetFloat(), arr[i + 2].GetFloat(), arr[i + 3].GetFloat() } });
+                vec.Add(arr[i].GetFloat(), { arr[i + 1].GetFloat(), arr[i + 2].GetFloat(), arr[i + 3].GetFloat() });
             }
         }
     }
 
     template<>
-    void ReadKeyVector<XMFLOAT4>(const rapidjson::Value& obj, const char* name, std::vector<QuatKey>& vec)
+    void ReadKeyVector<XMFLOAT4>(const rapidjson::Value& obj, const char* name, KeyChannel<XMFLOAT4>& vec)
     {
         if (obj.HasMember(name) && obj[name].IsArray())
         {
             const auto& arr = obj[name].GetArray();
-            for (size_t i = 0; i < arr.Size(); i += 5)
+            vec.reserve(arr.Size() / 5);
+            for (size_t i = 0; i + 4 < arr.Size(); i += 5)
             {
-                vec.push_back({ arr[i].GetFloat(), { arr[i + 1].GetFloat(), arr[i + 2].GetFloat(), arr[i + 3].GetFloat(), arr[i + 4].GetFloat() } });
+                vec.Add(arr[i].GetFloat(), { arr[i + 1].GetFloat(), arr[i + 2].GetFloat(), arr[i + 3].GetFloat(), arr[i + 4].GetFloat() });
             }
         }
     }
+
+    template<typename T, typename Interp>
+    T SampleChannel(const KeyChannel<T>& channel, float time, UINT& cursor, const T& fallback, Interp interp)
+    {
+        if (channel.empty()) return fallback;
+
+        if (time <= channel.times.front())
+        {
+            cursor = 0;
+            return channel.values.front();
+        }
+        if (time >= channel.times.back())
+            return channel.values.back();
+
+        UINT i = channel.FindKey(time, cursor);
+
+        float keyTimeDiff = channel.times[i + 1] - channel.times[i];
+        if (keyTimeDiff <= 0.0f)
+            return channel.values[i];
+
+        float t = (time - channel.times[i]) / keyTimeDiff;
+        return interp(channel.values[i], channel.values[i + 1], t);
+    }
+
+    XMFLOAT3 LerpKey(const XMFLOAT3& a, const XMFLOAT3& b, float t) { return Math::Lerp(a, b, t); }
+    XMFLOAT4 SlerpKey(const XMFLOAT4& a, const XMFLOAT4& b, float t) { return Matrix4x4::QuaternionSlerp(a, b, t); }
+
+    // Index of boneKey in the name-sorted track list, or tracks.size() when missing.
+    size_t FindTrackSlot(const std::vector<std::pair<std::string, AnimationTrack>>& tracks, const std::string& boneKey)
+    {
+        auto it = std::lower_bound(tracks.begin(), tracks.end(), boneKey,
+            [](const std::pair<std::string, AnimationTrack>& element, const std::string& key) {
+                return element.first < key;
+            });
+
+        if (it != tracks.end() && it->first == boneKey)
+        {
+            return static_cast<size_t>(it - tracks.begin());
+        }
+        return tracks.size();
+    }
+
+    const AnimationTrack* FindTrack(const std::vector<std::pair<std::string, AnimationTrack>>& tracks, const std::string& boneKey)
+    {
+        size_t slot = FindTrackSlot(tracks, boneKey);
+        return slot < tracks.size() ? &tracks[slot].second : nullptr;
+    }
+
+    XMFLOAT4 LerpKey4(const XMFLOAT4& a, const XMFLOAT4& b, float t)
+    {
+        return XMFLOAT4(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t);
+    }
+
+    // Rotation about +Y contained in q (twist of a swing-twist split), in (-pi, pi].
+    float YawOf(const XMFLOAT4& q)
+    {
+        float sign = (q.w < 0.0f) ? -1.0f : 1.0f;
+        return 2.0f * std::atan2(q.y * sign, q.w * sign);
+    }
+
+    // Rewrites every key through delta, then drops the channel if it is identity throughout
+    // or keeps a single key if it never changes.
+    template<typename T, typename Delta>
+    void MakeDeltaChannel(KeyChannel<T>& channel, const T& identity, Delta delta)
+    {
+        constexpr float Epsilon = 1e-5f;
+        auto nearlyEqual = [](const T& a, const T& b)
+            {
+                const float* pa = &a.x;
+                const float* pb = &b.x;
+                for (size_t c = 0; c < sizeof(T) / sizeof(float); ++c)
+                    if (std::fabs(pa[c] - pb[c]) > Epsilon) return false;
+                return true;
+            };
+
+        bool allIdentity = true;
+        bool allSame = true;
+        for (size_t i = 0; i < channel.size(); ++i)
+        {
+            channel.values[i] = delta(channel.values[i]);
+            allIdentity = allIdentity && nearlyEqual(channel.values[i], identity);
+            allSame = allSame && nearlyEqual(channel.values[i], channel.values[0]);
+        }
+
+        if (allIdentity)
+        {
+            channel = KeyChannel<T>();
+        }
+        else if (allSame && channel.size() > 1)
+        {
+            T value = channel.values[0];
+            channel = KeyChannel<T>();
+            channel.Add(0.0f, value);
+        }
+    }
+}
+
+template<typename T>
+void KeyChannel<T>::Finalize()
+{
+    invStep = 0.0f;
+
+    const size_t count = times.size();
+    if (count < 2) return;
+
+    const float step = (times.back() - times.front()) / static_cast<float>(count - 1);
+    if (step <= 0.0f) return;
+
+    const float tolerance = step * 1e-3f;
+    for (size_t i = 1; i + 1 < count; ++i)
+    {
+        if (fabsf(times[i] - (times.front() + step * static_cast<float>(i))) > tolerance)
+            return;
+    }
+
+    invStep = 1.0f / step;
 }
 
+template<typename T>
+UINT KeyChannel<T>::FindKey(float time, UINT& cursor) const
+{
+    const UINT last = static_cast<UINT>(times.size()) - 2;
+    UINT i;
+
+    if (invStep > 0.0f)
+    {
+        i = std::min(static_cast<UINT>((time - times.front()) * invStep), last);
+
+        // Rounding can land one key off right at a key boundary.
+        if (i > 0 && time < times[i]) --i;
+        else if (i < last && time >= times[i + 1]) ++i;
+    }
+    else
+    {
+        i = std::min(cursor, last);
+
+        // Forward playback normally stays on the cursor's key or moves a step or two.
+        UINT steps = 0;
+        while (i < last && time >= times[i + 1] && steps++ < MaxCursorSteps)
+            ++i;
+
+        // Seeks, loops and large jumps fall back to a binary search.
+        if (time < times[i] || (i < last && time >= times[i + 1]))
+        {
+            auto it = std::upper_bound(times.begin(), times.end(), time);
+            i = static_cast<UINT>(it - times.begin()) - 1;
+        }
+    }
+
+    cursor = i;
+    return i;
+}
+
+template struct KeyChannel<XMFLOAT3>;
+template struct KeyChannel<XMFLOAT4>;
+
 bool AnimationClip::SaveToFile(const std::string& path) const
+{
+    bool ok = BinaryIO::WriteFileAtomic(path, [this](std::ostream& os)
+        {
+            uint32_t flags = 0;
+            if (mRootMotionBaked) flags |= ClipFlag_RootMotionBaked;
+            if (mHasAdditive) flags |= ClipFlag_Additive;
+
+            BinaryIO::Write(os, ClipMagic);
+            BinaryIO::Write(os, ClipVersion);
+            BinaryIO::Write(os, static_cast<int32_t>(mAvatarDefinitionType));
+            BinaryIO::Write(os, mDuration);
+            BinaryIO::Write(os, mTicksPerSecond);
+            BinaryIO::Write(os, flags);
+            BinaryIO::Write(os, mAdditiveReferenceTime);
+            BinaryIO::Write(os, mAdditiveReferenceClip);
+
+            WriteTrackSet(os, mTracks);
+
+            if (mRootMotionBaked)
+            {
+                BinaryIO::Write(os, MakeChannelHeader(mRootMotion));
+                WriteChannelData(os, mRootMotion);
+            }
+
+            if (mHasAdditive)
+                WriteTrackSet(os, mAdditiveTracks);
+
+            return true;
+        });
+
+    if (!ok)
+        OutputDebugStringA(("[AnimationClip] Failed to write clip: " + path + "\n").c_str());
+    return ok;
+}
+
+bool AnimationClip::ExportToJson(const std::string& path) const
 {
     Document doc(kObjectType);
     Document::AllocatorType& alloc = doc.GetAllocator();
@@ -91,6 +369,19 @@ bool AnimationClip::SaveToFile(const std::string& path) const
     }
     doc.AddMember("Tracks", tracks, alloc);
 
+    if (mRootMotionBaked)
+    {
+        doc.AddMember("RootMotionBaked", true, alloc);
+        WriteKeyVector(doc, "RootMotion", mRootMotion, alloc);
+    }
+
+    if (mHasAdditive)
+    {
+        doc.AddMember("AdditiveReferenceTime", mAdditiveReferenceTime, alloc);
+        if (mAdditiveReferenceClip.IsValid())
+            doc.AddMember("AdditiveReferenceClip", Value(mAdditiveReferenceClip.ToString().c_str(), alloc), alloc);
+    }
+
     StringBuffer buffer;
     PrettyWriter<StringBuffer> writer(buffer);
     doc.Accept(writer);
@@ -104,16 +395,83 @@ bool AnimationClip::SaveToFile(const std::string& path) const
 
 bool AnimationClip::LoadFromFile(std::string path, const RendererContext& ctx)
 {
-    std::ifstream ifs(path);
-    if (!ifs.is_open()) return false;
+    // Packed clips are decompressed into memory; loose ones are mapped.
+    ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
+    MappedFile file;
+    std::vector<uint8_t> packed;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    if (rs->FindPack(path))
+    {
+        if (!rs->ReadFile(path, packed)) return false;
+        data = packed.data();
+        size = packed.size();
+    }
+    else
+    {
+        if (!file.Open(path)) return false;
+        data = file.GetData();
+        size = file.GetSize();
+    }
+
+    uint32_t magic = 0;
+    BinaryReader reader(data, size);
+    if (!reader.Read(magic) || magic != ClipMagic)
+        return ReadJson(reinterpret_cast<const char*>(data), size);
+
+    reader = BinaryReader(data, size);
+    if (!ReadBinary(reader) || !reader.IsAtEnd())
+    {
+        OutputDebugStringA(("[AnimationClip] Invalid clip file: " + path + "\n").c_str());
+        return false;
+    }
+    return true;
+}
+
+bool AnimationClip::ReadBinary(BinaryReader& reader)
+{
+    uint32_t magic = 0, version = 0, flags = 0;
+    int32_t definitionType = 0;
+    if (!reader.Read(magic) || !reader.Read(version) || magic != ClipMagic || version == 0 || version > ClipVersion)
+        return false;
+
+    bool ok = reader.Read(definitionType) && reader.Read(mDuration) && reader.Read(mTicksPerSecond) &&
+        reader.Read(flags) && reader.Read(mAdditiveReferenceTime);
+    if (!ok) return false;
+
+    // Version 1 clips were always additive against themselves.
+    mAdditiveReferenceClip = {};
+    if (version >= 2 && !reader.Read(mAdditiveReferenceClip)) return false;
+    mAvatarDefinitionType = static_cast<DefinitionType>(definitionType);
+
+    if (!ReadTrackSet(reader, mTracks)) return false;
 
-    std::stringstream buffer;
-    buffer << ifs.rdbuf();
-    std::string json = buffer.str();
-    ifs.close();
+    mRootMotion = KeyChannel<XMFLOAT4>();
+    mRootMotionBaked = (flags & ClipFlag_RootMotionBaked) != 0;
+    if (mRootMotionBaked)
+    {
+        ChannelHeader header;
+        if (!reader.Read(header) || !ReadChannelData(reader, header, mRootMotion)) return false;
+    }
+    else
+    {
+        BakeRootMotion();
+    }
+
+    // Additive tracks were built against the reference when the clip was saved.
+    mAdditiveTracks.clear();
+    mHasAdditive = (flags & ClipFlag_Additive) != 0;
+    if (mHasAdditive && !ReadTrackSet(reader, mAdditiveTracks)) return false;
+    ++mAdditiveRevision;
+
+    return true;
+}
 
+bool AnimationClip::ReadJson(const char* json, size_t size)
+{
     Document doc;
-    if (doc.Parse(json.c_str()).HasParseError()) return false;
+    if (doc.Parse(json, size).HasParseError()) return false;
 
     if (doc.HasMember("DefinitionType"))
         mAvatarDefinitionType = (DefinitionType)doc["DefinitionType"].GetInt();
@@ -134,107 +492,119 @@ bool AnimationClip::LoadFromFile(std::string path, const RendererContext& ctx)
         ReadKeyVector(trackObj, "PositionKeys", track.PositionKeys);
         ReadKeyVector(trackObj, "RotationKeys", track.RotationKeys);
         ReadKeyVector(trackObj, "ScaleKeys", track.ScaleKeys);
+        track.Finalize();
 
         mTracks.emplace_back(std::move(boneName), std::move(track));
     }
 
     std::sort(mTracks.begin(), mTracks.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
 
+    // Clips saved before root motion baking still carry it in the Hips track.
+    mRootMotion = KeyChannel<XMFLOAT4>();
+    if (doc.HasMember("RootMotionBaked") && doc["RootMotionBaked"].GetBool())
+    {
+        ReadKeyVector(doc, "RootMotion", mRootMotion);
+        mRootMotion.Finalize();
+        mRootMotionBaked = true;
+    }
+    else
+    {
+        BakeRootMotion();
+    }
+
+    mAdditiveTracks.clear();
+    mHasAdditive = false;
+    mAdditiveReferenceClip = {};
+    if (doc.HasMember("AdditiveReferenceClip") && doc["AdditiveReferenceClip"].IsString())
+        mAdditiveReferenceClip = Guid::FromString(doc["AdditiveReferenceClip"].GetString());
+    if (doc.HasMember("AdditiveReferenceTime"))
+    {
+        mAdditiveReferenceTime = doc["AdditiveReferenceTime"].GetFloat();
+        mAdditivePending = true;
+    }
+
     return true;
 }
 
 XMFLOAT3 AnimationTrack::SamplePosition(float time) const
 {
-    if (PositionKeys.empty()) return XMFLOAT3(0, 0, 0);
-
-    auto itNext = std::lower_bound(PositionKeys.begin(), PositionKeys.end(), time, KeyTimeCompare{});
-
-    if (itNext == PositionKeys.begin())
-        return PositionKeys.front().value;
-    if (itNext == PositionKeys.end())
-        return PositionKeys.back().value;
-
-    auto itPrev = itNext - 1;
-
-    float keyTimeDiff = itNext->time - itPrev->time;
-    if (keyTimeDiff <= 0.0f)
-        return itPrev->value;
-
-    float t = (time - itPrev->time) / keyTimeDiff;
-    return Math::Lerp(itPrev->value, itNext->value, t);
+    UINT cursor = 0;
+    return SampleChannel(PositionKeys, time, cursor, XMFLOAT3(0, 0, 0), LerpKey);
 }
 
 XMFLOAT4 AnimationTrack::SampleRotation(float time) const
 {
-    if (RotationKeys.empty()) return XMFLOAT4(0, 0, 0, 1);
-
-    auto itNext = std::lower_bound(RotationKeys.begin(), RotationKeys.end(), time, KeyTimeCompare{});
-
-    if (itNext == RotationKeys.begin())
-        return RotationKeys.front().value;
-    if (itNext == RotationKeys.end())
-        return RotationKeys.back().value;
-
-    auto itPrev = itNext - 1;
-
-    float keyTimeDiff = itNext->time - itPrev->time;
-    if (keyTimeDiff <= 0.0f)
-        return itPrev->value;
-
-    float t = (time - itPrev->time) / keyTimeDiff;
-    return Matrix4x4::QuaternionSlerp(itPrev->value, itNext->value, t);
+    UINT cursor = 0;
+    return SampleChannel(RotationKeys, time, cursor, XMFLOAT4(0, 0, 0, 1), SlerpKey);
 }
 
 XMFLOAT3 AnimationTrack::SampleScale(float time) const
 {
-    if (ScaleKeys.empty()) return XMFLOAT3(1, 1, 1);
-
-    auto itNext = std::lower_bound(ScaleKeys.begin(), ScaleKeys.end(), time, KeyTimeCompare{});
-
-    if (itNext == ScaleKeys.begin())
-        return ScaleKeys.front().value;
-    if (itNext == ScaleKeys.end())
-        return ScaleKeys.back().value;
-
-    auto itPrev = itNext - 1;
-
-    float keyTimeDiff = itNext->time - itPrev->time;
-    if (keyTimeDiff <= 0.0f)
-        return itPrev->value;
-
-    float t = (time - itPrev->time) / keyTimeDiff;
-    return Math::Lerp(itPrev->value, itNext->value, t);
+    UINT cursor = 0;
+    return SampleChannel(ScaleKeys, time, cursor, XMFLOAT3(1, 1, 1), LerpKey);
 }
 
 XMMATRIX AnimationTrack::Sample(float time) const
 {
-    XMFLOAT3 s_val = SampleScale(time);
-    XMFLOAT4 r_val = SampleRotation(time);
-    XMFLOAT3 t_val = SamplePosition(time);
-
-    XMVECTOR S = XMLoadFloat3(&s_val);
-    XMVECTOR R = XMLoadFloat4(&r_val);
-    XMVECTOR T = XMLoadFloat3(&t_val);
+    XMVECTOR S, R, T;
+    Sample(time, S, R, T);
 
     return XMMatrixScalingFromVector(S) * XMMatrixRotationQuaternion(R) * XMMatrixTranslationFromVector(T);
 }
 
 void AnimationTrack::Sample(float time, XMVECTOR& outS, XMVECTOR& outR, XMVECTOR& outT) const
 {
-    XMFLOAT3 s = SampleScale(time);
-    XMFLOAT4 r = SampleRotation(time);
-    XMFLOAT3 t = SamplePosition(time);
+    Cursor cursor;
+    Sample(time, cursor, outS, outR, outT);
+}
+
+void AnimationTrack::Sample(float time, Cursor& cursor, XMVECTOR& outS, XMVECTOR& outR, XMVECTOR& outT) const
+{
+    XMFLOAT3 s = SampleChannel(ScaleKeys, time, cursor.scale, XMFLOAT3(1, 1, 1), LerpKey);
+    XMFLOAT4 r = SampleChannel(RotationKeys, time, cursor.rotation, XMFLOAT4(0, 0, 0, 1), SlerpKey);
+    XMFLOAT3 t = SampleChannel(PositionKeys, time, cursor.position, XMFLOAT3(0, 0, 0), LerpKey);
 
     outS = XMLoadFloat3(&s);
     outR = XMLoadFloat4(&r);
     outT = XMLoadFloat3(&t);
 }
 
+void AnimationTrack::Finalize()
+{
+    PositionKeys.Finalize();
+    RotationKeys.Finalize();
+    ScaleKeys.Finalize();
+}
+
 AnimationClip::AnimationClip()
     : Game_Resource(ResourceType::AnimationClip)
 {
 }
 
+MemoryFootprint AnimationClip::GetMemoryFootprint() const
+{
+    auto channelBytes = [](const auto& channel)
+        {
+            using Value = typename std::decay_t<decltype(channel.values)>::value_type;
+            return static_cast<UINT64>(channel.times.capacity()) * sizeof(float) +
+                static_cast<UINT64>(channel.values.capacity()) * sizeof(Value);
+        };
+    auto trackBytes = [&](const std::vector<std::pair<std::string, AnimationTrack>>& tracks)
+        {
+            UINT64 bytes = static_cast<UINT64>(tracks.capacity()) * sizeof(tracks[0]);
+            for (const auto& [name, track] : tracks)
+            {
+                bytes += name.capacity();
+                bytes += channelBytes(track.PositionKeys) + channelBytes(track.RotationKeys) + channelBytes(track.ScaleKeys);
+            }
+            return bytes;
+        };
+
+    MemoryFootprint footprint;
+    footprint.cpuBytes = trackBytes(mTracks) + trackBytes(mAdditiveTracks) + channelBytes(mRootMotion);
+    return footprint;
+}
+
 UINT AnimationClip::GetTotalKeyframes() 
 {
     if (!TotalKeyframe)
@@ -252,16 +622,179 @@ UINT AnimationClip::GetTotalKeyframes()
 
 const AnimationTrack* AnimationClip::GetTrack(const std::string& boneKey) const
 {
-    auto it = std::lower_bound(mTracks.begin(), mTracks.end(), boneKey,
-        [](const std::pair<std::string, AnimationTrack>& element, const std::string& key) {
-            return element.first < key;
-        });
+    return FindTrack(mTracks, boneKey);
+}
 
-    if (it != mTracks.end() && it->first == boneKey)
+uint16_t AnimationClip::FindTrackIndex(const std::string& boneKey) const
+{
+    size_t slot = FindTrackSlot(mTracks, boneKey);
+    if (slot >= mTracks.size() || slot >= InvalidTrackIndex) return InvalidTrackIndex;
+
+    return static_cast<uint16_t>(slot);
+}
+
+const AnimationTrack* AnimationClip::GetAdditiveTrack(const std::string& boneKey) const
+{
+    return FindTrack(mAdditiveTracks, boneKey);
+}
+
+void AnimationClip::BakeRootMotion()
+{
+    mRootMotion = KeyChannel<XMFLOAT4>();
+    mRootMotionBaked = true;
+
+    size_t slot = FindTrackSlot(mTracks, "Hips");
+    if (slot >= mTracks.size()) return;
+
+    AnimationTrack& track = mTracks[slot].second;
+    if (track.PositionKeys.empty() && track.RotationKeys.empty()) return;
+
+    std::vector<float> times = track.PositionKeys.times;
+    times.insert(times.end(), track.RotationKeys.times.begin(), track.RotationKeys.times.end());
+    std::sort(times.begin(), times.end());
+    times.erase(std::unique(times.begin(), times.end()), times.end());
+
+    const XMFLOAT3 startPos = track.SamplePosition(times.front());
+    float prevYaw = YawOf(track.SampleRotation(times.front()));
+    float yaw = 0.0f;
+
+    mRootMotion.reserve(times.size());
+    for (float t : times)
+    {
+        XMFLOAT3 p = track.SamplePosition(t);
+
+        float keyYaw = YawOf(track.SampleRotation(t));
+        float step = keyYaw - prevYaw;
+        if (step > XM_PI) step -= XM_2PI;
+        else if (step < -XM_PI) step += XM_2PI;
+        yaw += step;
+        prevYaw = keyYaw;
+
+        // Vertical travel stays in the pose so gravity and grounding keep working.
+        mRootMotion.Add(t, XMFLOAT4(p.x - startPos.x, 0.0f, p.z - startPos.z, yaw));
+    }
+    mRootMotion.Finalize();
+
+    for (size_t i = 0; i < track.PositionKeys.size(); ++i)
     {
-        return &it->second;
+        XMFLOAT4 m = SampleRootMotion(track.PositionKeys.times[i]);
+        track.PositionKeys.values[i].x -= m.x;
+        track.PositionKeys.values[i].z -= m.z;
     }
-    return nullptr;
+
+    for (size_t i = 0; i < track.RotationKeys.size(); ++i)
+    {
+        // Undo the accumulated yaw in the parent's space: q' = yaw^-1 * q.
+        XMFLOAT4 m = SampleRootMotion(track.RotationKeys.times[i]);
+        XMVECTOR q = XMLoadFloat4(&track.RotationKeys.values[i]);
+        q = XMQuaternionMultiply(q, XMQuaternionRotationRollPitchYaw(0.0f, -m.w, 0.0f));
+        XMStoreFloat4(&track.RotationKeys.values[i], XMQuaternionNormalize(q));
+    }
+
+    track.Finalize();
+}
+
+XMFLOAT4 AnimationClip::SampleRootMotion(float time) const
+{
+    UINT cursor = 0;
+    return SampleChannel(mRootMotion, time, cursor, XMFLOAT4(0, 0, 0, 0), LerpKey4);
+}
+
+void AnimationClip::SetAdditive(bool additive)
+{
+    if (additive)
+    {
+        auto reference = ResolveAdditiveReference();
+        BuildAdditive(reference.get());
+        return;
+    }
+
+    mAdditiveTracks.clear();
+    mHasAdditive = false;
+    mAdditivePending = false;
+    ++mAdditiveRevision;
+}
+
+void AnimationClip::SetAdditiveReference(const Guid& referenceClip, float referenceTime)
+{
+    mAdditiveReferenceClip = referenceClip;
+    mAdditiveReferenceTime = referenceTime;
+    if (mHasAdditive)
+        SetAdditive(true);
+}
+
+void AnimationClip::ResolvePendingAdditive()
+{
+    if (!mAdditivePending) return;
+
+    auto reference = ResolveAdditiveReference();
+    BuildAdditive(reference.get());
+}
+
+std::shared_ptr<AnimationClip> AnimationClip::ResolveAdditiveReference() const
+{
+    if (!mAdditiveReferenceClip.IsValid() || mAdditiveReferenceClip == GetGUID())
+        return nullptr;
+
+    ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
+    auto reference = rs->GetOrLoad<AnimationClip>(mAdditiveReferenceClip, {});
+    if (!reference)
+        OutputDebugStringA(("[AnimationClip] Additive reference clip not found, using the clip itself: " + GetAlias() + "\n").c_str());
+    return reference;
+}
+
+void AnimationClip::BuildAdditive(const AnimationClip* reference)
+{
+    if (!reference) reference = this;
+    const float referenceTime = mAdditiveReferenceTime;
+    mAdditivePending = false;
+
+    mAdditiveTracks.clear();
+    mAdditiveTracks.reserve(mTracks.size());
+
+    for (const auto& [key, track] : mTracks)
+    {
+        // Bones the reference does not animate are measured against this clip's own reference frame.
+        const AnimationTrack* refTrack = reference->GetTrack(key);
+        if (!refTrack) refTrack = &track;
+
+        XMFLOAT3 refS = refTrack->SampleScale(referenceTime);
+        XMFLOAT4 refR = refTrack->SampleRotation(referenceTime);
+        XMFLOAT3 refT = refTrack->SamplePosition(referenceTime);
+        XMVECTOR invRefR = XMQuaternionInverse(XMLoadFloat4(&refR));
+
+        AnimationTrack additive = track;
+
+        MakeDeltaChannel(additive.PositionKeys, XMFLOAT3(0, 0, 0), [&](const XMFLOAT3& v)
+            {
+                return XMFLOAT3(v.x - refT.x, v.y - refT.y, v.z - refT.z);
+            });
+
+        // ref * delta = key, so applying the delta to the reference reproduces the clip.
+        MakeDeltaChannel(additive.RotationKeys, XMFLOAT4(0, 0, 0, 1), [&](const XMFLOAT4& v)
+            {
+                XMVECTOR q = XMQuaternionNormalize(XMQuaternionMultiply(XMLoadFloat4(&v), invRefR));
+                if (XMVectorGetW(q) < 0.0f) q = XMVectorNegate(q);
+
+                XMFLOAT4 out;
+                XMStoreFloat4(&out, q);
+                return out;
+            });
+
+        MakeDeltaChannel(additive.ScaleKeys, XMFLOAT3(1, 1, 1), [&](const XMFLOAT3& v)
+            {
+                auto ratio = [](float a, float b) { return std::fabs(b) > 1e-6f ? a / b : 1.0f; };
+                return XMFLOAT3(ratio(v.x, refS.x), ratio(v.y, refS.y), ratio(v.z, refS.z));
+            });
+
+        additive.Finalize();
+        mAdditiveTracks.emplace_back(key, std::move(additive));
+    }
+
+    std::sort(mAdditiveTracks.begin(), mAdditiveTracks.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    mHasAdditive = true;
+    ++mAdditiveRevision;
 }
 
 const AnimationTrack* AnimationClip::GetRootTrack() const
@@ -3,30 +3,56 @@
 #include "AvatarSystem.h"
 #include "Model_Avatar.h"
 #include "Skeleton.h"
+#include "AnimationBinding.h"
 
+class BinaryReader;
+
+// Keys of one channel as parallel time/value arrays so the search only touches the times.
 template<typename T>
-struct TKey
+struct KeyChannel
 {
-    float time;
-    T value;
-};
+    std::vector<float> times;
+    std::vector<T> values;
+    float invStep = 0.0f; // non-zero when the keys are evenly spaced
+
+    size_t size() const { return times.size(); }
+    bool empty() const { return times.empty(); }
+    void reserve(size_t n) { times.reserve(n); values.reserve(n); }
+    void Add(float time, const T& value) { times.push_back(time); values.push_back(value); }
+
+    // Detects uniform key spacing; call once the keys are in place.
+    void Finalize();
 
-using VectorKey = TKey<XMFLOAT3>;
-using QuatKey = TKey<XMFLOAT4>;
+    // Index i with times[i] <= time < times[i + 1]. Expects times.front() < time < times.back().
+    UINT FindKey(float time, UINT& cursor) const;
+
+    static constexpr UINT MaxCursorSteps = 4;
+};
 
 class AnimationTrack
 {
 public:
+    // Last key index per channel, so forward playback does not search from scratch.
+    struct Cursor
+    {
+        UINT position = 0;
+        UINT rotation = 0;
+        UINT scale = 0;
+    };
+
     XMFLOAT3 SamplePosition(float time) const;
     XMFLOAT4 SampleRotation(float time) const;
     XMFLOAT3 SampleScale(float time) const;
 
     XMMATRIX Sample(float time) const;
     void Sample(float time, XMVECTOR& outS, XMVECTOR& outR, XMVECTOR& outT) const;
+    void Sample(float time, Cursor& cursor, XMVECTOR& outS, XMVECTOR& outR, XMVECTOR& outT) const;
+
+    void Finalize();
 public:
-    std::vector<VectorKey> PositionKeys;
-    std::vector<QuatKey>   RotationKeys;
-    std::vector<VectorKey> ScaleKeys;
+    KeyChannel<XMFLOAT3> PositionKeys;
+    KeyChannel<XMFLOAT4> RotationKeys;
+    KeyChannel<XMFLOAT3> ScaleKeys;
 };
 
 class AnimationClip : public Game_Resource
@@ -35,8 +61,12 @@ public:
     AnimationClip();
     virtual ~AnimationClip() = default;
 
+    // Clips are saved in the binary .anim format; LoadFromFile also accepts JSON exports and older JSON clips.
     virtual bool LoadFromFile(std::string path, const RendererContext& ctx) override;
     virtual bool SaveToFile(const std::string& path) const;
+    bool ExportToJson(const std::string& path) const;
+
+    virtual MemoryFootprint GetMemoryFootprint() const override;
 
     DefinitionType GetDefinitionType() const { return mAvatarDefinitionType; }
 
@@ -45,8 +75,33 @@ public:
     UINT GetTotalKeyframes();
 
     const AnimationTrack* GetTrack(const std::string& boneKey) const;
+    uint16_t FindTrackIndex(const std::string& boneKey) const; // InvalidTrackIndex when missing
+    const AnimationTrack* GetTrack(uint16_t index) const { return index < mTracks.size() ? &mTracks[index].second : nullptr; }
     const AnimationTrack* GetRootTrack() const;
 
+    // Moves the Hips track's horizontal travel and yaw into a root motion curve (x, y, z = displacement
+    // from the first frame in the root's parent space, w = unwrapped yaw in radians) and strips them from the track.
+    void BakeRootMotion();
+    bool HasRootMotion() const { return !mRootMotion.empty(); }
+    XMFLOAT4 SampleRootMotion(float time) const;
+    XMFLOAT4 GetRootMotionEnd() const { return mRootMotion.empty() ? XMFLOAT4(0, 0, 0, 0) : mRootMotion.values.back(); }
+
+    // Additive version of every track: deltas against the reference clip (this clip when none is set) sampled at
+    // the reference time. Channels that never leave identity are dropped, so sampling them costs nothing.
+    // The tracks are saved with the clip and rebuilt whenever the settings change; the revision tells layers
+    // that their cached track pointers are stale.
+    void SetAdditive(bool additive);
+    void SetAdditiveReference(const Guid& referenceClip, float referenceTime);
+    bool HasAdditive() const { return mHasAdditive; }
+    const Guid& GetAdditiveReferenceClip() const { return mAdditiveReferenceClip; }
+    float GetAdditiveReferenceTime() const { return mAdditiveReferenceTime; }
+    uint32_t GetAdditiveRevision() const { return mAdditiveRevision; }
+    const AnimationTrack* GetAdditiveTrack(const std::string& boneKey) const;
+    const AnimationTrack* GetAdditiveTrack(uint16_t index) const { return index < mAdditiveTracks.size() ? &mAdditiveTracks[index].second : nullptr; }
+    // JSON clips only store the settings; ResourceSystem calls this on the main thread once the clip is registered,
+    // loading the reference if needed. Registration first lets two clips that reference each other resolve.
+    void ResolvePendingAdditive();
+
 	void SetAvatar(std::shared_ptr<Model_Avatar> avatar) { mModelAvatar = avatar; }
     void SetSkeleton(std::shared_ptr<Skeleton> skeleton) { mModelSkeleton = skeleton; }
 
@@ -64,4 +119,19 @@ public:
 
     std::vector<std::pair<std::string, AnimationTrack>> mTracks;
 
+    KeyChannel<XMFLOAT4> mRootMotion;
+    bool mRootMotionBaked = false;
+
+    std::vector<std::pair<std::string, AnimationTrack>> mAdditiveTracks;
+    Guid mAdditiveReferenceClip;
+    float mAdditiveReferenceTime = 0.0f;
+    uint32_t mAdditiveRevision = 0;
+    bool mHasAdditive = false;
+    bool mAdditivePending = false;
+
+private:
+    std::shared_ptr<AnimationClip> ResolveAdditiveReference() const;
+    void BuildAdditive(const AnimationClip* reference);
+    bool ReadBinary(BinaryReader& reader);
+    bool ReadJson(const char* json, size_t size);
 };
\ No newline at end of file
@@ -25,6 +25,17 @@ struct AnimationState
     bool isReverse = false;
     bool isValid = false;
 
+    // Per-bone key cursors into the clip's tracks, indexed like the layer's bone cache.
+    std::vector<AnimationTrack::Cursor> cursors;
+
+    // Skeleton bone -> clip track indices, shared through AnimationBindingCache.
+    std::shared_ptr<const ClipBinding> binding;
+
+    // Root motion curve value at rootMotionTime; invalid after jumps so the next frame resyncs instead of teleporting.
+    XMFLOAT4 rootMotionSample = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float rootMotionTime = 0.0f;
+    bool rootMotionValid = false;
+
     void Reset(std::shared_ptr<AnimationClip> newClip, float newSpeed, PlaybackMode newMode)
     {
         clip = newClip;
@@ -34,6 +45,9 @@ struct AnimationState
         weight = 1.0f;
         isReverse = false;
         isValid = (clip != nullptr);
+        binding.reset();
+        rootMotionValid = false;
+        cursors.assign(cursors.size(), AnimationTrack::Cursor{});
     }
 
     void Update(float deltaTime)
@@ -1,4 +1,5 @@
 #include "AnimationLayer.h"
+#include "AnimationPoseCache.h"
 #include "GameEngine.h"
 
 AnimationLayer::AnimationLayer()
@@ -14,10 +15,10 @@ rapidjson::Value AnimationLayer::ToJSON(rapidjson::Document::AllocatorType& allo
     v.AddMember("BlendMode", static_cast<int>(mBlendMode), alloc);
     v.AddMember("EnableRootMotion", mEnableRootMotion, alloc);
 
-    std::string maskGUID = mMask ? mMask->GetGUID() : "";
+    std::string maskGUID = mMask ? mMask->GetGUID().ToString() : "";
     v.AddMember("MaskGUID", rapidjson::Value(maskGUID.c_str(), alloc), alloc);
 
-    std::string clipGUID = mCurrentState.clip ? mCurrentState.clip->GetGUID() : "";
+    std::string clipGUID = mCurrentState.clip ? mCurrentState.clip->GetGUID().ToString() : "";
     v.AddMember("CurrentClipGUID", rapidjson::Value(clipGUID.c_str(), alloc), alloc);
 
     v.AddMember("Time", mCurrentState.currentTime, alloc);
@@ -39,8 +40,8 @@ void AnimationLayer::FromJSON(const rapidjson::Value& val)
 
     if (val.HasMember("MaskGUID"))
     {
-        std::string guid = val["MaskGUID"].GetString();
-        if (!guid.empty())
+        Guid guid = Guid::FromString(val["MaskGUID"].GetString());
+        if (guid.IsValid())
         {
             mMask = resSystem->GetByGUID<AvatarMask>(guid);
         }
@@ -52,8 +53,8 @@ void AnimationLayer::FromJSON(const rapidjson::Value& val)
 
     if (val.HasMember("CurrentClipGUID"))
     {
-        std::string guid = val["CurrentClipGUID"].GetString();
-        if (!guid.empty())
+        Guid guid = Guid::FromString(val["CurrentClipGUID"].GetString());
+        if (guid.IsValid())
         {
             mCurrentState.clip = resSystem->GetOrLoad<AnimationClip>(guid, "");
         }
@@ -66,6 +67,7 @@ void AnimationLayer::FromJSON(const rapidjson::Value& val)
 
     mCurrentState.isValid = (mCurrentState.clip != nullptr);
     mPrevState = AnimationState();
+    mPoseDirty = true;
 }
 
 
@@ -75,6 +77,7 @@ void AnimationLayer::SetNormalizedTime(float ratio)
     {
         float duration = mCurrentState.clip->GetDuration();
         mCurrentState.currentTime = duration * std::clamp(ratio, 0.0f, 1.0f);
+        mCurrentState.rootMotionValid = false;
     }
 }
 
@@ -115,12 +118,19 @@ void AnimationLayer::Play(std::shared_ptr<AnimationClip> clip, float blendTime,
     }
 
     mCurrentState.Reset(clip, speed, mode);
+    mPoseDirty = true;
 }
 
-void AnimationLayer::Update(float deltaTime)
+void AnimationLayer::SetBlendMode(LayerBlendMode mode)
 {
-    mPrevFrameTime = mCurrentState.currentTime;
+    if (mBlendMode == mode) return;
+    mBlendMode = mode;
+
+    mPoseDirty = true;
+}
 
+void AnimationLayer::Update(float deltaTime)
+{
     mCurrentState.Update(deltaTime);
 
     if (mIsTransitioning)
@@ -145,171 +155,261 @@ void AnimationLayer::Update(float deltaTime)
     }
 }
 
-void AnimationLayer::UpdateMaskCache(size_t boneCount, const std::vector<std::string>& boneToKeyMap)
+void AnimationLayer::UpdateMaskCache(const std::shared_ptr<Skeleton>& skeleton, const std::shared_ptr<Model_Avatar>& avatar)
 {
+    mPoseDirty = true;
+
+    const size_t boneCount = skeleton ? skeleton->GetBoneCount() : 0;
     if (mBoneCache.size() != boneCount)
     {
         mBoneCache.resize(boneCount);
     }
 
+    mMaskBinding = mMask ? AnimationBindingCache::Get().GetMaskBinding(mMask, skeleton, avatar) : nullptr;
+
     for (size_t i = 0; i < boneCount; ++i)
     {
-        if (mMask && !boneToKeyMap[i].empty())
-        {
-            mBoneCache[i].maskWeight = mMask->GetWeight(boneToKeyMap[i]);
-        }
-        else
-        {
-            mBoneCache[i].maskWeight = 1.0f;
-        }
+        mBoneCache[i].maskWeight = mMaskBinding ? mMaskBinding->weights[i] : 1.0f;
     }
 }
 
-void AnimationLayer::UpdateTrackCache(size_t boneCount, const std::vector<std::string>& boneToKeyMap)
+void AnimationLayer::UpdateTrackCache(const std::shared_ptr<Skeleton>& skeleton, const std::shared_ptr<Model_Avatar>& avatar)
 {
+    mPoseDirty = true;
+
+    const size_t boneCount = skeleton ? skeleton->GetBoneCount() : 0;
     if (mBoneCache.size() != boneCount)
     {
         mBoneCache.resize(boneCount);
     }
 
+    mCurrentState.cursors.resize(boneCount);
+    mPrevState.cursors.resize(boneCount);
+
     bool hasCurrent = (mCurrentState.isValid && mCurrentState.clip);
     bool hasPrev = (mIsTransitioning && mPrevState.isValid && mPrevState.clip);
 
-    for (size_t i = 0; i < boneCount; ++i)
-    {
-        LayerBoneCache& cache = mBoneCache[i];
+    auto& bindings = AnimationBindingCache::Get();
+    mCurrentState.binding = hasCurrent ? bindings.GetClipBinding(mCurrentState.clip, skeleton, avatar) : nullptr;
+    mPrevState.binding = hasPrev ? bindings.GetClipBinding(mPrevState.clip, skeleton, avatar) : nullptr;
 
-        cache.currentTrack = nullptr;
-        cache.prevTrack = nullptr;
+    const ClipBinding* current = mCurrentState.binding.get();
+    const ClipBinding* prev = mPrevState.binding.get();
 
-        const std::string& key = boneToKeyMap[i];
-        if (key.empty()) continue;
+    mCurrentAdditiveRevision = hasCurrent ? mCurrentState.clip->GetAdditiveRevision() : 0;
+    mPrevAdditiveRevision = hasPrev ? mPrevState.clip->GetAdditiveRevision() : 0;
+    if (mBlendMode == LayerBlendMode::Additive && hasCurrent && !mCurrentState.clip->HasAdditive())
+        OutputDebugStringA(("[AnimationLayer] Clip is not additive, enable it in the clip inspector: " + mCurrentState.clip->GetAlias() + "\n").c_str());
 
-        if (hasCurrent)
-        {
-            cache.currentTrack = mCurrentState.clip->GetTrack(key);
-        }
+    for (size_t i = 0; i < boneCount; ++i)
+    {
+        LayerBoneCache& cache = mBoneCache[i];
 
-        if (hasPrev)
-        {
-            cache.prevTrack = mPrevState.clip->GetTrack(key);
-        }
+        cache.currentTrack = current ? ResolveTrack(*mCurrentState.clip, current->boneToTrack[i]) : nullptr;
+        cache.prevTrack = prev ? ResolveTrack(*mPrevState.clip, prev->boneToTrack[i]) : nullptr;
     }
 }
 
-float AnimationLayer::GetCachedMaskWeight(int boneIndex) const
+AnimationLayer::PoseInputs AnimationLayer::CapturePoseInputs() const
 {
-    if (boneIndex >= 0 && boneIndex < mBoneCache.size())
+    PoseInputs in;
+    if (mCurrentState.isValid)
     {
-        return mBoneCache[boneIndex].maskWeight;
+        in.clip = mCurrentState.clip.get();
+        in.time = mCurrentState.currentTime;
+        in.blendWeight = mCurrentState.weight;
     }
-    return 1.0f;
+    if (mIsTransitioning && mPrevState.isValid)
+    {
+        in.prevClip = mPrevState.clip.get();
+        in.prevTime = mPrevState.currentTime;
+    }
+    in.layerWeight = mLayerWeight;
+    in.transitioning = mIsTransitioning;
+    in.blendMode = mBlendMode;
+    return in;
 }
 
-bool AnimationLayer::GetSample(const AnimationState& state, const std::string& key, XMVECTOR& s, XMVECTOR& r, XMVECTOR& t)
+bool AnimationLayer::IsTrackCacheStale() const
 {
-    if (!state.isValid || !state.clip) return false;
+    if (mBlendMode != LayerBlendMode::Additive) return false;
 
-    const AnimationTrack* track = state.clip->GetTrack(key);
-    if (!track) return false;
-
-    XMFLOAT3 vs = track->SampleScale(state.currentTime);
-    XMFLOAT4 vr = track->SampleRotation(state.currentTime);
-    XMFLOAT3 vt = track->SamplePosition(state.currentTime);
+    if (mCurrentState.isValid && mCurrentState.clip && mCurrentState.clip->GetAdditiveRevision() != mCurrentAdditiveRevision)
+        return true;
+    return mIsTransitioning && mPrevState.isValid && mPrevState.clip &&
+        mPrevState.clip->GetAdditiveRevision() != mPrevAdditiveRevision;
+}
 
-    s = XMLoadFloat3(&vs);
-    r = XMLoadFloat4(&vr);
-    t = XMLoadFloat3(&vt);
+const AnimationTrack* AnimationLayer::ResolveTrack(const AnimationClip& clip, uint16_t trackIndex) const
+{
+    if (trackIndex == InvalidTrackIndex) return nullptr;
+    if (mBlendMode != LayerBlendMode::Additive)
+        return clip.GetTrack(trackIndex);
 
-    return true;
+    // Additive tracks are built when the clip loads; a clip without them contributes nothing here.
+    return clip.GetAdditiveTrack(trackIndex);
 }
 
-std::pair<XMVECTOR, XMVECTOR> AnimationLayer::GetRootMotionDelta(float deltaTime)
+float AnimationLayer::GetCachedMaskWeight(int boneIndex) const
 {
-    if (!mCurrentState.clip || !mEnableRootMotion)
+    if (boneIndex >= 0 && boneIndex < mBoneCache.size())
     {
-        return { XMVectorZero(), XMQuaternionIdentity() };
+        return mBoneCache[boneIndex].maskWeight;
     }
+    return 1.0f;
+}
 
-    const AnimationTrack* rootTrack = mCurrentState.clip->GetRootTrack();
-    if (!rootTrack)
+bool AnimationLayer::ConsumeRootMotion(AnimationState& state, XMVECTOR& outPos, float& outYaw)
+{
+    outPos = XMVectorZero();
+    outYaw = 0.0f;
+
+    if (!state.isValid || !state.clip || !state.clip->HasRootMotion())
     {
-        return { XMVectorZero(), XMQuaternionIdentity() };
+        state.rootMotionValid = false;
+        return false;
     }
 
-    float prevTime = mPrevFrameTime;
-    float currTime = mCurrentState.currentTime;
+    const AnimationClip& clip = *state.clip;
+    XMFLOAT4 prev = state.rootMotionSample;
+    XMFLOAT4 curr = clip.SampleRootMotion(state.currentTime);
+    float prevTime = state.rootMotionTime;
+    bool wasValid = state.rootMotionValid;
 
-    XMVECTOR p1, r1, s1; 
-    XMVECTOR p2, r2, s2; 
+    state.rootMotionSample = curr;
+    state.rootMotionTime = state.currentTime;
+    state.rootMotionValid = true;
+    if (!wasValid) return true;
 
-    rootTrack->Sample(prevTime, s1, r1, p1);
-    rootTrack->Sample(currTime, s2, r2, p2);
+    // Travel from a to b, expressed in the heading at a.
+    auto segment = [](const XMFLOAT4& a, const XMFLOAT4& b, XMVECTOR& pos, float& yaw)
+        {
+            XMVECTOR d = XMVectorSet(b.x - a.x, b.y - a.y, b.z - a.z, 0.0f);
+            pos = XMVector3Rotate(d, XMQuaternionRotationRollPitchYaw(0.0f, -a.w, 0.0f));
+            yaw = b.w - a.w;
+        };
 
-    XMVECTOR deltaPos = XMVectorSubtract(p2, p1);
-    XMVECTOR deltaRot = XMQuaternionMultiply(r2, XMQuaternionInverse(r1));
+    const bool forward = (state.speed >= 0.0f) != (state.mode == PlaybackMode::PingPong && state.isReverse);
+    const bool wrapped = (state.mode == PlaybackMode::Loop) &&
+        (forward ? state.currentTime < prevTime : state.currentTime > prevTime);
 
-    if (mCurrentState.mode == PlaybackMode::Loop && currTime < prevTime)
+    if (!wrapped)
     {
-        float duration = mCurrentState.clip->GetDuration();
-        XMVECTOR startP, startR, startS;
-        XMVECTOR endP, endR, endS;
+        segment(prev, curr, outPos, outYaw);
+        return true;
+    }
+
+    // Crossed the loop point: finish the cycle, then continue from the other end.
+    const XMFLOAT4 start = { 0.0f, 0.0f, 0.0f, 0.0f };
+    const XMFLOAT4 end = clip.GetRootMotionEnd();
+
+    XMVECTOR tailPos, headPos;
+    float tailYaw, headYaw;
+    segment(prev, forward ? end : start, tailPos, tailYaw);
+    segment(forward ? start : end, curr, headPos, headYaw);
 
-        rootTrack->Sample(0.0f, startS, startR, startP);
-        rootTrack->Sample(duration, endS, endR, endP);
+    outPos = XMVectorAdd(tailPos, XMVector3Rotate(headPos, XMQuaternionRotationRollPitchYaw(0.0f, tailYaw, 0.0f)));
+    outYaw = tailYaw + headYaw;
+    return true;
+}
+
+bool AnimationLayer::ConsumeRootMotion(XMFLOAT4& outDelta)
+{
+    outDelta = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
 
-        XMVECTOR deltaTailP = XMVectorSubtract(endP, p1);
-        XMVECTOR deltaTailR = XMQuaternionMultiply(endR, XMQuaternionInverse(r1));
+    // Both states are consumed every frame so their samples stay in step, even when the result is unused.
+    XMVECTOR pos, prevPos = XMVectorZero();
+    float yaw, prevYaw = 0.0f;
+    bool hasCurrent = ConsumeRootMotion(mCurrentState, pos, yaw);
+    bool hasPrev = mIsTransitioning && ConsumeRootMotion(mPrevState, prevPos, prevYaw);
 
-        XMVECTOR deltaHeadP = XMVectorSubtract(p2, startP);
-        XMVECTOR deltaHeadR = XMQuaternionMultiply(r2, XMQuaternionInverse(startR));
+    // Additive layers adjust the pose on top of the base layer; they never move the character.
+    if (!mEnableRootMotion || mBlendMode == LayerBlendMode::Additive) return false;
+    if (!hasCurrent && !hasPrev) return false;
 
-        deltaPos = XMVectorAdd(deltaTailP, deltaHeadP);
-        deltaRot = XMQuaternionMultiply(deltaTailR, deltaHeadR);
+    // A state without root motion blends in as standing still.
+    if (mIsTransitioning)
+    {
+        float w = mCurrentState.weight;
+        pos = XMVectorLerp(prevPos, pos, w);
+        yaw = prevYaw + (yaw - prevYaw) * w;
     }
 
-    return { deltaPos, deltaRot };
+    XMStoreFloat3(reinterpret_cast<XMFLOAT3*>(&outDelta), pos);
+    outDelta.w = yaw;
+    return true;
 }
 
-bool AnimationLayer::EvaluateAndBlend(
-    int boneIndex,
-    XMVECTOR& inOutS,
-    XMVECTOR& inOutR,
-    XMVECTOR& inOutT)
+bool AnimationLayer::EvaluatePose(AnimationPose& outPose, AnimationPose& scratch, std::vector<float>& outWeights,
+    const uint8_t* skipBones, float timeStep)
 {
     if (!mCurrentState.isValid || mLayerWeight <= 0.0f)
         return false;
 
-    if (boneIndex < 0 || boneIndex >= mBoneCache.size()) return false;
-    const LayerBoneCache& cache = mBoneCache[boneIndex];
-
-    if (cache.maskWeight <= 0.0f) return false;
+    const size_t boneCount = mBoneCache.size();
+    if (mCurrentState.cursors.size() < boneCount) return false;
 
-    float finalAlpha = mLayerWeight * cache.maskWeight;
-    if (finalAlpha <= 0.001f) return false;
+    outPose.Resize(boneCount);
+    outWeights.assign(outPose.GetPaddedCount(), 0.0f);
 
-    if (!cache.currentTrack) return false;
+    const float currentTime = AnimationPoseCache::QuantizeTime(mCurrentState.currentTime, timeStep);
 
-    XMVECTOR s_curr, r_curr, t_curr;
-    cache.currentTrack->Sample(mCurrentState.currentTime, s_curr, r_curr, t_curr);
+    const MaskBinding* mask = (mMaskBinding && mMaskBinding->weights.size() == boneCount) ? mMaskBinding.get() : nullptr;
 
-    if (mIsTransitioning && mPrevState.isValid && cache.prevTrack)
+    bool anyBone = false;
+    for (size_t i = 0; i < boneCount; ++i)
     {
-        XMVECTOR s_prev, r_prev, t_prev;
-        cache.prevTrack->Sample(mPrevState.currentTime, s_prev, r_prev, t_prev);
+        if (mask)
+        {
+            // Whole 64-bone blocks the mask zeroes are stepped over with one test.
+            if ((i & 63) == 0 && mask->GetZeroWord(i >> 6) == ~uint64_t(0))
+            {
+                i += 63;
+                continue;
+            }
+            if (mask->IsZero(i)) continue;
+        }
+
+        const LayerBoneCache& cache = mBoneCache[i];
+        if (!cache.currentTrack) continue;
+        if (skipBones && skipBones[i]) continue;
 
-        float crossFadeAlpha = mCurrentState.weight;
-        s_curr = XMVectorLerp(s_prev, s_curr, crossFadeAlpha);
-        t_curr = XMVectorLerp(t_prev, t_curr, crossFadeAlpha);
-        r_curr = XMQuaternionSlerp(r_prev, r_curr, crossFadeAlpha);
+        float finalAlpha = mLayerWeight * cache.maskWeight;
+        if (finalAlpha <= 0.001f) continue;
+
+        XMVECTOR s, r, t;
+        cache.currentTrack->Sample(currentTime, mCurrentState.cursors[i], s, r, t);
+        outPose.SetBone(i, s, r, t);
+
+        outWeights[i] = finalAlpha;
+        anyBone = true;
     }
 
-    if (mBlendMode == LayerBlendMode::Override)
+    if (!anyBone) return false;
+
+    if (mIsTransitioning && mPrevState.isValid && mPrevState.cursors.size() >= boneCount)
     {
-        inOutS = XMVectorLerp(inOutS, s_curr, finalAlpha);
-        inOutT = XMVectorLerp(inOutT, t_curr, finalAlpha);
-        inOutR = XMQuaternionSlerp(inOutR, r_curr, finalAlpha);
+        scratch.Resize(boneCount);
+        const float prevTime = AnimationPoseCache::QuantizeTime(mPrevState.currentTime, timeStep);
+
+        for (size_t i = 0; i < boneCount; ++i)
+        {
+            const LayerBoneCache& cache = mBoneCache[i];
+            if (outWeights[i] > 0.0f && cache.prevTrack)
+            {
+                XMVECTOR s, r, t;
+                cache.prevTrack->Sample(prevTime, mPrevState.cursors[i], s, r, t);
+                scratch.SetBone(i, s, r, t);
+            }
+            else
+            {
+                // Bones missing from the outgoing clip stay on the incoming one.
+                scratch.CopyBone(i, outPose);
+            }
+        }
+
+        outPose.Blend(scratch, 1.0f - mCurrentState.weight);
     }
 
     return true;
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "AnimationCommon.h"
 #include "AvatarMask.h"
+#include "AnimationPose.h"
 
 struct LayerBoneCache
 {
@@ -22,27 +23,38 @@ public:
     void Play(std::shared_ptr<AnimationClip> clip, float blendTime = 0.2f, PlaybackMode mode = PlaybackMode::Loop, float speed = 1.0f);
     void Update(float deltaTime);
 
-    bool EvaluateAndBlend(
-        int boneIndex,
-        XMVECTOR& inOutS,
-        XMVECTOR& inOutR,
-        XMVECTOR& inOutT);
-
-    void UpdateMaskCache(size_t boneCount, const std::vector<std::string>& boneToKeyMap);
-    void UpdateTrackCache(size_t boneCount, const std::vector<std::string>& boneToKeyMap);
+    // Samples every bone into outPose and writes each bone's blend weight (0 where the layer does not apply).
+    // Additive layers write reference-relative deltas for AnimationPose::ApplyAdditive.
+    // scratch receives the outgoing state's pose during a crossfade. Bones flagged in skipBones are not sampled.
+    // A positive timeStep snaps sample times down to multiples of it.
+    bool EvaluatePose(AnimationPose& outPose, AnimationPose& scratch, std::vector<float>& outWeights,
+        const uint8_t* skipBones = nullptr, float timeStep = 0.0f);
+
+    // Looks up the mask compiled for this skeleton; bones it zeroes are never sampled.
+    void UpdateMaskCache(const std::shared_ptr<Skeleton>& skeleton, const std::shared_ptr<Model_Avatar>& avatar);
+    // Binds both states' clips to the skeleton through the shared binding cache; no name lookups
+    // happen here once a (clip, skeleton, avatar) binding exists.
+    void UpdateTrackCache(const std::shared_ptr<Skeleton>& skeleton, const std::shared_ptr<Model_Avatar>& avatar);
+    // True when an additive clip's tracks were rebuilt since UpdateTrackCache, leaving the cached tracks dangling.
+    bool IsTrackCacheStale() const;
 
     float GetCachedMaskWeight(int boneIndex) const;
 
+    // True when anything EvaluatePose reads has changed since the last ClearPoseDirty.
+    bool IsPoseDirty() const { return mPoseDirty || CapturePoseInputs() != mEvaluatedInputs; }
+    void ClearPoseDirty() { mEvaluatedInputs = CapturePoseInputs(); mPoseDirty = false; }
+
     void SetWeight(float w) { mLayerWeight = w; }
     float GetWeight() const { return mLayerWeight; }
 
-    void SetMask(std::shared_ptr<AvatarMask> mask) { mMask = mask; }
+    void SetMask(std::shared_ptr<AvatarMask> mask) { mMask = mask; mPoseDirty = true; }
     std::shared_ptr<AvatarMask> GetMask() const { return mMask; }
 
     void SetNormalizedTime(float ratio);
     float GetNormalizedTime() const;
 
-    void SetBlendMode(LayerBlendMode mode) { mBlendMode = mode; }
+    // Call UpdateTrackCache afterwards; additive layers read the clips' additive tracks.
+    void SetBlendMode(LayerBlendMode mode);
     LayerBlendMode GetBlendMode() const { return mBlendMode; }
 
     void SetSpeed(float speed) { mCurrentState.speed = speed; }
@@ -60,13 +72,30 @@ public:
     float GetTransitionTime() const { return mTransitionTime; }
     float GetTransitionDuration() const { return mTransitionDuration; }
     float GetCurrentDuration() const;
+    float GetCurrentTime() const { return mCurrentState.currentTime; }
     std::shared_ptr<AnimationClip> GetCurrentClip() const { return mCurrentState.clip; }
 
-    std::pair<XMVECTOR, XMVECTOR> GetRootMotionDelta(float deltaTime);
+    // Root travel since the previous call, one curve sample per state: xyz in the clip root's parent space,
+    // relative to the heading at the previous call, and w = yaw in radians. False when the layer has none.
+    bool ConsumeRootMotion(XMFLOAT4& outDelta);
 
 private:
-    bool GetSample(const AnimationState& state, const std::string& key,
-        XMVECTOR& s, XMVECTOR& r, XMVECTOR& t);
+    struct PoseInputs
+    {
+        const AnimationClip* clip = nullptr;
+        const AnimationClip* prevClip = nullptr;
+        float time = 0.0f;
+        float prevTime = 0.0f;
+        float layerWeight = 0.0f;
+        float blendWeight = 0.0f;
+        bool transitioning = false;
+        LayerBlendMode blendMode = LayerBlendMode::Override;
+
+        bool operator==(const PoseInputs&) const = default;
+    };
+    PoseInputs CapturePoseInputs() const;
+    static bool ConsumeRootMotion(AnimationState& state, XMVECTOR& outPos, float& outYaw);
+    const AnimationTrack* ResolveTrack(const AnimationClip& clip, uint16_t trackIndex) const;
 
 private:
     std::string mName;
@@ -82,7 +111,12 @@ private:
     float mTransitionDuration = 0.0f;
 
     std::vector<LayerBoneCache> mBoneCache;
+    std::shared_ptr<const MaskBinding> mMaskBinding;
+    uint32_t mCurrentAdditiveRevision = 0; // clip revisions the cached additive tracks were taken from
+    uint32_t mPrevAdditiveRevision = 0;
+
+    PoseInputs mEvaluatedInputs;
+    bool mPoseDirty = true; // set when caches or states change in ways PoseInputs cannot see
 
     bool mEnableRootMotion = true;
-    float mPrevFrameTime = 0.0f;
 };
\ No newline at end of file
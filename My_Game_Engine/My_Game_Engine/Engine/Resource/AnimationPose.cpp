@@ -0,0 +1,199 @@
+#include "AnimationPose.h"
+
+void AnimationPose::Resize(size_t boneCount)
+{
+    mBoneCount = boneCount;
+    mStride = (boneCount + 3) & ~size_t(3);
+    mData.resize(mStride * StreamCount, 0.0f);
+}
+
+void AnimationPose::SetBone(size_t i, FXMVECTOR s, FXMVECTOR r, FXMVECTOR t)
+{
+    XMFLOAT3 vs, vt;
+    XMFLOAT4 vr;
+    XMStoreFloat3(&vs, s);
+    XMStoreFloat4(&vr, r);
+    XMStoreFloat3(&vt, t);
+
+    float* d = mData.data();
+    d[TX * mStride + i] = vt.x; d[TY * mStride + i] = vt.y; d[TZ * mStride + i] = vt.z;
+    d[RX * mStride + i] = vr.x; d[RY * mStride + i] = vr.y; d[RZ * mStride + i] = vr.z; d[RW * mStride + i] = vr.w;
+    d[SX * mStride + i] = vs.x; d[SY * mStride + i] = vs.y; d[SZ * mStride + i] = vs.z;
+}
+
+void AnimationPose::GetBone(size_t i, XMVECTOR& s, XMVECTOR& r, XMVECTOR& t) const
+{
+    const float* d = mData.data();
+    t = XMVectorSet(d[TX * mStride + i], d[TY * mStride + i], d[TZ * mStride + i], 0.0f);
+    r = XMVectorSet(d[RX * mStride + i], d[RY * mStride + i], d[RZ * mStride + i], d[RW * mStride + i]);
+    s = XMVectorSet(d[SX * mStride + i], d[SY * mStride + i], d[SZ * mStride + i], 0.0f);
+}
+
+void AnimationPose::CopyBone(size_t i, const AnimationPose& src)
+{
+    for (int s = 0; s < StreamCount; ++s)
+        mData[s * mStride + i] = src.mData[s * src.mStride + i];
+}
+
+void AnimationPose::CopyFrom(const AnimationPose& src)
+{
+    mBoneCount = src.mBoneCount;
+    mStride = src.mStride;
+    mData.assign(src.mData.begin(), src.mData.end());
+}
+
+void AnimationPose::Blend(const AnimationPose& target, float weight)
+{
+    if (weight <= 0.0f) return;
+
+    XMVECTOR w = XMVectorReplicate(weight);
+    for (size_t i = 0; i < mStride; i += 4)
+        BlendLanes(target, i, w, w);
+}
+
+void AnimationPose::Blend(const AnimationPose& target, const float* weights, const float* translationWeights)
+{
+    for (size_t i = 0; i < mStride; i += 4)
+    {
+        XMVECTOR w = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(weights + i));
+        XMVECTOR wt = translationWeights ? XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(translationWeights + i)) : w;
+
+        // Masked-out groups of bones keep their current values.
+        if (XMVector4Equal(w, XMVectorZero()) && XMVector4Equal(wt, XMVectorZero())) continue;
+
+        BlendLanes(target, i, w, wt);
+    }
+}
+
+void AnimationPose::ApplyAdditive(const AnimationPose& delta, const float* weights, const float* translationWeights)
+{
+    const XMVECTOR zero = XMVectorZero();
+    const XMVECTOR one = XMVectorReplicate(1.0f);
+
+    for (size_t i = 0; i < mStride; i += 4)
+    {
+        XMVECTOR w = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(weights + i));
+        XMVECTOR wt = translationWeights ? XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(translationWeights + i)) : w;
+
+        if (XMVector4Equal(w, zero) && XMVector4Equal(wt, zero)) continue;
+
+        auto load = [i](const AnimationPose& p, Stream s) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(p.GetStream(s) + i)); };
+        auto store = [this, i](Stream s, FXMVECTOR v) { XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(GetStream(s) + i), v); };
+
+        store(TX, XMVectorMultiplyAdd(load(delta, TX), wt, load(*this, TX)));
+        store(TY, XMVectorMultiplyAdd(load(delta, TY), wt, load(*this, TY)));
+        store(TZ, XMVectorMultiplyAdd(load(delta, TZ), wt, load(*this, TZ)));
+
+        // s * lerp(1, ds, w)
+        store(SX, XMVectorMultiply(load(*this, SX), XMVectorMultiplyAdd(XMVectorSubtract(load(delta, SX), one), w, one)));
+        store(SY, XMVectorMultiply(load(*this, SY), XMVectorMultiplyAdd(XMVectorSubtract(load(delta, SY), one), w, one)));
+        store(SZ, XMVectorMultiply(load(*this, SZ), XMVectorMultiplyAdd(XMVectorSubtract(load(delta, SZ), one), w, one)));
+
+        // nlerp(identity, delta, w) with the delta kept on the w >= 0 hemisphere.
+        XMVECTOR dw = load(delta, RW);
+        XMVECTOR sign = XMVectorSelect(one, XMVectorNegate(one), XMVectorLess(dw, zero));
+        XMVECTOR bx = XMVectorMultiply(XMVectorMultiply(load(delta, RX), sign), w);
+        XMVECTOR by = XMVectorMultiply(XMVectorMultiply(load(delta, RY), sign), w);
+        XMVECTOR bz = XMVectorMultiply(XMVectorMultiply(load(delta, RZ), sign), w);
+        XMVECTOR bw = XMVectorMultiplyAdd(XMVectorSubtract(XMVectorMultiply(dw, sign), one), w, one);
+
+        XMVECTOR ax = load(*this, RX), ay = load(*this, RY), az = load(*this, RZ), aw = load(*this, RW);
+
+        // Hamilton product a * b; the result is normalized below, which also normalizes the nlerp.
+        XMVECTOR rx = XMVectorAdd(XMVectorAdd(XMVectorMultiply(aw, bx), XMVectorMultiply(ax, bw)), XMVectorSubtract(XMVectorMultiply(ay, bz), XMVectorMultiply(az, by)));
+        XMVECTOR ry = XMVectorAdd(XMVectorSubtract(XMVectorMultiply(aw, by), XMVectorMultiply(ax, bz)), XMVectorAdd(XMVectorMultiply(ay, bw), XMVectorMultiply(az, bx)));
+        XMVECTOR rz = XMVectorAdd(XMVectorAdd(XMVectorMultiply(aw, bz), XMVectorMultiply(ax, by)), XMVectorSubtract(XMVectorMultiply(az, bw), XMVectorMultiply(ay, bx)));
+        XMVECTOR rw = XMVectorSubtract(XMVectorSubtract(XMVectorMultiply(aw, bw), XMVectorMultiply(ax, bx)), XMVectorAdd(XMVectorMultiply(ay, by), XMVectorMultiply(az, bz)));
+
+        XMVECTOR lenSq = XMVectorAdd(XMVectorAdd(XMVectorMultiply(rx, rx), XMVectorMultiply(ry, ry)),
+            XMVectorAdd(XMVectorMultiply(rz, rz), XMVectorMultiply(rw, rw)));
+        XMVECTOR valid = XMVectorGreater(lenSq, XMVectorReplicate(1e-12f));
+        XMVECTOR invLen = XMVectorReciprocalSqrt(XMVectorSelect(one, lenSq, valid));
+
+        store(RX, XMVectorSelect(ax, XMVectorMultiply(rx, invLen), valid));
+        store(RY, XMVectorSelect(ay, XMVectorMultiply(ry, invLen), valid));
+        store(RZ, XMVectorSelect(az, XMVectorMultiply(rz, invLen), valid));
+        store(RW, XMVectorSelect(aw, XMVectorMultiply(rw, invLen), valid));
+    }
+}
+
+void AnimationPose::BlendLanes(const AnimationPose& target, size_t i, FXMVECTOR w, FXMVECTOR wt)
+{
+    auto load = [i](const AnimationPose& p, Stream s) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(p.GetStream(s) + i)); };
+    auto store = [this, i](Stream s, FXMVECTOR v) { XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(GetStream(s) + i), v); };
+    auto lerp = [&](Stream s, FXMVECTOR weight) { store(s, XMVectorMultiplyAdd(XMVectorSubtract(load(target, s), load(*this, s)), weight, load(*this, s))); };
+
+    lerp(TX, wt); lerp(TY, wt); lerp(TZ, wt);
+    lerp(SX, w); lerp(SY, w); lerp(SZ, w);
+
+    XMVECTOR ax = load(*this, RX), ay = load(*this, RY), az = load(*this, RZ), aw = load(*this, RW);
+    XMVECTOR bx = load(target, RX), by = load(target, RY), bz = load(target, RZ), bw = load(target, RW);
+
+    // Flip the target where the dot product is negative so each lane takes the shortest arc.
+    XMVECTOR dot = XMVectorAdd(XMVectorAdd(XMVectorMultiply(ax, bx), XMVectorMultiply(ay, by)),
+        XMVectorAdd(XMVectorMultiply(az, bz), XMVectorMultiply(aw, bw)));
+    XMVECTOR sign = XMVectorSelect(XMVectorReplicate(1.0f), XMVectorReplicate(-1.0f), XMVectorLess(dot, XMVectorZero()));
+
+    XMVECTOR rx = XMVectorMultiplyAdd(XMVectorSubtract(XMVectorMultiply(bx, sign), ax), w, ax);
+    XMVECTOR ry = XMVectorMultiplyAdd(XMVectorSubtract(XMVectorMultiply(by, sign), ay), w, ay);
+    XMVECTOR rz = XMVectorMultiplyAdd(XMVectorSubtract(XMVectorMultiply(bz, sign), az), w, az);
+    XMVECTOR rw = XMVectorMultiplyAdd(XMVectorSubtract(XMVectorMultiply(bw, sign), aw), w, aw);
+
+    XMVECTOR lenSq = XMVectorAdd(XMVectorAdd(XMVectorMultiply(rx, rx), XMVectorMultiply(ry, ry)),
+        XMVectorAdd(XMVectorMultiply(rz, rz), XMVectorMultiply(rw, rw)));
+    XMVECTOR valid = XMVectorGreater(lenSq, XMVectorReplicate(1e-12f));
+    XMVECTOR invLen = XMVectorReciprocalSqrt(XMVectorSelect(XMVectorReplicate(1.0f), lenSq, valid));
+
+    store(RX, XMVectorSelect(ax, XMVectorMultiply(rx, invLen), valid));
+    store(RY, XMVectorSelect(ay, XMVectorMultiply(ry, invLen), valid));
+    store(RZ, XMVectorSelect(az, XMVectorMultiply(rz, invLen), valid));
+    store(RW, XMVectorSelect(aw, XMVectorMultiply(rw, invLen), valid));
+}
+
+void AnimationPose::ToLocalMatrices(XMMATRIX* out) const
+{
+    const XMVECTOR one = XMVectorReplicate(1.0f);
+    const XMVECTOR two = XMVectorReplicate(2.0f);
+
+    for (size_t i = 0; i < mStride; i += 4)
+    {
+        auto load = [this, i](Stream s) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(GetStream(s) + i)); };
+
+        XMVECTOR x = load(RX), y = load(RY), z = load(RZ), w = load(RW);
+        XMVECTOR sx = load(SX), sy = load(SY), sz = load(SZ);
+
+        XMVECTOR xx = XMVectorMultiply(x, x), yy = XMVectorMultiply(y, y), zz = XMVectorMultiply(z, z);
+        XMVECTOR xy = XMVectorMultiply(x, y), xz = XMVectorMultiply(x, z), yz = XMVectorMultiply(y, z);
+        XMVECTOR wx = XMVectorMultiply(w, x), wy = XMVectorMultiply(w, y), wz = XMVectorMultiply(w, z);
+
+        // Rows of XMMatrixRotationQuaternion, each scaled by its axis scale (S * R), four bones at a time.
+        XMFLOAT4 m[12];
+        XMStoreFloat4(&m[0], XMVectorMultiply(sx, XMVectorNegativeMultiplySubtract(two, XMVectorAdd(yy, zz), one)));
+        XMStoreFloat4(&m[1], XMVectorMultiply(sx, XMVectorMultiply(two, XMVectorAdd(xy, wz))));
+        XMStoreFloat4(&m[2], XMVectorMultiply(sx, XMVectorMultiply(two, XMVectorSubtract(xz, wy))));
+
+        XMStoreFloat4(&m[3], XMVectorMultiply(sy, XMVectorMultiply(two, XMVectorSubtract(xy, wz))));
+        XMStoreFloat4(&m[4], XMVectorMultiply(sy, XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, zz), one)));
+        XMStoreFloat4(&m[5], XMVectorMultiply(sy, XMVectorMultiply(two, XMVectorAdd(yz, wx))));
+
+        XMStoreFloat4(&m[6], XMVectorMultiply(sz, XMVectorMultiply(two, XMVectorAdd(xz, wy))));
+        XMStoreFloat4(&m[7], XMVectorMultiply(sz, XMVectorMultiply(two, XMVectorSubtract(yz, wx))));
+        XMStoreFloat4(&m[8], XMVectorMultiply(sz, XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, yy), one)));
+
+        XMStoreFloat4(&m[9], load(TX));
+        XMStoreFloat4(&m[10], load(TY));
+        XMStoreFloat4(&m[11], load(TZ));
+
+        const size_t lanes = std::min<size_t>(4, mBoneCount - std::min(mBoneCount, i));
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            auto e = [&m, k](int row) { return (&m[row].x)[k]; };
+
+            out[i + k] = XMMATRIX(
+                e(0), e(1), e(2), 0.0f,
+                e(3), e(4), e(5), 0.0f,
+                e(6), e(7), e(8), 0.0f,
+                e(9), e(10), e(11), 1.0f);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+// Local-space pose in SoA form: one float stream per component, padded to a multiple of four bones
+// so blending and matrix conversion run four bones per SIMD lane group.
+class AnimationPose
+{
+public:
+    enum Stream
+    {
+        TX, TY, TZ,
+        RX, RY, RZ, RW,
+        SX, SY, SZ,
+        StreamCount
+    };
+
+public:
+    void Resize(size_t boneCount);
+
+    size_t GetBoneCount() const { return mBoneCount; }
+    size_t GetPaddedCount() const { return mStride; }
+
+    float* GetStream(Stream s) { return mData.data() + s * mStride; }
+    const float* GetStream(Stream s) const { return mData.data() + s * mStride; }
+
+    void SetBone(size_t i, FXMVECTOR s, FXMVECTOR r, FXMVECTOR t);
+    void GetBone(size_t i, XMVECTOR& s, XMVECTOR& r, XMVECTOR& t) const;
+    void CopyBone(size_t i, const AnimationPose& src);
+    void CopyFrom(const AnimationPose& src);
+
+    // this = lerp(this, target) per bone; rotations use nlerp along the shortest arc.
+    // Weight arrays hold GetPaddedCount() entries; translationWeights may be null to reuse weights.
+    void Blend(const AnimationPose& target, float weight);
+    void Blend(const AnimationPose& target, const float* weights, const float* translationWeights);
+
+    // this = this + delta * weight per bone: translations add, scales multiply and rotations
+    // post-multiply by the delta scaled from identity. delta holds additive (reference-relative) values.
+    void ApplyAdditive(const AnimationPose& delta, const float* weights, const float* translationWeights);
+
+    // Scale * Rotation * Translation per bone, written to out[0..GetBoneCount()).
+    void ToLocalMatrices(XMMATRIX* out) const;
+
+private:
+    void BlendLanes(const AnimationPose& target, size_t i, FXMVECTOR w, FXMVECTOR wt);
+
+private:
+    std::vector<float> mData;
+    size_t mBoneCount = 0;
+    size_t mStride = 0;
+};
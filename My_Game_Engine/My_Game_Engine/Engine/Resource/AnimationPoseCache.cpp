@@ -0,0 +1,107 @@
+#include "AnimationPoseCache.h"
+
+namespace
+{
+    struct
+    {
+        std::atomic<UINT> lookups = 0;
+        std::atomic<UINT> hits = 0;
+        std::atomic<UINT> published = 0;
+    } sCacheStats;
+
+    inline void HashCombine(size_t& seed, size_t value)
+    {
+        seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+}
+
+size_t AnimationPoseCache::KeyHash::operator()(const Key& key) const
+{
+    size_t h = std::hash<const void*>()(key.skeleton);
+    HashCombine(h, std::hash<const void*>()(key.avatar));
+    HashCombine(h, key.leafDepth);
+    HashCombine(h, key.layerCount);
+
+    for (UINT i = 0; i < key.layerCount && i < MaxLayers; ++i)
+    {
+        const LayerKey& layer = key.layers[i];
+        HashCombine(h, std::hash<const void*>()(layer.clip));
+        HashCombine(h, std::hash<const void*>()(layer.mask));
+        HashCombine(h, layer.timeKey);
+        HashCombine(h, std::hash<float>()(layer.weight));
+        HashCombine(h, layer.additive);
+    }
+    return h;
+}
+
+void AnimationPoseCache::BeginFrame()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTable.clear();
+    mEntriesUsed = 0;
+
+    sCacheStats.lookups = 0;
+    sCacheStats.hits = 0;
+    sCacheStats.published = 0;
+}
+
+AnimationPoseCache::Lookup AnimationPoseCache::Find(const Key& key, Entry*& outEntry)
+{
+    ++sCacheStats.lookups;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto it = mTable.find(key);
+    if (it != mTable.end())
+    {
+        outEntry = it->second;
+        if (!outEntry->ready.load(std::memory_order_acquire))
+            return Lookup::Busy;
+
+        ++sCacheStats.hits;
+        return Lookup::Hit;
+    }
+
+    if (mEntriesUsed == mEntryPool.size())
+        mEntryPool.push_back(std::make_unique<Entry>());
+
+    outEntry = mEntryPool[mEntriesUsed++].get();
+    outEntry->ready.store(false, std::memory_order_relaxed);
+    mTable.emplace(key, outEntry);
+    return Lookup::Claimed;
+}
+
+void AnimationPoseCache::Publish(Entry* entry, const XMFLOAT4X4* palette, size_t boneCount)
+{
+    if (!entry) return;
+
+    entry->palette.assign(palette, palette + boneCount);
+    entry->ready.store(true, std::memory_order_release);
+    ++sCacheStats.published;
+}
+
+uint32_t AnimationPoseCache::MakeTimeKey(float time, float timeStep)
+{
+    // The key is the time the layer actually samples, so controllers with different steps only share a palette
+    // when they land on the same sample. Adding zero folds -0 into +0.
+    const float sampleTime = QuantizeTime(time, timeStep) + 0.0f;
+
+    uint32_t bits;
+    memcpy(&bits, &sampleTime, sizeof(bits));
+    return bits;
+}
+
+float AnimationPoseCache::QuantizeTime(float time, float timeStep)
+{
+    if (timeStep <= 0.0f) return time;
+    return std::floor(time / timeStep) * timeStep;
+}
+
+AnimationPoseCacheStats AnimationPoseCache::GetStats()
+{
+    AnimationPoseCacheStats stats;
+    stats.lookups = sCacheStats.lookups;
+    stats.hits = sCacheStats.hits;
+    stats.published = sCacheStats.published;
+    return stats;
+}
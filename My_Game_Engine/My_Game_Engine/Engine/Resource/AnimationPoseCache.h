@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+
+class AnimationClip;
+class AvatarMask;
+class Skeleton;
+class Model_Avatar;
+
+struct AnimationPoseCacheStats
+{
+    UINT lookups = 0;
+    UINT hits = 0;
+    UINT published = 0;
+
+    float GetHitRate() const { return lookups ? static_cast<float>(hits) / lookups : 0.0f; }
+};
+
+// Per-frame table of evaluated palettes shared by controllers whose poses resolve to the same inputs.
+// The first controller to claim a key evaluates and publishes; later ones copy the published palette.
+class AnimationPoseCache
+{
+public:
+    static constexpr int MaxLayers = 4;
+
+    struct LayerKey
+    {
+        const AnimationClip* clip = nullptr;
+        const AvatarMask* mask = nullptr;
+        uint32_t timeKey = 0; // bit pattern of the quantized sample time
+        float weight = 0.0f;
+        bool additive = false;
+
+        bool operator==(const LayerKey&) const = default;
+    };
+
+    struct Key
+    {
+        const Skeleton* skeleton = nullptr;
+        const Model_Avatar* avatar = nullptr;
+        UINT leafDepth = 0; // 0 unless leaf bones are skipped
+        UINT layerCount = 0;
+        LayerKey layers[MaxLayers];
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct Entry
+    {
+        std::vector<XMFLOAT4X4> palette;
+        std::atomic<bool> ready = false;
+    };
+
+    enum class Lookup
+    {
+        Hit,     // entry holds a finished palette
+        Claimed, // caller evaluates and must Publish the entry
+        Busy     // another worker is still evaluating this key
+    };
+
+public:
+    AnimationPoseCache() = default;
+    AnimationPoseCache(const AnimationPoseCache&) = delete;
+    AnimationPoseCache& operator=(const AnimationPoseCache&) = delete;
+
+    // Drops last frame's entries; pooled palettes keep their storage.
+    void BeginFrame();
+
+    Lookup Find(const Key& key, Entry*& outEntry);
+    void Publish(Entry* entry, const XMFLOAT4X4* palette, size_t boneCount);
+
+    static uint32_t MakeTimeKey(float time, float timeStep);
+    static float QuantizeTime(float time, float timeStep);
+
+    // Totals since the last BeginFrame.
+    static AnimationPoseCacheStats GetStats();
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+private:
+    std::mutex mMutex;
+    std::unordered_map<Key, Entry*, KeyHash> mTable;
+    std::vector<std::unique_ptr<Entry>> mEntryPool;
+    size_t mEntriesUsed = 0;
+};
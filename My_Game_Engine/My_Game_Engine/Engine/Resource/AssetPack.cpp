@@ -0,0 +1,362 @@
+#include "AssetPack.h"
+#include "LZCodec.h"
+#include "CookedCache.h"
+#include "JobSystem.h"
+
+namespace
+{
+    constexpr uint32_t PackMagic = 0x4B415041; // "APAK"
+    constexpr uint32_t PackVersion = 1;
+    constexpr size_t BlockDataAlignment = 16;
+
+    template<typename T>
+    bool IsRangeValid(uint64_t offset, uint64_t count, size_t fileSize)
+    {
+        return offset % alignof(T) == 0 && offset <= fileSize && count <= (fileSize - offset) / sizeof(T);
+    }
+
+    std::atomic<uint64_t> gNextGeneration = 1;
+
+    // Small files share blocks, so each thread keeps the last block it decoded for its next read. Parallel
+    // readers, such as the meta loading jobs, never wait on each other.
+    struct BlockCache
+    {
+        uint64_t generation = 0;
+        uint32_t block = UINT32_MAX;
+        std::vector<uint8_t> data;
+    };
+    thread_local BlockCache tBlockCache;
+}
+
+UINT AssetPack::GetFileCount() const
+{
+    return mHeader ? mHeader->fileCount : 0;
+}
+
+std::string AssetPack::MakeKey(std::string_view path)
+{
+    std::string key = std::filesystem::path(path).lexically_normal().generic_string();
+    if (key.starts_with("./"))
+        key.erase(0, 2);
+
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+bool AssetPack::Open(const std::string& packPath)
+{
+    Close();
+    if (!mFile.Open(packPath))
+        return false;
+
+    const size_t size = mFile.GetSize();
+    const uint8_t* data = mFile.GetData();
+
+    const Header* header = reinterpret_cast<const Header*>(data);
+    bool ok = size >= sizeof(Header) && header->magic == PackMagic && header->version == PackVersion &&
+        header->blockSize == BlockSize &&
+        IsRangeValid<TocEntry>(header->tocOffset, header->fileCount, size) &&
+        IsRangeValid<BlockEntry>(header->blockTableOffset, header->blockCount, size) &&
+        IsRangeValid<char>(header->namesOffset, header->namesSize, size);
+
+    if (!ok)
+    {
+        OutputDebugStringA(("[AssetPack] Invalid pack: " + packPath + "\n").c_str());
+        Close();
+        return false;
+    }
+
+    mHeader = header;
+    mToc = reinterpret_cast<const TocEntry*>(data + header->tocOffset);
+    mBlocks = reinterpret_cast<const BlockEntry*>(data + header->blockTableOffset);
+    mNames = reinterpret_cast<const char*>(data + header->namesOffset);
+
+    if (!ValidateTables())
+    {
+        OutputDebugStringA(("[AssetPack] Corrupt table of contents: " + packPath + "\n").c_str());
+        Close();
+        return false;
+    }
+
+    mPackPath = packPath;
+    mGeneration = gNextGeneration++;
+    return true;
+}
+
+void AssetPack::Close()
+{
+    mFile.Close();
+    mPackPath.clear();
+    mHeader = nullptr;
+    mToc = nullptr;
+    mBlocks = nullptr;
+    mNames = nullptr;
+    mGeneration = 0;
+}
+
+bool AssetPack::ValidateTables() const
+{
+    // Every block but the last is full, so the stream size follows from the last block alone.
+    uint64_t streamSize = 0;
+    for (uint32_t i = 0; i < mHeader->blockCount; ++i)
+    {
+        const uint32_t rawSize = mBlocks[i].rawSize;
+        const bool isLast = i + 1 == mHeader->blockCount;
+        if (isLast ? (rawSize == 0 || rawSize > BlockSize) : rawSize != BlockSize)
+            return false;
+        streamSize += rawSize;
+    }
+
+    // Entries are checked once here so lookups and reads can trust their ranges.
+    for (uint32_t i = 0; i < mHeader->fileCount; ++i)
+    {
+        const TocEntry& entry = mToc[i];
+        if (entry.size > streamSize || entry.offset > streamSize - entry.size)
+            return false;
+        if (static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > mHeader->namesSize)
+            return false;
+    }
+    return true;
+}
+
+const AssetPack::TocEntry* AssetPack::FindEntry(std::string_view path) const
+{
+    if (!mHeader) return nullptr;
+
+    const std::string key = MakeKey(path);
+    const uint64_t hash = CookedCache::HashString(key);
+
+    const TocEntry* end = mToc + mHeader->fileCount;
+    const TocEntry* it = std::lower_bound(mToc, end, hash, [](const TocEntry& e, uint64_t h) { return e.hash < h; });
+    for (; it != end && it->hash == hash; ++it)
+    {
+        if (std::string_view(mNames + it->nameOffset, it->nameLength) == key)
+            return it;
+    }
+    return nullptr;
+}
+
+bool AssetPack::DecodeBlock(uint32_t index, uint8_t* dst) const
+{
+    const BlockEntry& block = mBlocks[index];
+    if (block.rawSize > BlockSize || block.fileOffset > mFile.GetSize() || block.compressedSize > mFile.GetSize() - block.fileOffset)
+        return false;
+
+    const uint8_t* src = mFile.GetData() + block.fileOffset;
+    if (block.compressedSize == block.rawSize)
+    {
+        memcpy(dst, src, block.rawSize);
+        return true;
+    }
+    return LZCodec::Decompress(src, block.compressedSize, dst, block.rawSize);
+}
+
+bool AssetPack::CopyFromBlock(uint32_t index, const TocEntry& entry, uint8_t* out) const
+{
+    const uint64_t blockBegin = static_cast<uint64_t>(index) * BlockSize;
+    const uint64_t blockEnd = blockBegin + mBlocks[index].rawSize;
+    const uint64_t fileEnd = entry.offset + entry.size;
+
+    // Blocks wholly inside the file decode straight into the output.
+    if (blockBegin >= entry.offset && blockEnd <= fileEnd)
+        return DecodeBlock(index, out + (blockBegin - entry.offset));
+
+    const uint64_t copyBegin = std::max(blockBegin, entry.offset);
+    const uint64_t copyEnd = std::min(blockEnd, fileEnd);
+    if (copyBegin >= copyEnd)
+        return false;
+
+    BlockCache& cache = tBlockCache;
+    if (cache.generation != mGeneration || cache.block != index)
+    {
+        cache.data.resize(BlockSize);
+        if (!DecodeBlock(index, cache.data.data()))
+        {
+            cache.block = UINT32_MAX;
+            return false;
+        }
+        cache.generation = mGeneration;
+        cache.block = index;
+    }
+
+    memcpy(out + (copyBegin - entry.offset), cache.data.data() + (copyBegin - blockBegin), copyEnd - copyBegin);
+    return true;
+}
+
+bool AssetPack::ReadFile(std::string_view path, std::vector<uint8_t>& out, JobSystem* jobs) const
+{
+    const TocEntry* entry = FindEntry(path);
+    if (!entry) return false;
+
+    out.resize(entry->size);
+    if (entry->size == 0) return true;
+
+    // Open has checked the entry against the block table, so the span is in range.
+    const uint64_t first = entry->offset / BlockSize;
+    const uint64_t last = (entry->offset + entry->size - 1) / BlockSize;
+
+    std::atomic<bool> ok = true;
+    auto decodeRange = [&](size_t begin, size_t end, UINT)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (!CopyFromBlock(static_cast<uint32_t>(first + i), *entry, out.data()))
+                    ok = false;
+            }
+        };
+
+    const size_t blockCount = static_cast<size_t>(last - first + 1);
+    if (jobs && blockCount > 1)
+        jobs->ParallelFor(blockCount, 1, decodeRange);
+    else
+        decodeRange(0, blockCount, 0);
+
+    if (!ok)
+        OutputDebugStringA(("[AssetPack] Corrupt block data for " + std::string(path) + " in " + mPackPath + "\n").c_str());
+    return ok;
+}
+
+void AssetPack::ForEachFile(const std::function<void(std::string_view path)>& fn) const
+{
+    if (!mHeader) return;
+
+    for (uint32_t i = 0; i < mHeader->fileCount; ++i)
+    {
+        const TocEntry& entry = mToc[i];
+        fn(std::string_view(mNames + entry.nameOffset, entry.nameLength));
+    }
+}
+
+void AssetPackWriter::AddFile(const std::string& path, const std::string& sourcePath)
+{
+    mFiles.emplace_back(path, sourcePath);
+}
+
+bool AssetPackWriter::Write(const std::string& packPath, JobSystem* jobs) const
+{
+    using Header = AssetPack::Header;
+    using TocEntry = AssetPack::TocEntry;
+    using BlockEntry = AssetPack::BlockEntry;
+    constexpr uint32_t BlockSize = AssetPack::BlockSize;
+
+    struct SortedFile
+    {
+        std::string key;
+        uint64_t hash;
+        const std::string* sourcePath;
+    };
+
+    std::vector<SortedFile> files;
+    files.reserve(mFiles.size());
+    for (const auto& [path, sourcePath] : mFiles)
+    {
+        std::string key = AssetPack::MakeKey(path);
+        uint64_t hash = CookedCache::HashString(key);
+        files.push_back({ std::move(key), hash, &sourcePath });
+    }
+
+    // Later additions of the same path replace earlier ones.
+    std::stable_sort(files.begin(), files.end(), [](const SortedFile& a, const SortedFile& b)
+        {
+            return a.hash != b.hash ? a.hash < b.hash : a.key < b.key;
+        });
+    auto last = std::unique(files.rbegin(), files.rend(), [](const SortedFile& a, const SortedFile& b) { return a.key == b.key; });
+    files.erase(files.begin(), last.base());
+
+    std::vector<uint8_t> stream;
+    std::vector<TocEntry> toc;
+    std::string names;
+    toc.reserve(files.size());
+
+    for (const SortedFile& file : files)
+    {
+        std::ifstream ifs(*file.sourcePath, std::ios::binary | std::ios::ate);
+        if (!ifs.is_open())
+        {
+            OutputDebugStringA(("[AssetPack] Failed to read: " + *file.sourcePath + "\n").c_str());
+            return false;
+        }
+
+        const size_t size = static_cast<size_t>(ifs.tellg());
+        ifs.seekg(0);
+
+        TocEntry& entry = toc.emplace_back();
+        entry.hash = file.hash;
+        entry.offset = stream.size();
+        entry.size = size;
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameLength = static_cast<uint32_t>(file.key.size());
+        names += file.key;
+
+        stream.resize(stream.size() + size);
+        if (size && !ifs.read(reinterpret_cast<char*>(stream.data() + entry.offset), size))
+            return false;
+    }
+
+    const uint32_t blockCount = static_cast<uint32_t>((stream.size() + BlockSize - 1) / BlockSize);
+    std::vector<std::vector<uint8_t>> blocks(blockCount);
+    std::vector<BlockEntry> blockTable(blockCount);
+
+    auto compressRange = [&](size_t begin, size_t end, UINT)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const uint8_t* src = stream.data() + i * BlockSize;
+                const uint32_t rawSize = static_cast<uint32_t>(std::min<size_t>(BlockSize, stream.size() - i * BlockSize));
+
+                // A block that does not shrink is stored as is; equal sizes mark it as stored.
+                std::vector<uint8_t>& block = blocks[i];
+                block.resize(rawSize);
+                size_t compressed = LZCodec::Compress(src, rawSize, block.data(), rawSize - 1);
+                if (compressed == 0)
+                {
+                    memcpy(block.data(), src, rawSize);
+                    compressed = rawSize;
+                }
+                block.resize(compressed);
+
+                blockTable[i].compressedSize = static_cast<uint32_t>(compressed);
+                blockTable[i].rawSize = rawSize;
+            }
+        };
+
+    if (jobs)
+        jobs->ParallelFor(blockCount, 4, compressRange);
+    else
+        compressRange(0, blockCount, 0);
+
+    Header header{};
+    header.magic = PackMagic;
+    header.version = PackVersion;
+    header.blockSize = BlockSize;
+    header.fileCount = static_cast<uint32_t>(toc.size());
+    header.blockCount = blockCount;
+    header.tocOffset = sizeof(Header);
+    header.blockTableOffset = header.tocOffset + toc.size() * sizeof(TocEntry);
+    header.namesOffset = header.blockTableOffset + blockTable.size() * sizeof(BlockEntry);
+    header.namesSize = names.size();
+
+    uint64_t dataOffset = header.namesOffset + header.namesSize;
+    dataOffset = (dataOffset + BlockDataAlignment - 1) / BlockDataAlignment * BlockDataAlignment;
+    for (BlockEntry& block : blockTable)
+    {
+        block.fileOffset = dataOffset;
+        dataOffset += block.compressedSize;
+    }
+
+    bool ok = BinaryIO::WriteFileAtomic(packPath, [&](std::ostream& os)
+        {
+            BinaryIO::Write(os, header);
+            BinaryIO::WriteArray(os, toc.data(), toc.size());
+            BinaryIO::WriteArray(os, blockTable.data(), blockTable.size());
+            BinaryIO::WriteArray(os, names.data(), names.size());
+            BinaryIO::WritePadding(os, BlockDataAlignment);
+            for (const auto& block : blocks)
+                BinaryIO::WriteArray(os, block.data(), block.size());
+            return true;
+        });
+
+    if (!ok)
+        OutputDebugStringA(("[AssetPack] Failed to write pack: " + packPath + "\n").c_str());
+    return ok;
+}
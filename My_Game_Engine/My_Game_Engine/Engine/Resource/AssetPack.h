@@ -0,0 +1,97 @@
+#pragma once
+#include "BinaryIO.h"
+
+class JobSystem;
+
+// Read-only archive of many small asset files. The files are concatenated into one stream that is cut into
+// 64 KB blocks, each compressed on its own, so reading a file only decompresses the blocks it spans. The table
+// of contents is sorted by path hash and searched in place in the memory mapping.
+class AssetPack
+{
+public:
+    static constexpr uint32_t BlockSize = 64 * 1024;
+
+public:
+    AssetPack() = default;
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool Open(const std::string& packPath);
+    void Close();
+
+    bool IsOpen() const { return mFile.IsOpen(); }
+    const std::string& GetPackPath() const { return mPackPath; }
+    UINT GetFileCount() const;
+
+    bool Contains(std::string_view path) const { return FindEntry(path) != nullptr; }
+    // Blocks are decompressed in parallel when the file spans several of them and a job system is given.
+    bool ReadFile(std::string_view path, std::vector<uint8_t>& out, JobSystem* jobs = nullptr) const;
+    void ForEachFile(const std::function<void(std::string_view path)>& fn) const;
+
+    // Lookup key for a path: lexically normal, forward slashes, lower case.
+    static std::string MakeKey(std::string_view path);
+
+private:
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t blockSize;
+        uint32_t fileCount;
+        uint32_t blockCount;
+        uint32_t reserved;
+        uint64_t tocOffset;
+        uint64_t blockTableOffset;
+        uint64_t namesOffset;
+        uint64_t namesSize;
+    };
+
+    struct TocEntry
+    {
+        uint64_t hash;
+        uint64_t offset; // into the uncompressed stream
+        uint64_t size;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+    };
+
+    struct BlockEntry
+    {
+        uint64_t fileOffset;
+        uint32_t compressedSize; // equal to rawSize when the block is stored uncompressed
+        uint32_t rawSize;
+    };
+
+    friend class AssetPackWriter;
+
+    const TocEntry* FindEntry(std::string_view path) const;
+    bool ValidateTables() const;
+    bool DecodeBlock(uint32_t index, uint8_t* dst) const;
+    bool CopyFromBlock(uint32_t index, const TocEntry& entry, uint8_t* out) const;
+
+private:
+    MappedFile mFile;
+    std::string mPackPath;
+
+    const Header* mHeader = nullptr;
+    const TocEntry* mToc = nullptr;
+    const BlockEntry* mBlocks = nullptr;
+    const char* mNames = nullptr;
+
+    // Identifies this opening of the pack in the per-thread block caches, so a reopened pack never hits stale data.
+    uint64_t mGeneration = 0;
+};
+
+// Collects files and writes them as one AssetPack.
+class AssetPackWriter
+{
+public:
+    // path is what the engine asks for at runtime; sourcePath is where the file is read from now.
+    void AddFile(const std::string& path, const std::string& sourcePath);
+    size_t GetFileCount() const { return mFiles.size(); }
+
+    bool Write(const std::string& packPath, JobSystem* jobs = nullptr) const;
+
+private:
+    std::vector<std::pair<std::string, std::string>> mFiles;
+};
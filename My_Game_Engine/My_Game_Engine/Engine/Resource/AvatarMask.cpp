@@ -9,13 +9,8 @@ AvatarMask::AvatarMask()
 
 bool AvatarMask::LoadFromFile(std::string path, const RendererContext& ctx)
 {
-    std::ifstream ifs(path);
-    if (!ifs.is_open()) return false;
-
-    std::stringstream buffer;
-    buffer << ifs.rdbuf();
-    std::string json = buffer.str();
-    ifs.close();
+    std::string json;
+    if (!GameEngine::Get().GetResourceSystem()->ReadTextFile(path, json)) return false;
 
     rapidjson::Document doc;
     if (doc.Parse(json.c_str()).HasParseError()) return false;
@@ -35,6 +30,7 @@ bool AvatarMask::LoadFromFile(std::string path, const RendererContext& ctx)
             }
         }
     }
+    ++mRevision;
 
     return true;
 }
@@ -78,37 +74,44 @@ bool AvatarMask::SaveToFile(const std::string& path) const
     return true;
 }
 
-void AvatarMask::ExpandHierarchy(const Skeleton* skeleton, const std::vector<std::string>& boneToKeyMap)
+void AvatarMask::Compile(const Skeleton& skeleton, const std::vector<std::string>& boneKeys, std::vector<float>& outWeights) const
 {
-    if (!skeleton) return;
-
-    const auto& bones = skeleton->GetBones();
-    size_t boneCount = bones.size();
+    const auto& bones = skeleton.GetBones();
+    const size_t boneCount = bones.size();
 
-    if (boneToKeyMap.size() != boneCount) return;
+    outWeights.assign(boneCount, 1.0f);
+    if (boneKeys.size() != boneCount) return;
 
-    for (size_t i = 0; i < boneCount; ++i)
-    {
-        const BoneInfo& bone = bones[i];
+    // -1 = no weight yet; resolved parents first, so inheritance can run down whole chains.
+    std::vector<float> resolved(boneCount, -1.0f);
+    std::vector<uint8_t> visited(boneCount, 0);
 
-        const std::string& currentKey = boneToKeyMap[i];
-        if (currentKey.empty()) continue;
-
-        bool hasWeight = (mWeights.find(currentKey) != mWeights.end());
-
-        if (!hasWeight && bone.parentIndex >= 0)
+    std::function<float(size_t)> resolve = [&](size_t i) -> float
         {
-            const std::string& parentKey = boneToKeyMap[bone.parentIndex];
+            if (visited[i]) return resolved[i];
+            visited[i] = 1;
+
+            const std::string& key = boneKeys[i];
+            if (key.empty()) return resolved[i];
 
-            if (!parentKey.empty())
+            auto it = mWeights.find(key);
+            if (it != mWeights.end())
             {
-                auto parentIt = mWeights.find(parentKey);
-                if (parentIt != mWeights.end())
-                {
-                    mWeights[currentKey] = parentIt->second;
-                }
+                resolved[i] = it->second;
             }
-        }
+            else if (bones[i].parentIndex >= 0 && !boneKeys[bones[i].parentIndex].empty())
+            {
+                resolved[i] = resolve(bones[i].parentIndex);
+            }
+            return resolved[i];
+        };
+
+    for (size_t i = 0; i < boneCount; ++i)
+    {
+        if (boneKeys[i].empty()) continue;
+
+        float w = resolve(i);
+        outWeights[i] = (w >= 0.0f) ? w : 0.0f;
     }
 }
 
@@ -125,9 +128,11 @@ float AvatarMask::GetWeight(const std::string& abstractKey) const
 void AvatarMask::SetWeight(const std::string& abstractKey, float weight)
 {
     mWeights[abstractKey] = weight;
+    ++mRevision;
 }
 
 void AvatarMask::Clear()
 {
     mWeights.clear();
+    ++mRevision;
 }
\ No newline at end of file
@@ -11,7 +11,9 @@ public:
     virtual bool LoadFromFile(std::string path, const RendererContext& ctx) override;
     virtual bool SaveToFile(const std::string& path) const override;
 
-    void ExpandHierarchy(const Skeleton* skeleton, const std::vector<std::string>& boneToKeyMap);
+    // Per-bone weights for a skeleton whose bones map to boneKeys. Mapped bones without an entry inherit
+    // their parent's resolved weight (0 at the top); unmapped bones are not masked (1). The mask is not modified.
+    void Compile(const Skeleton& skeleton, const std::vector<std::string>& boneKeys, std::vector<float>& outWeights) const;
 
     float GetWeight(const std::string& abstractKey) const;
     void SetWeight(const std::string& abstractKey, float weight);
@@ -19,6 +21,10 @@ public:
 
     const std::unordered_map<std::string, float>& GetMetaMap() const { return mWeights; }
 
+    // Bumped on every weight change so compiled masks know to rebuild.
+    UINT GetRevision() const { return mRevision; }
+
 private:
     std::unordered_map<std::string, float> mWeights;
+    UINT mRevision = 0;
 };
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "BinaryIO.h"
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (mFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(mFile, &size) || size.QuadPart <= 0)
+    {
+        Close();
+        return false;
+    }
+
+    mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mMapping)
+    {
+        Close();
+        return false;
+    }
+
+    mData = static_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+    if (!mData)
+    {
+        Close();
+        return false;
+    }
+
+    mSize = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (mData) UnmapViewOfFile(mData);
+    if (mMapping) CloseHandle(mMapping);
+    if (mFile != INVALID_HANDLE_VALUE) CloseHandle(mFile);
+
+    mData = nullptr;
+    mMapping = nullptr;
+    mFile = INVALID_HANDLE_VALUE;
+    mSize = 0;
+}
+
+bool BinaryIO::WriteFileAtomic(const std::string& path, const std::function<bool(std::ostream&)>& writer)
+{
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) return false;
+
+        if (!writer(ofs) || !ofs.good())
+        {
+            ofs.close();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    return !ec;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+// Read-only memory mapping of a whole file. The view stays valid until Close or destruction.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return mData != nullptr; }
+    const uint8_t* GetData() const { return mData; }
+    size_t GetSize() const { return mSize; }
+
+private:
+    HANDLE mFile = INVALID_HANDLE_VALUE;
+    HANDLE mMapping = nullptr;
+    const uint8_t* mData = nullptr;
+    size_t mSize = 0;
+};
+
+// Bounds-checked cursor over a mapped or in-memory buffer. Every read fails once the buffer is exhausted.
+class BinaryReader
+{
+public:
+    BinaryReader(const uint8_t* data, size_t size) : mBegin(data), mCursor(data), mEnd(data + size) {}
+
+    template<typename T>
+    bool Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (GetRemaining() < sizeof(T)) return false;
+        memcpy(&value, mCursor, sizeof(T));
+        mCursor += sizeof(T);
+        return true;
+    }
+
+    bool ReadString(std::string& str)
+    {
+        uint32_t size = 0;
+        if (!Read(size) || GetRemaining() < size) return false;
+        str.assign(reinterpret_cast<const char*>(mCursor), size);
+        mCursor += size;
+        return true;
+    }
+
+    // Returns a pointer into the buffer and advances past it, or null if fewer than size bytes remain.
+    const uint8_t* Skip(size_t size)
+    {
+        if (GetRemaining() < size) return nullptr;
+        const uint8_t* block = mCursor;
+        mCursor += size;
+        return block;
+    }
+
+    template<typename T>
+    bool ReadArray(std::vector<T>& out, size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const uint8_t* block = Skip(count * sizeof(T));
+        if (!block) return false;
+        out.resize(count);
+        if (count) memcpy(out.data(), block, count * sizeof(T));
+        return true;
+    }
+
+    // Skips the padding BinaryIO::WritePadding emitted; offsets are relative to the buffer start.
+    bool Align(size_t alignment)
+    {
+        size_t offset = GetOffset();
+        size_t padding = (alignment - offset % alignment) % alignment;
+        return Skip(padding) != nullptr;
+    }
+
+    size_t GetOffset() const { return static_cast<size_t>(mCursor - mBegin); }
+    size_t GetRemaining() const { return static_cast<size_t>(mEnd - mCursor); }
+    // Check counts read from a file with this before sizing containers by them.
+    bool CanRead(uint64_t count, size_t elementSize) const { return elementSize == 0 || count <= GetRemaining() / elementSize; }
+    bool IsAtEnd() const { return mCursor == mEnd; }
+
+private:
+    const uint8_t* mBegin;
+    const uint8_t* mCursor;
+    const uint8_t* mEnd;
+};
+
+namespace BinaryIO
+{
+    template<typename T>
+    void Write(std::ostream& os, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    inline void WriteString(std::ostream& os, const std::string& str)
+    {
+        Write(os, static_cast<uint32_t>(str.size()));
+        os.write(str.data(), str.size());
+    }
+
+    template<typename T>
+    void WriteArray(std::ostream& os, const T* data, size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (count) os.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+    }
+
+    // Zero-fills up to the next multiple of alignment from the start of the stream.
+    inline void WritePadding(std::ostream& os, size_t alignment)
+    {
+        static const char zeros[64] = {};
+        size_t offset = static_cast<size_t>(os.tellp());
+        size_t padding = (alignment - offset % alignment) % alignment;
+        os.write(zeros, padding);
+    }
+
+    // Writes through a temporary file renamed over the target, so readers never see a partial file.
+    bool WriteFileAtomic(const std::string& path, const std::function<bool(std::ostream&)>& writer);
+}
@@ -0,0 +1,101 @@
+#include "CookedCache.h"
+#include "BinaryIO.h"
+
+namespace
+{
+    constexpr uint64_t HashPrime = 1099511628211ull;
+
+    std::string SanitizeFileName(const std::string& name)
+    {
+        std::string out = name.empty() ? std::string("unnamed") : name;
+        for (char& c : out)
+        {
+            if (c == '<' || c == '>' || c == ':' || c == '"' || c == '/' || c == '\\' || c == '|' || c == '?' || c == '*' || c == '#')
+                c = '_';
+        }
+        return out;
+    }
+
+    std::string ToHex(uint64_t value)
+    {
+        std::stringstream ss;
+        ss << std::hex << std::setw(16) << std::setfill('0') << value;
+        return ss.str();
+    }
+}
+
+uint64_t CookedCache::HashBytes(const void* data, size_t size, uint64_t seed)
+{
+    // FNV-1a over 8-byte words, with the tail folded in byte by byte.
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * HashPrime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i)
+        hash = (hash ^ bytes[i]) * HashPrime;
+
+    return hash;
+}
+
+uint64_t CookedCache::HashString(std::string_view str, uint64_t seed)
+{
+    return HashBytes(str.data(), str.size(), seed);
+}
+
+uint64_t CookedCache::HashSourceFile(const std::string& sourcePath, uint64_t settingsHash)
+{
+    MappedFile file;
+    if (!file.Open(sourcePath)) return 0;
+
+    uint64_t hash = HashBytes(file.GetData(), file.GetSize());
+    hash = HashBytes(&settingsHash, sizeof(settingsHash), hash);
+    return hash ? hash : 1;
+}
+
+std::string CookedCache::GetCookedPath(const std::string& sourcePath, const std::string& name, uint64_t key, const char* extension)
+{
+    namespace fs = std::filesystem;
+
+    fs::path source(sourcePath);
+    fs::path dir = source.parent_path() / "Cooked" / source.stem();
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    return (dir / (SanitizeFileName(name) + "_" + ToHex(key) + extension)).string();
+}
+
+void CookedCache::RemoveStale(const std::string& cookedPath)
+{
+    namespace fs = std::filesystem;
+
+    fs::path current(cookedPath);
+    const std::string stem = current.stem().string();
+    const size_t split = stem.rfind('_');
+    if (split == std::string::npos) return;
+
+    const std::string prefix = stem.substr(0, split + 1);
+    const std::string extension = current.extension().string();
+
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(current.parent_path(), ec); !ec && it != fs::directory_iterator(); it.increment(ec))
+    {
+        const fs::path& p = it->path();
+        if (p == current || p.extension() != extension) continue;
+
+        const std::string otherStem = p.stem().string();
+        // Same name followed only by a 16-digit key.
+        if (otherStem.size() == prefix.size() + 16 && otherStem.compare(0, prefix.size(), prefix) == 0)
+        {
+            std::error_code removeError;
+            fs::remove(p, removeError);
+        }
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Location and keys of cooked files derived from source assets. Cooked files live next to their source in
+// Cooked/<source name>/ and carry the key in their file name, so a changed source simply misses the cache.
+namespace CookedCache
+{
+    uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 1469598103934665603ull);
+    uint64_t HashString(std::string_view str, uint64_t seed = 1469598103934665603ull);
+
+    // Hash of the file's contents mixed with the importer settings; 0 if the file cannot be read.
+    uint64_t HashSourceFile(const std::string& sourcePath, uint64_t settingsHash);
+
+    std::string GetCookedPath(const std::string& sourcePath, const std::string& name, uint64_t key, const char* extension);
+
+    // Deletes cooked files of the same name written for older keys.
+    void RemoveStale(const std::string& cookedPath);
+}
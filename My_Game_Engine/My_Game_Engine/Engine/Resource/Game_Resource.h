@@ -1,4 +1,5 @@
 #pragma once
+#include "Guid.h"
 
 
 enum class FileCategory
@@ -16,41 +17,49 @@ enum class FileCategory
 };
 
 
-static std::string ExtractFileName(const std::string& path)
+// Sub-resource paths are "<container>#<kind>:<name>" (see MakeSubresourcePath). These split them without allocating.
+inline std::string_view GetContainerPath(std::string_view path)
 {
-    std::string base_path = path;
+    return path.substr(0, path.find('#'));
+}
 
+inline bool SplitSubresourcePath(std::string_view path, std::string_view& container, std::string_view& kind, std::string_view& name)
+{
     size_t hash_pos = path.find('#');
-    if (hash_pos != std::string::npos)
-    {
-        base_path = path.substr(0, hash_pos);
-    }
+    container = path.substr(0, hash_pos);
+    kind = {};
+    name = {};
+    if (hash_pos == std::string_view::npos)
+        return false;
+
+    std::string_view sub = path.substr(hash_pos + 1);
+    size_t colon_pos = sub.find(':');
+    kind = sub.substr(0, colon_pos);
+    if (colon_pos != std::string_view::npos)
+        name = sub.substr(colon_pos + 1);
+    return true;
+}
+
+// Lets string-keyed maps be searched with a string_view or literal without building a std::string.
+struct StringHash
+{
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const noexcept { return std::hash<std::string_view>{}(str); }
+};
 
-    return std::filesystem::path(base_path).stem().string();
+static std::string ExtractFileName(const std::string& path)
+{
+    return std::filesystem::path(GetContainerPath(path)).stem().string();
 }
 
 static std::string GetPhysicalFilePath(const std::string& path)
 {
-    std::string base_path = path;
-    size_t hash_pos = path.find('#');
-    if (hash_pos != std::string::npos)
-    {
-        base_path = path.substr(0, hash_pos);
-    }
-
-    return std::filesystem::path(base_path).lexically_normal().string();
+    return std::filesystem::path(GetContainerPath(path)).lexically_normal().string();
 }
 
 static std::string NormalizeFilePath(const std::string& path)
 {
-    std::string base_path = path;
-    size_t hash_pos = path.find('#');
-    if (hash_pos != std::string::npos)
-    {
-        base_path = path.substr(0, hash_pos);
-    }
-
-    std::filesystem::path fs_path(base_path);
+    std::filesystem::path fs_path(GetContainerPath(path));
     return fs_path.lexically_normal().string();
 }
 
@@ -115,6 +124,25 @@ enum class ResourceType
     etc,
 };
 
+// Bytes a resource keeps resident: CPU heap, committed GPU buffers and textures, and upload-heap staging
+// buffers that are only needed until their copy completes.
+struct MemoryFootprint
+{
+    UINT64 cpuBytes = 0;
+    UINT64 gpuBytes = 0;
+    UINT64 stagingBytes = 0;
+
+    UINT64 GetTotal() const { return cpuBytes + gpuBytes + stagingBytes; }
+
+    MemoryFootprint& operator+=(const MemoryFootprint& other)
+    {
+        cpuBytes += other.cpuBytes;
+        gpuBytes += other.gpuBytes;
+        stagingBytes += other.stagingBytes;
+        return *this;
+    }
+};
+
 class Game_Resource 
 {
 private:
@@ -123,7 +151,7 @@ private:
     ResourceType resource_type;
     std::string alias;
     std::string file_path;
-    std::string GUID;
+    Guid GUID;
     bool mIsTemporary = false;
 
 protected:
@@ -136,14 +164,22 @@ public:
     virtual bool LoadFromFile(std::string path, const RendererContext& ctx) = 0;
     virtual bool SaveToFile(const std::string& path) const = 0; 
 
+    virtual MemoryFootprint GetMemoryFootprint() const { return {}; }
+    // Ids of resources this one refers to by id rather than by shared_ptr; they stay loaded while it is in use.
+    virtual void GetDependencies(std::vector<UINT>& outIds) const {}
+    // Called after eviction once the GPU is done with the resource, to return descriptor slots.
+    virtual void OnUnload(const RendererContext& ctx) {}
+    // Called once the upload that created the resource has completed on the GPU, to drop staging and CPU-only copies.
+    virtual void OnUploadComplete() {}
+
     void SetId(UINT id) { resource_id = id; }
-    void SetGUID(const std::string& guid) { GUID = guid; }
+    void SetGUID(const Guid& guid) { GUID = guid; }
     void SetAlias(std::string a) { alias = a; }
     void SetPath(std::string p) { file_path = p.data(); }
     void SetTemporary(bool temp) { mIsTemporary = temp; }
 
     UINT GetId() const { return resource_id; }
-    const std::string& GetGUID() const { return GUID; }
+    const Guid& GetGUID() const { return GUID; }
     ResourceType Get_Type() const { return resource_type; }
     std::string GetAlias() const { return alias; }
     std::string GetPath() const { return file_path; }
@@ -0,0 +1,138 @@
+#include "Guid.h"
+
+namespace
+{
+    uint64_t RotL(uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    uint64_t Mix(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xFF51AFD7ED558CCDull;
+        k ^= k >> 33;
+        k *= 0xC4CEB9FE1A85EC53ull;
+        k ^= k >> 33;
+        return k;
+    }
+
+    // MurmurHash3 x64 128-bit, fed as one stream without concatenating the parts.
+    class Hasher128
+    {
+    public:
+        void Update(std::string_view data)
+        {
+            for (char c : data)
+            {
+                mBlock[mBlockSize++] = static_cast<uint8_t>(c);
+                if (mBlockSize == sizeof(mBlock))
+                {
+                    uint64_t k1, k2;
+                    memcpy(&k1, mBlock, 8);
+                    memcpy(&k2, mBlock + 8, 8);
+                    Round(k1, k2);
+                    mBlockSize = 0;
+                }
+            }
+            mLength += data.size();
+        }
+
+        Guid Finish()
+        {
+            uint64_t k1 = 0, k2 = 0;
+            for (size_t i = mBlockSize; i-- > 8;)
+                k2 = (k2 << 8) | mBlock[i];
+            for (size_t i = std::min<size_t>(mBlockSize, 8); i-- > 0;)
+                k1 = (k1 << 8) | mBlock[i];
+
+            if (mBlockSize > 8) { k2 *= C2; k2 = RotL(k2, 33); k2 *= C1; mH2 ^= k2; }
+            if (mBlockSize > 0) { k1 *= C1; k1 = RotL(k1, 31); k1 *= C2; mH1 ^= k1; }
+
+            mH1 ^= mLength;
+            mH2 ^= mLength;
+            mH1 += mH2;
+            mH2 += mH1;
+            mH1 = Mix(mH1);
+            mH2 = Mix(mH2);
+            mH1 += mH2;
+            mH2 += mH1;
+            return { mH1, mH2 };
+        }
+
+    private:
+        static constexpr uint64_t C1 = 0x87C37B91114253D5ull;
+        static constexpr uint64_t C2 = 0x4CF5AD432745937Full;
+
+        void Round(uint64_t k1, uint64_t k2)
+        {
+            k1 *= C1; k1 = RotL(k1, 31); k1 *= C2; mH1 ^= k1;
+            mH1 = RotL(mH1, 27); mH1 += mH2; mH1 = mH1 * 5 + 0x52DCE729;
+            k2 *= C2; k2 = RotL(k2, 33); k2 *= C1; mH2 ^= k2;
+            mH2 = RotL(mH2, 31); mH2 += mH1; mH2 = mH2 * 5 + 0x38495AB5;
+        }
+
+        uint64_t mH1 = 0;
+        uint64_t mH2 = 0;
+        uint8_t mBlock[16] = {};
+        size_t mBlockSize = 0;
+        uint64_t mLength = 0;
+    };
+
+    bool ParseHex64(std::string_view str, uint64_t& out)
+    {
+        out = 0;
+        for (char c : str)
+        {
+            uint64_t digit;
+            if (c >= '0' && c <= '9') digit = c - '0';
+            else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+            else return false;
+            out = (out << 4) | digit;
+        }
+        return true;
+    }
+}
+
+Guid Guid::Generate()
+{
+    static std::mutex mutex;
+    static std::mt19937_64 gen(std::random_device{}());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Guid guid;
+    while (!guid.IsValid())
+        guid = { gen(), gen() };
+    return guid;
+}
+
+Guid Guid::FromName(std::string_view path, std::string_view name)
+{
+    Hasher128 hasher;
+    hasher.Update(path);
+    hasher.Update("|");
+    hasher.Update(name);
+    return hasher.Finish();
+}
+
+std::string Guid::ToString() const
+{
+    if (!IsValid()) return {};
+
+    char buffer[33];
+    snprintf(buffer, sizeof(buffer), "%016llx%016llx", static_cast<unsigned long long>(hi), static_cast<unsigned long long>(lo));
+    return buffer;
+}
+
+Guid Guid::FromString(std::string_view str)
+{
+    Guid guid;
+    bool ok = false;
+    if (str.size() == 32)
+        ok = ParseHex64(str.substr(0, 16), guid.hi) && ParseHex64(str.substr(16), guid.lo);
+    else if (str.size() == 16)
+        ok = ParseHex64(str, guid.lo);
+
+    return ok ? guid : Guid{};
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+// 128-bit resource identifier. Compared and hashed by value; the hex string form exists only for JSON.
+struct Guid
+{
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    bool IsValid() const { return hi != 0 || lo != 0; }
+
+    // Random, for resources without a stable source name.
+    static Guid Generate();
+    // Stable across imports: a 128-bit hash of the source path and the sub-resource name.
+    static Guid FromName(std::string_view path, std::string_view name);
+
+    // 32 lower-case hex digits; the null Guid becomes an empty string.
+    std::string ToString() const;
+    // Accepts 32 hex digits, or the 16-digit ids of older metas and scenes. Anything else gives the null Guid.
+    static Guid FromString(std::string_view str);
+
+    bool operator==(const Guid&) const = default;
+    auto operator<=>(const Guid&) const = default;
+};
+
+template<>
+struct std::hash<Guid>
+{
+    size_t operator()(const Guid& g) const noexcept
+    {
+        return static_cast<size_t>(g.hi ^ (g.lo * 0x9E3779B97F4A7C15ull));
+    }
+};
@@ -0,0 +1,153 @@
+#include "LZCodec.h"
+
+namespace
+{
+    constexpr size_t MinMatch = 4;
+    constexpr size_t MaxOffset = 0xFFFF;
+    constexpr int HashBits = 14;
+    constexpr uint32_t EmptySlot = 0xFFFFFFFF;
+
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    uint32_t HashSequence(uint32_t v)
+    {
+        return (v * 2654435761u) >> (32 - HashBits);
+    }
+
+    // Lengths that saturate their 4-bit nibble continue in 255-valued bytes.
+    bool WriteLength(uint8_t*& op, const uint8_t* oend, size_t len)
+    {
+        while (len >= 255)
+        {
+            if (op >= oend) return false;
+            *op++ = 255;
+            len -= 255;
+        }
+        if (op >= oend) return false;
+        *op++ = static_cast<uint8_t>(len);
+        return true;
+    }
+
+    bool ReadLength(const uint8_t*& ip, const uint8_t* iend, size_t& len)
+    {
+        uint8_t b = 0;
+        do
+        {
+            if (ip >= iend) return false;
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    }
+
+    // matchLen == 0 marks the final, literal-only sequence.
+    bool WriteSequence(uint8_t*& op, const uint8_t* oend, const uint8_t* literals, size_t literalLen, size_t offset, size_t matchLen)
+    {
+        if (op >= oend) return false;
+
+        uint8_t* token = op++;
+        const size_t literalNibble = std::min<size_t>(literalLen, 15);
+        const size_t matchNibble = matchLen ? std::min<size_t>(matchLen - MinMatch, 15) : 0;
+        *token = static_cast<uint8_t>((literalNibble << 4) | matchNibble);
+
+        if (literalLen >= 15 && !WriteLength(op, oend, literalLen - 15)) return false;
+        if (static_cast<size_t>(oend - op) < literalLen) return false;
+        memcpy(op, literals, literalLen);
+        op += literalLen;
+
+        if (matchLen == 0) return true;
+
+        if (oend - op < 2) return false;
+        *op++ = static_cast<uint8_t>(offset & 0xFF);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+
+        if (matchLen - MinMatch >= 15 && !WriteLength(op, oend, matchLen - MinMatch - 15)) return false;
+        return true;
+    }
+}
+
+size_t LZCodec::Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+{
+    std::vector<uint32_t> table(size_t(1) << HashBits, EmptySlot);
+
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;
+    const uint8_t* iend = src + srcSize;
+    uint8_t* op = dst;
+    const uint8_t* oend = dst + dstCapacity;
+
+    while (srcSize >= MinMatch && ip <= iend - MinMatch)
+    {
+        const uint32_t sequence = Read32(ip);
+        uint32_t& slot = table[HashSequence(sequence)];
+        const uint32_t candidate = slot;
+        slot = static_cast<uint32_t>(ip - src);
+
+        if (candidate == EmptySlot || static_cast<size_t>(ip - src) - candidate > MaxOffset || Read32(src + candidate) != sequence)
+        {
+            ++ip;
+            continue;
+        }
+
+        const uint8_t* match = src + candidate;
+        size_t len = MinMatch;
+        while (ip + len < iend && match[len] == ip[len])
+            ++len;
+
+        if (!WriteSequence(op, oend, anchor, ip - anchor, ip - match, len))
+            return 0;
+
+        ip += len;
+        anchor = ip;
+    }
+
+    if (!WriteSequence(op, oend, anchor, iend - anchor, 0, 0))
+        return 0;
+    return static_cast<size_t>(op - dst);
+}
+
+bool LZCodec::Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+    const uint8_t* ip = src;
+    const uint8_t* iend = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + dstSize;
+
+    while (ip < iend)
+    {
+        const uint8_t token = *ip++;
+
+        size_t literalLen = token >> 4;
+        if (literalLen == 15 && !ReadLength(ip, iend, literalLen)) return false;
+        if (static_cast<size_t>(iend - ip) < literalLen || static_cast<size_t>(oend - op) < literalLen) return false;
+        memcpy(op, ip, literalLen);
+        ip += literalLen;
+        op += literalLen;
+
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return false;
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+
+        size_t matchLen = token & 0x0F;
+        if (matchLen == 15 && !ReadLength(ip, iend, matchLen)) return false;
+        matchLen += MinMatch;
+
+        if (offset == 0 || offset > static_cast<size_t>(op - dst) || static_cast<size_t>(oend - op) < matchLen)
+            return false;
+
+        // Byte by byte so overlapping matches repeat the pattern, as the encoder assumed.
+        const uint8_t* match = op - offset;
+        for (size_t i = 0; i < matchLen; ++i)
+            op[i] = match[i];
+        op += matchLen;
+    }
+
+    return op == oend;
+}
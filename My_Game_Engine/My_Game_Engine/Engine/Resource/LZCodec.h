@@ -0,0 +1,12 @@
+#pragma once
+
+// Byte-oriented LZ77 codec for asset pack blocks. Each sequence is a token (literal length, match length),
+// the literals and a 16-bit back offset, so decoding is a tight copy loop with no entropy stage.
+namespace LZCodec
+{
+    // Returns the compressed size, or 0 if the result would not fit in dstCapacity.
+    size_t Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+
+    // Fails unless the stream is well formed and decodes to exactly dstSize bytes.
+    bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+}
@@ -45,21 +45,24 @@ Material::Material() : Game_Resource(ResourceType::Material)
 
 bool Material::LoadFromFile(std::string path, const RendererContext& ctx)
 {
-    std::ifstream ifs(path.data());
-    if (!ifs.is_open())
+    ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
+
+    std::string json;
+    if (!rs->ReadTextFile(path, json))
     {
         OutputDebugStringA(("[Material] Failed to open: " + std::string(path) + "\n").c_str());
         return false;
     }
 
-    ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
-
-    std::string json((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
     Document doc;
     if (doc.Parse(json.c_str()).HasParseError())
         return false;
 
-    if (doc.HasMember("guid")) SetGUID(doc["guid"].GetString());
+    if (doc.HasMember("guid"))
+    {
+        if (Guid guid = Guid::FromString(doc["guid"].GetString()); guid.IsValid())
+            SetGUID(guid);
+    }
     if (doc.HasMember("name")) SetAlias(doc["name"].GetString());
     if (doc.HasMember("shader")) shaderName = doc["shader"].GetString();
 
@@ -84,7 +87,7 @@ bool Material::LoadFromFile(std::string path, const RendererContext& ctx)
 
                 // 1GUID 켱 ˻
                 if (texEntry.HasMember("guid"))
-                    tex = rs->GetByGUID<Texture>(texEntry["guid"].GetString());
+                    tex = rs->GetByGUID<Texture>(Guid::FromString(texEntry["guid"].GetString()));
 
                 // 2GUID ų ĳ     ε
                 if (!tex && texEntry.HasMember("path"))
@@ -134,7 +137,7 @@ bool Material::SaveToFile(const std::string& path) const
     auto& alloc = doc.GetAllocator();
 
     // --- ⺻ Ÿ ---
-    doc.AddMember("guid", rapidjson::Value(GetGUID().c_str(), alloc), alloc);
+    doc.AddMember("guid", rapidjson::Value(GetGUID().ToString().c_str(), alloc), alloc);
     doc.AddMember("name", rapidjson::Value(GetAlias().c_str(), alloc), alloc);
     doc.AddMember("shader", rapidjson::Value(shaderName.c_str(), alloc), alloc);
 
@@ -159,7 +162,7 @@ bool Material::SaveToFile(const std::string& path) const
             if (auto tex = rsm->GetById<Texture>(texId))
             {
                 rapidjson::Value texEntry(rapidjson::kObjectType);
-                texEntry.AddMember("guid", rapidjson::Value(tex->GetGUID().c_str(), alloc), alloc);
+                texEntry.AddMember("guid", rapidjson::Value(tex->GetGUID().ToString().c_str(), alloc), alloc);
                 texEntry.AddMember("path", rapidjson::Value(tex->GetPath().c_str(), alloc), alloc);
                 texObj.AddMember(rapidjson::Value(key, alloc), texEntry, alloc);
             }
@@ -191,6 +194,15 @@ bool Material::SaveToFile(const std::string& path) const
     return true;
 }
 
+void Material::GetDependencies(std::vector<UINT>& outIds) const
+{
+    for (UINT texId : { diffuseTexId, normalTexId, roughnessTexId, metallicTexId })
+    {
+        if (texId != Engine::INVALID_ID)
+            outIds.push_back(texId);
+    }
+}
+
 void Material::FromAssimp(const aiMaterial* material)
 {
     aiColor4D color;
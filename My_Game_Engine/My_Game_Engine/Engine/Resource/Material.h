@@ -11,6 +11,7 @@ public:
     virtual ~Material() = default;
     virtual bool LoadFromFile(std::string path, const RendererContext& ctx);
     virtual bool SaveToFile(const std::string& outputPath) const;
+    virtual void GetDependencies(std::vector<UINT>& outIds) const override;
 
     void FromAssimp(const aiMaterial* material);
     void FromFbxSDK(const FbxSurfaceMaterial* material);
@@ -2,6 +2,37 @@
 #include "GameEngine.h"
 #include "Model.h"
 #include "DX_Graphics/ResourceUtils.h"
+#include "Physics/MeshBVH.h"
+#include "BinaryIO.h"
+
+namespace
+{
+    constexpr uint32_t CookedMeshMagic = 0x4853454D; // "MESH"
+    constexpr uint32_t CookedMeshVersion = 1;
+
+    UINT64 GetBufferBytes(const ComPtr<ID3D12Resource>& buffer)
+    {
+        return buffer ? buffer->GetDesc().Width : 0;
+    }
+
+    template<typename T>
+    UINT64 GetVectorBytes(const std::vector<T>& vec)
+    {
+        return static_cast<UINT64>(vec.capacity()) * sizeof(T);
+    }
+
+    template<typename T>
+    void ReleaseVector(std::vector<T>& vec)
+    {
+        vec.clear();
+        vec.shrink_to_fit();
+    }
+
+    bool IsAttrInStride(const VertexStreamLayout::Attr& attr, UINT size, UINT stride)
+    {
+        return !attr.present || static_cast<UINT64>(attr.offset) + size <= stride;
+    }
+}
 
 static inline void CreateDefaultBufferWithUpload(
     const RendererContext& rc,
@@ -26,6 +57,7 @@ void Mesh::BuildInterleavedBuffers()
     if (!colors.empty())   mVertexFlags |= VertexFlags::HasColor0;
 
     const size_t vCount = positions.size();
+    mVertexCount = static_cast<UINT>(vCount);
     if (vCount == 0) return;
 
     mHotLayout = {};
@@ -76,37 +108,40 @@ void Mesh::BuildInterleavedBuffers()
     }
 
     RendererContext rc = GameEngine::Get().Get_UploadContext();
+    UploadVertexBuffers(rc, mHotCPU.data(), (UINT)mHotCPU.size(), mColdCPU.data(), (UINT)mColdCPU.size());
+    UploadIndexBuffer(rc);
+}
 
-    if (!mHotCPU.empty())
+void Mesh::UploadVertexBuffers(const RendererContext& rc, const uint8_t* hot, UINT hotSize, const uint8_t* cold, UINT coldSize)
+{
+    if (hotSize)
     {
-        CreateDefaultBufferWithUpload(rc, mHotCPU.data(), (UINT)mHotCPU.size(),
+        CreateDefaultBufferWithUpload(rc, hot, hotSize,
             D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER,
             mHotVB, mHotUpload);
 
         mHotVBV.BufferLocation = mHotVB->GetGPUVirtualAddress();
         mHotVBV.StrideInBytes = mHotLayout.stride;
-        mHotVBV.SizeInBytes = (UINT)mHotCPU.size();
+        mHotVBV.SizeInBytes = hotSize;
     }
 
-    if (!mColdCPU.empty())
+    if (coldSize)
     {
-        CreateDefaultBufferWithUpload(rc, mColdCPU.data(), (UINT)mColdCPU.size(),
+        CreateDefaultBufferWithUpload(rc, cold, coldSize,
             D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER,
             mColdVB, mColdUpload);
 
         mColdVBV.BufferLocation = mColdVB->GetGPUVirtualAddress();
         mColdVBV.StrideInBytes = mColdLayout.stride;
-        mColdVBV.SizeInBytes = (UINT)mColdCPU.size();
+        mColdVBV.SizeInBytes = coldSize;
     }
-
-    UploadIndexBuffer();
 }
 
-void Mesh::UploadIndexBuffer()
+void Mesh::UploadIndexBuffer(const RendererContext& rc)
 {
+    mIndexCount = static_cast<UINT>(indices.size());
     if (indices.empty()) return;
 
-    RendererContext rc = GameEngine::Get().Get_UploadContext();
     mIndexBuffer = ResourceUtils::CreateBufferResource(
         rc, indices.data(),
         (UINT)(sizeof(UINT) * indices.size()),
@@ -172,6 +207,221 @@ void Mesh::SetAABB()
     }
 }
 
+bool Mesh::BuildCollisionBVH()
+{
+    mCollisionBVH.reset();
+
+    if (positions.empty() || indices.empty())
+    {
+        OutputDebugStringA(("[Mesh] No CPU geometry to build collision from: " + GetAlias() + "\n").c_str());
+        return false;
+    }
+
+    auto bvh = std::make_shared<MeshBVH>();
+    if (submeshes.empty())
+    {
+        bvh->Build(positions, indices);
+    }
+    else
+    {
+        std::vector<UINT> triIndices;
+        triIndices.reserve(indices.size());
+
+        for (const auto& sub : submeshes)
+        {
+            for (UINT i = 0; i < sub.indexCount; ++i)
+                triIndices.push_back(static_cast<UINT>(static_cast<INT>(indices[sub.startIndexLocation + i]) + sub.baseVertexLocation));
+        }
+        bvh->Build(positions, triIndices);
+    }
+
+    if (bvh->IsEmpty())
+    {
+        OutputDebugStringA(("[Mesh] Collision BVH is empty: " + GetAlias() + "\n").c_str());
+        return false;
+    }
+
+    mCollisionBVH = bvh;
+    return true;
+}
+
+MemoryFootprint Mesh::GetMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.cpuBytes = GetVectorBytes(positions) + GetVectorBytes(normals) + GetVectorBytes(tangents) +
+        GetVectorBytes(uvs) + GetVectorBytes(uv1s) + GetVectorBytes(colors) + GetVectorBytes(indices) +
+        GetVectorBytes(mHotCPU) + GetVectorBytes(mColdCPU) + GetVectorBytes(submeshes);
+    for (const auto& vertices : mCpToVertexMap)
+        footprint.cpuBytes += GetVectorBytes(vertices);
+    if (mCollisionBVH)
+        footprint.cpuBytes += mCollisionBVH->GetMemorySize();
+
+    footprint.gpuBytes = GetBufferBytes(mHotVB) + GetBufferBytes(mColdVB) + GetBufferBytes(mIndexBuffer);
+    footprint.stagingBytes = GetBufferBytes(mHotUpload) + GetBufferBytes(mColdUpload) + GetBufferBytes(mIndexUpload);
+    return footprint;
+}
+
+void Mesh::OnUploadComplete()
+{
+    mHotUpload.Reset();
+    mColdUpload.Reset();
+    mIndexUpload.Reset();
+    ReleaseCPUData();
+}
+
+void Mesh::ReleaseCPUData()
+{
+    ReleaseVector(normals);
+    ReleaseVector(tangents);
+    ReleaseVector(uvs);
+    ReleaseVector(uv1s);
+    ReleaseVector(colors);
+    ReleaseVector(mHotCPU);
+    ReleaseVector(mColdCPU);
+    ReleaseVector(mCpToVertexMap);
+
+    // The collision BVH was built at import and carries its own copy.
+    ReleaseVector(positions);
+    ReleaseVector(indices);
+}
+
+void Mesh::GetDependencies(std::vector<UINT>& outIds) const
+{
+    for (const Submesh& sub : submeshes)
+    {
+        if (sub.materialId != Engine::INVALID_ID)
+            outIds.push_back(sub.materialId);
+    }
+}
+
+bool Mesh::SaveToFile(const std::string& outputPath) const
+{
+    if (mHotCPU.empty() || indices.empty()) return false;
+
+    bool ok = BinaryIO::WriteFileAtomic(outputPath, [this](std::ostream& os)
+        {
+            WriteCooked(os);
+            return true;
+        });
+
+    if (!ok)
+        OutputDebugStringA(("[Mesh] Failed to write cooked mesh: " + outputPath + "\n").c_str());
+    return ok;
+}
+
+bool Mesh::LoadFromFile(std::string path, const RendererContext& ctx)
+{
+    MappedFile file;
+    if (!file.Open(path)) return false;
+
+    BinaryReader reader(file.GetData(), file.GetSize());
+    CookedStreams streams;
+    if (!ReadCooked(reader, streams) || !reader.IsAtEnd())
+    {
+        OutputDebugStringA(("[Mesh] Invalid cooked mesh: " + path + "\n").c_str());
+        return false;
+    }
+
+    UploadCooked(ctx, streams);
+    return true;
+}
+
+void Mesh::WriteCooked(std::ostream& os) const
+{
+    BinaryIO::Write(os, CookedMeshMagic);
+    BinaryIO::Write(os, CookedMeshVersion);
+    BinaryIO::Write(os, static_cast<UINT>(mVertexFlags));
+    BinaryIO::Write(os, GetVertexCount());
+    BinaryIO::Write(os, mHotLayout);
+    BinaryIO::Write(os, mColdLayout);
+    BinaryIO::Write(os, static_cast<UINT>(mHotCPU.size()));
+    BinaryIO::Write(os, static_cast<UINT>(mColdCPU.size()));
+    BinaryIO::Write(os, GetIndexCount());
+    BinaryIO::Write(os, mLocalAABB);
+
+    BinaryIO::Write(os, GetSubMeshCount());
+    for (const Submesh& sub : submeshes)
+    {
+        BinaryIO::Write(os, sub.indexCount);
+        BinaryIO::Write(os, sub.startIndexLocation);
+        BinaryIO::Write(os, sub.baseVertexLocation);
+        BinaryIO::Write(os, sub.materialSlot);
+        BinaryIO::Write(os, sub.localAABB);
+    }
+
+    BinaryIO::WriteArray(os, mHotCPU.data(), mHotCPU.size());
+    BinaryIO::WriteArray(os, mColdCPU.data(), mColdCPU.size());
+    BinaryIO::WriteArray(os, indices.data(), indices.size());
+}
+
+bool Mesh::ReadCooked(BinaryReader& reader, CookedStreams& streams)
+{
+    uint32_t magic = 0, version = 0;
+    UINT flags = 0, vertexCount = 0, hotSize = 0, coldSize = 0, indexCount = 0, submeshCount = 0;
+
+    if (!reader.Read(magic) || !reader.Read(version) || magic != CookedMeshMagic || version != CookedMeshVersion)
+        return false;
+
+    bool ok = reader.Read(flags) && reader.Read(vertexCount) && reader.Read(mHotLayout) && reader.Read(mColdLayout) &&
+        reader.Read(hotSize) && reader.Read(coldSize) && reader.Read(indexCount) && reader.Read(mLocalAABB) &&
+        reader.Read(submeshCount);
+    // A stale or corrupt file fails here, before anything is uploaded, and the importer cooks the mesh again.
+    ok = ok && vertexCount != 0 && indexCount != 0 && mHotLayout.stride != 0 && mHotLayout.position.present &&
+        IsAttrInStride(mHotLayout.position, sizeof(XMFLOAT3), mHotLayout.stride) &&
+        hotSize == static_cast<UINT64>(mHotLayout.stride) * vertexCount &&
+        coldSize == static_cast<UINT64>(mColdLayout.stride) * vertexCount &&
+        reader.CanRead(submeshCount, sizeof(Submesh::indexCount) + sizeof(Submesh::startIndexLocation) +
+            sizeof(Submesh::baseVertexLocation) + sizeof(Submesh::materialSlot) + sizeof(Submesh::localAABB));
+    if (!ok)
+        return false;
+
+    mVertexFlags = static_cast<VertexFlags>(flags);
+    mVertexCount = vertexCount;
+
+    submeshes.resize(submeshCount);
+    for (Submesh& sub : submeshes)
+    {
+        ok = ok && reader.Read(sub.indexCount) && reader.Read(sub.startIndexLocation) && reader.Read(sub.baseVertexLocation) &&
+            reader.Read(sub.materialSlot) && reader.Read(sub.localAABB);
+        sub.materialId = Engine::INVALID_ID;
+    }
+
+    const uint8_t* hot = reader.Skip(hotSize);
+    const uint8_t* cold = reader.Skip(coldSize);
+    if (!ok || !hot || !cold || !reader.ReadArray(indices, indexCount))
+        return false;
+
+    for (const Submesh& sub : submeshes)
+    {
+        if (static_cast<UINT64>(sub.startIndexLocation) + sub.indexCount > indexCount)
+            return false;
+
+        for (UINT i = sub.startIndexLocation; i < sub.startIndexLocation + sub.indexCount; ++i)
+        {
+            const int64_t vertex = static_cast<int64_t>(indices[i]) + sub.baseVertexLocation;
+            if (vertex < 0 || vertex >= vertexCount)
+                return false;
+        }
+    }
+
+    streams = { hot, cold, hotSize, coldSize };
+    return true;
+}
+
+void Mesh::UploadCooked(const RendererContext& ctx, const CookedStreams& streams)
+{
+    // Streams go straight from the mapping to the upload heap; only positions are kept, and only for collision.
+    if (mGenerateCollision)
+    {
+        positions.resize(mVertexCount);
+        for (UINT i = 0; i < mVertexCount; ++i)
+            memcpy(&positions[i], streams.hot + i * mHotLayout.stride + mHotLayout.position.offset, sizeof(XMFLOAT3));
+    }
+
+    UploadVertexBuffers(ctx, streams.hot, streams.hotSize, streams.cold, streams.coldSize);
+    UploadIndexBuffer(ctx);
+}
+
 void Mesh::FromAssimp(const aiMesh* mesh)
 {
     positions.clear(); normals.clear(); tangents.clear();
@@ -537,20 +787,7 @@ void SkinnedMesh::FromAssimp(const aiMesh* mesh)
 
     mVertexFlags |= VertexFlags::Skinned;
 
-    if (mHotVB)
-    {
-        RendererContext rc = GameEngine::Get().Get_UploadContext();
-        DescriptorManager* heap = rc.resourceHeap;
-        HotInputSRV = heap->Allocate(HeapRegion::SRV_Static);
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
-        srvDesc.Buffer.NumElements = mHotVBV.SizeInBytes / mHotVBV.StrideInBytes;
-        srvDesc.Buffer.StructureByteStride = mHotVBV.StrideInBytes;
-        rc.device->CreateShaderResourceView(mHotVB.Get(), &srvDesc, heap->GetCpuHandle(HotInputSRV));
-    }
+    CreateHotInputSRV();
 }
 
 void SkinnedMesh::FromFbxSDK(FbxMesh* fbxMesh)
@@ -605,20 +842,63 @@ void SkinnedMesh::FromFbxSDK(FbxMesh* fbxMesh)
     mCpToVertexMap.clear();
     mCpToVertexMap.shrink_to_fit();
 
-    if (mHotVB)
-    {
-        RendererContext rc = GameEngine::Get().Get_UploadContext();
-        DescriptorManager* heap = rc.resourceHeap;
-        HotInputSRV = heap->Allocate(HeapRegion::SRV_Static);
+    CreateHotInputSRV();
+}
+
+void SkinnedMesh::CreateHotInputSRV()
+{
+    if (!mHotVB) return;
+
+    RendererContext rc = GameEngine::Get().Get_UploadContext();
+    DescriptorManager* heap = rc.resourceHeap;
+    HotInputSRV = heap->Allocate(HeapRegion::SRV_Static);
+
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+    srvDesc.Buffer.NumElements = mHotVBV.SizeInBytes / mHotVBV.StrideInBytes;
+    srvDesc.Buffer.StructureByteStride = mHotVBV.StrideInBytes;
+    rc.device->CreateShaderResourceView(mHotVB.Get(), &srvDesc, heap->GetCpuHandle(HotInputSRV));
+}
+
+void SkinnedMesh::WriteCooked(std::ostream& os) const
+{
+    Mesh::WriteCooked(os);
+
+    BinaryIO::Write(os, static_cast<UINT>(mSkinCPU.size()));
+    BinaryIO::WriteArray(os, mSkinCPU.data(), mSkinCPU.size());
+
+    // Skin indices refer to this skeleton's bone order; names let a load re-index them against its own skeleton.
+    const UINT boneCount = mModelSkeleton ? mModelSkeleton->GetBoneCount() : 0;
+    BinaryIO::Write(os, boneCount);
+    for (UINT i = 0; i < boneCount; ++i)
+        BinaryIO::WriteString(os, mModelSkeleton->GetBoneName((int)i));
+}
+
+bool SkinnedMesh::ReadCooked(BinaryReader& reader, CookedStreams& streams)
+{
+    if (!Mesh::ReadCooked(reader, streams) || !HasFlag(mVertexFlags, VertexFlags::Skinned))
+        return false;
 
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
-        srvDesc.Buffer.NumElements = mHotVBV.SizeInBytes / mHotVBV.StrideInBytes;
-        srvDesc.Buffer.StructureByteStride = mHotVBV.StrideInBytes;
-        rc.device->CreateShaderResourceView(mHotVB.Get(), &srvDesc, heap->GetCpuHandle(HotInputSRV));
+    // The skinning pass reads one skin entry per vertex.
+    UINT skinCount = 0, boneCount = 0;
+    if (!reader.Read(skinCount) || skinCount != mVertexCount || !reader.ReadArray(mSkinCPU, skinCount) ||
+        !reader.Read(boneCount) || !reader.CanRead(boneCount, sizeof(uint32_t)))
+        return false;
+
+    mCookedBoneNames.resize(boneCount);
+    for (std::string& name : mCookedBoneNames)
+    {
+        if (!reader.ReadString(name)) return false;
     }
+    return true;
+}
+
+void SkinnedMesh::UploadCooked(const RendererContext& ctx, const CookedStreams& streams)
+{
+    Mesh::UploadCooked(ctx, streams);
+    CreateHotInputSRV();
 }
 
 void SkinnedMesh::Skinning_Skeleton_Bones(std::shared_ptr<Skeleton> skeletonRes)
@@ -626,8 +906,29 @@ void SkinnedMesh::Skinning_Skeleton_Bones(std::shared_ptr<Skeleton> skeletonRes)
     mModelSkeleton = skeletonRes;
     if (!mModelSkeleton) return;
 
+    if (!mCookedBoneNames.empty())
+    {
+        std::vector<int> remap(mCookedBoneNames.size());
+        for (size_t i = 0; i < mCookedBoneNames.size(); ++i)
+            remap[i] = mModelSkeleton->GetBoneIndex(mCookedBoneNames[i]);
+
+        for (GPU_SkinData& v : mSkinCPU)
+        {
+            for (int j = 0; j < MAX_BONES_PER_VERTEX; ++j)
+            {
+                int idx = v.idx[j] < remap.size() ? remap[v.idx[j]] : -1;
+                if (idx < 0) { v.idx[j] = 0; v.w16[j] = 0; }
+                else v.idx[j] = static_cast<uint16_t>(idx);
+            }
+        }
+        mCookedBoneNames.clear();
+
+        UploadSkinData();
+        return;
+    }
+
     bone_vertex_data.clear();
-    bone_vertex_data.resize(positions.size());
+    bone_vertex_data.resize(GetVertexCount());
 
     for (auto& m : bone_mapping_data)
     {
@@ -668,22 +969,30 @@ void SkinnedMesh::Skinning_Skeleton_Bones(std::shared_ptr<Skeleton> skeletonRes)
     const UINT vCount = static_cast<UINT>(bone_vertex_data.size());
     if (vCount == 0) return;
 
-    std::vector<GPU_SkinData> gpuData(vCount);
+    mSkinCPU.resize(vCount);
     for (UINT i = 0; i < vCount; ++i)
     {
         for (int j = 0; j < MAX_BONES_PER_VERTEX; ++j)
         {
-            gpuData[i].idx[j] = bone_vertex_data[i].boneIndices[j];
-            gpuData[i].w16[j] = static_cast<uint16_t>(
+            mSkinCPU[i].idx[j] = bone_vertex_data[i].boneIndices[j];
+            mSkinCPU[i].w16[j] = static_cast<uint16_t>(
                 std::clamp(bone_vertex_data[i].weights[j], 0.0f, 1.0f) * 65535.0f);
         }
     }
 
+    UploadSkinData();
+}
+
+void SkinnedMesh::UploadSkinData()
+{
+    const UINT vCount = static_cast<UINT>(mSkinCPU.size());
+    if (vCount == 0) return;
+
     RendererContext rc = GameEngine::Get().Get_UploadContext();
     const UINT stride = sizeof(GPU_SkinData);
     const UINT bufferSize = stride * vCount;
 
-    mSkinData = ResourceUtils::CreateBufferResource(rc, gpuData.data(), bufferSize,
+    mSkinData = ResourceUtils::CreateBufferResource(rc, mSkinCPU.data(), bufferSize,
         D3D12_HEAP_TYPE_DEFAULT,
         D3D12_RESOURCE_FLAG_NONE,
         D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
@@ -722,4 +1031,43 @@ void SkinnedMesh::Bind(ComPtr<ID3D12GraphicsCommandList> cmdList) const
         cmdList->IASetIndexBuffer(&mIBV);
 
     cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-}
\ No newline at end of file
+}
+
+MemoryFootprint SkinnedMesh::GetMemoryFootprint() const
+{
+    MemoryFootprint footprint = Mesh::GetMemoryFootprint();
+    footprint.cpuBytes += GetVectorBytes(bone_vertex_data) + GetVectorBytes(bone_mapping_data) + GetVectorBytes(mSkinCPU);
+    footprint.gpuBytes += GetBufferBytes(mSkinData);
+    footprint.stagingBytes += GetBufferBytes(mSkinDataUpload);
+    return footprint;
+}
+
+void SkinnedMesh::OnUnload(const RendererContext& ctx)
+{
+    if (HotInputSRV != UINT_MAX)
+        ctx.resourceHeap->FreeDeferred(HeapRegion::SRV_Static, HotInputSRV);
+    if (SkinDataSRV != UINT_MAX)
+        ctx.resourceHeap->FreeDeferred(HeapRegion::SRV_Static, SkinDataSRV);
+
+    HotInputSRV = UINT_MAX;
+    SkinDataSRV = UINT_MAX;
+}
+
+void SkinnedMesh::OnUploadComplete()
+{
+    Mesh::OnUploadComplete();
+    mSkinDataUpload.Reset();
+}
+
+void SkinnedMesh::ReleaseCPUData()
+{
+    Mesh::ReleaseCPUData();
+
+    // Weights are only needed on the CPU until they are resolved against a skeleton and uploaded.
+    if (mSkinData)
+    {
+        ReleaseVector(bone_vertex_data);
+        ReleaseVector(bone_mapping_data);
+        ReleaseVector(mSkinCPU);
+    }
+}
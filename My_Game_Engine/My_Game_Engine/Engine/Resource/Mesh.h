@@ -29,6 +29,8 @@ struct VertexStreamLayout
 };
 
 class Skeleton;
+class MeshBVH;
+class BinaryReader;
 static const int MAX_BONES_PER_VERTEX = 4;
 
 class Mesh : public Game_Resource
@@ -43,13 +45,19 @@ public:
         UINT startIndexLocation = 0;
         INT  baseVertexLocation = 0;
         UINT materialId = Engine::INVALID_ID;
+        int  materialSlot = -1; // source material index; cooked meshes store this and the importer resolves materialId
         BoundingBox localAABB;
     };
 
     Mesh();
     virtual ~Mesh() = default;
-    virtual bool LoadFromFile(std::string path, const RendererContext& ctx) { return false; }
-    virtual bool SaveToFile(const std::string& outputPath) const { return false; }
+    // Cooked .mesh: interleaved streams, indices, submeshes and bounds, mapped and uploaded without conversion.
+    virtual bool LoadFromFile(std::string path, const RendererContext& ctx);
+    virtual bool SaveToFile(const std::string& outputPath) const;
+
+    virtual MemoryFootprint GetMemoryFootprint() const override;
+    virtual void GetDependencies(std::vector<UINT>& outIds) const override;
+    virtual void OnUploadComplete() override;
 
     virtual void FromAssimp(const aiMesh* mesh);
     virtual void FromFbxSDK(FbxMesh* fbxMesh);
@@ -64,17 +72,45 @@ public:
     const D3D12_VERTEX_BUFFER_VIEW& GetColdVBV() const { return mColdVBV; }
     const D3D12_INDEX_BUFFER_VIEW& GetIBV() const { return mIBV; }
 
-    UINT GetIndexCount() const { return static_cast<UINT>(indices.size()); }
+    UINT GetIndexCount() const { return mIndexCount; }
     UINT GetMaterialID() const { return submeshes.empty() ? Engine::INVALID_ID : submeshes[0].materialId; }
     const BoundingBox& GetLocalAABB() const { return mLocalAABB; }
     
-    UINT GetVertexCount() const { return static_cast<UINT>(positions.size()); }
+    UINT GetVertexCount() const { return mVertexCount; }
 	UINT GetSubMeshCount() const { return static_cast<UINT>(submeshes.size()); }
 
+    // Whether the mesh gets a collision BVH at import. Off by default; the model importers set it from the model's
+    // "generate_collision" import setting before the mesh is built or loaded, so cooked loads keep positions.
+    void SetGenerateCollision(bool generate) { mGenerateCollision = generate; }
+    bool GetGenerateCollision() const { return mGenerateCollision; }
+
+    // Called by the importers once positions, indices and submeshes are final and before the upload completes.
+    bool BuildCollisionBVH();
+    // Null when the mesh was not imported for collision.
+    std::shared_ptr<const MeshBVH> GetCollisionBVH() const { return mCollisionBVH; }
+
 protected:
     void BuildInterleavedBuffers();
-    void UploadIndexBuffer();
+    void UploadVertexBuffers(const RendererContext& rc, const uint8_t* hot, UINT hotSize, const uint8_t* cold, UINT coldSize);
+    void UploadIndexBuffer(const RendererContext& rc);
     void SetAABB();
+    // Drops the attribute and interleaved streams once uploaded and cooked; bounds, counts and submeshes stay.
+    virtual void ReleaseCPUData();
+
+    // Vertex streams of a cooked file, pointing into its mapping.
+    struct CookedStreams
+    {
+        const uint8_t* hot = nullptr;
+        const uint8_t* cold = nullptr;
+        UINT hotSize = 0;
+        UINT coldSize = 0;
+    };
+
+    virtual void WriteCooked(std::ostream& os) const;
+    // Parses and validates only; nothing is uploaded, so a rejected file leaves no GPU work behind.
+    virtual bool ReadCooked(BinaryReader& reader, CookedStreams& streams);
+    // Runs once the whole file has been validated.
+    virtual void UploadCooked(const RendererContext& ctx, const CookedStreams& streams);
 
 protected:
     std::vector<XMFLOAT3> positions;
@@ -105,6 +141,11 @@ protected:
     D3D12_INDEX_BUFFER_VIEW  mIBV{};
 
     BoundingBox mLocalAABB;
+    UINT mVertexCount = 0;
+    UINT mIndexCount = 0;
+    bool mGenerateCollision = false;
+
+    std::shared_ptr<MeshBVH> mCollisionBVH;
 
 	std::vector<std::vector<UINT>> mCpToVertexMap; // Tempory Container for Control point to vertex mapping for FBX
 
@@ -161,12 +202,17 @@ public:
         float weight;
     };
 
+    // Resolves bone names against the skeleton and uploads the skin buffer; cooked skin data is only re-indexed.
     void Skinning_Skeleton_Bones(std::shared_ptr<Skeleton> skeletonRes);
 
     virtual void FromAssimp(const aiMesh* mesh) override;
     virtual void FromFbxSDK(FbxMesh* fbxMesh) override;
     virtual void Bind(ComPtr<ID3D12GraphicsCommandList> cmdList) const;
 
+    virtual MemoryFootprint GetMemoryFootprint() const override;
+    virtual void OnUnload(const RendererContext& ctx) override;
+    virtual void OnUploadComplete() override;
+
     UINT GetHotInputSRV() const { return HotInputSRV; }
     UINT GetSkinDataSRV() const { return SkinDataSRV; }
 
@@ -177,6 +223,15 @@ public:
     std::vector<VertexBoneDataCPU> bone_vertex_data;
     std::vector<BoneMappingData>   bone_mapping_data;
 
+protected:
+    virtual void WriteCooked(std::ostream& os) const override;
+    virtual bool ReadCooked(BinaryReader& reader, CookedStreams& streams) override;
+    virtual void UploadCooked(const RendererContext& ctx, const CookedStreams& streams) override;
+    virtual void ReleaseCPUData() override;
+
+    void CreateHotInputSRV();
+    void UploadSkinData();
+
 protected:
     UINT SkinDataSRV = UINT_MAX;
     UINT HotInputSRV = UINT_MAX;
@@ -184,4 +239,7 @@ protected:
     std::shared_ptr<Skeleton> mModelSkeleton;
     ComPtr<ID3D12Resource> mSkinData;
     ComPtr<ID3D12Resource> mSkinDataUpload;
+
+    std::vector<GPU_SkinData> mSkinCPU;
+    std::vector<std::string> mCookedBoneNames; // bone names the cooked indices refer to, cleared once re-indexed
 };
\ No newline at end of file
@@ -1,39 +1,42 @@
 #include "MetaIO.h"
 #include "Game_Resource.h"
+#include "BinaryIO.h"
 
-static uint64_t SimpleHash(const std::string& key)
+namespace
 {
-    uint64_t hash = 1469598103934665603ull;
-    for (unsigned char c : key)
-        hash = (hash ^ c) * 1099511628211ull; 
-    return hash;
-}
-
-std::string MetaIO::CreateGUID()
-{
-    static std::random_device rd;
-    static std::mt19937_64 gen(rd());
-    static std::uniform_int_distribution<uint64_t> dis;
+    constexpr uint32_t MetaIndexMagic = 0x5844494D; // "MIDX"
+    constexpr uint32_t MetaIndexVersion = 2;
 
-    uint64_t high = dis(gen);
-    uint64_t low = dis(gen);
-
-    std::stringstream ss;
-    ss << std::hex << std::setw(16) << std::setfill('0') << high
-        << std::setw(16) << std::setfill('0') << low;
-    return ss.str();
-}
+    // Smallest encodings of a record and a sub-resource (empty strings), used to bound counts before resizing.
+    constexpr size_t MinRecordBytes = 3 * sizeof(uint32_t) + sizeof(int64_t) + sizeof(uint64_t) + sizeof(uint8_t) +
+        sizeof(Guid) + sizeof(uint32_t);
+    constexpr size_t MinSubResourceBytes = 2 * sizeof(uint32_t) + sizeof(Guid);
 
-std::string MetaIO::CreateGUID(const std::string& path, const std::string& name)
-{
-    std::string key = path + "|" + name;
-
-    uint64_t h = SimpleHash(key);
+    Guid ReadGuid(const Value& obj)
+    {
+        if (!obj.HasMember("guid") || !obj["guid"].IsString())
+            return {};
+        return Guid::FromString(obj["guid"].GetString());
+    }
 
-    std::stringstream ss;
-    ss << std::hex << std::setw(16) << std::setfill('0') << h;
+    // Leaves the file (and its timestamp) untouched when it already holds this content, so the meta index stays
+    // valid for every resource that is merely loaded.
+    bool WriteMetaIfChanged(const std::string& metaPath, std::string_view content)
+    {
+        std::error_code ec;
+        if (std::filesystem::file_size(metaPath, ec) == content.size() && !ec)
+        {
+            std::ifstream ifs(metaPath, std::ios::binary);
+            std::string existing((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+            if (existing == content)
+                return true;
+        }
 
-    return ss.str();
+        std::ofstream ofs(metaPath, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) return false;
+        ofs.write(content.data(), static_cast<std::streamsize>(content.size()));
+        return true;
+    }
 }
 
 void MetaIO::EnsureResourceGUID(const std::shared_ptr<Game_Resource>& res)
@@ -51,10 +54,13 @@ void MetaIO::EnsureResourceGUID(const std::shared_ptr<Game_Resource>& res)
                 std::istreambuf_iterator<char>());
 
             Document doc;
-            if (!doc.Parse(json.c_str()).HasParseError() && doc.HasMember("guid"))
+            if (!doc.Parse(json.c_str()).HasParseError())
             {
-                res->SetGUID(doc["guid"].GetString());
-                return;
+                if (Guid guid = ReadGuid(doc); guid.IsValid())
+                {
+                    res->SetGUID(guid);
+                    return;
+                }
             }
         }
     }
@@ -66,16 +72,16 @@ void MetaIO::EnsureResourceGUID(const std::shared_ptr<Game_Resource>& res)
     switch (category)
     {
     case FileCategory::ComplexModel:
-        res->SetGUID(CreateGUID(path, name));
+        res->SetGUID(Guid::FromName(path, name));
         break;
 
     case FileCategory::Texture:
     case FileCategory::Material:
-        res->SetGUID(CreateGUID());
+        res->SetGUID(Guid::Generate());
         break;
 
     default:
-        res->SetGUID(CreateGUID());
+        res->SetGUID(Guid::Generate());
         break;
     }
 }
@@ -89,7 +95,7 @@ bool MetaIO::SaveSimpleMeta(const std::shared_ptr<Game_Resource>& res)
     doc.SetObject();
     auto& alloc = doc.GetAllocator();
 
-    doc.AddMember("guid", Value(res->GetGUID().c_str(), alloc), alloc);
+    doc.AddMember("guid", Value(res->GetGUID().ToString().c_str(), alloc), alloc);
 
     std::string typeStr;
     switch (res->Get_Type())
@@ -112,11 +118,7 @@ bool MetaIO::SaveSimpleMeta(const std::shared_ptr<Game_Resource>& res)
     PrettyWriter<StringBuffer> writer(buffer);
     doc.Accept(writer);
 
-    std::string metaPath = res->GetPathCopy() + ".meta";
-    std::ofstream ofs(metaPath, std::ios::trunc);
-    if (!ofs.is_open()) return false;
-    ofs << buffer.GetString();
-    return true;
+    return WriteMetaIfChanged(res->GetPathCopy() + ".meta", { buffer.GetString(), buffer.GetSize() });
 }
 
 
@@ -137,8 +139,8 @@ bool MetaIO::LoadSimpleMeta(const std::shared_ptr<Game_Resource>& res)
     if (doc.Parse(json.c_str()).HasParseError())
         return false;
 
-    if (doc.HasMember("guid"))
-        res->SetGUID(doc["guid"].GetString());
+    if (Guid guid = ReadGuid(doc); guid.IsValid())
+        res->SetGUID(guid);
     if (doc.HasMember("alias"))
         res->SetAlias(doc["alias"].GetString());
 
@@ -151,9 +153,10 @@ bool MetaIO::SaveFbxMeta(const FbxMeta& meta)
     doc.SetObject();
     auto& alloc = doc.GetAllocator();
 
-    doc.AddMember("guid", Value(meta.guid.c_str(), alloc), alloc);
+    doc.AddMember("guid", Value(meta.guid.ToString().c_str(), alloc), alloc);
     doc.AddMember("path", Value(meta.path.c_str(), alloc), alloc);
     doc.AddMember("type", Value("FBX_MODEL", alloc), alloc);
+    doc.AddMember("generate_collision", meta.generateCollision, alloc);
 
     Value subArr(kArrayType);
     for (auto& s : meta.sub_resources)
@@ -161,7 +164,7 @@ bool MetaIO::SaveFbxMeta(const FbxMeta& meta)
         Value obj(kObjectType);
         obj.AddMember("name", Value(s.name.c_str(), alloc), alloc);
         obj.AddMember("type", Value(s.type.c_str(), alloc), alloc);
-        obj.AddMember("guid", Value(s.guid.c_str(), alloc), alloc);
+        obj.AddMember("guid", Value(s.guid.ToString().c_str(), alloc), alloc);
         subArr.PushBack(obj, alloc);
     }
     doc.AddMember("sub_resources", subArr, alloc);
@@ -170,11 +173,7 @@ bool MetaIO::SaveFbxMeta(const FbxMeta& meta)
     PrettyWriter<StringBuffer> writer(buffer);
     doc.Accept(writer);
 
-    std::string metaPath = meta.path + ".meta";
-    std::ofstream ofs(metaPath, std::ios::trunc);
-    if (!ofs.is_open()) return false;
-    ofs << buffer.GetString();
-    return true;
+    return WriteMetaIfChanged(meta.path + ".meta", { buffer.GetString(), buffer.GetSize() });
 }
 
 bool MetaIO::LoadFbxMeta(FbxMeta& out, const std::string& fbxPath)
@@ -188,9 +187,13 @@ bool MetaIO::LoadFbxMeta(FbxMeta& out, const std::string& fbxPath)
     if (doc.Parse(json.c_str()).HasParseError())
         return false;
 
-    if (!doc.HasMember("guid")) return false;
+    // Import settings are read even when the rest of the meta is unusable.
+    if (doc.HasMember("generate_collision") && doc["generate_collision"].IsBool())
+        out.generateCollision = doc["generate_collision"].GetBool();
+
+    out.guid = ReadGuid(doc);
+    if (!out.guid.IsValid()) return false;
 
-    out.guid = doc["guid"].GetString();
     out.path = doc["path"].GetString();
 
     if (doc.HasMember("sub_resources"))
@@ -201,9 +204,138 @@ bool MetaIO::LoadFbxMeta(FbxMeta& out, const std::string& fbxPath)
             SubResourceMeta s;
             s.name = v["name"].GetString();
             s.type = v["type"].GetString();
-            s.guid = v["guid"].GetString();
+            s.guid = ReadGuid(v);
             out.sub_resources.push_back(s);
         }
     }
     return true;
 }
+
+bool MetaIO::ParseMetaRecord(MetaIndexRecord& record)
+{
+    std::ifstream ifs(record.metaPath);
+    if (!ifs.is_open())
+    {
+        record.valid = false;
+        return false;
+    }
+
+    std::string json((std::istreambuf_iterator<char>(ifs)),
+        std::istreambuf_iterator<char>());
+    return ParseMetaRecord(record, json);
+}
+
+bool MetaIO::ParseMetaRecord(MetaIndexRecord& record, const std::string& json)
+{
+    record.valid = false;
+    record.guid = {};
+    record.path.clear();
+    record.type.clear();
+    record.sub_resources.clear();
+
+    Document doc;
+    if (doc.Parse(json.c_str()).HasParseError())
+        return false;
+
+    record.guid = ReadGuid(doc);
+    if (!doc.HasMember("path") || !record.guid.IsValid())
+        return false;
+
+    record.path = doc["path"].GetString();
+    if (doc.HasMember("type") && doc["type"].IsString())
+        record.type = doc["type"].GetString();
+
+    if (doc.HasMember("sub_resources") && doc["sub_resources"].IsArray())
+    {
+        for (const auto& v : doc["sub_resources"].GetArray())
+        {
+            if (!v.IsObject())
+                continue;
+
+            SubResourceMeta sub;
+            sub.guid = ReadGuid(v);
+            if (!sub.guid.IsValid())
+                continue;
+
+            if (v.HasMember("name") && v["name"].IsString()) sub.name = v["name"].GetString();
+            if (v.HasMember("type") && v["type"].IsString()) sub.type = v["type"].GetString();
+            record.sub_resources.push_back(std::move(sub));
+        }
+    }
+
+    record.valid = true;
+    return true;
+}
+
+bool MetaIO::LoadMetaIndex(const std::string& indexPath, std::vector<MetaIndexRecord>& out)
+{
+    out.clear();
+
+    MappedFile file;
+    if (!file.Open(indexPath)) return false;
+
+    BinaryReader reader(file.GetData(), file.GetSize());
+
+    uint32_t magic = 0, version = 0, count = 0;
+    if (!reader.Read(magic) || !reader.Read(version) || !reader.Read(count))
+        return false;
+    if (magic != MetaIndexMagic || version != MetaIndexVersion)
+        return false;
+    if (!reader.CanRead(count, MinRecordBytes))
+        return false;
+
+    out.resize(count);
+    for (MetaIndexRecord& record : out)
+    {
+        uint8_t valid = 0;
+        uint32_t subCount = 0;
+        bool ok = reader.ReadString(record.metaPath) && reader.Read(record.writeTime) && reader.Read(record.fileSize) &&
+            reader.Read(valid) && reader.Read(record.guid) && reader.ReadString(record.path) &&
+            reader.ReadString(record.type) && reader.Read(subCount);
+
+        record.valid = valid != 0;
+        ok = ok && reader.CanRead(subCount, MinSubResourceBytes);
+        if (ok)
+        {
+            record.sub_resources.resize(subCount);
+            for (SubResourceMeta& sub : record.sub_resources)
+                ok = ok && reader.ReadString(sub.name) && reader.ReadString(sub.type) && reader.Read(sub.guid);
+        }
+
+        if (!ok)
+        {
+            out.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MetaIO::SaveMetaIndex(const std::string& indexPath, const std::vector<MetaIndexRecord>& records)
+{
+    return BinaryIO::WriteFileAtomic(indexPath, [&](std::ostream& os)
+        {
+            BinaryIO::Write(os, MetaIndexMagic);
+            BinaryIO::Write(os, MetaIndexVersion);
+            BinaryIO::Write(os, static_cast<uint32_t>(records.size()));
+
+            for (const MetaIndexRecord& record : records)
+            {
+                BinaryIO::WriteString(os, record.metaPath);
+                BinaryIO::Write(os, record.writeTime);
+                BinaryIO::Write(os, record.fileSize);
+                BinaryIO::Write(os, static_cast<uint8_t>(record.valid ? 1 : 0));
+                BinaryIO::Write(os, record.guid);
+                BinaryIO::WriteString(os, record.path);
+                BinaryIO::WriteString(os, record.type);
+                BinaryIO::Write(os, static_cast<uint32_t>(record.sub_resources.size()));
+                for (const SubResourceMeta& sub : record.sub_resources)
+                {
+                    BinaryIO::WriteString(os, sub.name);
+                    BinaryIO::WriteString(os, sub.type);
+                    BinaryIO::Write(os, sub.guid);
+                }
+            }
+            return true;
+        });
+}
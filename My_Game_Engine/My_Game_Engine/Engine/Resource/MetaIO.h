@@ -5,22 +5,35 @@ struct SubResourceMeta
 {
     std::string name;
     std::string type;
-    std::string guid;
+    Guid guid;
 };
 
 struct FbxMeta
 {
-    std::string guid;
+    Guid guid;
     std::string path;
     std::vector<SubResourceMeta> sub_resources;
+    bool generateCollision = false; // import setting: meshes keep a collision BVH for mesh colliders
+};
+
+// One .meta file as recorded in the binary meta index. writeTime and fileSize are those of the .meta file
+// itself; a record whose stamp still matches the file on disk is used without parsing the JSON again.
+struct MetaIndexRecord
+{
+    std::string metaPath;
+    int64_t writeTime = 0;
+    uint64_t fileSize = 0;
+
+    bool valid = false; // false when the .meta could not be parsed or lacks path/guid
+    Guid guid;
+    std::string path;
+    std::string type;
+    std::vector<SubResourceMeta> sub_resources;
 };
 
 
 namespace MetaIO
 {
-    std::string CreateGUID();
-    std::string CreateGUID(const std::string& path, const std::string& name);
-
     void EnsureResourceGUID(const std::shared_ptr<Game_Resource>& res);
 
     bool SaveSimpleMeta(const std::shared_ptr<Game_Resource>& res);
@@ -29,4 +42,11 @@ namespace MetaIO
 
     bool SaveFbxMeta(const FbxMeta& meta);
     bool LoadFbxMeta(FbxMeta& out, const std::string& fbxPath);
+
+    // Fills guid/path/type/sub_resources of the record from its .meta file, or from already loaded JSON.
+    bool ParseMetaRecord(MetaIndexRecord& record);
+    bool ParseMetaRecord(MetaIndexRecord& record, const std::string& json);
+
+    bool LoadMetaIndex(const std::string& indexPath, std::vector<MetaIndexRecord>& out);
+    bool SaveMetaIndex(const std::string& indexPath, const std::vector<MetaIndexRecord>& records);
 }
\ No newline at end of file
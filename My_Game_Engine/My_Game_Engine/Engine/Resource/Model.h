@@ -27,6 +27,10 @@ public:
 
     virtual bool LoadFromFile(std::string path, const RendererContext& ctx) { return false; }
     virtual bool SaveToFile(const std::string& outputPath) const { return false; }
+    virtual void GetDependencies(std::vector<UINT>& outIds) const override
+    {
+        if (mAvatarID != Engine::INVALID_ID) outIds.push_back(mAvatarID);
+    }
 
     std::shared_ptr<Node> GetRoot() const { return root; }
     void SetRoot(const std::shared_ptr<Node>& node) { root = node; }
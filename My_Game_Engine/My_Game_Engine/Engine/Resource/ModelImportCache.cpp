@@ -0,0 +1,506 @@
+#include "ModelImportCache.h"
+#include "GameEngine.h"
+#include "BinaryIO.h"
+#include "CookedCache.h"
+#include "ModelLoader_FBX.h"
+#include "ModelLoader_Assimp.h"
+
+namespace
+{
+    constexpr uint32_t ModelCacheMagic = 0x4C444F4D; // "MODL"
+    constexpr uint32_t ModelCacheVersion = 2;
+
+    struct CachedResourceRef
+    {
+        std::string path;
+        std::string alias;
+    };
+
+    struct CachedMesh
+    {
+        bool skinned = false;
+        std::string cookedPath;
+        std::string alias;
+        Guid guid;
+        std::string path;
+        std::vector<int> submeshMaterials; // index into the material list, -1 for none
+    };
+
+    struct CachedNode
+    {
+        std::string name;
+        XMFLOAT4X4 localTransform;
+        std::vector<UINT> meshes;
+        std::vector<CachedNode> children;
+    };
+
+    struct CachedModel
+    {
+        ModelImporter importer = ModelImporter::FBX;
+        uint64_t importerSettings = 0;
+
+        bool hasModel = false;
+        std::string modelAlias;
+        std::vector<CachedResourceRef> materials;
+
+        bool hasSkeleton = false;
+        bool skeletonTemporary = false;
+        CachedResourceRef skeleton;
+        std::shared_ptr<Skeleton> embeddedSkeleton; // temporary skeletons have no file of their own
+
+        bool hasAvatar = false;
+        bool avatarTemporary = false;
+        CachedResourceRef avatar;
+
+        std::vector<CachedMesh> meshes;
+        CachedNode root;
+        std::vector<CachedResourceRef> clips;
+    };
+
+    void WriteRef(std::ostream& os, const std::string& path, const std::string& alias)
+    {
+        BinaryIO::WriteString(os, path);
+        BinaryIO::WriteString(os, alias);
+    }
+
+    bool ReadRef(BinaryReader& reader, CachedResourceRef& ref)
+    {
+        return reader.ReadString(ref.path) && reader.ReadString(ref.alias);
+    }
+
+    void WriteNode(std::ostream& os, const Model::Node& node, const std::unordered_map<const Mesh*, UINT>& meshIndex)
+    {
+        BinaryIO::WriteString(os, node.name);
+        BinaryIO::Write(os, node.localTransform);
+
+        BinaryIO::Write(os, static_cast<UINT>(node.meshes.size()));
+        for (const auto& mesh : node.meshes)
+            BinaryIO::Write(os, meshIndex.at(mesh.get()));
+
+        BinaryIO::Write(os, static_cast<UINT>(node.children.size()));
+        for (const auto& child : node.children)
+            WriteNode(os, *child, meshIndex);
+    }
+
+    bool ReadNode(BinaryReader& reader, CachedNode& node, size_t meshCount)
+    {
+        UINT count = 0;
+        if (!reader.ReadString(node.name) || !reader.Read(node.localTransform) || !reader.Read(count))
+            return false;
+        if (!reader.ReadArray(node.meshes, count))
+            return false;
+        for (UINT index : node.meshes)
+        {
+            if (index >= meshCount) return false;
+        }
+
+        if (!reader.Read(count)) return false;
+        node.children.resize(count);
+        for (CachedNode& child : node.children)
+        {
+            if (!ReadNode(reader, child, meshCount)) return false;
+        }
+        return true;
+    }
+
+    std::shared_ptr<Model::Node> BuildNode(const CachedNode& cached, const std::vector<std::shared_ptr<Mesh>>& meshes)
+    {
+        auto node = std::make_shared<Model::Node>();
+        node->name = cached.name;
+        node->localTransform = cached.localTransform;
+        for (UINT index : cached.meshes)
+            node->meshes.push_back(meshes[index]);
+        for (const CachedNode& child : cached.children)
+            node->children.push_back(BuildNode(child, meshes));
+        return node;
+    }
+
+    bool ReadCachedModel(BinaryReader& reader, CachedModel& out)
+    {
+        uint32_t magic = 0, version = 0, importer = 0;
+        if (!reader.Read(magic) || !reader.Read(version) || magic != ModelCacheMagic || version != ModelCacheVersion)
+            return false;
+        if (!reader.Read(importer) || !reader.Read(out.importerSettings))
+            return false;
+        out.importer = static_cast<ModelImporter>(importer);
+
+        uint8_t flag = 0;
+        if (!reader.Read(flag)) return false;
+        out.hasModel = flag != 0;
+        if (out.hasModel && !reader.ReadString(out.modelAlias)) return false;
+
+        UINT count = 0;
+        if (!reader.Read(count)) return false;
+        out.materials.resize(count);
+        for (auto& material : out.materials)
+        {
+            if (!ReadRef(reader, material)) return false;
+        }
+
+        if (!reader.Read(flag)) return false;
+        out.hasSkeleton = flag != 0;
+        if (out.hasSkeleton)
+        {
+            if (!reader.Read(flag) || !ReadRef(reader, out.skeleton)) return false;
+            out.skeletonTemporary = flag != 0;
+            if (out.skeletonTemporary)
+            {
+                out.embeddedSkeleton = std::make_shared<Skeleton>();
+                if (!out.embeddedSkeleton->ReadBinary(reader)) return false;
+            }
+        }
+
+        if (!reader.Read(flag)) return false;
+        out.hasAvatar = flag != 0;
+        if (out.hasAvatar)
+        {
+            if (!reader.Read(flag) || !ReadRef(reader, out.avatar)) return false;
+            out.avatarTemporary = flag != 0;
+        }
+
+        if (!reader.Read(count)) return false;
+        out.meshes.resize(count);
+        for (CachedMesh& mesh : out.meshes)
+        {
+            UINT submeshCount = 0;
+            bool ok = reader.Read(flag) && reader.ReadString(mesh.cookedPath) && reader.ReadString(mesh.alias) &&
+                reader.Read(mesh.guid) && reader.ReadString(mesh.path) && reader.Read(submeshCount) &&
+                reader.ReadArray(mesh.submeshMaterials, submeshCount);
+            if (!ok) return false;
+            mesh.skinned = flag != 0;
+
+            for (int material : mesh.submeshMaterials)
+            {
+                if (material >= (int)out.materials.size()) return false;
+            }
+        }
+
+        if (!reader.Read(flag)) return false;
+        if (flag && !ReadNode(reader, out.root, out.meshes.size())) return false;
+
+        if (!reader.Read(count)) return false;
+        out.clips.resize(count);
+        for (auto& clip : out.clips)
+        {
+            if (!ReadRef(reader, clip)) return false;
+        }
+
+        return reader.IsAtEnd();
+    }
+
+    // Every file the cache refers to must still exist; otherwise the import runs cold and rewrites it.
+    bool ReferencedFilesExist(const CachedModel& cached)
+    {
+        namespace fs = std::filesystem;
+
+        for (const auto& material : cached.materials)
+            if (!fs::exists(material.path)) return false;
+        for (const auto& mesh : cached.meshes)
+            if (!fs::exists(mesh.cookedPath)) return false;
+        for (const auto& clip : cached.clips)
+            if (!fs::exists(clip.path)) return false;
+
+        if (cached.hasSkeleton && !cached.skeletonTemporary && !fs::exists(cached.skeleton.path)) return false;
+        if (cached.hasAvatar && !cached.avatarTemporary && !fs::exists(cached.avatar.path)) return false;
+        return true;
+    }
+
+    template<typename T>
+    std::shared_ptr<T> LoadExisting(ResourceSystem* rs, const CachedResourceRef& ref, const RendererContext& ctx)
+    {
+        return rs->LoadOrReuse<T>(ref.path, ref.alias, ctx, []() -> std::shared_ptr<T> { return nullptr; });
+    }
+}
+
+std::string ModelImportCache::GetCachePath(const std::string& sourcePath)
+{
+    uint64_t hash = CookedCache::HashSourceFile(sourcePath, ModelCacheVersion);
+    if (!hash) return {};
+
+    return CookedCache::GetCookedPath(sourcePath, ExtractFileName(sourcePath), hash, ".model");
+}
+
+uint64_t ModelImportCache::GetImporterSettings(ModelImporter importer)
+{
+    switch (importer)
+    {
+    case ModelImporter::FBX:    return ModelLoader_FBX::ImportSettingsVersion;
+    case ModelImporter::Assimp: return ModelLoader_Assimp::ImportSettingsVersion;
+    default: return 0;
+    }
+}
+
+bool ModelImportCache::Load(const std::string& sourcePath, LoadResult& result)
+{
+    const std::string cachePath = GetCachePath(sourcePath);
+    if (cachePath.empty() || !std::filesystem::exists(cachePath))
+        return false;
+
+    CachedModel cached;
+    {
+        MappedFile file;
+        if (!file.Open(cachePath)) return false;
+
+        BinaryReader reader(file.GetData(), file.GetSize());
+        if (!ReadCachedModel(reader, cached))
+        {
+            OutputDebugStringA(("[ModelImportCache] Invalid cache file: " + cachePath + "\n").c_str());
+            return false;
+        }
+    }
+
+    if (cached.importerSettings != GetImporterSettings(cached.importer) || !ReferencedFilesExist(cached))
+        return false;
+
+    ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
+    RendererContext ctx = GameEngine::Get().Get_UploadContext();
+
+    // The collision setting is not part of the cache key; it is read from the .meta on every load.
+    FbxMeta importSettings;
+    MetaIO::LoadFbxMeta(importSettings, sourcePath);
+
+    // Meshes first: nothing is registered until every cooked mesh has loaded.
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    meshes.reserve(cached.meshes.size());
+    for (const CachedMesh& entry : cached.meshes)
+    {
+        std::shared_ptr<Mesh> mesh = entry.skinned ? std::make_shared<SkinnedMesh>() : std::make_shared<Mesh>();
+        mesh->SetGenerateCollision(importSettings.generateCollision);
+        if (!mesh->LoadFromFile(entry.cookedPath, ctx) || mesh->submeshes.size() != entry.submeshMaterials.size())
+            return false;
+        meshes.push_back(mesh);
+    }
+
+    std::shared_ptr<Model> model;
+    if (cached.hasModel)
+    {
+        model = std::make_shared<Model>();
+        model->SetAlias(cached.modelAlias);
+        model->SetPath(sourcePath);
+        rs->RegisterResource(model);
+        result.modelId = model->GetId();
+    }
+
+    std::vector<UINT> materialIds(cached.materials.size(), Engine::INVALID_ID);
+    for (size_t i = 0; i < cached.materials.size(); ++i)
+    {
+        auto mat = LoadExisting<Material>(rs, cached.materials[i], ctx);
+        if (!mat) continue;
+        materialIds[i] = mat->GetId();
+
+        if (mat->diffuseTexId != Engine::INVALID_ID)
+            result.textureIds.push_back(mat->diffuseTexId);
+        if (mat->normalTexId != Engine::INVALID_ID)
+            result.textureIds.push_back(mat->normalTexId);
+        if (mat->roughnessTexId != Engine::INVALID_ID)
+            result.textureIds.push_back(mat->roughnessTexId);
+        if (mat->metallicTexId != Engine::INVALID_ID)
+            result.textureIds.push_back(mat->metallicTexId);
+
+        result.materialIds.push_back(mat->GetId());
+    }
+
+    std::shared_ptr<Skeleton> skeleton;
+    if (cached.hasSkeleton)
+    {
+        if (cached.skeletonTemporary)
+        {
+            skeleton = cached.embeddedSkeleton;
+            skeleton->SetTemporary(true);
+            skeleton->SetPath(cached.skeleton.path);
+            skeleton->SetAlias(cached.skeleton.alias);
+            rs->RegisterResource(skeleton);
+        }
+        else
+        {
+            skeleton = LoadExisting<Skeleton>(rs, cached.skeleton, ctx);
+            if (skeleton) result.skeletonId = skeleton->GetId();
+        }
+    }
+
+    std::shared_ptr<Model_Avatar> avatar;
+    if (cached.hasAvatar && skeleton)
+    {
+        if (cached.avatarTemporary)
+        {
+            // Temporary avatars are never edited, so they are rebuilt the same way the importer built them.
+            avatar = std::make_shared<Model_Avatar>();
+            avatar->SetDefinitionType(DefinitionType::Humanoid);
+            avatar->AutoMap(skeleton);
+            avatar->SetTemporary(true);
+            avatar->SetPath(cached.avatar.path);
+            avatar->SetAlias(cached.avatar.alias);
+            rs->RegisterResource(avatar);
+        }
+        else
+        {
+            avatar = LoadExisting<Model_Avatar>(rs, cached.avatar, ctx);
+            if (avatar) result.avatarId = avatar->GetId();
+        }
+    }
+
+    if (model)
+    {
+        model->SetSkeleton(skeleton);
+        if (avatar)
+            model->SetAvatarID(avatar->GetId());
+    }
+
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const CachedMesh& entry = cached.meshes[i];
+        auto& mesh = meshes[i];
+
+        for (size_t s = 0; s < mesh->submeshes.size(); ++s)
+        {
+            int material = entry.submeshMaterials[s];
+            mesh->submeshes[s].materialId = material >= 0 ? materialIds[material] : Engine::INVALID_ID;
+        }
+
+        mesh->SetAlias(entry.alias);
+        mesh->SetGUID(entry.guid);
+        if (!entry.path.empty())
+            mesh->SetPath(entry.path);
+        if (mesh->GetGenerateCollision())
+            mesh->BuildCollisionBVH();
+        rs->RegisterResource(mesh);
+    }
+
+    if (model)
+        model->SetRoot(BuildNode(cached.root, meshes));
+
+    for (const auto& ref : cached.clips)
+    {
+        auto clip = LoadExisting<AnimationClip>(rs, ref, ctx);
+        if (!clip) continue;
+
+        clip->SetAvatar(avatar);
+        clip->SetSkeleton(skeleton);
+        result.clipIds.push_back(clip->GetId());
+    }
+
+    for (auto& mesh : meshes)
+    {
+        if (auto skinned = std::dynamic_pointer_cast<SkinnedMesh>(mesh))
+            skinned->Skinning_Skeleton_Bones(skeleton);
+
+        result.meshIds.push_back(mesh->GetId());
+    }
+
+    if (model)
+    {
+        model->SetMeshCount((UINT)result.meshIds.size());
+        model->SetMaterialCount((UINT)result.materialIds.size());
+        model->SetTextureCount((UINT)result.textureIds.size());
+    }
+
+    return true;
+}
+
+void ModelImportCache::Save(const ModelImportRecord& record)
+{
+    // Only graphs whose every part can be reloaded without the importer are cached.
+    for (const auto& [mesh, cookedPath] : record.meshes)
+    {
+        if (cookedPath.empty() || !std::filesystem::exists(cookedPath)) return;
+    }
+    for (const auto& clip : record.clips)
+    {
+        if (clip->IsTemporary()) return;
+    }
+
+    ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
+
+    std::vector<std::shared_ptr<Material>> materials;
+    std::unordered_map<UINT, int> materialIndex;
+    for (UINT id : record.materialIds)
+    {
+        auto mat = rs->GetById<Material>(id);
+        if (!mat || materialIndex.count(id)) continue;
+        materialIndex[id] = (int)materials.size();
+        materials.push_back(mat);
+    }
+
+    std::unordered_map<const Mesh*, UINT> meshIndex;
+    for (size_t i = 0; i < record.meshes.size(); ++i)
+        meshIndex[record.meshes[i].first.get()] = (UINT)i;
+
+    // Meshes reachable from the node tree but missing from the list would leave dangling references.
+    std::function<bool(const Model::Node&)> nodeMeshesKnown = [&](const Model::Node& node)
+        {
+            for (const auto& mesh : node.meshes)
+                if (!meshIndex.count(mesh.get())) return false;
+            for (const auto& child : node.children)
+                if (!nodeMeshesKnown(*child)) return false;
+            return true;
+        };
+    auto root = record.model ? record.model->GetRoot() : nullptr;
+    if (root && !nodeMeshesKnown(*root)) return;
+
+    const std::string cachePath = GetCachePath(record.sourcePath);
+    if (cachePath.empty()) return;
+
+    bool ok = BinaryIO::WriteFileAtomic(cachePath, [&](std::ostream& os)
+        {
+            BinaryIO::Write(os, ModelCacheMagic);
+            BinaryIO::Write(os, ModelCacheVersion);
+            BinaryIO::Write(os, static_cast<uint32_t>(record.importer));
+            BinaryIO::Write(os, record.importerSettings);
+
+            BinaryIO::Write(os, static_cast<uint8_t>(record.model ? 1 : 0));
+            if (record.model)
+                BinaryIO::WriteString(os, record.model->GetAlias());
+
+            BinaryIO::Write(os, static_cast<UINT>(materials.size()));
+            for (const auto& mat : materials)
+                WriteRef(os, mat->GetPath(), mat->GetAlias());
+
+            BinaryIO::Write(os, static_cast<uint8_t>(record.skeleton ? 1 : 0));
+            if (record.skeleton)
+            {
+                BinaryIO::Write(os, static_cast<uint8_t>(record.skeleton->IsTemporary() ? 1 : 0));
+                WriteRef(os, record.skeleton->GetPath(), record.skeleton->GetAlias());
+                if (record.skeleton->IsTemporary())
+                    record.skeleton->WriteBinary(os);
+            }
+
+            BinaryIO::Write(os, static_cast<uint8_t>(record.avatar ? 1 : 0));
+            if (record.avatar)
+            {
+                BinaryIO::Write(os, static_cast<uint8_t>(record.avatar->IsTemporary() ? 1 : 0));
+                WriteRef(os, record.avatar->GetPath(), record.avatar->GetAlias());
+            }
+
+            BinaryIO::Write(os, static_cast<UINT>(record.meshes.size()));
+            for (const auto& [mesh, cookedPath] : record.meshes)
+            {
+                BinaryIO::Write(os, static_cast<uint8_t>(std::dynamic_pointer_cast<SkinnedMesh>(mesh) ? 1 : 0));
+                BinaryIO::WriteString(os, cookedPath);
+                BinaryIO::WriteString(os, mesh->GetAlias());
+                BinaryIO::Write(os, mesh->GetGUID());
+                BinaryIO::WriteString(os, mesh->GetPath());
+
+                BinaryIO::Write(os, mesh->GetSubMeshCount());
+                for (const auto& sub : mesh->submeshes)
+                {
+                    auto it = materialIndex.find(sub.materialId);
+                    BinaryIO::Write(os, it != materialIndex.end() ? it->second : -1);
+                }
+            }
+
+            BinaryIO::Write(os, static_cast<uint8_t>(root ? 1 : 0));
+            if (root)
+                WriteNode(os, *root, meshIndex);
+
+            BinaryIO::Write(os, static_cast<UINT>(record.clips.size()));
+            for (const auto& clip : record.clips)
+                WriteRef(os, clip->GetPath(), clip->GetAlias());
+
+            return true;
+        });
+
+    if (ok)
+        CookedCache::RemoveStale(cachePath);
+    else
+        OutputDebugStringA(("[ModelImportCache] Failed to write cache: " + cachePath + "\n").c_str());
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "ResourceSystem.h"
+
+enum class ModelImporter : uint32_t
+{
+    FBX,
+    Assimp,
+};
+
+// Everything an importer produced for one source file, handed to ModelImportCache::Save.
+struct ModelImportRecord
+{
+    std::string sourcePath;
+    ModelImporter importer = ModelImporter::FBX;
+    uint64_t importerSettings = 0;
+
+    std::shared_ptr<Model> model; // null for animation-only sources
+    std::vector<UINT> materialIds;
+    std::vector<std::pair<std::shared_ptr<Mesh>, std::string>> meshes; // mesh and its cooked .mesh path
+    std::shared_ptr<Skeleton> skeleton;
+    std::shared_ptr<Model_Avatar> avatar;
+    std::vector<std::shared_ptr<AnimationClip>> clips;
+};
+
+// Whole imported model graph in one binary file next to the cooked meshes: node tree, cooked mesh and
+// material references, skeleton, avatar and clips. A warm load rebuilds the resources from it without
+// touching the FBX SDK or Assimp. The file is keyed by the source's content hash and validated against
+// the importer settings it was written with.
+class ModelImportCache
+{
+public:
+    static bool Load(const std::string& sourcePath, LoadResult& result);
+    static void Save(const ModelImportRecord& record);
+
+private:
+    static std::string GetCachePath(const std::string& sourcePath);
+    static uint64_t GetImporterSettings(ModelImporter importer);
+};
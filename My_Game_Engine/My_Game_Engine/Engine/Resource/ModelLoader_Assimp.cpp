@@ -4,6 +4,8 @@
 #include "MetaIO.h"
 #include "Model_Avatar.h"
 #include "AnimationClip.h"
+#include "CookedCache.h"
+#include "ModelImportCache.h"
 
 using namespace DirectX;
 
@@ -30,6 +32,13 @@ ModelLoader_Assimp::ModelLoader_Assimp()
 bool ModelLoader_Assimp::Load(const std::string& path, std::string_view alias, LoadResult& result)
 {
     m_meshMap.clear();
+    m_pendingCooks.clear();
+    m_cookedPaths.clear();
+    m_sourceHash = CookedCache::HashSourceFile(path, ImportSettingsVersion);
+
+    FbxMeta importSettings;
+    MetaIO::LoadFbxMeta(importSettings, path);
+    m_generateCollision = importSettings.generateCollision;
 
     ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
     RendererContext ctx = GameEngine::Get().Get_UploadContext();
@@ -38,16 +47,7 @@ bool ModelLoader_Assimp::Load(const std::string& path, std::string_view alias, L
 
     importer.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
 
-    const aiScene* scene = importer.ReadFile(path,
-        aiProcess_Triangulate |
-        aiProcess_CalcTangentSpace |
-        aiProcess_JoinIdenticalVertices |
-        aiProcess_GenNormals |
-        aiProcess_LimitBoneWeights |
-//        aiProcess_ValidateDataStructure |
-        aiProcess_MakeLeftHanded |
-        aiProcess_FlipWindingOrder
-    );
+    const aiScene* scene = importer.ReadFile(path, ImportFlags);
 
     if (!scene)
     {
@@ -228,10 +228,21 @@ bool ModelLoader_Assimp::Load(const std::string& path, std::string_view alias, L
         }
     }
 
+    for (auto& [mesh, cookedPath] : m_pendingCooks)
+    {
+        auto skinned = std::dynamic_pointer_cast<SkinnedMesh>(mesh);
+        if (skinned && !skinned->GetSkeleton()) continue;
+
+        if (mesh->SaveToFile(cookedPath))
+            CookedCache::RemoveStale(cookedPath);
+    }
+    m_pendingCooks.clear();
+
     FbxMeta meta;
     if (model) meta.guid = model->GetGUID();
     else meta.guid = rs->GetOrCreateGUID(path);
     meta.path = path;
+    meta.generateCollision = m_generateCollision;
 
     for (auto& mesh : loadedMeshes)
     {
@@ -300,6 +311,22 @@ bool ModelLoader_Assimp::Load(const std::string& path, std::string_view alias, L
         model->SetTextureCount((UINT)result.textureIds.size());
     }
 
+    ModelImportRecord cacheRecord;
+    cacheRecord.sourcePath = path;
+    cacheRecord.importer = ModelImporter::Assimp;
+    cacheRecord.importerSettings = ImportSettingsVersion;
+    cacheRecord.model = model;
+    cacheRecord.materialIds = result.materialIds;
+    for (auto& mesh : loadedMeshes)
+    {
+        auto it = m_cookedPaths.find(mesh.get());
+        cacheRecord.meshes.emplace_back(mesh, it != m_cookedPaths.end() ? it->second : std::string());
+    }
+    cacheRecord.skeleton = skeletonRes;
+    cacheRecord.avatar = modelAvatar;
+    cacheRecord.clips = loadedClips;
+    ModelImportCache::Save(cacheRecord);
+
     return true;
 }
 
@@ -359,32 +386,62 @@ std::shared_ptr<Mesh> ModelLoader_Assimp::CreateMeshFromNode(
     aiMesh* mesh = scene->mMeshes[meshIndex];
     bool hasSkin = mesh->HasBones();
     std::shared_ptr<Mesh> newMesh = hasSkin ? std::make_shared<SkinnedMesh>() : std::make_shared<Mesh>();
+    newMesh->SetGenerateCollision(m_generateCollision);
 
-    newMesh->FromAssimp(mesh);
+    std::string cookedPath;
+    if (m_sourceHash)
+    {
+        std::string cookedName = std::string(mesh->mName.C_Str()) + "_" + std::to_string(meshIndex);
+        cookedPath = CookedCache::GetCookedPath(path, cookedName, CookedCache::HashString(cookedName, m_sourceHash), ".mesh");
+    }
 
-    if (newMesh->GetIndexCount() > 0)
+    if (!cookedPath.empty() && std::filesystem::exists(cookedPath) &&
+        newMesh->LoadFromFile(cookedPath, GameEngine::Get().Get_UploadContext()))
     {
-        Mesh::Submesh sub{};
-        sub.indexCount = newMesh->GetIndexCount();
-        sub.startIndexLocation = 0;
-        sub.baseVertexLocation = 0;
+        for (auto& sub : newMesh->submeshes)
+        {
+            sub.materialId = (sub.materialSlot >= 0 && sub.materialSlot < (int)materialIDs.size())
+                ? materialIDs[sub.materialSlot]
+                : Engine::INVALID_ID;
+        }
+    }
+    else
+    {
+        newMesh = hasSkin ? std::make_shared<SkinnedMesh>() : std::make_shared<Mesh>();
+        newMesh->SetGenerateCollision(m_generateCollision);
+        newMesh->FromAssimp(mesh);
 
-        if (mesh->mMaterialIndex < materialIDs.size())
+        if (newMesh->GetIndexCount() > 0)
         {
-            sub.materialId = materialIDs[mesh->mMaterialIndex];
+            Mesh::Submesh sub{};
+            sub.indexCount = newMesh->GetIndexCount();
+            sub.startIndexLocation = 0;
+            sub.baseVertexLocation = 0;
+            sub.materialSlot = static_cast<int>(mesh->mMaterialIndex);
+
+            if (mesh->mMaterialIndex < materialIDs.size())
+            {
+                sub.materialId = materialIDs[mesh->mMaterialIndex];
+            }
+            else
+            {
+                sub.materialId = Engine::INVALID_ID;
+            }
+            newMesh->submeshes.push_back(sub);
         }
         else
         {
-            sub.materialId = Engine::INVALID_ID;
+            return nullptr;
         }
-        newMesh->submeshes.push_back(sub);
-    }
-    else
-    {
-        return nullptr;
+
+        newMesh->SetAABB();
+
+        if (!cookedPath.empty())
+            m_pendingCooks.emplace_back(newMesh, cookedPath);
     }
 
-    newMesh->SetAABB();
+    if (!cookedPath.empty())
+        m_cookedPaths[newMesh.get()] = cookedPath;
 
     std::string originalName = mesh->mName.C_Str();
     if (originalName.empty())
@@ -394,7 +451,12 @@ std::shared_ptr<Mesh> ModelLoader_Assimp::CreateMeshFromNode(
     newMesh->SetAlias(originalName);
 
     std::string uniqueGUIDInput = originalName + "_" + std::to_string(meshIndex);
-    newMesh->SetGUID(MetaIO::CreateGUID(path, uniqueGUIDInput));
+    newMesh->SetGUID(Guid::FromName(path, uniqueGUIDInput));
+    // Gives the mesh the model's unit, so the ResourceSystem unloads and re-imports them together.
+    newMesh->SetPath(MakeSubresourcePath(path, "mesh", uniqueGUIDInput));
+
+    if (newMesh->GetGenerateCollision())
+        newMesh->BuildCollisionBVH();
 
     ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
     rs->RegisterResource(newMesh);
@@ -531,19 +593,22 @@ std::shared_ptr<AnimationClip> ModelLoader_Assimp::ProcessAnimation(const aiAnim
         auto ToTime = [&](double t) { return (float)(t / clip->mTicksPerSecond); };
 
         for (unsigned int k = 0; k < channel->mNumPositionKeys; ++k)
-            track.PositionKeys.push_back({ ToTime(channel->mPositionKeys[k].mTime), Vec3FromAssimp(channel->mPositionKeys[k].mValue) });
+            track.PositionKeys.Add(ToTime(channel->mPositionKeys[k].mTime), Vec3FromAssimp(channel->mPositionKeys[k].mValue));
 
         for (unsigned int k = 0; k < channel->mNumRotationKeys; ++k)
-            track.RotationKeys.push_back({ ToTime(channel->mRotationKeys[k].mTime), QuatFromAssimp(channel->mRotationKeys[k].mValue) });
+            track.RotationKeys.Add(ToTime(channel->mRotationKeys[k].mTime), QuatFromAssimp(channel->mRotationKeys[k].mValue));
 
         for (unsigned int k = 0; k < channel->mNumScalingKeys; ++k)
-            track.ScaleKeys.push_back({ ToTime(channel->mScalingKeys[k].mTime), Vec3FromAssimp(channel->mScalingKeys[k].mValue) });
+            track.ScaleKeys.Add(ToTime(channel->mScalingKeys[k].mTime), Vec3FromAssimp(channel->mScalingKeys[k].mValue));
 
+        track.Finalize();
         clip->mTracks.emplace_back(key, std::move(track));
     }
 
     std::sort(clip->mTracks.begin(), clip->mTracks.end(),
         [](const auto& a, const auto& b) { return a.first < b.first; });
 
+    clip->BakeRootMotion();
+
     return clip;
 }
\ No newline at end of file
@@ -3,6 +3,20 @@
 
 class ModelLoader_Assimp
 {
+public:
+    static constexpr unsigned int ImportFlags =
+        aiProcess_Triangulate |
+        aiProcess_CalcTangentSpace |
+        aiProcess_JoinIdenticalVertices |
+        aiProcess_GenNormals |
+        aiProcess_LimitBoneWeights |
+//        aiProcess_ValidateDataStructure |
+        aiProcess_MakeLeftHanded |
+        aiProcess_FlipWindingOrder;
+
+    // Bump the high word when the conversion from aiScene changes so cooked meshes and model caches are rebuilt.
+    static constexpr uint64_t ImportSettingsVersion = (uint64_t(1) << 32) | ImportFlags;
+
 public:
     explicit ModelLoader_Assimp();
     bool Load(const std::string& path, std::string_view alias, LoadResult& result);
@@ -36,4 +50,9 @@ private:
 private:
     // [߿] ޽ ߺ ε  ĳ (aiMesh Index -> Mesh Resource)
     std::unordered_map<unsigned int, std::shared_ptr<Mesh>> m_meshMap;
+
+    uint64_t m_sourceHash = 0; // 0 when the source could not be hashed; cooking is skipped
+    bool m_generateCollision = false; // from the model's .meta, applied to every mesh before it is built
+    std::vector<std::pair<std::shared_ptr<Mesh>, std::string>> m_pendingCooks; // freshly imported meshes and their cooked paths
+    std::unordered_map<const Mesh*, std::string> m_cookedPaths;
 };
@@ -6,6 +6,8 @@
 #include "Mesh.h"
 #include "Model_Avatar.h"
 #include "AnimationClip.h"
+#include "CookedCache.h"
+#include "ModelImportCache.h"
 
 ModelLoader_FBX::ModelLoader_FBX()
 {
@@ -15,11 +17,18 @@ ModelLoader_FBX::ModelLoader_FBX()
 bool ModelLoader_FBX::Load(const std::string& path, std::string_view alias, LoadResult& result)
 {
     m_meshMap.clear();
+    m_pendingCooks.clear();
+    m_cookedPaths.clear();
 
     RendererContext ctx = GameEngine::Get().Get_UploadContext();
     ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
 
     std::string physicalPath = GetPhysicalFilePath(path);
+    m_sourceHash = CookedCache::HashSourceFile(physicalPath, ImportSettingsVersion);
+
+    FbxMeta importSettings;
+    MetaIO::LoadFbxMeta(importSettings, physicalPath);
+    m_generateCollision = importSettings.generateCollision;
 
     FbxManager* fbxManager = FbxManager::Create();
     FbxIOSettings* ios = FbxIOSettings::Create(fbxManager, IOSROOT);
@@ -233,6 +242,16 @@ bool ModelLoader_FBX::Load(const std::string& path, std::string_view alias, Load
         }
     }
 
+    for (auto& [mesh, cookedPath] : m_pendingCooks)
+    {
+        auto skinned = std::dynamic_pointer_cast<SkinnedMesh>(mesh);
+        if (skinned && !skinned->GetSkeleton()) continue;
+
+        if (mesh->SaveToFile(cookedPath))
+            CookedCache::RemoveStale(cookedPath);
+    }
+    m_pendingCooks.clear();
+
     FbxMeta meta;
     if (model)
     {
@@ -243,6 +262,7 @@ bool ModelLoader_FBX::Load(const std::string& path, std::string_view alias, Load
         meta.guid = rs->GetOrCreateGUID(physicalPath);
     }
     meta.path = physicalPath;
+    meta.generateCollision = m_generateCollision;
 
     for (auto& mesh : loadedMeshes)
     {
@@ -309,6 +329,22 @@ bool ModelLoader_FBX::Load(const std::string& path, std::string_view alias, Load
         model->SetTextureCount((UINT)result.textureIds.size());
     }
 
+    ModelImportRecord cacheRecord;
+    cacheRecord.sourcePath = physicalPath;
+    cacheRecord.importer = ModelImporter::FBX;
+    cacheRecord.importerSettings = ImportSettingsVersion;
+    cacheRecord.model = model;
+    cacheRecord.materialIds = result.materialIds;
+    for (auto& mesh : loadedMeshes)
+    {
+        auto it = m_cookedPaths.find(mesh.get());
+        cacheRecord.meshes.emplace_back(mesh, it != m_cookedPaths.end() ? it->second : std::string());
+    }
+    cacheRecord.skeleton = skeletonRes;
+    cacheRecord.avatar = modelAvatar;
+    cacheRecord.clips = loadedClips;
+    ModelImportCache::Save(cacheRecord);
+
     fbxManager->Destroy();
     return true;
 }
@@ -378,18 +414,72 @@ std::shared_ptr<Mesh> ModelLoader_FBX::CreateMeshFromNode(
     ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
 
     bool hasSkin = (fbxMesh->GetDeformerCount(FbxDeformer::eSkin) > 0);
+    auto createMesh = [this, hasSkin]() -> std::shared_ptr<Mesh>
+        {
+            std::shared_ptr<Mesh> mesh = hasSkin ? std::make_shared<SkinnedMesh>() : std::make_shared<Mesh>();
+            mesh->SetGenerateCollision(m_generateCollision);
+            return mesh;
+        };
 
-    std::shared_ptr<Mesh> mesh = hasSkin
-        ? std::make_shared<SkinnedMesh>()
-        : std::make_shared<Mesh>();
+    std::shared_ptr<Mesh> mesh = createMesh();
+    std::string nodePath = fbxNode->GetName();
 
-    mesh->FromFbxSDK(fbxMesh);
+    // Cooked meshes are keyed by source contents and their order in the file, since node names can repeat.
+    std::string cookedPath;
+    if (m_sourceHash)
+    {
+        std::string cookedName = nodePath + "_" + std::to_string(m_meshMap.size());
+        cookedPath = CookedCache::GetCookedPath(path, cookedName, CookedCache::HashString(cookedName, m_sourceHash), ".mesh");
+    }
+
+    if (!cookedPath.empty() && std::filesystem::exists(cookedPath) &&
+        mesh->LoadFromFile(cookedPath, GameEngine::Get().Get_UploadContext()))
+    {
+        for (auto& sub : mesh->submeshes)
+        {
+            FbxSurfaceMaterial* fbxMat =
+                (sub.materialSlot >= 0 && sub.materialSlot < fbxNode->GetMaterialCount())
+                ? fbxNode->GetMaterial(sub.materialSlot)
+                : nullptr;
+
+            auto it = (fbxMat ? matMap.find(fbxMat) : matMap.end());
+            sub.materialId = (it != matMap.end()) ? it->second : Engine::INVALID_ID;
+        }
+    }
+    else
+    {
+        mesh = createMesh();
+        BuildMeshFromFbx(mesh, fbxNode, matMap);
+        if (!cookedPath.empty())
+            m_pendingCooks.emplace_back(mesh, cookedPath);
+    }
+
+    if (!cookedPath.empty())
+        m_cookedPaths[mesh.get()] = cookedPath;
 
-    std::string nodePath = fbxNode->GetName();
     mesh->SetAlias(nodePath);
-    mesh->SetGUID(MetaIO::CreateGUID(path, nodePath));
+    mesh->SetGUID(Guid::FromName(path, nodePath));
     mesh->SetPath(MakeSubresourcePath(path, "mesh", nodePath));
 
+    if (mesh->GetGenerateCollision())
+        mesh->BuildCollisionBVH();
+
+    rs->RegisterResource(mesh);
+
+
+    m_meshMap[fbxMesh] = mesh;
+
+    return mesh;
+}
+
+
+void ModelLoader_FBX::BuildMeshFromFbx(const std::shared_ptr<Mesh>& mesh, FbxNode* fbxNode,
+    std::unordered_map<FbxSurfaceMaterial*, UINT>& matMap)
+{
+    FbxMesh* fbxMesh = fbxNode->GetMesh();
+
+    mesh->FromFbxSDK(fbxMesh);
+
     FbxGeometryElementMaterial* matElem = fbxMesh->GetElementMaterial();
     int polyCount = fbxMesh->GetPolygonCount();
 
@@ -412,6 +502,7 @@ std::shared_ptr<Mesh> ModelLoader_FBX::CreateMeshFromNode(
             sub.startIndexLocation = indexOffset;
             sub.indexCount = (UINT)idxList.size();
             sub.baseVertexLocation = 0;
+            sub.materialSlot = matSlot;
 
             FbxSurfaceMaterial* fbxMat =
                 (matSlot >= 0 && matSlot < fbxNode->GetMaterialCount())
@@ -436,15 +527,8 @@ std::shared_ptr<Mesh> ModelLoader_FBX::CreateMeshFromNode(
         mesh->submeshes.push_back(sub);
     }
     mesh->SetAABB();
-    rs->RegisterResource(mesh);
-
-
-    m_meshMap[fbxMesh] = mesh;
-
-    return mesh;
 }
 
-
 std::shared_ptr<Skeleton> ModelLoader_FBX::BuildSkeleton(FbxScene* fbxScene)
 {
     auto skeletonRes = std::make_shared<Skeleton>();
@@ -704,16 +788,19 @@ std::shared_ptr<AnimationClip> ModelLoader_FBX::BuildAnimation(
                 finalPos = bindPos;
             }
 
-            track.RotationKeys.push_back({ time, XMFLOAT4((float)q[0], (float)q[1], (float)q[2], (float)q[3]) });
-            track.PositionKeys.push_back({ time, finalPos });
-            track.ScaleKeys.push_back({ time, XMFLOAT3((float)s[0], (float)s[1], (float)s[2]) });
+            track.RotationKeys.Add(time, XMFLOAT4((float)q[0], (float)q[1], (float)q[2], (float)q[3]));
+            track.PositionKeys.Add(time, finalPos);
+            track.ScaleKeys.Add(time, XMFLOAT3((float)s[0], (float)s[1], (float)s[2]));
         }
 
+        track.Finalize();
         newClip->mTracks.emplace_back(abstractKey, std::move(track));
     }
 
     std::sort(newClip->mTracks.begin(), newClip->mTracks.end(),
         [](const auto& a, const auto& b) { return a.first < b.first; });
 
+    newClip->BakeRootMotion();
+
     return newClip;
 }
\ No newline at end of file
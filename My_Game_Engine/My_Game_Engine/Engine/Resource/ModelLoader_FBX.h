@@ -3,6 +3,10 @@
 
 class ModelLoader_FBX
 {
+public:
+    // Bump when the FBX conversion changes so cooked meshes and model caches are rebuilt.
+    static constexpr uint64_t ImportSettingsVersion = 1;
+
 public:
     explicit ModelLoader_FBX();
     bool Load(const std::string& path, std::string_view alias, LoadResult& result);
@@ -13,8 +17,15 @@ private:
 
     std::shared_ptr<Mesh> CreateMeshFromNode(FbxNode* fbxNode,
         std::unordered_map<FbxSurfaceMaterial*, UINT>& matMap, const std::string& path);
+    void BuildMeshFromFbx(const std::shared_ptr<Mesh>& mesh, FbxNode* fbxNode,
+        std::unordered_map<FbxSurfaceMaterial*, UINT>& matMap);
 
     std::shared_ptr<Skeleton> BuildSkeleton(FbxScene* fbxScene);
     std::shared_ptr<AnimationClip> BuildAnimation(FbxScene* scene, FbxAnimStack* animStack, std::shared_ptr<Model_Avatar> avatar, std::shared_ptr<Skeleton> skeleton);
     std::unordered_map<FbxMesh*, std::shared_ptr<Mesh>> m_meshMap;
+
+    uint64_t m_sourceHash = 0; // 0 when the source could not be hashed; cooking is skipped
+    bool m_generateCollision = false; // from the model's .meta, applied to every mesh before it is built
+    std::vector<std::pair<std::shared_ptr<Mesh>, std::string>> m_pendingCooks; // freshly imported meshes and their cooked paths
+    std::unordered_map<const Mesh*, std::string> m_cookedPaths;
 };
@@ -51,13 +51,8 @@ bool Model_Avatar::SaveToFile(const std::string& outputPath) const
 
 bool Model_Avatar::LoadFromFile(std::string path, const RendererContext& ctx)
 {
-    std::ifstream ifs(path);
-    if (!ifs.is_open()) return false;
-
-    std::stringstream buffer;
-    buffer << ifs.rdbuf();
-    std::string json = buffer.str();
-    ifs.close();
+    std::string json;
+    if (!GameEngine::Get().GetResourceSystem()->ReadTextFile(path, json)) return false;
 
     rapidjson::Document doc;
     if (doc.Parse(json.c_str()).HasParseError()) return false;
@@ -95,6 +90,7 @@ bool Model_Avatar::LoadFromFile(std::string path, const RendererContext& ctx)
     }
 
     mIsReverseMapDirty = true;
+    ++mMappingRevision;
     return true;
 }
 
@@ -248,6 +244,7 @@ void Model_Avatar::AutoMap(std::shared_ptr<Skeleton> skeleton)
     }
 
     mIsReverseMapDirty = true;
+    ++mMappingRevision;
 
     OutputDebugStringA(("[AutoMap] Final mapped bones: " + std::to_string(mBoneMap.size()) + "\n").c_str());
 }
@@ -269,6 +266,13 @@ void Model_Avatar::SetDefinitionType(DefinitionType type)
     mDefinitionType = type;
 }
 
+void Model_Avatar::SetMapping(const std::string& key, const std::string& value)
+{
+    mBoneMap[key] = value;
+    mIsReverseMapDirty = true;
+    ++mMappingRevision;
+}
+
 void Model_Avatar::SetCorrection(const std::string& abstractKey, const DirectX::XMFLOAT4& rotation)
 {
     mTPoseCorrections[abstractKey] = rotation;
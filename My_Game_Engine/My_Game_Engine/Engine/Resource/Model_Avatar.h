@@ -14,7 +14,7 @@ public:
 
     void AutoMap(std::shared_ptr<Skeleton> skeleton);
 
-	// void SetMapping(const std::string& key, const std::string& value); //  ϰ   ʿ
+	void SetMapping(const std::string& key, const std::string& value); //  ϰ   ʿ
 
     void SetDefinitionType(DefinitionType type);
     DefinitionType GetDefinitionType() const { return mDefinitionType; }
@@ -27,6 +27,9 @@ public:
 
     const std::string& GetMappedKeyByBoneName(const std::string& boneName) const;
 
+    // Bumped whenever the bone map changes, so cached bindings know to rebuild.
+    UINT GetMappingRevision() const { return mMappingRevision; }
+
 private:
     void BuildReverseMap() const;
 
@@ -35,6 +38,7 @@ private:
 
     mutable std::unordered_map<std::string, std::string> mReverseBoneMap;
     mutable bool mIsReverseMapDirty = true;
+    UINT mMappingRevision = 0;
 
     std::unordered_map<std::string, DirectX::XMFLOAT4> mTPoseCorrections;
 
@@ -0,0 +1,20 @@
+#pragma once
+
+// Counted reference to a registered resource, obtained from ResourceSystem::Acquire. While any handle to a
+// resource is alive it is never unloaded or evicted. Handles only share a token with the system, so they can
+// outlive it safely.
+class ResourceHandle
+{
+public:
+    ResourceHandle() = default;
+
+    UINT GetId() const { return mToken ? *mToken : Engine::INVALID_ID; }
+    bool IsValid() const { return mToken != nullptr; }
+    void Reset() { mToken.reset(); }
+
+private:
+    friend class ResourceSystem;
+    explicit ResourceHandle(std::shared_ptr<const UINT> token) : mToken(std::move(token)) {}
+
+    std::shared_ptr<const UINT> mToken;
+};
@@ -2,11 +2,38 @@
 #include "GameEngine.h"
 #include "ModelLoader_Assimp.h"
 #include "ModelLoader_FBX.h"
+#include "ModelImportCache.h"
 #include "TextureLoader.h"
 
+namespace
+{
+    constexpr const char* MetaIndexFileName = "meta_index.bin";
+    constexpr const char* PackExtension = ".pak";
+    constexpr size_t MetaParseGrain = 32;
+
+    void LogImportTime(const std::string& path, bool warm, std::chrono::steady_clock::time_point start)
+    {
+        auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::string msg = "[ResourceSystem] Imported " + path + (warm ? " (warm) in " : " (cold) in ") +
+            std::to_string(ms) + " ms\n";
+        OutputDebugStringA(msg.c_str());
+    }
+}
 
 void ResourceSystem::Initialize(const std::string& assetRoot)
 {
+    std::vector<std::filesystem::path> packPaths;
+    std::error_code ec;
+    for (auto it = std::filesystem::directory_iterator(assetRoot, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec))
+    {
+        if (it->path().extension() == PackExtension && it->is_regular_file(ec))
+            packPaths.push_back(it->path());
+    }
+
+    std::sort(packPaths.begin(), packPaths.end());
+    for (const auto& packPath : packPaths)
+        MountPack(packPath.string());
+
     LoadAllMeta(assetRoot);
     std::string output = "[ResourceSystem] Meta cache loaded: " + std::to_string(mAllMetaData.size()) + " entries.\n";
 	OutputDebugStringA(output.c_str());
@@ -23,68 +50,219 @@ void ResourceSystem::LoadAllMeta(const std::string& assetRoot)
         return; 
     }
 
-    for (auto& p : fs::recursive_directory_iterator(assetRoot))
+    // The walk only stats files; .meta JSON is parsed only when the file differs from the index record.
+    const std::string indexPath = (fs::path(assetRoot) / MetaIndexFileName).string();
+
+    std::vector<MetaIndexRecord> cached;
+    MetaIO::LoadMetaIndex(indexPath, cached);
+
+    std::unordered_map<std::string, MetaIndexRecord*> cachedByMetaPath;
+    cachedByMetaPath.reserve(cached.size());
+    for (auto& record : cached)
+        cachedByMetaPath[record.metaPath] = &record;
+
+    std::vector<MetaIndexRecord> records;
+    std::vector<size_t> stale;
+
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(assetRoot, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
     {
-        if (p.path().extension() == ".meta")
+        const fs::directory_entry& p = *it;
+        if (p.path().extension() != ".meta" || !p.is_regular_file(ec))
+            continue;
+        if (!mPacks.empty() && FindPack(p.path().string()))
+            continue;
+
+        MetaIndexRecord record;
+        record.metaPath = p.path().generic_string();
+        record.writeTime = static_cast<int64_t>(p.last_write_time(ec).time_since_epoch().count());
+        record.fileSize = static_cast<uint64_t>(p.file_size(ec));
+
+        auto found = cachedByMetaPath.find(record.metaPath);
+        if (found != cachedByMetaPath.end() &&
+            found->second->writeTime == record.writeTime && found->second->fileSize == record.fileSize)
         {
-            std::ifstream ifs(p.path());
-            if (!ifs.is_open())
-                continue;
-
-            std::string json((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-            rapidjson::Document doc;
+            records.push_back(std::move(*found->second));
+            continue;
+        }
 
-            if (doc.Parse(json.c_str()).HasParseError())
-                continue;
+        stale.push_back(records.size());
+        records.push_back(std::move(record));
+    }
 
-            if (doc.HasMember("path") && doc.HasMember("guid"))
+    if (!stale.empty())
+    {
+        auto parseRange = [&](size_t begin, size_t end, UINT)
             {
-                std::string filePath = doc["path"].GetString();
-                std::string rootGuid = doc["guid"].GetString();
+                for (size_t i = begin; i < end; ++i)
+                    MetaIO::ParseMetaRecord(records[stale[i]]);
+            };
 
-                ResourceMetaEntry& entry = mAllMetaData.emplace_back();
-                entry.path = filePath;
-                entry.guid = rootGuid;
-
-                ResourceMetaEntry* entryPtr = &entry;
+        if (JobSystem* jobs = GameEngine::Get().GetJobSystem())
+            jobs->ParallelFor(stale.size(), MetaParseGrain, parseRange);
+        else
+            parseRange(0, stale.size(), 0);
+    }
 
-                mPathToMeta[filePath] = entryPtr;
-                mGuidToMeta[rootGuid] = entryPtr;
+    // Packed .meta files are parsed straight from their pack; the index only tracks loose files.
+    std::vector<MetaIndexRecord> packed;
+    for (const auto& pack : mPacks)
+    {
+        pack->ForEachFile([&](std::string_view path)
+            {
+                if (path.ends_with(".meta"))
+                    packed.emplace_back().metaPath = path;
+            });
+    }
 
-                if (doc.HasMember("sub_resources") && doc["sub_resources"].IsArray())
+    if (!packed.empty())
+    {
+        auto parsePacked = [&](size_t begin, size_t end, UINT)
+            {
+                std::string json;
+                for (size_t i = begin; i < end; ++i)
                 {
-                    const auto& subArray = doc["sub_resources"].GetArray();
-                    for (rapidjson::SizeType i = 0; i < subArray.Size(); ++i)
-                    {
-                        const auto& subItem = subArray[i];
-                        if (subItem.IsObject() && subItem.HasMember("guid") && subItem["guid"].IsString())
-                        {
-                            std::string subGuid = subItem["guid"].GetString();
-
-                            mGuidToMeta[subGuid] = entryPtr;
-                        }
-                    }
+                    if (ReadTextFile(packed[i].metaPath, json))
+                        MetaIO::ParseMetaRecord(packed[i], json);
                 }
-            }
-        }
+            };
+
+        if (JobSystem* jobs = GameEngine::Get().GetJobSystem())
+            jobs->ParallelFor(packed.size(), MetaParseGrain, parsePacked);
+        else
+            parsePacked(0, packed.size(), 0);
+    }
+
+    auto registerRecord = [&](const MetaIndexRecord& record)
+        {
+            if (!record.valid)
+                return;
+
+            ResourceMetaEntry& entry = mAllMetaData.emplace_back();
+            entry.path = record.path;
+            entry.guid = record.guid;
+
+            ResourceMetaEntry* entryPtr = &entry;
+
+            mPathToMeta[InternPath(record.path)] = entryPtr;
+            mGuidToMeta[record.guid] = entryPtr;
+
+            for (const auto& sub : record.sub_resources)
+                mGuidToMeta[sub.guid] = entryPtr;
+        };
+
+    for (const auto& record : records)
+        registerRecord(record);
+    for (const auto& record : packed)
+        registerRecord(record);
+
+    // Removed .meta files drop out of the index as well, so it is rewritten on any difference.
+    if (!stale.empty() || records.size() != cached.size())
+    {
+        if (!MetaIO::SaveMetaIndex(indexPath, records))
+            OutputDebugStringA(("[ResourceSystem] Failed to write meta index: " + indexPath + "\n").c_str());
     }
+
+    std::string output = "[ResourceSystem] Meta index: " + std::to_string(records.size()) + " files, " +
+        std::to_string(stale.size()) + " re-parsed, " + std::to_string(packed.size()) + " packed.\n";
+    OutputDebugStringA(output.c_str());
+}
+
+bool ResourceSystem::MountPack(const std::string& packPath)
+{
+    auto pack = std::make_unique<AssetPack>();
+    if (!pack->Open(packPath))
+    {
+        OutputDebugStringA(("[ResourceSystem] Failed to mount pack: " + packPath + "\n").c_str());
+        return false;
+    }
+
+    OutputDebugStringA(("[ResourceSystem] Mounted pack " + packPath + " (" + std::to_string(pack->GetFileCount()) + " files)\n").c_str());
+    mPacks.push_back(std::move(pack));
+    return true;
 }
 
-std::string ResourceSystem::GetOrCreateGUID(const std::string& path)
+const AssetPack* ResourceSystem::FindPack(const std::string& path) const
 {
-    if (auto it = mPathToMeta.find(path); it != mPathToMeta.end())
+    for (auto it = mPacks.rbegin(); it != mPacks.rend(); ++it)
+    {
+        if ((*it)->Contains(path))
+            return it->get();
+    }
+    return nullptr;
+}
+
+bool ResourceSystem::FileExists(const std::string& path) const
+{
+    return FindPack(path) != nullptr || std::filesystem::exists(path);
+}
+
+bool ResourceSystem::ReadFile(const std::string& path, std::vector<uint8_t>& out) const
+{
+    if (const AssetPack* pack = FindPack(path))
+        return pack->ReadFile(path, out, GameEngine::Get().GetJobSystem());
+
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    if (!ifs.is_open()) return false;
+
+    out.resize(static_cast<size_t>(ifs.tellg()));
+    ifs.seekg(0);
+    return out.empty() || ifs.read(reinterpret_cast<char*>(out.data()), out.size()).good();
+}
+
+bool ResourceSystem::ReadTextFile(const std::string& path, std::string& out) const
+{
+    std::vector<uint8_t> bytes;
+    if (!ReadFile(path, bytes)) return false;
+
+    out.assign(bytes.begin(), bytes.end());
+    return true;
+}
+
+std::string_view ResourceSystem::ToPathKey(std::string_view path, std::string& scratch)
+{
+    if (path.find('\\') == std::string_view::npos)
+        return path;
+
+    scratch.assign(path);
+    std::replace(scratch.begin(), scratch.end(), '\\', '/');
+    return scratch;
+}
+
+std::string_view ResourceSystem::InternPath(std::string_view path)
+{
+    std::string scratch;
+    std::string_view key = ToPathKey(path, scratch);
+
+    if (auto it = mPathPool.find(key); it != mPathPool.end())
+        return *it;
+    return *mPathPool.emplace(key).first;
+}
+
+UINT ResourceSystem::GetIdByPath(std::string_view path) const
+{
+    std::string scratch;
+    if (auto it = mPathToId.find(ToPathKey(path, scratch)); it != mPathToId.end())
+        return it->second;
+    return Engine::INVALID_ID;
+}
+
+Guid ResourceSystem::GetOrCreateGUID(const std::string& path)
+{
+    std::string scratch;
+    if (auto it = mPathToMeta.find(ToPathKey(path, scratch)); it != mPathToMeta.end())
     {
         return it->second->guid;
     }
 
-    std::string guid = MetaIO::CreateGUID(path, "");
+    Guid guid = Guid::FromName(path, "");
 
     ResourceMetaEntry& entry = mAllMetaData.emplace_back();
     entry.path = path;
     entry.guid = guid;
 
     ResourceMetaEntry* entryPtr = &entry;
-    mPathToMeta[path] = entryPtr;
+    mPathToMeta[InternPath(path)] = entryPtr;
     mGuidToMeta[guid] = entryPtr;
 
     return guid;
@@ -118,18 +296,19 @@ void ResourceSystem::RegisterResource(const std::shared_ptr<Game_Resource>& res)
     }
 
     std::string resourcePath = res->GetPath();
-    std::string resourceGUID = res->GetGUID();
+    std::string_view pathKey = InternPath(resourcePath);
+    Guid resourceGUID = res->GetGUID();
 
-    if (resourceGUID.empty())
+    if (!resourceGUID.IsValid())
     {
-        auto it = mPathToMeta.find(resourcePath);
+        auto it = mPathToMeta.find(pathKey);
         if (it != mPathToMeta.end())
         {
             resourceGUID = it->second->guid;
         }
         else
         {
-            resourceGUID = MetaIO::CreateGUID(resourcePath, res->GetAlias());
+            resourceGUID = Guid::FromName(resourcePath, res->GetAlias());
         }
 
         res->SetGUID(resourceGUID);
@@ -151,7 +330,7 @@ void ResourceSystem::RegisterResource(const std::shared_ptr<Game_Resource>& res)
         metaPtr = &newMeta;
 
         mGuidToMeta[resourceGUID] = metaPtr;
-        mPathToMeta[resourcePath] = metaPtr;
+        mPathToMeta[pathKey] = metaPtr;
     }
 
     ResourceEntry entry;
@@ -159,12 +338,23 @@ void ResourceSystem::RegisterResource(const std::shared_ptr<Game_Resource>& res)
     entry.alias = res->GetAlias();
     entry.metaData = metaPtr;
     entry.resource = res;
+    entry.lastUsedFrame = mFrameCounter;
+    if (!resourcePath.empty())
+    {
+        entry.unitPath = InternPath(GetContainerPath(resourcePath));
+        entry.reloadable = FileExists(GetPhysicalFilePath(resourcePath));
+    }
 
     res->SetId(entry.id);
+    mPendingUploads.push_back(res);
+
+    ResourceEntry& stored = mResources[entry.id] = entry;
+    SetFootprint(stored, res->GetMemoryFootprint());
+    if (!stored.unitPath.empty())
+        mUnits[stored.unitPath].push_back(stored.id);
 
-    mResources[entry.id] = entry;
     mGUIDToId[resourceGUID] = entry.id;
-    mPathToId[resourcePath] = entry.id;
+    mPathToId[pathKey] = entry.id;
 
     if (!entry.alias.empty())
     {
@@ -196,10 +386,20 @@ void ResourceSystem::RegisterResource(const std::shared_ptr<Game_Resource>& res)
     default: break;
     }
 
-    if (resourcePath.find('#') == std::string::npos)
+    // Model containers keep their import settings and sub-resource GUIDs in the .meta written by SaveFbxMeta;
+    // a simple meta would drop them.
+    FileCategory category = DetectFileCategory(resourcePath);
+    if (resourcePath.find('#') == std::string::npos &&
+        category != FileCategory::FBX && category != FileCategory::ComplexModel)
     {
         MetaIO::SaveSimpleMeta(res);
     }
+
+    if (res->Get_Type() == ResourceType::AnimationClip)
+    {
+        if (auto clip = std::dynamic_pointer_cast<AnimationClip>(res))
+            clip->ResolvePendingAdditive();
+    }
 }
 
 void ResourceSystem::Load(const std::string& path, std::string_view alias, LoadResult& result)
@@ -207,9 +407,9 @@ void ResourceSystem::Load(const std::string& path, std::string_view alias, LoadR
     std::string normalized_path = NormalizeFilePath(path);
     FileCategory category = DetectFileCategory(normalized_path);
 
-    if (auto it = mPathToId.find(path); it != mPathToId.end())
+    if (UINT cachedId = GetIdByPath(path); cachedId != Engine::INVALID_ID)
     {
-        if (auto res = GetById<Game_Resource>(it->second))
+        if (auto res = GetById<Game_Resource>(cachedId))
         {
             OutputDebugStringA(("[ResourceSystem] Cached resource hit: " + normalized_path + "\n").c_str());
 
@@ -223,6 +423,16 @@ void ResourceSystem::Load(const std::string& path, std::string_view alias, LoadR
             return;
         }
     }
+
+    // A container and its sub-resources are unloaded as one unit, so a missing sub-resource of a container that
+    // is still registered will not come back by importing the file again; that would only duplicate the rest.
+    if (std::string_view container = GetContainerPath(path); container.size() != path.size() &&
+        GetIdByPath(container) != Engine::INVALID_ID)
+    {
+        OutputDebugStringA(("[ResourceSystem] Sub-resource not found in loaded container: " + path + "\n").c_str());
+        return;
+    }
+
     const RendererContext& ctx = GameEngine::Get().Get_UploadContext();
     auto renderer = GameEngine::Get().GetRenderer();
     bool bManagedByExternal = renderer->IsUploadOpen(); 
@@ -234,10 +444,18 @@ void ResourceSystem::Load(const std::string& path, std::string_view alias, LoadR
     {
     case FileCategory::FBX:
     {
+        auto start = std::chrono::steady_clock::now();
+        if (ModelImportCache::Load(normalized_path, result))
+        {
+            LogImportTime(normalized_path, true, start);
+            return;
+        }
+
         ModelLoader_FBX fbxLoader;
         if (fbxLoader.Load(normalized_path, alias, result))
         {
             OutputDebugStringA(("[FBX SDK] Loaded model: " + normalized_path + "\n").c_str());
+            LogImportTime(normalized_path, false, start);
             return;
         }
 
@@ -245,6 +463,7 @@ void ResourceSystem::Load(const std::string& path, std::string_view alias, LoadR
         if (assimpLoader.Load(normalized_path, alias, result))
         {
             OutputDebugStringA(("[Assimp] Loaded FBX: " + normalized_path + "\n").c_str());
+            LogImportTime(normalized_path, false, start);
             return;
         }
 
@@ -254,10 +473,18 @@ void ResourceSystem::Load(const std::string& path, std::string_view alias, LoadR
 
     case FileCategory::ComplexModel:
     {
+        auto start = std::chrono::steady_clock::now();
+        if (ModelImportCache::Load(normalized_path, result))
+        {
+            LogImportTime(normalized_path, true, start);
+            return;
+        }
+
         ModelLoader_Assimp assimpLoader;
         if (assimpLoader.Load(normalized_path, alias, result))
         {
             OutputDebugStringA(("[Assimp] Loaded model: " + normalized_path + "\n").c_str());
+            LogImportTime(normalized_path, false, start);
             return;
         }
 
@@ -368,6 +595,331 @@ void ResourceSystem::Load(const std::string& path, std::string_view alias, LoadR
 		renderer->EndUpload();
 }
 
+ResourceHandle ResourceSystem::Acquire(UINT id)
+{
+    auto it = mResources.find(id);
+    if (it == mResources.end()) return {};
+
+    it->second.lastUsedFrame = mFrameCounter;
+
+    std::shared_ptr<const UINT> token = it->second.refToken.lock();
+    if (!token)
+    {
+        token = std::make_shared<const UINT>(id);
+        it->second.refToken = token;
+    }
+    return ResourceHandle(token);
+}
+
+bool ResourceSystem::IsInUse(UINT id) const
+{
+    return CollectInUse().count(id) != 0;
+}
+
+bool ResourceSystem::Unload(UINT id)
+{
+    auto it = mResources.find(id);
+    if (it == mResources.end()) return false;
+
+    std::vector<UINT> unit;
+    GetUnit(it->second, unit);
+
+    std::unordered_set<UINT> inUse = CollectInUse();
+    for (UINT member : unit)
+    {
+        if (inUse.count(member))
+        {
+            OutputDebugStringA(("[ResourceSystem] Unload skipped, resource or its unit still in use: " + std::to_string(id) + "\n").c_str());
+            return false;
+        }
+    }
+
+    for (UINT member : unit)
+        Unregister(member);
+    return true;
+}
+
+void ResourceSystem::UnloadUnused()
+{
+    // Resources built in code have no file to come back from, so only reloadable units are dropped.
+    std::unordered_set<UINT> inUse = CollectInUse();
+
+    std::vector<UINT> unused;
+    std::vector<UINT> unit;
+    std::unordered_set<std::string_view> visitedUnits;
+    for (const auto& [id, entry] : mResources)
+    {
+        if (!entry.unitPath.empty() && !visitedUnits.insert(entry.unitPath).second) continue;
+
+        GetUnit(entry, unit);
+        if (CanEvictUnit(unit, inUse))
+            unused.insert(unused.end(), unit.begin(), unit.end());
+    }
+
+    for (UINT id : unused)
+        Unregister(id);
+}
+
+void ResourceSystem::Update()
+{
+    ++mFrameCounter;
+    ReleaseCompleted();
+    CompletePendingUploads();
+
+    // Usage is kept current as resources register, finish uploading and unregister, so a frame within
+    // budget ends here without walking the resources.
+    std::array<bool, ResourceTypeCount> overBudget{};
+    bool anyOverBudget = false;
+    for (size_t category = 0; category < ResourceTypeCount; ++category)
+    {
+        overBudget[category] = IsOverBudget(category);
+        anyOverBudget = anyOverBudget || overBudget[category];
+    }
+    if (!anyOverBudget) return;
+
+    std::unordered_set<UINT> inUse = CollectInUse();
+    for (UINT id : inUse)
+    {
+        if (auto it = mResources.find(id); it != mResources.end())
+            it->second.lastUsedFrame = mFrameCounter;
+    }
+
+    // Candidates are whole units holding a resource of an over-budget category; a unit was last used when
+    // any of its resources was.
+    struct Candidate
+    {
+        std::vector<UINT> ids;
+        UINT64 lastUsedFrame = 0;
+    };
+    std::vector<Candidate> candidates;
+    std::unordered_set<std::string_view> visitedUnits;
+
+    for (const auto& [id, entry] : mResources)
+    {
+        if (!overBudget[static_cast<size_t>(entry.resource->Get_Type())] || !entry.reloadable || inUse.count(id))
+            continue;
+        if (!entry.unitPath.empty() && !visitedUnits.insert(entry.unitPath).second)
+            continue;
+
+        Candidate candidate;
+        GetUnit(entry, candidate.ids);
+        if (!CanEvictUnit(candidate.ids, inUse))
+            continue;
+
+        for (UINT member : candidate.ids)
+            candidate.lastUsedFrame = std::max(candidate.lastUsedFrame, mResources.at(member).lastUsedFrame);
+        candidates.push_back(std::move(candidate));
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.lastUsedFrame < b.lastUsedFrame; });
+
+    for (const Candidate& candidate : candidates)
+    {
+        // Earlier evictions may already have brought every category this unit would relieve under budget.
+        bool relieves = false;
+        for (UINT member : candidate.ids)
+            relieves = relieves || IsOverBudget(static_cast<size_t>(mResources.at(member).resource->Get_Type()));
+        if (!relieves) continue;
+
+        for (UINT member : candidate.ids)
+            Unregister(member);
+    }
+}
+
+bool ResourceSystem::IsOverBudget(size_t category) const
+{
+    const ResourceBudget& budget = mBudgets[category];
+    const MemoryFootprint& usage = mCategoryUsage[category];
+    return (budget.cpuBytes && usage.cpuBytes > budget.cpuBytes) ||
+        (budget.gpuBytes && usage.gpuBytes > budget.gpuBytes);
+}
+
+void ResourceSystem::SetFootprint(ResourceEntry& entry, const MemoryFootprint& footprint)
+{
+    MemoryFootprint& usage = mCategoryUsage[static_cast<size_t>(entry.resource->Get_Type())];
+    usage.cpuBytes -= std::min(usage.cpuBytes, entry.footprint.cpuBytes);
+    usage.gpuBytes -= std::min(usage.gpuBytes, entry.footprint.gpuBytes);
+    usage.stagingBytes -= std::min(usage.stagingBytes, entry.footprint.stagingBytes);
+    usage += footprint;
+    entry.footprint = footprint;
+}
+
+void ResourceSystem::GetUnit(const ResourceEntry& entry, std::vector<UINT>& out) const
+{
+    out.clear();
+    auto it = entry.unitPath.empty() ? mUnits.end() : mUnits.find(entry.unitPath);
+    if (it != mUnits.end())
+        out = it->second;
+    else
+        out.push_back(entry.id);
+}
+
+bool ResourceSystem::CanEvictUnit(const std::vector<UINT>& unit, const std::unordered_set<UINT>& inUse) const
+{
+    for (UINT member : unit)
+    {
+        auto it = mResources.find(member);
+        if (it == mResources.end() || !it->second.reloadable || inUse.count(member))
+            return false;
+    }
+    return true;
+}
+
+MemoryFootprint ResourceSystem::GetTotalUsage() const
+{
+    MemoryFootprint total;
+    for (const MemoryFootprint& usage : mCategoryUsage)
+        total += usage;
+    return total;
+}
+
+std::vector<const ResourceEntry*> ResourceSystem::GetTopMemoryConsumers(size_t count) const
+{
+    std::vector<const ResourceEntry*> entries;
+    entries.reserve(mResources.size());
+    for (const auto& [id, entry] : mResources)
+        entries.push_back(&entry);
+
+    auto larger = [](const ResourceEntry* a, const ResourceEntry* b) { return a->footprint.GetTotal() > b->footprint.GetTotal(); };
+    count = std::min(count, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(), larger);
+    entries.resize(count);
+    return entries;
+}
+
+std::unordered_set<UINT> ResourceSystem::CollectInUse() const
+{
+    std::vector<UINT> pending;
+    for (const auto& [id, entry] : mResources)
+    {
+        if (!entry.refToken.expired() || entry.resource.use_count() > GetOwnedReferenceCount(entry))
+            pending.push_back(id);
+    }
+
+    std::unordered_set<UINT> inUse;
+    std::vector<UINT> dependencies;
+    while (!pending.empty())
+    {
+        UINT id = pending.back();
+        pending.pop_back();
+        if (!inUse.insert(id).second) continue;
+
+        auto it = mResources.find(id);
+        if (it == mResources.end()) continue;
+
+        dependencies.clear();
+        it->second.resource->GetDependencies(dependencies);
+        for (UINT dependency : dependencies)
+        {
+            if (!inUse.count(dependency))
+                pending.push_back(dependency);
+        }
+    }
+    return inUse;
+}
+
+long ResourceSystem::GetOwnedReferenceCount(const ResourceEntry& entry) const
+{
+    // The entry itself, the typed list, and the skinned list for skinned meshes.
+    long count = 1;
+    if (entry.resource->Get_Type() != ResourceType::etc)
+        ++count;
+    if (std::dynamic_pointer_cast<SkinnedMesh>(entry.resource))
+        ++count;
+    return count;
+}
+
+void ResourceSystem::Unregister(UINT id)
+{
+    auto it = mResources.find(id);
+    if (it == mResources.end()) return;
+
+    std::shared_ptr<Game_Resource> res = it->second.resource;
+
+    auto eraseIndex = [id](auto& index, const auto& key)
+        {
+            auto found = index.find(key);
+            if (found != index.end() && found->second == id)
+                index.erase(found);
+        };
+    const std::string path = res->GetPath();
+    std::string scratch;
+    eraseIndex(mGUIDToId, res->GetGUID());
+    eraseIndex(mPathToId, ToPathKey(path, scratch));
+    eraseIndex(mAliasToId, res->GetAlias());
+
+    SetFootprint(it->second, {});
+    if (auto unit = mUnits.find(it->second.unitPath); unit != mUnits.end())
+    {
+        std::erase(unit->second, id);
+        if (unit->second.empty())
+            mUnits.erase(unit);
+    }
+
+    auto eraseFrom = [&res](auto& list)
+        {
+            std::erase_if(list, [&res](const auto& item) { return item.get() == res.get(); });
+        };
+    switch (res->Get_Type())
+    {
+    case ResourceType::Mesh:          eraseFrom(mMeshes); eraseFrom(mSkinnedMeshes); break;
+    case ResourceType::Material:      eraseFrom(mMaterials); break;
+    case ResourceType::Texture:       eraseFrom(mTextures); break;
+    case ResourceType::Model:         eraseFrom(mModels); break;
+    case ResourceType::Skeleton:      eraseFrom(mSkeletons); break;
+    case ResourceType::ModelAvatar:   eraseFrom(mAvatars); break;
+    case ResourceType::AnimationClip: eraseFrom(mAnimationClips); break;
+    case ResourceType::AvatarMask:    eraseFrom(mAvatarMasks); break;
+    case ResourceType::TerrainData:   eraseFrom(mTerrains); break;
+    default: break;
+    }
+
+    mResources.erase(it);
+    res->SetId(Engine::INVALID_ID);
+
+    // Frames already submitted may still read its buffers, so it lives until the GPU passes them.
+    UINT64 fenceValue = GameEngine::Get().GetRenderer()->GetSubmittedFenceValue();
+    mPendingReleases.push_back({ fenceValue, std::move(res) });
+
+    OutputDebugStringA(("[ResourceSystem] Unloaded resource: " + std::to_string(id) + "\n").c_str());
+}
+
+void ResourceSystem::ReleaseCompleted()
+{
+    if (mPendingReleases.empty()) return;
+
+    DX12_Renderer* renderer = GameEngine::Get().GetRenderer();
+    const UINT64 completed = renderer->GetCompletedFenceValue();
+    RendererContext ctx = renderer->Get_RenderContext();
+
+    std::erase_if(mPendingReleases, [&](PendingRelease& pending)
+        {
+            if (pending.fenceValue > completed) return false;
+            pending.resource->OnUnload(ctx);
+            return true;
+        });
+}
+
+void ResourceSystem::CompletePendingUploads()
+{
+    if (mPendingUploads.empty()) return;
+
+    DX12_Renderer* renderer = GameEngine::Get().GetRenderer();
+    if (renderer->IsUploadOpen() || renderer->GetCompletedFenceValue() < renderer->GetUploadFenceValue())
+        return;
+
+    // Staging buffers and CPU copies are gone now, so the footprint is sampled again.
+    for (const auto& pending : mPendingUploads)
+    {
+        auto res = pending.lock();
+        if (!res) continue;
+
+        res->OnUploadComplete();
+        if (auto it = mResources.find(res->GetId()); it != mResources.end())
+            SetFootprint(it->second, res->GetMemoryFootprint());
+    }
+    mPendingUploads.clear();
+}
 
 void ResourceSystem::PrintSummary() const
 {
@@ -381,7 +933,7 @@ void ResourceSystem::PrintSummary() const
     for (auto& [id, entry] : mResources)
     {
         std::cout << "  [" << id << "] " << entry.metaData->path
-            << " | GUID: " << entry.metaData->guid
+            << " | GUID: " << entry.metaData->guid.ToString()
             << " | Alias: " << entry.alias << "\n";
     }
 }
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include "AvatarMask.h"
 #include "MetaIO.h"
 #include "TerrainResource.h"
+#include "ResourceHandle.h"
+#include "AssetPack.h"
 
 struct LoadResult
 {
@@ -32,7 +34,7 @@ inline std::string MakeSubresourcePath(const std::string& containerPath, const c
 
 struct ResourceMetaEntry
 {
-    std::string guid;
+    Guid guid;
     std::string path;
 };
 
@@ -42,6 +44,20 @@ struct ResourceEntry
     std::string alias; 
     const ResourceMetaEntry* metaData = nullptr;
     std::shared_ptr<Game_Resource> resource;
+
+    std::weak_ptr<const UINT> refToken; // shared by every ResourceHandle to this entry
+    UINT64 lastUsedFrame = 0; // last Acquire, or last eviction pass that found it in use
+    MemoryFootprint footprint; // sampled at registration and when its upload completes
+
+    std::string_view unitPath; // interned container file; resources sharing it unload and reload together
+    bool reloadable = false;   // the container file existed at registration
+};
+
+// Residency limit for one resource category; zero means unlimited.
+struct ResourceBudget
+{
+    UINT64 cpuBytes = 0;
+    UINT64 gpuBytes = 0;
 };
 
 class ResourceSystem
@@ -54,12 +70,15 @@ public:
 
 
     template<typename T> std::shared_ptr<T> GetById(UINT id) const;
-    template<typename T> std::shared_ptr<T> GetByGUID(const std::string& guid) const;
-    template<typename T> std::shared_ptr<T> GetByPath(const std::string& path) const;
-    template<typename T> std::shared_ptr<T> GetByAlias(const std::string& alias) const;
+    template<typename T> std::shared_ptr<T> GetByGUID(const Guid& guid) const;
+    template<typename T> std::shared_ptr<T> GetByPath(std::string_view path) const;
+    template<typename T> std::shared_ptr<T> GetByAlias(std::string_view alias) const;
     template<typename T> std::vector<std::shared_ptr<T>> GetAllResources();
     template<typename T> std::shared_ptr<T> LoadOrReuse(const std::string& path, const std::string& alias, const RendererContext& ctx, std::function<std::shared_ptr<T>()> createCallback);
-    template<typename T> std::shared_ptr<T> GetOrLoad(const std::string& guid, const std::string& path);
+    template<typename T> std::shared_ptr<T> GetOrLoad(const Guid& guid, std::string_view path);
+
+    // Path lookups accept either slash; only a path with backslashes is copied to be normalized.
+    UINT GetIdByPath(std::string_view path) const;
 
     const std::vector<std::shared_ptr<Mesh>>& GetMeshes() const { return mMeshes; }
     const std::vector<std::shared_ptr<SkinnedMesh>>& GetSkinnedMeshes() const { return mSkinnedMeshes; }
@@ -73,10 +92,38 @@ public:
     const std::vector<std::shared_ptr<TerrainResource>>& GetTerrains() const { return mTerrains; }
     const std::unordered_map<UINT, ResourceEntry>& GetResourceMap() const { return mResources; }
 
+    // Lifetime
+    // A resource is in use while a handle to it is alive, something outside the system holds a shared_ptr to it,
+    // or an in-use resource depends on it by id. Only resources that are not in use are unloaded.
+    ResourceHandle Acquire(UINT id);
+    bool IsInUse(UINT id) const;
+    bool Unload(UINT id);
+    void UnloadUnused();
+
+    // Once per frame after submission: releases evicted resources whose last frame has completed on the GPU and,
+    // only while a category is over budget, evicts the least recently used units with a resource in it.
+    void Update();
+
+    void SetBudget(ResourceType type, const ResourceBudget& budget) { mBudgets[static_cast<size_t>(type)] = budget; }
+    const ResourceBudget& GetBudget(ResourceType type) const { return mBudgets[static_cast<size_t>(type)]; }
+    const MemoryFootprint& GetCategoryUsage(ResourceType type) const { return mCategoryUsage[static_cast<size_t>(type)]; }
+    MemoryFootprint GetTotalUsage() const;
+    // Registered resources with the largest sampled footprint, largest first.
+    std::vector<const ResourceEntry*> GetTopMemoryConsumers(size_t count) const;
+
     // Meta
-    std::string GetOrCreateGUID(const std::string& path);
+    Guid GetOrCreateGUID(const std::string& path);
     void LoadAllMeta(const std::string& assetRoot);
 
+    // Packs
+    // Every .pak in the asset root is mounted at Initialize. A file inside a mounted pack is read from the pack
+    // without touching the disk; later mounts shadow earlier ones, and anything not packed is read loose.
+    bool MountPack(const std::string& packPath);
+    const AssetPack* FindPack(const std::string& path) const;
+    bool FileExists(const std::string& path) const;
+    bool ReadFile(const std::string& path, std::vector<uint8_t>& out) const;
+    bool ReadTextFile(const std::string& path, std::string& out) const;
+
     // Util
     UINT GetNextIdPreview() const { return mNextResourceID; }
     void PrintSummary() const;
@@ -87,9 +134,9 @@ private:
     std::unordered_map<UINT, ResourceEntry> mResources; // id ߽ 
 
     //  Lookup  ε
-    std::unordered_map<std::string, UINT> mGUIDToId;
-    std::unordered_map<std::string, UINT> mPathToId;
-    std::unordered_map<std::string, UINT> mAliasToId;
+    std::unordered_map<Guid, UINT> mGUIDToId;
+    std::unordered_map<std::string_view, UINT, StringHash, std::equal_to<>> mPathToId; // keys live in mPathPool
+    std::unordered_map<std::string, UINT, StringHash, std::equal_to<>> mAliasToId;
 
     // ŸԺ ĳ (, ˻ )
     std::vector<std::shared_ptr<Mesh>>     mMeshes;
@@ -105,10 +152,46 @@ private:
 
     // GUID ĳ (meta scan)
     std::deque<ResourceMetaEntry> mAllMetaData;
-    std::unordered_map<std::string, ResourceMetaEntry*> mGuidToMeta;
-    std::unordered_map<std::string, ResourceMetaEntry*> mPathToMeta;
+    std::unordered_map<Guid, ResourceMetaEntry*> mGuidToMeta;
+    std::unordered_map<std::string_view, ResourceMetaEntry*, StringHash, std::equal_to<>> mPathToMeta; // keys live in mPathPool
+
+    // Every registered path, normalized to forward slashes once. Entries are never removed, so views stay valid.
+    std::unordered_set<std::string, StringHash, std::equal_to<>> mPathPool;
+    std::string_view InternPath(std::string_view path);
+    static std::string_view ToPathKey(std::string_view path, std::string& scratch);
+
+    std::vector<std::unique_ptr<AssetPack>> mPacks;
 
     UINT mNextResourceID = 1;
+
+    // Lifetime
+    struct PendingRelease
+    {
+        UINT64 fenceValue;
+        std::shared_ptr<Game_Resource> resource;
+    };
+
+    static constexpr size_t ResourceTypeCount = static_cast<size_t>(ResourceType::etc) + 1;
+
+    std::unordered_set<UINT> CollectInUse() const;
+    long GetOwnedReferenceCount(const ResourceEntry& entry) const;
+    bool IsOverBudget(size_t category) const;
+    void SetFootprint(ResourceEntry& entry, const MemoryFootprint& footprint);
+    void GetUnit(const ResourceEntry& entry, std::vector<UINT>& out) const;
+    bool CanEvictUnit(const std::vector<UINT>& unit, const std::unordered_set<UINT>& inUse) const;
+    void Unregister(UINT id);
+    void ReleaseCompleted();
+    void CompletePendingUploads();
+
+    std::vector<PendingRelease> mPendingReleases;
+    std::vector<std::weak_ptr<Game_Resource>> mPendingUploads; // registered since the last upload was known complete
+    std::array<ResourceBudget, ResourceTypeCount> mBudgets{};
+    std::array<MemoryFootprint, ResourceTypeCount> mCategoryUsage{}; // kept current by SetFootprint
+    UINT64 mFrameCounter = 0;
+
+    // A model and the meshes imported with it only come back by importing the file again, so everything
+    // registered under one container path is unloaded as one unit. Pathless resources are units of their own.
+    std::unordered_map<std::string_view, std::vector<UINT>> mUnits; // keys live in mPathPool
 };
 
 template<typename T>
@@ -120,7 +203,7 @@ std::shared_ptr<T> ResourceSystem::GetById(UINT id) const
 }
 
 template<typename T>
-std::shared_ptr<T> ResourceSystem::GetByGUID(const std::string& guid) const
+std::shared_ptr<T> ResourceSystem::GetByGUID(const Guid& guid) const
 {
     if (auto it = mGUIDToId.find(guid); it != mGUIDToId.end())
         return GetById<T>(it->second);
@@ -128,15 +211,13 @@ std::shared_ptr<T> ResourceSystem::GetByGUID(const std::string& guid) const
 }
 
 template<typename T>
-std::shared_ptr<T> ResourceSystem::GetByPath(const std::string& path) const
+std::shared_ptr<T> ResourceSystem::GetByPath(std::string_view path) const
 {
-    if (auto it = mPathToId.find(path); it != mPathToId.end())
-        return GetById<T>(it->second);
-    return nullptr;
+    return GetById<T>(GetIdByPath(path));
 }
 
 template<typename T>
-std::shared_ptr<T> ResourceSystem::GetByAlias(const std::string& alias) const
+std::shared_ptr<T> ResourceSystem::GetByAlias(std::string_view alias) const
 {
     if (auto it = mAliasToId.find(alias); it != mAliasToId.end())
         return GetById<T>(it->second);
@@ -226,7 +307,7 @@ std::shared_ptr<T> ResourceSystem::LoadOrReuse(
     std::shared_ptr<T> resource;
     bool isNew = false;
 
-    if (std::filesystem::exists(path))
+    if (FileExists(path))
     {
         resource = std::make_shared<T>();
         if (!resource->LoadFromFile(path, ctx))
@@ -273,17 +354,17 @@ std::shared_ptr<T> ResourceSystem::LoadOrReuse(
 }
 
 template<typename T>
-std::shared_ptr<T> ResourceSystem::GetOrLoad(const std::string& guid, const std::string& path)
+std::shared_ptr<T> ResourceSystem::GetOrLoad(const Guid& guid, std::string_view path)
 {
-    if (!guid.empty())
+    if (guid.IsValid())
     {
         if (auto res = GetByGUID<T>(guid))
             return res;
     }
 
-    std::string loadPath = path;
+    std::string_view loadPath = path;
 
-    if (loadPath.empty() && !guid.empty())
+    if (loadPath.empty() && guid.IsValid())
     {
         if (auto it = mGuidToMeta.find(guid); it != mGuidToMeta.end())
         {
@@ -296,11 +377,13 @@ std::shared_ptr<T> ResourceSystem::GetOrLoad(const std::string& guid, const std:
         if (auto res = GetByPath<T>(loadPath))
             return res;
 
-        if (std::filesystem::exists(loadPath))
+        // Only a miss pays for an owned copy of the path.
+        const std::string pathCopy(loadPath);
+        if (FileExists(pathCopy))
         {
             LoadResult result;
-            std::string file_name = ExtractFileName(loadPath);
-            Load(loadPath, file_name, result);
+            std::string file_name = ExtractFileName(pathCopy);
+            Load(pathCopy, file_name, result);
 
             UINT targetId = Engine::INVALID_ID;
 
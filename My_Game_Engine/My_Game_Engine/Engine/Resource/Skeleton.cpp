@@ -1,4 +1,6 @@
 #include "Skeleton.h"
+#include "BinaryIO.h"
+#include "GameEngine.h"
 
 Skeleton::Skeleton()
     : Game_Resource(ResourceType::Skeleton)
@@ -45,6 +47,17 @@ int Skeleton::GetBoneIndex(const std::string& name) const
     return -1;
 }
 
+MemoryFootprint Skeleton::GetMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.cpuBytes = static_cast<UINT64>(mBones.capacity()) * sizeof(BoneInfo) +
+        static_cast<UINT64>(mNames.capacity()) * sizeof(std::string) +
+        static_cast<UINT64>(mNameToIndex.size()) * (sizeof(std::string) + sizeof(int));
+    for (const std::string& name : mNames)
+        footprint.cpuBytes += name.capacity() * 2; // the name and its lookup key
+    return footprint;
+}
+
 int Skeleton::GetRootBoneIndex() const
 {
     if (mCachedRootIndex != -1)
@@ -72,11 +85,8 @@ void Skeleton::BuildNameToIndex()
 
 bool Skeleton::LoadFromFile(std::string path, const RendererContext& ctx)
 {
-    std::ifstream ifs(path);
-    if (!ifs.is_open()) return false;
-
-    std::string json((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-    ifs.close();
+    std::string json;
+    if (!GameEngine::Get().GetResourceSystem()->ReadTextFile(path, json)) return false;
 
     Document doc;
     if (doc.Parse(json.c_str()).HasParseError()) return false;
@@ -261,4 +271,34 @@ void Skeleton::SortBoneList()
     }
 
     BuildNameToIndex();
-}
\ No newline at end of file
+}
+
+void Skeleton::WriteBinary(std::ostream& os) const
+{
+    BinaryIO::Write(os, static_cast<UINT>(mBones.size()));
+    for (size_t i = 0; i < mBones.size(); ++i)
+    {
+        BinaryIO::WriteString(os, mNames[i]);
+        BinaryIO::Write(os, mBones[i]);
+    }
+}
+
+bool Skeleton::ReadBinary(BinaryReader& reader)
+{
+    // Each bone needs at least its name length and its BoneInfo.
+    UINT boneCount = 0;
+    if (!reader.Read(boneCount) || !reader.CanRead(boneCount, sizeof(uint32_t) + sizeof(BoneInfo)))
+        return false;
+
+    mNames.resize(boneCount);
+    mBones.resize(boneCount);
+    for (UINT i = 0; i < boneCount; ++i)
+    {
+        if (!reader.ReadString(mNames[i]) || !reader.Read(mBones[i]))
+            return false;
+    }
+
+    mCachedRootIndex = -1;
+    BuildNameToIndex();
+    return true;
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include "Game_Resource.h"
 
+class BinaryReader;
+
 
 struct BoneInfo
 {
@@ -27,9 +29,14 @@ public:
 
     virtual bool LoadFromFile(std::string path, const RendererContext& ctx) override;
     virtual bool SaveToFile(const std::string& path) const;
+    virtual MemoryFootprint GetMemoryFootprint() const override;
 
     void SortBoneList();
 
+    // Compact form embedded in cooked import caches; the bone order is kept as written.
+    void WriteBinary(std::ostream& os) const;
+    bool ReadBinary(BinaryReader& reader);
+
     const std::vector<BoneInfo>& GetBones() const;
     const BoneInfo& GetBone(int index) const;
     const BoneInfo& GetBone(const std::string& name) const;
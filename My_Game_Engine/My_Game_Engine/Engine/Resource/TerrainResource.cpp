@@ -17,6 +17,15 @@ bool TerrainResource::SaveToFile(const std::string& path) const
     return false;
 }
 
+MemoryFootprint TerrainResource::GetMemoryFootprint() const
+{
+    // The raw file and normalized buffers only live during LoadFromFile; the height map texture is its own resource.
+    MemoryFootprint footprint;
+    if (mHeightField)
+        footprint.cpuBytes = sizeof(TerrainHeightField) + mHeightField->GetMemorySize();
+    return footprint;
+}
+
 bool TerrainResource::LoadFromFile(std::string rawPath, const RendererContext& ctx)
 {
     std::ifstream file(rawPath, std::ios::binary | std::ios::ate);
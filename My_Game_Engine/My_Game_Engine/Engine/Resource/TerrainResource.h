@@ -10,8 +10,13 @@ public:
 
     virtual bool LoadFromFile(std::string path, const RendererContext& ctx) override;
     virtual bool SaveToFile(const std::string& path) const;
+    virtual MemoryFootprint GetMemoryFootprint() const override;
 
     UINT GetHeightMapTextureResourceID() const { return mHeightMapTextureResourceID; }
+    virtual void GetDependencies(std::vector<UINT>& outIds) const override
+    {
+        if (mHeightMapTextureResourceID != Engine::INVALID_ID) outIds.push_back(mHeightMapTextureResourceID);
+    }
     const TerrainHeightField* GetHeightField() const { return mHeightField.get(); }
 
 private:
@@ -2,6 +2,7 @@
 #include "Texture.h"
 #include "DX_Graphics/Renderer.h"
 #include "DX_Graphics/ResourceUtils.h"
+#include "GameEngine.h"
 
 static std::wstring ToWString(std::string_view str)
 {
@@ -21,12 +22,28 @@ Texture::Texture() : Game_Resource(ResourceType::Texture)
 
 bool Texture::LoadFromFile(std::string path, const RendererContext& ctx)
 {
-    std::wstring wpath = ToWString(path);
+    ResourceSystem* rs = GameEngine::Get().GetResourceSystem();
+    const bool isDDS = path.ends_with(".dds");
 
-    if (wpath.ends_with(L".dds"))
-        mTexture = ResourceUtils::LoadDDSTexture(ctx, wpath, mUploadBuffer);
+    if (rs->FindPack(path))
+    {
+        std::vector<uint8_t> data;
+        if (!rs->ReadFile(path, data)) return false;
+
+        if (isDDS)
+            mTexture = ResourceUtils::LoadDDSTextureFromMemory(ctx, data.data(), data.size(), mUploadBuffer);
+        else
+            mTexture = ResourceUtils::LoadWICTextureFromMemory(ctx, data.data(), data.size(), mUploadBuffer);
+    }
     else
-        mTexture = ResourceUtils::LoadWICTexture(ctx, wpath, mUploadBuffer);
+    {
+        std::wstring wpath = ToWString(path);
+
+        if (isDDS)
+            mTexture = ResourceUtils::LoadDDSTexture(ctx, wpath, mUploadBuffer);
+        else
+            mTexture = ResourceUtils::LoadWICTexture(ctx, wpath, mUploadBuffer);
+    }
 
     if (!mTexture) return false;
 
@@ -73,4 +90,26 @@ void Texture::SetResource(ComPtr<ID3D12Resource> new_resource, const RendererCon
 
     mGpuHandle = ctx.resourceHeap->GetGpuHandle(mSlot);
 
-}
\ No newline at end of file
+}
+
+MemoryFootprint Texture::GetMemoryFootprint() const
+{
+	MemoryFootprint footprint;
+	if (mTexture)
+	{
+		ComPtr<ID3D12Device> device;
+		D3D12_RESOURCE_DESC desc = mTexture->GetDesc();
+		if (SUCCEEDED(mTexture->GetDevice(IID_PPV_ARGS(&device))))
+			footprint.gpuBytes = device->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+	}
+	if (mUploadBuffer)
+		footprint.stagingBytes = mUploadBuffer->GetDesc().Width;
+	return footprint;
+}
+
+void Texture::OnUnload(const RendererContext& ctx)
+{
+	if (mSlot != UINT(-1))
+		ctx.resourceHeap->FreeDeferred(HeapRegion::SRV_Static, mSlot);
+	mSlot = UINT(-1);
+}
@@ -9,6 +9,10 @@ public:
 	virtual bool LoadFromFile(std::string path, const RendererContext& ctx);
 	virtual bool SaveToFile(const std::string& outputPath) const { return false; }
 
+	virtual MemoryFootprint GetMemoryFootprint() const override;
+	virtual void OnUnload(const RendererContext& ctx) override;
+	virtual void OnUploadComplete() override { mUploadBuffer.Reset(); }
+
 	void SetResource(ComPtr<ID3D12Resource> new_resource, const RendererContext& ctx, ComPtr<ID3D12Resource> uploadBuffer);
 	ID3D12Resource* GetResource() const { return mTexture.Get(); }
 
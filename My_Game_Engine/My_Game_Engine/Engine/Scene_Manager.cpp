@@ -1,5 +1,6 @@
 #include "Scene_Manager.h"
 #include "SceneArchive.h"
+#include "GameEngine.h"
 
 void SceneManager::SetActiveScene(const std::shared_ptr<Scene>& scene) 
 {
@@ -16,6 +17,7 @@ std::shared_ptr<Scene> SceneManager::GetActiveScene() const
 void SceneManager::UnloadScene(UINT id)
 {
     map_Scenes.erase(id);
+    GameEngine::Get().GetResourceSystem()->UnloadUnused();
 }
 
 
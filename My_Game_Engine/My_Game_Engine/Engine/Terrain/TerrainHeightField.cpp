@@ -55,4 +55,98 @@ float TerrainHeightField::GetHeight(float u, float v) const
     float bot = Math::Lerp(h01, h11, dx);
 
     return Math::Lerp(top, bot, dz);
-}
\ No newline at end of file
+}
+
+XMFLOAT3 TerrainHeightField::GetNormal(float u, float v, float width, float depth, float maxHeight) const
+{
+    if (mWidthCount < 2 || mHeightCount < 2)
+        return XMFLOAT3(0.0f, 1.0f, 0.0f);
+
+    float du = 1.0f / (mWidthCount - 1);
+    float dv = 1.0f / (mHeightCount - 1);
+
+    float u0 = std::max(u - du, 0.0f);
+    float u1 = std::min(u + du, 1.0f);
+    float v0 = std::max(v - dv, 0.0f);
+    float v1 = std::min(v + dv, 1.0f);
+
+    float dHdx = (GetHeight(u1, v) - GetHeight(u0, v)) * maxHeight / ((u1 - u0) * width);
+    float dHdz = (GetHeight(u, v1) - GetHeight(u, v0)) * maxHeight / ((v1 - v0) * depth);
+
+    XMFLOAT3 n;
+    XMStoreFloat3(&n, XMVector3Normalize(XMVectorSet(-dHdx, 1.0f, -dHdz, 0.0f)));
+    return n;
+}
+
+XMVECTOR TerrainHeightField::GetHeight4(FXMVECTOR u, FXMVECTOR v) const
+{
+    if (mWidthCount < 2 || mHeightCount < 2)
+        return XMVectorZero();
+
+    XMVECTOR gridX = XMVectorScale(u, (float)(mWidthCount - 1));
+    XMVECTOR gridZ = XMVectorScale(v, (float)(mHeightCount - 1));
+
+    XMVECTOR cellX = XMVectorClamp(XMVectorFloor(gridX), XMVectorZero(), XMVectorReplicate((float)(mWidthCount - 2)));
+    XMVECTOR cellZ = XMVectorClamp(XMVectorFloor(gridZ), XMVectorZero(), XMVectorReplicate((float)(mHeightCount - 2)));
+
+    XMFLOAT4 fx, fz;
+    XMStoreFloat4(&fx, cellX);
+    XMStoreFloat4(&fz, cellZ);
+
+    const float xs[4] = { fx.x, fx.y, fx.z, fx.w };
+    const float zs[4] = { fz.x, fz.y, fz.z, fz.w };
+
+    float h00[4], h10[4], h01[4], h11[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        UINT x = (UINT)xs[i];
+        UINT z = (UINT)zs[i];
+        const float* row0 = &mHeightData[z * mWidthCount + x];
+        const float* row1 = row0 + mWidthCount;
+
+        h00[i] = row0[0];
+        h10[i] = row0[1];
+        h01[i] = row1[0];
+        h11[i] = row1[1];
+    }
+
+    XMVECTOR dx = XMVectorSubtract(gridX, cellX);
+    XMVECTOR dz = XMVectorSubtract(gridZ, cellZ);
+
+    XMVECTOR top = XMVectorLerpV(XMLoadFloat4((const XMFLOAT4*)h00), XMLoadFloat4((const XMFLOAT4*)h10), dx);
+    XMVECTOR bot = XMVectorLerpV(XMLoadFloat4((const XMFLOAT4*)h01), XMLoadFloat4((const XMFLOAT4*)h11), dx);
+
+    return XMVectorLerpV(top, bot, dz);
+}
+
+void TerrainHeightField::GetNormal4(FXMVECTOR u, FXMVECTOR v, float width, float depth, float maxHeight, XMVECTOR& outX, XMVECTOR& outY, XMVECTOR& outZ) const
+{
+    if (mWidthCount < 2 || mHeightCount < 2)
+    {
+        outX = XMVectorZero();
+        outY = XMVectorReplicate(1.0f);
+        outZ = XMVectorZero();
+        return;
+    }
+
+    XMVECTOR du = XMVectorReplicate(1.0f / (mWidthCount - 1));
+    XMVECTOR dv = XMVectorReplicate(1.0f / (mHeightCount - 1));
+
+    XMVECTOR u0 = XMVectorMax(XMVectorSubtract(u, du), XMVectorZero());
+    XMVECTOR u1 = XMVectorMin(XMVectorAdd(u, du), XMVectorReplicate(1.0f));
+    XMVECTOR v0 = XMVectorMax(XMVectorSubtract(v, dv), XMVectorZero());
+    XMVECTOR v1 = XMVectorMin(XMVectorAdd(v, dv), XMVectorReplicate(1.0f));
+
+    XMVECTOR dHdx = XMVectorDivide(
+        XMVectorScale(XMVectorSubtract(GetHeight4(u1, v), GetHeight4(u0, v)), maxHeight),
+        XMVectorScale(XMVectorSubtract(u1, u0), width));
+    XMVECTOR dHdz = XMVectorDivide(
+        XMVectorScale(XMVectorSubtract(GetHeight4(u, v1), GetHeight4(u, v0)), maxHeight),
+        XMVectorScale(XMVectorSubtract(v1, v0), depth));
+
+    XMVECTOR invLen = XMVectorReciprocalSqrt(XMVectorAdd(XMVectorAdd(XMVectorMultiply(dHdx, dHdx), XMVectorMultiply(dHdz, dHdz)), XMVectorReplicate(1.0f)));
+
+    outX = XMVectorNegate(XMVectorMultiply(dHdx, invLen));
+    outY = invLen;
+    outZ = XMVectorNegate(XMVectorMultiply(dHdz, invLen));
+}
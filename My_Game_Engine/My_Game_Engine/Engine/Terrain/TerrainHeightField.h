@@ -9,9 +9,15 @@ public:
     void BuildFromRawData(const std::vector<uint16_t>& rawData, UINT resolution);
 
     float GetHeight(float localX, float localZ) const;
+    XMFLOAT3 GetNormal(float u, float v, float width, float depth, float maxHeight) const;
+
+    // Four samples per call, one per lane. u/v must already be clamped to [0, 1].
+    XMVECTOR GetHeight4(FXMVECTOR u, FXMVECTOR v) const;
+    void GetNormal4(FXMVECTOR u, FXMVECTOR v, float width, float depth, float maxHeight, XMVECTOR& outX, XMVECTOR& outY, XMVECTOR& outZ) const;
 
     UINT GetWidthCount() const { return mWidthCount; }
     UINT GetHeightCount() const { return mHeightCount; }
+    size_t GetMemorySize() const { return mHeightData.capacity() * sizeof(float); }
 
 private:
     std::vector<float> mHeightData;
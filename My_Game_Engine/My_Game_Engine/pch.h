@@ -32,6 +32,7 @@
 #include <optional>
 #include <functional>
 #include <thread>
+#include <chrono>
 #include <mutex>
 #include <bitset>
 #include <sstream>
@@ -0,0 +1,384 @@
+#include "Components/AnimationControllerComponent.h"
+#include "Resource/AnimationPoseCache.h"
+#include "Resource/BinaryIO.h"
+#include "DXMathUtils.h"
+#include "JobSystem.h"
+
+// Times the CPU side of character animation on generated skeletons and clips: key sampling, pose evaluation,
+// controller scaling across the job system and pose sharing. Needs no window, device or assets.
+// Build it in Release; Debug numbers mostly measure the iterator checks.
+//   AnimationBench [frames]
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr float FrameTime = 1.0f / 60.0f;
+    constexpr float KeyRate = 30.0f;
+    constexpr size_t AnimationUpdateGrain = 8; // same grain as Scene::Update_Scene
+
+    // Sums sampled values so the optimizer cannot drop the loops being timed.
+    volatile float gSink = 0.0f;
+
+    double SecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // ---------------------------------------------------------------- Key sampling
+
+    template<typename T, typename Interp>
+    T SampleLowerBound(const KeyChannel<T>& channel, float time, const T& fallback, Interp interp)
+    {
+        if (channel.empty()) return fallback;
+        if (time <= channel.times.front()) return channel.values.front();
+        if (time >= channel.times.back()) return channel.values.back();
+
+        auto it = std::lower_bound(channel.times.begin(), channel.times.end(), time);
+        size_t i = static_cast<size_t>(it - channel.times.begin());
+        if (channel.times[i] > time) --i;
+
+        const float t = (time - channel.times[i]) / (channel.times[i + 1] - channel.times[i]);
+        return interp(channel.values[i], channel.values[i + 1], t);
+    }
+
+    // The binary search every sample did before tracks kept a cursor and detected uniform spacing.
+    void SampleReference(const AnimationTrack& track, float time, XMVECTOR& outS, XMVECTOR& outR, XMVECTOR& outT)
+    {
+        auto lerp = [](const XMFLOAT3& a, const XMFLOAT3& b, float t) { return Math::Lerp(a, b, t); };
+        auto slerp = [](const XMFLOAT4& a, const XMFLOAT4& b, float t) { return Matrix4x4::QuaternionSlerp(a, b, t); };
+
+        const XMFLOAT3 s = SampleLowerBound(track.ScaleKeys, time, XMFLOAT3(1, 1, 1), lerp);
+        const XMFLOAT4 r = SampleLowerBound(track.RotationKeys, time, XMFLOAT4(0, 0, 0, 1), slerp);
+        const XMFLOAT3 t = SampleLowerBound(track.PositionKeys, time, XMFLOAT3(0, 0, 0), lerp);
+        outS = XMLoadFloat3(&s);
+        outR = XMLoadFloat4(&r);
+        outT = XMLoadFloat3(&t);
+    }
+
+    // Rotation and position keys at KeyRate; jitter > 0 moves each key by up to that fraction of a frame.
+    AnimationTrack MakeTrack(UINT keyCount, float jitter, float phase, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> offset(-jitter, jitter);
+
+        AnimationTrack track;
+        track.RotationKeys.reserve(keyCount);
+        track.PositionKeys.reserve(keyCount);
+        for (UINT k = 0; k < keyCount; ++k)
+        {
+            const bool interior = k > 0 && k + 1 < keyCount;
+            const float time = (k + (interior && jitter > 0.0f ? offset(rng) : 0.0f)) / KeyRate;
+            const float angle = time * XM_2PI + phase;
+
+            XMFLOAT4 rotation;
+            XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(0.4f * sinf(angle), 0.3f * cosf(angle), 0.1f * sinf(2.0f * angle)));
+            track.RotationKeys.Add(time, rotation);
+            track.PositionKeys.Add(time, XMFLOAT3(0.05f * sinf(angle), 1.0f + 0.02f * cosf(2.0f * angle), 0.0f));
+        }
+        track.ScaleKeys.Add(0.0f, XMFLOAT3(1, 1, 1));
+        track.Finalize();
+        return track;
+    }
+
+    template<typename SampleFn>
+    double TimeSamples(const std::vector<float>& times, SampleFn&& sample)
+    {
+        float sum = 0.0f;
+        XMVECTOR s, r, t;
+        const auto start = Clock::now();
+        for (float time : times)
+        {
+            sample(time, s, r, t);
+            sum += XMVectorGetX(r) + XMVectorGetY(t);
+        }
+        const double seconds = SecondsSince(start);
+        gSink = gSink + sum;
+        return seconds * 1e9 / times.size();
+    }
+
+    void BenchKeySampling()
+    {
+        printf("\n== Key sampling: cursor sampler vs lower_bound (ns per track sample) ==\n");
+        printf("%6s  %-8s  %-8s  %10s  %12s  %8s  %10s\n", "keys", "spacing", "access", "cursor", "lower_bound", "speedup", "max diff");
+
+        constexpr size_t SampleCount = 1 << 20;
+        std::mt19937 rng(1234);
+
+        for (UINT keyCount : { 31u, 301u, 3001u })
+        {
+            for (float jitter : { 0.0f, 0.3f })
+            {
+                const AnimationTrack track = MakeTrack(keyCount, jitter, 0.5f, rng);
+                const float duration = track.RotationKeys.times.back();
+
+                std::vector<float> forward(SampleCount), random(SampleCount);
+                std::uniform_real_distribution<float> anyTime(0.0f, duration);
+                float time = 0.0f;
+                for (size_t i = 0; i < SampleCount; ++i)
+                {
+                    forward[i] = time;
+                    time = fmodf(time + FrameTime, duration);
+                    random[i] = anyTime(rng);
+                }
+
+                for (const auto& [access, times] : { std::pair{ "forward", &forward }, std::pair{ "random", &random } })
+                {
+                    // Both samplers must agree before their timings mean anything.
+                    float maxDiff = 0.0f;
+                    AnimationTrack::Cursor cursor;
+                    for (size_t i = 0; i < times->size(); i += 7)
+                    {
+                        XMVECTOR s0, r0, t0, s1, r1, t1;
+                        track.Sample((*times)[i], cursor, s0, r0, t0);
+                        SampleReference(track, (*times)[i], s1, r1, t1);
+                        const XMVECTOR diff = XMVectorMax(XMVectorAbs(r0 - r1), XMVectorAbs(t0 - t1));
+                        maxDiff = std::max({ maxDiff, XMVectorGetX(diff), XMVectorGetY(diff), XMVectorGetZ(diff), XMVectorGetW(diff) });
+                    }
+
+                    cursor = {};
+                    const double cursorNs = TimeSamples(*times, [&](float t, XMVECTOR& s, XMVECTOR& r, XMVECTOR& p) { track.Sample(t, cursor, s, r, p); });
+                    const double referenceNs = TimeSamples(*times, [&](float t, XMVECTOR& s, XMVECTOR& r, XMVECTOR& p) { SampleReference(track, t, s, r, p); });
+
+                    printf("%6u  %-8s  %-8s  %10.1f  %12.1f  %7.2fx  %10.2e\n", keyCount, jitter > 0.0f ? "jittered" : "uniform",
+                        access, cursorNs, referenceNs, referenceNs / cursorNs, maxDiff);
+                }
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------- Characters
+
+    struct Rig
+    {
+        std::shared_ptr<Skeleton> skeleton;
+        std::shared_ptr<Model_Avatar> avatar;
+    };
+
+    std::string BoneName(UINT i) { return "Bone_" + std::to_string(i); }
+    std::string BoneKey(UINT i) { return i == 0 ? "Hips" : "Key_" + std::to_string(i); }
+
+    // Chains of six bones, each starting halfway up the rig, roughly like spine, limbs and fingers.
+    int ParentOf(UINT i) { return i == 0 ? -1 : static_cast<int>(i % 6 == 0 ? i / 2 : i - 1); }
+
+    Rig MakeRig(UINT boneCount)
+    {
+        std::ostringstream os(std::ios::binary);
+        BinaryIO::Write(os, boneCount);
+
+        std::vector<XMFLOAT4X4> model(boneCount);
+        for (UINT i = 0; i < boneCount; ++i)
+        {
+            BoneInfo bone{};
+            bone.parentIndex = ParentOf(i);
+            bone.bindScale = XMFLOAT3(1, 1, 1);
+            bone.bindRotation = XMFLOAT4(0, 0, 0, 1);
+            bone.bindTranslation = i == 0 ? XMFLOAT3(0, 1, 0) : XMFLOAT3(0, 0.1f, 0);
+
+            const XMMATRIX local = XMMatrixTranslation(bone.bindTranslation.x, bone.bindTranslation.y, bone.bindTranslation.z);
+            const XMMATRIX toModel = bone.parentIndex >= 0 ? local * XMLoadFloat4x4(&model[bone.parentIndex]) : local;
+            XMStoreFloat4x4(&model[i], toModel);
+            XMStoreFloat4x4(&bone.bindLocal, local);
+            XMStoreFloat4x4(&bone.inverseBind, XMMatrixInverse(nullptr, toModel));
+
+            BinaryIO::WriteString(os, BoneName(i));
+            BinaryIO::Write(os, bone);
+        }
+
+        const std::string bytes = os.str();
+        BinaryReader reader(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+
+        Rig rig;
+        rig.skeleton = std::make_shared<Skeleton>();
+        rig.skeleton->ReadBinary(reader);
+
+        rig.avatar = std::make_shared<Model_Avatar>();
+        for (UINT i = 0; i < boneCount; ++i)
+            rig.avatar->SetMapping(BoneKey(i), BoneName(i));
+        return rig;
+    }
+
+    std::shared_ptr<AnimationClip> MakeClip(UINT boneCount, float duration, float phase)
+    {
+        auto clip = std::make_shared<AnimationClip>();
+        clip->mDuration = duration;
+        clip->mTicksPerSecond = KeyRate;
+
+        std::mt19937 rng(static_cast<UINT>(phase * 1000.0f));
+        const UINT keyCount = static_cast<UINT>(duration * KeyRate) + 1;
+        for (UINT i = 0; i < boneCount; ++i)
+            clip->mTracks.emplace_back(BoneKey(i), MakeTrack(keyCount, 0.0f, phase + 0.37f * i, rng));
+
+        std::sort(clip->mTracks.begin(), clip->mTracks.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        return clip;
+    }
+
+    struct Crowd
+    {
+        std::vector<std::shared_ptr<AnimationControllerComponent>> controllers;
+        std::vector<AnimationScratch> scratch;
+        AnimationPoseCache poseCache;
+        AnimationPoseCacheStats cacheStats;
+    };
+
+    std::shared_ptr<AnimationControllerComponent> MakeController(const Rig& rig, const std::shared_ptr<AnimationClip>& clip, float normalizedTime)
+    {
+        auto controller = std::make_shared<AnimationControllerComponent>();
+        controller->SetOwner(nullptr);
+        controller->SetSkeleton(rig.skeleton);
+        controller->SetModelAvatar(rig.avatar);
+
+        // Every character evaluates every frame; LOD is a separate saving.
+        AnimationLODSettings lod;
+        lod.enabled = false;
+        controller->SetLODSettings(lod);
+
+        controller->Play(0, clip, 0.0f);
+        controller->SetLayerNormalizedTime(0, normalizedTime);
+        return controller;
+    }
+
+    // Runs frames the way Scene::Update_Scene does and returns milliseconds per frame.
+    double RunFrames(Crowd& crowd, UINT frames, JobSystem* jobs)
+    {
+        const UINT workerCount = jobs ? jobs->GetWorkerCount() : 1;
+        if (crowd.scratch.size() < workerCount)
+            crowd.scratch.resize(workerCount);
+
+        auto updateRange = [&](size_t begin, size_t end, UINT worker)
+            {
+                for (size_t i = begin; i < end; ++i)
+                    crowd.controllers[i]->Update(FrameTime, crowd.scratch[worker], nullptr, &crowd.poseCache);
+            };
+
+        crowd.cacheStats = {};
+        const auto start = Clock::now();
+        for (UINT frame = 0; frame < frames; ++frame)
+        {
+            AnimationControllerComponent::ResetLODStats();
+            crowd.poseCache.BeginFrame();
+
+            if (jobs)
+                jobs->ParallelFor(crowd.controllers.size(), AnimationUpdateGrain, updateRange);
+            else
+                updateRange(0, crowd.controllers.size(), 0);
+
+            const AnimationPoseCacheStats stats = AnimationPoseCache::GetStats();
+            crowd.cacheStats.lookups += stats.lookups;
+            crowd.cacheStats.hits += stats.hits;
+            crowd.cacheStats.published += stats.published;
+        }
+        return SecondsSince(start) * 1000.0 / frames;
+    }
+
+    // One warm-up frame fills scratch buffers and bindings so the timed frames measure steady state.
+    double RunWarmFrames(Crowd& crowd, UINT frames, JobSystem* jobs)
+    {
+        RunFrames(crowd, 1, jobs);
+        return RunFrames(crowd, frames, jobs);
+    }
+
+    void BenchPoseEvaluation(UINT frames)
+    {
+        printf("\n== Pose evaluation: one thread (us per character per frame) ==\n");
+        printf("%6s  %10s  %18s\n", "bones", "1 layer", "+ additive layer");
+
+        constexpr UINT CharacterCount = 64;
+        for (UINT boneCount : { 60u, 150u, 300u })
+        {
+            const Rig rig = MakeRig(boneCount);
+            auto base = MakeClip(boneCount, 1.0f, 0.0f);
+            auto additive = MakeClip(boneCount, 1.0f, 1.3f);
+            additive->SetAdditive(true);
+
+            double usPerCharacter[2] = {};
+            for (int layers = 1; layers <= 2; ++layers)
+            {
+                Crowd crowd;
+                for (UINT i = 0; i < CharacterCount; ++i)
+                {
+                    auto controller = MakeController(rig, base, static_cast<float>(i) / CharacterCount);
+                    if (layers == 2)
+                    {
+                        controller->SetLayerCount(2);
+                        controller->SetLayerBlendMode(1, LayerBlendMode::Additive);
+                        controller->Play(1, additive, 0.0f);
+                    }
+                    crowd.controllers.push_back(controller);
+                }
+                usPerCharacter[layers - 1] = RunWarmFrames(crowd, frames, nullptr) * 1000.0 / CharacterCount;
+            }
+
+            printf("%6u  %10.2f  %18.2f\n", boneCount, usPerCharacter[0], usPerCharacter[1]);
+        }
+    }
+
+    void BenchControllerScaling(UINT frames, JobSystem& jobs)
+    {
+        printf("\n== Controller scaling: 150 bones, %u workers (ms per frame, us per controller) ==\n", jobs.GetWorkerCount());
+        printf("%11s  %10s  %10s  %10s  %10s  %8s\n", "controllers", "serial ms", "us/ctrl", "jobs ms", "us/ctrl", "speedup");
+
+        const Rig rig = MakeRig(150);
+        auto clip = MakeClip(150, 1.0f, 0.0f);
+
+        for (UINT count : { 1u, 10u, 100u, 1000u })
+        {
+            Crowd crowd;
+            for (UINT i = 0; i < count; ++i)
+                crowd.controllers.push_back(MakeController(rig, clip, static_cast<float>(i) / count));
+
+            const double serialMs = RunWarmFrames(crowd, frames, nullptr);
+            const double jobsMs = RunWarmFrames(crowd, frames, &jobs);
+            printf("%11u  %10.3f  %10.2f  %10.3f  %10.2f  %7.2fx\n", count, serialMs, serialMs * 1000.0 / count,
+                jobsMs, jobsMs * 1000.0 / count, serialMs / jobsMs);
+        }
+    }
+
+    void BenchPoseSharing(UINT frames, JobSystem& jobs)
+    {
+        constexpr UINT CharacterCount = 1000;
+        constexpr UINT ClipCount = 5;
+
+        printf("\n== Pose sharing: %u characters, %u clips, 150 bones, %u workers ==\n", CharacterCount, ClipCount, jobs.GetWorkerCount());
+        printf("%-16s  %10s  %10s  %10s\n", "sharing", "ms/frame", "hit rate", "published");
+
+        const Rig rig = MakeRig(150);
+        std::vector<std::shared_ptr<AnimationClip>> clips;
+        for (UINT c = 0; c < ClipCount; ++c)
+            clips.push_back(MakeClip(150, 0.8f + 0.2f * c, 0.7f * c));
+
+        struct Mode { const char* name; bool enabled; float timeStep; };
+        for (const Mode& mode : { Mode{ "off", false, 0.0f }, Mode{ "exact time", true, 0.0f }, Mode{ "1/30 s step", true, 1.0f / 30.0f } })
+        {
+            // Same clip and phase assignment for every mode so only the sharing differs.
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<float> phase(0.0f, 1.0f);
+
+            Crowd crowd;
+            for (UINT i = 0; i < CharacterCount; ++i)
+            {
+                auto controller = MakeController(rig, clips[i % ClipCount], phase(rng));
+                controller->SetPoseSharing(mode.enabled, mode.timeStep);
+                crowd.controllers.push_back(controller);
+            }
+
+            const double ms = RunWarmFrames(crowd, frames, &jobs);
+            printf("%-16s  %10.3f  %9.1f%%  %10.1f\n", mode.name, ms, crowd.cacheStats.GetHitRate() * 100.0f,
+                static_cast<double>(crowd.cacheStats.published) / frames);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const UINT frames = argc > 1 ? std::max(1, atoi(argv[1])) : 120;
+
+    JobSystem jobs;
+
+    BenchKeySampling();
+    BenchPoseEvaluation(frames);
+    BenchControllerScaling(frames, jobs);
+    BenchPoseSharing(frames, jobs);
+
+    printf("\n[AnimationBench] checksum %g\n", static_cast<double>(gSink));
+    return 0;
+}
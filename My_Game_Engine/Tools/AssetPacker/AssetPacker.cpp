@@ -0,0 +1,75 @@
+#include "Resource/AssetPack.h"
+#include "JobSystem.h"
+
+// Packs the small runtime assets under an asset root into one .pak that ResourceSystem mounts at startup.
+// Run it from the game's working directory so the stored paths match what the engine asks for.
+//   AssetPacker <asset root> <output .pak> [extensions...]
+
+namespace
+{
+    const std::vector<std::string> DefaultExtensions =
+    {
+        ".meta", ".mat", ".anim", ".skel", ".avatar", ".mask",
+        ".png", ".jpg", ".jpeg", ".tga", ".bmp", ".dds", ".hdr"
+    };
+
+    std::string ToLower(std::string s)
+    {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return s;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage: AssetPacker <asset root> <output .pak> [extensions...]\n");
+        return 1;
+    }
+
+    const std::filesystem::path root = argv[1];
+    const std::string packPath = argv[2];
+
+    std::vector<std::string> extensions;
+    for (int i = 3; i < argc; ++i)
+        extensions.push_back(ToLower(argv[i]));
+    if (extensions.empty())
+        extensions = DefaultExtensions;
+
+    auto start = std::chrono::steady_clock::now();
+
+    AssetPackWriter writer;
+    uint64_t totalBytes = 0;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(root, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (!it->is_regular_file(ec))
+            continue;
+
+        const std::string ext = ToLower(it->path().extension().string());
+        if (std::find(extensions.begin(), extensions.end(), ext) == extensions.end())
+            continue;
+
+        writer.AddFile(it->path().generic_string(), it->path().string());
+        totalBytes += it->file_size(ec);
+    }
+
+    if (writer.GetFileCount() == 0)
+    {
+        printf("[AssetPacker] No files matched under %s\n", root.string().c_str());
+        return 1;
+    }
+
+    JobSystem jobs;
+    if (!writer.Write(packPath, &jobs))
+    {
+        printf("[AssetPacker] Failed to write %s\n", packPath.c_str());
+        return 1;
+    }
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("[AssetPacker] %zu files, %.2f MB -> %.2f MB in %.1f ms\n", writer.GetFileCount(),
+        totalBytes / (1024.0 * 1024.0), std::filesystem::file_size(packPath, ec) / (1024.0 * 1024.0), ms);
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include "Resource/ResourceSystem.h"
+#include "DX_Graphics/Renderer.h"
+
+// Console checks for ResourceSystem behaviour that has no visible symptom in the editor.
+// Exits with the number of failed checks, so ctest reports any failure.
+//   ResourceTests
+
+namespace
+{
+    std::atomic<size_t> gAllocations = 0;
+    int gFailures = 0;
+
+    void Check(bool condition, const char* what)
+    {
+        printf("[%s] %s\n", condition ? " OK " : "FAIL", what);
+        if (!condition) ++gFailures;
+    }
+
+    template<typename Fn>
+    size_t CountAllocations(Fn&& fn)
+    {
+        const size_t before = gAllocations.load();
+        fn();
+        return gAllocations.load() - before;
+    }
+
+    std::string MakeScratchDirectory(const char* name)
+    {
+        std::error_code ec;
+        std::filesystem::path dir = std::filesystem::temp_directory_path(ec) / "ResourceTests" / name;
+        std::filesystem::create_directories(dir, ec);
+        return dir.generic_string();
+    }
+
+    std::shared_ptr<AnimationClip> RegisterClip(ResourceSystem& rs, const std::string& path, const std::string& alias)
+    {
+        auto clip = std::make_shared<AnimationClip>();
+        clip->SetPath(path);
+        clip->SetAlias(alias);
+        rs.RegisterResource(clip);
+        return clip;
+    }
+
+    // Lookups of registered resources run every frame from components; a hit must not touch the heap.
+    void TestLookupHitsDoNotAllocate()
+    {
+        ResourceSystem rs;
+        const std::string dir = MakeScratchDirectory("Lookup");
+        const std::string walkPath = dir + "/Walk.anim";
+        const std::string runPath = dir + "/Run.anim";
+
+        auto walk = RegisterClip(rs, walkPath, "Walk");
+        auto run = RegisterClip(rs, runPath, "Run");
+        const UINT walkId = walk->GetId();
+        const Guid walkGuid = walk->GetGUID();
+
+        // A view into a longer buffer: lookups must not depend on a terminating null.
+        const std::string padded = runPath + "#ignored";
+        const std::string_view runView(padded.data(), runPath.size());
+
+        UINT id = Engine::INVALID_ID;
+        std::shared_ptr<AnimationClip> found;
+
+        Check(CountAllocations([&] { id = rs.GetIdByPath(walkPath); }) == 0 && id == walkId,
+            "GetIdByPath hit does not allocate");
+        Check(CountAllocations([&] { id = rs.GetIdByPath(runView); }) == 0 && id == run->GetId(),
+            "GetIdByPath hit through an unterminated view does not allocate");
+        Check(CountAllocations([&] { found = rs.GetByPath<AnimationClip>(walkPath); }) == 0 && found == walk,
+            "GetByPath hit does not allocate");
+        Check(CountAllocations([&] { found = rs.GetByAlias<AnimationClip>("Run"); }) == 0 && found == run,
+            "GetByAlias hit does not allocate");
+        Check(CountAllocations([&] { found = rs.GetByGUID<AnimationClip>(walkGuid); }) == 0 && found == walk,
+            "GetByGUID hit does not allocate");
+        Check(CountAllocations([&] { found = rs.GetOrLoad<AnimationClip>(walkGuid, {}); }) == 0 && found == walk,
+            "GetOrLoad hit by GUID does not allocate");
+        Check(CountAllocations([&] { found = rs.GetOrLoad<AnimationClip>({}, runView); }) == 0 && found == run,
+            "GetOrLoad hit by path does not allocate");
+
+        // Backslashes are normalized through a copy; the lookup must still resolve.
+        std::string backslashed = walkPath;
+        std::replace(backslashed.begin(), backslashed.end(), '/', '\\');
+        Check(rs.GetIdByPath(backslashed) == walkId, "GetIdByPath resolves a backslashed path");
+        Check(rs.GetIdByPath(dir + "/Missing.anim") == Engine::INVALID_ID, "GetIdByPath misses an unknown path");
+    }
+
+    // A WARP device with one command list, standing in for the renderer's upload context.
+    struct UploadDevice
+    {
+        ComPtr<ID3D12Device> device;
+        ComPtr<ID3D12CommandQueue> queue;
+        ComPtr<ID3D12CommandAllocator> allocator;
+        ComPtr<ID3D12GraphicsCommandList> cmdList;
+        ComPtr<ID3D12Fence> fence;
+        UINT64 fenceValue = 0;
+
+        bool Create()
+        {
+            ComPtr<IDXGIFactory4> factory;
+            ComPtr<IDXGIAdapter> warp;
+            if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory))) || FAILED(factory->EnumWarpAdapter(IID_PPV_ARGS(&warp))) ||
+                FAILED(D3D12CreateDevice(warp.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&device))))
+                return false;
+
+            D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+            queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+            return SUCCEEDED(device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&queue))) &&
+                SUCCEEDED(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&allocator))) &&
+                SUCCEEDED(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, allocator.Get(), nullptr, IID_PPV_ARGS(&cmdList))) &&
+                SUCCEEDED(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)));
+        }
+
+        RendererContext GetContext() const { return { device.Get(), cmdList.Get(), nullptr }; }
+
+        // Runs the recorded copies and waits, as the renderer does before calling OnUploadComplete.
+        void Flush()
+        {
+            cmdList->Close();
+            ID3D12CommandList* lists[] = { cmdList.Get() };
+            queue->ExecuteCommandLists(1, lists);
+            queue->Signal(fence.Get(), ++fenceValue);
+
+            HANDLE event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+            fence->SetEventOnCompletion(fenceValue, event);
+            WaitForSingleObject(event, INFINITE);
+            CloseHandle(event);
+
+            allocator->Reset();
+            cmdList->Reset(allocator.Get(), nullptr);
+        }
+    };
+
+    // Writes a flat grid the way the importers cook meshes: positions only, one submesh.
+    class GridMesh : public Mesh
+    {
+    public:
+        bool Cook(UINT size, const std::string& path)
+        {
+            mHotLayout = {};
+            mHotLayout.stride = sizeof(XMFLOAT3);
+            mHotLayout.position = { 0, DXGI_FORMAT_R32G32B32_FLOAT, true };
+            mColdLayout = {};
+
+            mHotCPU.resize(static_cast<size_t>(size) * size * sizeof(XMFLOAT3));
+            for (UINT z = 0; z < size; ++z)
+            {
+                for (UINT x = 0; x < size; ++x)
+                {
+                    const XMFLOAT3 position(static_cast<float>(x), 0.0f, static_cast<float>(z));
+                    memcpy(mHotCPU.data() + (static_cast<size_t>(z) * size + x) * sizeof(XMFLOAT3), &position, sizeof(position));
+                }
+            }
+
+            for (UINT z = 0; z + 1 < size; ++z)
+            {
+                for (UINT x = 0; x + 1 < size; ++x)
+                {
+                    const UINT i = z * size + x;
+                    indices.insert(indices.end(), { i, i + size, i + 1, i + 1, i + size, i + size + 1 });
+                }
+            }
+
+            mVertexCount = size * size;
+            mIndexCount = static_cast<UINT>(indices.size());
+
+            const float half = (size - 1) * 0.5f;
+            mLocalAABB = BoundingBox(XMFLOAT3(half, 0.0f, half), XMFLOAT3(half, 0.0f, half));
+
+            Submesh sub;
+            sub.indexCount = mIndexCount;
+            sub.materialSlot = 0;
+            sub.localAABB = mLocalAABB;
+            submeshes = { sub };
+
+            return SaveToFile(path);
+        }
+    };
+
+    // Once its upload completes, a mesh keeps only what it needs resident: no staging buffers, no CPU geometry,
+    // and a collision BVH only when the model was imported with generate_collision.
+    void TestMeshResidentBytes()
+    {
+        UploadDevice upload;
+        if (!upload.Create())
+        {
+            Check(false, "WARP device for mesh uploads");
+            return;
+        }
+
+        const std::string path = MakeScratchDirectory("Mesh") + "/Grid.mesh";
+        Check(GridMesh().Cook(64, path), "Cook a 64x64 grid mesh");
+
+        UINT64 residentCpu[2] = {};
+        for (bool generateCollision : { false, true })
+        {
+            auto mesh = std::make_shared<Mesh>();
+            mesh->SetGenerateCollision(generateCollision);
+            if (!mesh->LoadFromFile(path, upload.GetContext()))
+            {
+                Check(false, "Load the cooked grid mesh");
+                return;
+            }
+            if (generateCollision)
+                Check(mesh->BuildCollisionBVH(), "Build the collision BVH at import");
+
+            const MemoryFootprint before = mesh->GetMemoryFootprint();
+            upload.Flush();
+            mesh->OnUploadComplete();
+            const MemoryFootprint after = mesh->GetMemoryFootprint();
+            residentCpu[generateCollision] = after.cpuBytes;
+
+            printf("    generate_collision=%d: cpu %llu -> %llu, gpu %llu -> %llu, staging %llu -> %llu bytes\n",
+                generateCollision ? 1 : 0, before.cpuBytes, after.cpuBytes, before.gpuBytes, after.gpuBytes,
+                before.stagingBytes, after.stagingBytes);
+
+            Check(before.stagingBytes > 0 && after.stagingBytes == 0, "Staging buffers are released after the upload");
+            Check(after.gpuBytes == before.gpuBytes && after.gpuBytes > 0, "GPU buffers stay resident");
+            Check(after.cpuBytes < before.cpuBytes, "CPU geometry is released after the upload");
+            Check((mesh->GetCollisionBVH() != nullptr) == generateCollision, "A collision BVH exists only with generate_collision");
+        }
+
+        // Without collision only the submesh table stays; the BVH is the whole difference.
+        Check(residentCpu[0] < 1024, "Without generate_collision no geometry stays on the CPU");
+        Check(residentCpu[1] > residentCpu[0], "generate_collision keeps the BVH resident");
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    ++gAllocations;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main()
+{
+    TestLookupHitsDoNotAllocate();
+    TestMeshResidentBytes();
+
+    printf("[ResourceTests] %d failed\n", gFailures);
+    return gFailures;
+}